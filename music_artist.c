@@ -0,0 +1,587 @@
+// header files
+#include "music_artist.h"
+#include <pthread.h>
+
+// global definitions
+// artists per block; blocks never move, so names stay where they are
+#define ARTIST_BLOCK_SIZE 1024
+#define ARTIST_MIN_SLOTS 64
+// block pointers in the first directory
+#define ARTIST_MIN_BLOCKS 16
+
+// one artist, or one unused number waiting to be reused
+typedef struct ArtistRecord
+{
+    // the name, empty for an unused number
+    char name[STR_LEN];
+    // the name's length
+    uint32_t length;
+    // the name's hash
+    uint32_t hash;
+    // references held by songs and caches; 0 for an unused number
+    uint32_t refs;
+    // the next unused number, while this one is unused
+    uint32_t nextFree;
+}
+ArtistRecord;
+
+// the pointers to the blocks
+//
+// A full directory is copied into one twice its size rather than
+// reallocated, and the old one is kept, so a reader that loaded it without
+// the lock still finds every block that existed then.
+typedef struct ArtistDirectory
+{
+    // the directory this one replaced, NULL for the first
+    struct ArtistDirectory *previous;
+    // the number of block pointers it has room for
+    size_t capacity;
+    ArtistRecord *blocks[];
+}
+ArtistDirectory;
+
+// every artist of the program, shared by all playlists
+static struct
+{
+    // guards everything below
+    pthread_mutex_t lock;
+    // the records in blocks of ARTIST_BLOCK_SIZE, and how many blocks; the
+    // directory is also read without the lock
+    ArtistDirectory *directory;
+    size_t blockCount;
+    // numbers handed out so far, used or not
+    size_t used;
+    // the first unused number, ARTIST_NONE if there is none
+    uint32_t freeList;
+    // number of artists with references
+    size_t live;
+    // open-addressing table of number + 1, 0 for an empty slot
+    uint32_t *slots;
+    size_t mask;
+}
+artistPool = { PTHREAD_MUTEX_INITIALIZER, NULL, 0, 0, ARTIST_NONE, 0, NULL, 0 };
+
+/**
+ * Function: artistHash (helper)
+ * Input argument: name - the artist name
+ *                 length - the number of bytes in the name
+ * Output argument: none
+ * Return: a 32-bit FNV-1a hash of the name
+ * Dependencies: none
+ */
+static uint32_t artistHash(const char *name, size_t length)
+{
+    // FNV-1a over the bytes
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ (unsigned char)name[i]) * 16777619u;
+    }
+    // return the hash
+    return hash;
+}
+
+/**
+ * Function: artistRecord (helper)
+ * Input argument: id - an artist number below artistPool.used
+ * Output argument: none
+ * Return: a pointer to the number's record
+ * Dependencies: none
+ *
+ * Safe without the lock for a number the caller holds a reference to.
+ */
+static inline ArtistRecord *artistRecord(uint32_t id)
+{
+    ArtistDirectory *directory =
+        __atomic_load_n(&artistPool.directory, __ATOMIC_ACQUIRE);
+    return &directory->blocks[id / ARTIST_BLOCK_SIZE][id % ARTIST_BLOCK_SIZE];
+}
+
+/**
+ * Function: artistAddBlock (helper)
+ * Input argument: none
+ * Output argument: one more block of records is allocated, in a larger
+ *                  directory if the current one is full; the lock must be
+ *                  held
+ * Return: true on success, false if memory ran out
+ * Dependencies: stdlib.h, string.h
+ */
+static bool artistAddBlock(void)
+{
+    ArtistRecord *block = (ArtistRecord*)calloc(
+        ARTIST_BLOCK_SIZE, sizeof(ArtistRecord));
+    if (block == NULL)
+    {
+        return false;
+    }
+    ArtistDirectory *directory = artistPool.directory;
+    // a full directory is copied into one twice its size
+    if (directory == NULL || artistPool.blockCount == directory->capacity)
+    {
+        size_t capacity = directory == NULL ? ARTIST_MIN_BLOCKS :
+            directory->capacity * 2;
+        ArtistDirectory *larger = (ArtistDirectory*)malloc(
+            sizeof(ArtistDirectory) + capacity * sizeof(ArtistRecord*));
+        if (larger == NULL)
+        {
+            free(block);
+            return false;
+        }
+        larger->previous = directory;
+        larger->capacity = capacity;
+        if (directory != NULL)
+        {
+            memcpy(larger->blocks, directory->blocks,
+                artistPool.blockCount * sizeof(ArtistRecord*));
+        }
+        directory = larger;
+    }
+    // fill the block in before readers can see the directory
+    directory->blocks[artistPool.blockCount++] = block;
+    __atomic_store_n(&artistPool.directory, directory, __ATOMIC_RELEASE);
+    // return success
+    return true;
+}
+
+/**
+ * Function: artistSlotOf (helper)
+ * Input argument: name - the artist name
+ *                 length - the number of bytes in the name
+ *                 hash - the name's hash
+ * Output argument: none
+ * Return: the slot holding the artist, or the empty slot it would take;
+ *         the lock must be held and the slots allocated
+ * Dependencies: artistRecord, string.h
+ */
+static size_t artistSlotOf(const char *name, size_t length, uint32_t hash)
+{
+    // probe from the slot the hash points at
+    size_t position = hash & artistPool.mask;
+    while (artistPool.slots[position] != 0)
+    {
+        // stop at the artist
+        ArtistRecord *record = artistRecord(artistPool.slots[position] - 1);
+        if (record->hash == hash && record->length == length &&
+            memcmp(record->name, name, length) == 0)
+        {
+            break;
+        }
+        position = (position + 1) & artistPool.mask;
+    }
+    // return the slot
+    return position;
+}
+
+/**
+ * Function: artistGrowSlots (helper)
+ * Input argument: none
+ * Output argument: the slot table doubles and every artist is placed again;
+ *                  the lock must be held
+ * Return: true on success, false if memory ran out
+ * Dependencies: artistRecord, stdlib.h
+ */
+static bool artistGrowSlots(void)
+{
+    // double the table, starting from the minimum
+    size_t capacity = artistPool.slots == NULL ? ARTIST_MIN_SLOTS :
+        (artistPool.mask + 1) * 2;
+    uint32_t *slots = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+    if (slots == NULL)
+    {
+        return false;
+    }
+    // place every live artist in the new table
+    for (size_t id = 0; id < artistPool.used; id++)
+    {
+        ArtistRecord *record = artistRecord((uint32_t)id);
+        if (record->refs == 0)
+        {
+            continue;
+        }
+        size_t position = record->hash & (capacity - 1);
+        while (slots[position] != 0)
+        {
+            position = (position + 1) & (capacity - 1);
+        }
+        slots[position] = (uint32_t)id + 1;
+    }
+    // swap the tables
+    free(artistPool.slots);
+    artistPool.slots = slots;
+    artistPool.mask = capacity - 1;
+    // return success
+    return true;
+}
+
+/**
+ * Function: artistNewId (helper)
+ * Input argument: none
+ * Output argument: a number is taken from the unused ones, or a new one is
+ *                  added; the lock must be held
+ * Return: the number, or ARTIST_NONE if memory ran out
+ * Dependencies: artistRecord, artistAddBlock
+ */
+static uint32_t artistNewId(void)
+{
+    // reuse a released number first
+    if (artistPool.freeList != ARTIST_NONE)
+    {
+        uint32_t id = artistPool.freeList;
+        artistPool.freeList = artistRecord(id)->nextFree;
+        return id;
+    }
+    // numbers must stay below ARTIST_NONE
+    if (artistPool.used >= ARTIST_NONE)
+    {
+        return ARTIST_NONE;
+    }
+    // add a block when the last one is full
+    if (artistPool.used == artistPool.blockCount * ARTIST_BLOCK_SIZE &&
+        !artistAddBlock())
+    {
+        return ARTIST_NONE;
+    }
+    // hand out the next number
+    return (uint32_t)artistPool.used++;
+}
+
+/**
+ * Function: artistInternLocked (helper)
+ * Input argument: name - the artist name, not necessarily null terminated
+ *                 length - the number of bytes in the name, below STR_LEN
+ *                 hash - the name's hash
+ * Output argument: the artist is added unless it already was, and gains a
+ *                  reference; the lock must be held
+ * Return: the artist's number, or ARTIST_NONE if memory ran out
+ * Dependencies: artistGrowSlots, artistSlotOf, artistNewId, string.h
+ */
+static uint32_t artistInternLocked(const char *name, size_t length,
+    uint32_t hash)
+{
+    // keep the table at most half full
+    if (artistPool.slots == NULL ||
+        (artistPool.live + 1) * 2 > artistPool.mask + 1)
+    {
+        if (!artistGrowSlots())
+        {
+            return ARTIST_NONE;
+        }
+    }
+    // an artist that is already known gains a reference
+    size_t position = artistSlotOf(name, length, hash);
+    if (artistPool.slots[position] != 0)
+    {
+        uint32_t id = artistPool.slots[position] - 1;
+        artistRecord(id)->refs++;
+        return id;
+    }
+    // otherwise, give it a number
+    uint32_t id = artistNewId();
+    if (id == ARTIST_NONE)
+    {
+        return ARTIST_NONE;
+    }
+    // fill in its record
+    ArtistRecord *record = artistRecord(id);
+    memcpy(record->name, name, length);
+    record->name[length] = '\0';
+    record->length = (uint32_t)length;
+    record->hash = hash;
+    record->refs = 1;
+    // and make it findable
+    artistPool.slots[position] = id + 1;
+    artistPool.live++;
+    // return its number
+    return id;
+}
+
+/**
+ * Function: artistReleaseLocked (helper)
+ * Input argument: id - an artist number with at least one reference
+ * Output argument: the artist loses a reference and is dropped with its
+ *                  last one; the lock must be held
+ * Return: none
+ * Dependencies: artistRecord, artistSlotOf
+ */
+static void artistReleaseLocked(uint32_t id)
+{
+    // nothing more to do while references remain
+    ArtistRecord *record = artistRecord(id);
+    if (--record->refs > 0)
+    {
+        return;
+    }
+    // find its slot and shift the following entries back over it
+    size_t position = artistSlotOf(record->name, record->length,
+        record->hash);
+    size_t next = (position + 1) & artistPool.mask;
+    while (artistPool.slots[next] != 0)
+    {
+        // an entry moves back only if that does not pass its home slot
+        uint32_t hash = artistRecord(artistPool.slots[next] - 1)->hash;
+        size_t home = hash & artistPool.mask;
+        if (((next - home) & artistPool.mask) >=
+            ((next - position) & artistPool.mask))
+        {
+            artistPool.slots[position] = artistPool.slots[next];
+            position = next;
+        }
+        next = (next + 1) & artistPool.mask;
+    }
+    artistPool.slots[position] = 0;
+    // clear the record and put its number up for reuse
+    record->name[0] = '\0';
+    record->length = 0;
+    record->nextFree = artistPool.freeList;
+    artistPool.freeList = id;
+    artistPool.live--;
+}
+
+/**
+ * Function: artistPoolIntern
+ * Input argument: name - the artist name, not necessarily null terminated
+ *                 length - the number of bytes in the name, below STR_LEN
+ * Output argument: the artist is added unless it already was, and gains a
+ *                  reference
+ * Return: the artist's number, or ARTIST_NONE if memory ran out
+ * Dependencies: artistHash, artistInternLocked, pthread.h
+ */
+uint32_t artistPoolIntern(const char *name, size_t length)
+{
+    // names must fit in a record
+    if (length >= STR_LEN)
+    {
+        return ARTIST_NONE;
+    }
+    // hash outside the lock
+    uint32_t hash = artistHash(name, length);
+    pthread_mutex_lock(&artistPool.lock);
+    uint32_t id = artistInternLocked(name, length, hash);
+    pthread_mutex_unlock(&artistPool.lock);
+    // return the number
+    return id;
+}
+
+/**
+ * Function: artistPoolFind
+ * Input argument: name - a null terminated artist name
+ * Output argument: none
+ * Return: the artist's number, or ARTIST_NONE if no song has that artist
+ * Dependencies: artistHash, artistSlotOf, pthread.h, string.h
+ */
+uint32_t artistPoolFind(const char *name)
+{
+    // hash outside the lock
+    size_t length = strlen(name);
+    uint32_t hash = artistHash(name, length);
+    uint32_t id = ARTIST_NONE;
+    pthread_mutex_lock(&artistPool.lock);
+    // look the name up if there is a table to look in
+    if (artistPool.slots != NULL && length < STR_LEN)
+    {
+        uint32_t entry = artistPool.slots[artistSlotOf(name, length, hash)];
+        id = entry == 0 ? ARTIST_NONE : entry - 1;
+    }
+    pthread_mutex_unlock(&artistPool.lock);
+    // return the number
+    return id;
+}
+
+/**
+ * Function: artistPoolRetain
+ * Input argument: id - an artist number with at least one reference
+ *                 count - the number of references to add
+ * Output argument: the artist gains count references
+ * Return: none
+ * Dependencies: artistRecord, pthread.h
+ */
+void artistPoolRetain(uint32_t id, uint32_t count)
+{
+    pthread_mutex_lock(&artistPool.lock);
+    artistRecord(id)->refs += count;
+    pthread_mutex_unlock(&artistPool.lock);
+}
+
+/**
+ * Function: artistPoolRelease
+ * Input argument: id - an artist number with at least one reference
+ * Output argument: the artist loses a reference; with its last one its name
+ *                  is dropped and its number can be reused
+ * Return: none
+ * Dependencies: artistReleaseLocked, pthread.h
+ */
+void artistPoolRelease(uint32_t id)
+{
+    pthread_mutex_lock(&artistPool.lock);
+    artistReleaseLocked(id);
+    pthread_mutex_unlock(&artistPool.lock);
+}
+
+/**
+ * Function: artistPoolName
+ * Input argument: id - an artist number with at least one reference
+ * Output argument: none
+ * Return: the artist's name, valid while the artist has references
+ * Dependencies: artistRecord
+ */
+const char *artistPoolName(uint32_t id)
+{
+    return artistRecord(id)->name;
+}
+
+/**
+ * Function: artistPoolLength
+ * Input argument: id - an artist number with at least one reference
+ * Output argument: none
+ * Return: the number of bytes in the artist's name
+ * Dependencies: artistRecord
+ */
+size_t artistPoolLength(uint32_t id)
+{
+    return artistRecord(id)->length;
+}
+
+/**
+ * Function: artistPoolCount
+ * Input argument: none
+ * Output argument: none
+ * Return: the number of artists with at least one reference
+ * Dependencies: pthread.h
+ */
+size_t artistPoolCount(void)
+{
+    pthread_mutex_lock(&artistPool.lock);
+    size_t live = artistPool.live;
+    pthread_mutex_unlock(&artistPool.lock);
+    return live;
+}
+
+/**
+ * Function: artistCacheInit
+ * Input argument: cache - a pointer to an artist cache
+ * Output argument: every entry is empty
+ * Return: none
+ * Dependencies: none
+ */
+void artistCacheInit(ArtistCache *cache)
+{
+    // mark every entry empty
+    for (size_t i = 0; i < ARTIST_CACHE_SIZE; i++)
+    {
+        cache->entries[i].id = ARTIST_NONE;
+        cache->entries[i].pending = 0;
+    }
+}
+
+/**
+ * Function: artistCacheSettle (helper)
+ * Input argument: entry - a filled cache entry
+ * Output argument: the entry's handed out references reach the pool, its
+ *                  own is released, and it is empty again; the lock must be
+ *                  held
+ * Return: none
+ * Dependencies: artistRecord, artistReleaseLocked
+ */
+static void artistCacheSettle(ArtistCacheEntry *entry)
+{
+    // count the references handed out, then drop the entry's own
+    artistRecord(entry->id)->refs += entry->pending;
+    artistReleaseLocked(entry->id);
+    // empty the entry
+    entry->id = ARTIST_NONE;
+    entry->pending = 0;
+}
+
+/**
+ * Function: artistCacheIntern
+ * Input argument: cache - a pointer to the calling thread's artist cache
+ *                 name - the artist name, not necessarily null terminated
+ *                 length - the number of bytes in the name, below STR_LEN
+ * Output argument: the caller owns one reference to the artist
+ * Return: the artist's number, or ARTIST_NONE if memory ran out
+ * Dependencies: pthread.h, string.h
+ */
+uint32_t artistCacheIntern(ArtistCache *cache, const char *name,
+    size_t length)
+{
+    // names must fit in a record
+    if (length >= STR_LEN)
+    {
+        return ARTIST_NONE;
+    }
+    // the hash picks the entry
+    uint32_t hash = artistHash(name, length);
+    ArtistCacheEntry *entry = &cache->entries[hash & (ARTIST_CACHE_SIZE - 1)];
+    // a hit costs no lock
+    if (entry->id != ARTIST_NONE && entry->length == length &&
+        memcmp(entry->name, name, length) == 0)
+    {
+        entry->pending++;
+        return entry->id;
+    }
+    // a miss settles the entry it replaces and interns the artist twice,
+    // once for the entry and once for the caller
+    pthread_mutex_lock(&artistPool.lock);
+    if (entry->id != ARTIST_NONE)
+    {
+        artistCacheSettle(entry);
+    }
+    uint32_t id = artistInternLocked(name, length, hash);
+    pthread_mutex_unlock(&artistPool.lock);
+    if (id == ARTIST_NONE)
+    {
+        return ARTIST_NONE;
+    }
+    // fill the entry
+    entry->id = id;
+    entry->pending = 1;
+    entry->length = (uint32_t)length;
+    memcpy(entry->name, name, length);
+    // return the number
+    return id;
+}
+
+/**
+ * Function: artistCacheDrop
+ * Input argument: cache - a pointer to the artist cache the id came from
+ *                 id - an artist number returned by artistCacheIntern
+ * Output argument: the caller's reference is given back
+ * Return: none
+ * Dependencies: artistPoolRelease
+ */
+void artistCacheDrop(ArtistCache *cache, uint32_t id)
+{
+    // take the reference back from the entry that still counts it
+    for (size_t i = 0; i < ARTIST_CACHE_SIZE; i++)
+    {
+        if (cache->entries[i].id == id && cache->entries[i].pending > 0)
+        {
+            cache->entries[i].pending--;
+            return;
+        }
+    }
+    // otherwise, the pool has already counted it
+    artistPoolRelease(id);
+}
+
+/**
+ * Function: artistCacheFlush
+ * Input argument: cache - a pointer to an artist cache
+ * Output argument: the references handed out reach the pool, the cache's
+ *                  own are released, and every entry is empty again
+ * Return: none
+ * Dependencies: pthread.h
+ */
+void artistCacheFlush(ArtistCache *cache)
+{
+    // settle every filled entry in one locked pass
+    pthread_mutex_lock(&artistPool.lock);
+    for (size_t i = 0; i < ARTIST_CACHE_SIZE; i++)
+    {
+        if (cache->entries[i].id != ARTIST_NONE)
+        {
+            artistCacheSettle(&cache->entries[i]);
+        }
+    }
+    pthread_mutex_unlock(&artistPool.lock);
+}
@@ -0,0 +1,157 @@
+#ifndef MUSIC_ARTIST_H
+#define MUSIC_ARTIST_H
+
+// header files
+#include "music_lib.h"
+
+// global definitions
+// the artist number that names no artist
+#define ARTIST_NONE UINT32_MAX
+// entries in a thread's artist cache, a power of two
+#define ARTIST_CACHE_SIZE 256
+
+// one recently interned artist and the references handed out for it
+typedef struct ArtistCacheEntry
+{
+    // the artist's number, ARTIST_NONE for an empty entry
+    uint32_t id;
+    // references handed out since the entry was filled, not yet counted by
+    // the pool
+    uint32_t pending;
+    // the name and its length, to recognize the artist without the pool
+    uint32_t length;
+    char name[STR_LEN];
+}
+ArtistCacheEntry;
+
+// a direct-mapped cache in front of the artist pool, owned by one thread
+//
+// Every entry holds one reference of its own, so its artist stays alive,
+// and counts the references it hands out. They reach the pool in one locked
+// step when the entry is replaced or the cache is flushed.
+typedef struct ArtistCache
+{
+    ArtistCacheEntry entries[ARTIST_CACHE_SIZE];
+}
+ArtistCache;
+
+// function prototypes
+
+/**
+ * Function: artistPoolIntern
+ * Input argument: name - the artist name, not necessarily null terminated
+ *                 length - the number of bytes in the name, below STR_LEN
+ * Output argument: the artist is added unless it already was, and gains a
+ *                  reference
+ * Return: the artist's number, or ARTIST_NONE if memory ran out
+ * Dependencies: pthread.h, stdlib.h, string.h
+ *
+ * The pool is shared by every playlist and thread. Numbers are dense and
+ * reused once an artist's last reference is released.
+ */
+uint32_t artistPoolIntern(const char *name, size_t length);
+
+/**
+ * Function: artistPoolFind
+ * Input argument: name - a null terminated artist name
+ * Output argument: none
+ * Return: the artist's number, or ARTIST_NONE if no song has that artist
+ * Dependencies: pthread.h, string.h
+ */
+uint32_t artistPoolFind(const char *name);
+
+/**
+ * Function: artistPoolRetain
+ * Input argument: id - an artist number with at least one reference
+ *                 count - the number of references to add
+ * Output argument: the artist gains count references
+ * Return: none
+ * Dependencies: pthread.h
+ */
+void artistPoolRetain(uint32_t id, uint32_t count);
+
+/**
+ * Function: artistPoolRelease
+ * Input argument: id - an artist number with at least one reference
+ * Output argument: the artist loses a reference; with its last one its name
+ *                  is dropped and its number can be reused
+ * Return: none
+ * Dependencies: pthread.h
+ */
+void artistPoolRelease(uint32_t id);
+
+/**
+ * Function: artistPoolName
+ * Input argument: id - an artist number with at least one reference
+ * Output argument: none
+ * Return: the artist's name, valid while the artist has references
+ * Dependencies: none
+ *
+ * Reads without the lock, and is safe on any thread while the caller holds
+ * a reference: blocks never move, and a reader that loaded an old
+ * directory still finds its block there.
+ */
+const char *artistPoolName(uint32_t id);
+
+/**
+ * Function: artistPoolLength
+ * Input argument: id - an artist number with at least one reference
+ * Output argument: none
+ * Return: the number of bytes in the artist's name
+ * Dependencies: none
+ */
+size_t artistPoolLength(uint32_t id);
+
+/**
+ * Function: artistPoolCount
+ * Input argument: none
+ * Output argument: none
+ * Return: the number of artists with at least one reference
+ * Dependencies: pthread.h
+ */
+size_t artistPoolCount(void);
+
+/**
+ * Function: artistCacheInit
+ * Input argument: cache - a pointer to an artist cache
+ * Output argument: every entry is empty
+ * Return: none
+ * Dependencies: none
+ */
+void artistCacheInit(ArtistCache *cache);
+
+/**
+ * Function: artistCacheIntern
+ * Input argument: cache - a pointer to the calling thread's artist cache
+ *                 name - the artist name, not necessarily null terminated
+ *                 length - the number of bytes in the name, below STR_LEN
+ * Output argument: the caller owns one reference to the artist
+ * Return: the artist's number, or ARTIST_NONE if memory ran out
+ * Dependencies: pthread.h, string.h
+ *
+ * Repeated artists are answered from the cache without taking the lock.
+ */
+uint32_t artistCacheIntern(ArtistCache *cache, const char *name,
+    size_t length);
+
+/**
+ * Function: artistCacheDrop
+ * Input argument: cache - a pointer to the artist cache the id came from
+ *                 id - an artist number returned by artistCacheIntern
+ * Output argument: the caller's reference is given back
+ * Return: none
+ * Dependencies: artistPoolRelease
+ */
+void artistCacheDrop(ArtistCache *cache, uint32_t id);
+
+/**
+ * Function: artistCacheFlush
+ * Input argument: cache - a pointer to an artist cache
+ * Output argument: the references handed out reach the pool, the cache's
+ *                  own are released, and every entry is empty again
+ * Return: none
+ * Dependencies: pthread.h
+ */
+void artistCacheFlush(ArtistCache *cache);
+
+#endif // MUSIC_ARTIST_H
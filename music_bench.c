@@ -0,0 +1,2891 @@
+// header files
+#include "music_lib.h"
+#include "music_sort.h"
+#include "music_snapshot.h"
+#include "music_columnar.h"
+#include "music_artist.h"
+#include "music_rng.h"
+#include "music_shared.h"
+#include "music_journal.h"
+#include "music_search.h"
+#include <fcntl.h>
+#include <math.h>
+#include <strings.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+// Benchmarks for music_lib. Build with
+//     gcc -std=gnu11 -O2 -pthread -o music_bench music_bench.c music_lib.c
+//         music_pool.c music_sort.c music_rng.c music_index.c music_csv.c
+//         music_snapshot.c music_columnar.c music_artist.c music_output.c
+//         music_cursor.c music_order.c music_epoch.c music_shared.c
+//         music_journal.c music_search.c music_prefix.c -lm
+// and run "./music_bench <benchmark> [songs]", e.g. "./music_bench pool".
+//
+// "./music_bench generate [songs] [options]" writes a synthetic playlist.csv
+// to the working directory, and "./music_bench suite [songs] [options]"
+// times every call of the Song ** API on one, printing a JSON line per call
+// with ns/op, allocations per op and the peak RSS, e.g.
+//     ./music_bench suite 1000000 artists=20000 zipf=1.1 label=abc123
+//         >> results.jsonl
+// Options: artists=N (default songs / 1000), zipf=S (artist popularity,
+// default 0 for uniform), genres=W,W,W,W,W (relative weights in enum order),
+// seed=N and label=TEXT.
+
+// global definitions
+#define BENCH_DEFAULT_SONGS 1000000
+#define BENCH_REPEATS 5
+// seconds each call of the suite is repeated for
+#define BENCH_BUDGET 0.25
+// at most this many songs are added by the suite
+#define BENCH_MAX_OPS 1000000
+
+// allocation counting: the benchmark replaces malloc and friends with
+// wrappers that count calls and bytes before handing them to glibc. The
+// sanitizers bring their own allocator, so under them counts read -1.
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && \
+    !defined(__SANITIZE_THREAD__)
+#define BENCH_COUNT_ALLOCS 1
+#else
+#define BENCH_COUNT_ALLOCS 0
+#endif
+
+// calls to malloc, calloc and realloc, and the bytes they asked for
+static uint64_t benchAllocs;
+static uint64_t benchAllocBytes;
+
+#if BENCH_COUNT_ALLOCS
+// glibc's own entry points, which the wrappers forward to
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+
+/**
+ * Function: benchCountAlloc (helper)
+ * Input argument: size - the number of bytes requested
+ * Output argument: the counters include one more allocation
+ * Return: none
+ * Dependencies: none
+ *
+ * The CSV loader allocates from several threads, so the counters are
+ * updated atomically.
+ */
+static inline void benchCountAlloc(size_t size)
+{
+    __atomic_fetch_add(&benchAllocs, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&benchAllocBytes, size, __ATOMIC_RELAXED);
+}
+
+// counting replacements for the C allocator
+void *malloc(size_t size)
+{
+    benchCountAlloc(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    benchCountAlloc(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    benchCountAlloc(size);
+    return __libc_realloc(pointer, size);
+}
+#endif
+
+/**
+ * Function: benchNow
+ * Input argument: none
+ * Output argument: none
+ * Return: a monotonic timestamp in seconds
+ * Dependencies: time.h
+ */
+static double benchNow(void)
+{
+    // read the monotonic clock
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    // convert it to seconds
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/**
+ * Function: benchMute
+ * Input argument: none
+ * Output argument: stdout is redirected to /dev/null
+ * Return: a duplicate of the original stdout for benchUnmute
+ * Dependencies: unistd.h, fcntl.h, stdio.h
+ */
+static int benchMute(void)
+{
+    // flush anything already printed
+    fflush(stdout);
+    // keep the real stdout
+    int saved = dup(STDOUT_FILENO);
+    // point stdout at /dev/null
+    int null = open("/dev/null", O_WRONLY);
+    dup2(null, STDOUT_FILENO);
+    close(null);
+    // return the real stdout
+    return saved;
+}
+
+/**
+ * Function: benchUnmute
+ * Input argument: saved - the descriptor returned by benchMute
+ * Output argument: stdout is restored
+ * Return: none
+ * Dependencies: unistd.h, stdio.h
+ */
+static void benchUnmute(int saved)
+{
+    // drop whatever was buffered for /dev/null
+    fflush(stdout);
+    // put the real stdout back
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+}
+
+/**
+ * Function: benchRandomWord
+ * Input argument: buffer - where to write the word
+ *                 size - the size of the buffer
+ *                 seed - a pointer to the generator state
+ * Output argument: buffer holds a capitalized word of random syllables
+ * Return: none
+ * Dependencies: none
+ */
+static void benchRandomWord(char *buffer, size_t size, unsigned *seed)
+{
+    // syllables the words are made of
+    static const char *syllables[] = {
+        "la", "mor", "en", "ti", "sun", "ka", "ri", "do", "bel", "shi",
+        "on", "va", "ne", "qu", "ar", "lo", "mi", "zen", "te", "ra"
+    };
+    // create variable to track the length written so far
+    size_t length = 0;
+    // pick two to four syllables
+    int count = 2 + (int)(rand_r(seed) % 3);
+    for (int i = 0; i < count; i++)
+    {
+        // append a random syllable while it fits
+        const char *syllable = syllables[rand_r(seed) % 20];
+        size_t n = strlen(syllable);
+        if (length + n + 1 >= size)
+        {
+            break;
+        }
+        memcpy(buffer + length, syllable, n);
+        length += n;
+    }
+    // terminate the word and capitalize it
+    buffer[length] = '\0';
+    buffer[0] = (char)toupper((unsigned char)buffer[0]);
+}
+
+/**
+ * Function: benchRandomPlaylist
+ * Input argument: playlist - a pointer to an empty playlist handle
+ *                 count - the number of songs to add
+ *                 artists - the number of distinct artists
+ *                 seed - the seed for the song contents
+ * Output argument: playlist holds count songs in random order
+ * Return: true on success, false if memory ran out
+ * Dependencies: benchRandomWord, playlistAddSong, stdio.h
+ */
+static bool benchRandomPlaylist(
+    Playlist *playlist, size_t count, size_t artists, unsigned seed)
+{
+    // buffers for the generated strings
+    char title[STR_LEN];
+    char artist[STR_LEN];
+    char word[16];
+    // add each song
+    for (size_t i = 0; i < count; i++)
+    {
+        // titles are two random words
+        benchRandomWord(title, sizeof(title) / 2, &seed);
+        benchRandomWord(word, sizeof(word), &seed);
+        strcat(title, " ");
+        strcat(title, word);
+        // artists are random words picked from a fixed set
+        unsigned artistSeed = (unsigned)(rand_r(&seed) % artists) + 1;
+        benchRandomWord(artist, sizeof(artist) / 2, &artistSeed);
+        snprintf(word, sizeof(word), " %u", artistSeed % 100);
+        strcat(artist, word);
+        // append the song
+        if (!playlistAddSong(playlist, title, artist,
+            (Genre)(rand_r(&seed) % GENRE_COUNT)))
+        {
+            return false;
+        }
+    }
+    // return success
+    return true;
+}
+
+/**
+ * Function: benchFillSong
+ * Input argument: song - a pointer to the song to fill in
+ *                 i - the number of the song being generated
+ * Output argument: song holds a synthetic title, artist and genre
+ * Return: none
+ * Dependencies: stdio.h
+ */
+static void benchFillSong(Song *song, size_t i)
+{
+    // every song gets a unique title, always short enough to be inline
+    snprintf(song->title.text, sizeof(song->title.text), "Track %u",
+        (unsigned)i);
+    song->titleLength = (uint32_t)strlen(song->title.text);
+    // spread the songs over a few thousand artist numbers; the allocator
+    // benchmark never looks their names up, so they are not interned
+    song->artist = (uint32_t)(i % 4096);
+    // and over every genre
+    song->genre = (Genre)(i % GENRE_COUNT);
+}
+
+/**
+ * Function: benchTraverse
+ * Input argument: head - a pointer to a linear list of songs
+ * Output argument: none
+ * Return: a checksum over the fields a play loop would read
+ * Dependencies: none
+ */
+static size_t benchTraverse(const Song *head)
+{
+    // create variable to accumulate the checksum
+    size_t sum = 0;
+    // loop through the list the way play does
+    for (const Song *current = head; current != NULL; current = current->next)
+    {
+        // touch the fields a play loop prints
+        sum += (size_t)current->genre + (unsigned char)songTitle(current)[6] +
+            (size_t)current->artist;
+    }
+    // return the checksum so the loop is not optimized away
+    return sum;
+}
+
+/**
+ * Function: benchBestTraversal
+ * Input argument: head - a pointer to a linear list of songs
+ *                 sum - a pointer to the checksum output
+ * Output argument: sum holds the checksum of the last traversal
+ * Return: the fastest of BENCH_REPEATS traversals in seconds
+ * Dependencies: benchNow, benchTraverse
+ */
+static double benchBestTraversal(const Song *head, size_t *sum)
+{
+    // start with an impossible time
+    double best = 1e30;
+    // repeat the traversal to hide warm-up noise
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        // time one traversal
+        double start = benchNow();
+        *sum = benchTraverse(head);
+        double elapsed = benchNow() - start;
+        // keep the fastest one
+        if (elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+    // return the fastest traversal
+    return best;
+}
+
+/**
+ * Function: benchChurn
+ * Input argument: songs - an array with every song of a list, in list order
+ *                 count - the number of songs in the array
+ *                 pool - the pool to use, or NULL for plain malloc
+ * Output argument: half of the songs are released and reallocated, and the
+ *                  array is relinked in order, as after a long editing session
+ * Return: none
+ * Dependencies: songPoolFree, songPoolAlloc, stdlib.h
+ */
+static void benchChurn(Song **songs, size_t count, SongPool *pool)
+{
+    // the same pseudo-random choices for both allocators
+    srand(1);
+    // release a random half of the songs
+    for (size_t i = 0; i < count; i++)
+    {
+        // skip the songs that stay
+        if (rand() & 1)
+        {
+            continue;
+        }
+        // release the song
+        if (pool != NULL)
+        {
+            songPoolFree(pool, songs[i]);
+        }
+        else
+        {
+            free(songs[i]);
+        }
+        // and mark its slot empty
+        songs[i] = NULL;
+    }
+    // reallocate the released songs, which reuses whatever the allocator freed
+    for (size_t i = 0; i < count; i++)
+    {
+        // skip the songs that stayed
+        if (songs[i] != NULL)
+        {
+            continue;
+        }
+        // allocate a replacement
+        songs[i] = pool != NULL ? songPoolAlloc(pool) :
+            (Song*)malloc(sizeof(Song));
+        // fill it in again
+        benchFillSong(songs[i], i);
+    }
+    // relink the list in array order
+    for (size_t i = 0; i < count; i++)
+    {
+        songs[i]->next = i + 1 < count ? songs[i + 1] : NULL;
+    }
+}
+
+/**
+ * Function: benchPool
+ * Input argument: count - the number of songs to build
+ * Output argument: timings are printed to stdout
+ * Return: 0 on success, 1 if memory ran out
+ * Dependencies: songPoolAlloc, songPoolDestroy, benchChurn,
+ *               benchBestTraversal, stdlib.h, stdio.h
+ *
+ * Compares traversal and teardown of songs from plain malloc against songs
+ * from a SongPool, both straight after loading and after churn.
+ */
+static int benchPool(size_t count)
+{
+    // array that keeps every song in list order during churn
+    Song **songs = (Song**)malloc(count * sizeof(Song*));
+    // give up if the allocation failed
+    if (songs == NULL)
+    {
+        return 1;
+    }
+    // print the header
+    printf("%-10s %-8s %12s %12s\n", "allocator", "heap", "traverse_ms",
+        "teardown_ms");
+    // run each combination of allocator and heap state
+    for (int churned = 0; churned <= 1; churned++)
+    {
+        for (int pooled = 0; pooled <= 1; pooled++)
+        {
+            // create the pool for the pooled runs
+            SongPool pool;
+            songPoolInit(&pool);
+            // allocate and fill every song
+            for (size_t i = 0; i < count; i++)
+            {
+                songs[i] = pooled ? songPoolAlloc(&pool) :
+                    (Song*)malloc(sizeof(Song));
+                benchFillSong(songs[i], i);
+            }
+            // link the songs in order
+            for (size_t i = 0; i < count; i++)
+            {
+                songs[i]->next = i + 1 < count ? songs[i + 1] : NULL;
+            }
+            // age the heap if asked to
+            if (churned)
+            {
+                benchChurn(songs, count, pooled ? &pool : NULL);
+            }
+            // time the traversal
+            size_t sum = 0;
+            double traverse = benchBestTraversal(songs[0], &sum);
+            // time the teardown
+            double start = benchNow();
+            // a pool frees its slabs at once
+            if (pooled)
+            {
+                songPoolDestroy(&pool);
+            }
+            // plain malloc frees every song by walking the list
+            else
+            {
+                Song *current = songs[0];
+                while (current != NULL)
+                {
+                    Song *next = current->next;
+                    free(current);
+                    current = next;
+                }
+            }
+            double teardown = benchNow() - start;
+            // print one row of results
+            printf("%-10s %-8s %12.3f %12.3f   (checksum %zu)\n",
+                pooled ? "pool" : "malloc", churned ? "churned" : "fresh",
+                traverse * 1e3, teardown * 1e3, sum);
+        }
+    }
+    // free the bookkeeping array
+    free(songs);
+    // return success
+    return 0;
+}
+
+/**
+ * Function: benchCompareArtistPlain
+ * Input argument: a, b - pointers to the songs to compare
+ * Output argument: none
+ * Return: the strcmp order of the artists
+ * Dependencies: songArtist, string.h
+ *
+ * Same order as songCompareByArtist, but not recognised by sortPlaylist, so
+ * it measures the comparator-only path.
+ */
+static int benchCompareArtistPlain(const Song *a, const Song *b)
+{
+    // artists order like strcmp
+    return strcmp(songArtist(a), songArtist(b));
+}
+
+/**
+ * Function: benchSort
+ * Input argument: count - the largest playlist size to sort
+ * Output argument: timings are printed to stdout
+ * Return: 0 on success, 1 if a sort is wrong or memory ran out
+ * Dependencies: benchRandomPlaylist, playlistSortByGenre, sortPlaylist,
+ *               benchMute, benchUnmute, stdio.h
+ *
+ * Sorts random playlists of 10k, 100k and 1M songs (capped at count) with
+ * the genre bucket sort and with the merge sort for each built-in order.
+ */
+static int benchSort(size_t count)
+{
+    // the sorts to compare
+    static const struct
+    {
+        const char *name;
+        SongComparator compare;
+    }
+    sorts[] = {
+        { "sortByGenre", NULL },
+        { "genre", songCompareByGenre },
+        { "artist", songCompareByArtist },
+        { "artist(plain)", benchCompareArtistPlain },
+        { "title", songCompareByTitle },
+        { "genre+artist+title", songCompareByGenreArtistTitle }
+    };
+    // print the header
+    printf("%-20s %10s %12s\n", "sort", "songs", "ms");
+    // run each size up to the requested one
+    for (size_t size = 10000; size <= count; size *= 10)
+    {
+        // run each sort on a fresh copy of the same random playlist
+        for (size_t s = 0; s < sizeof(sorts) / sizeof(sorts[0]); s++)
+        {
+            // build the playlist
+            Playlist playlist;
+            playlistInit(&playlist);
+            if (!benchRandomPlaylist(&playlist, size, 5000, 42))
+            {
+                return 1;
+            }
+            // time the sort with its message muted
+            int saved = benchMute();
+            double start = benchNow();
+            if (sorts[s].compare == NULL)
+            {
+                playlistSortByGenre(&playlist);
+            }
+            else
+            {
+                sortPlaylist(&playlist, sorts[s].compare);
+            }
+            double elapsed = benchNow() - start;
+            benchUnmute(saved);
+            // check the order, using the genre comparator for the bucket sort
+            SongComparator check = sorts[s].compare != NULL ?
+                sorts[s].compare : songCompareByGenre;
+            for (Song *song = playlist.head; song->next != NULL;
+                song = song->next)
+            {
+                if (check(song, song->next) > 0)
+                {
+                    printf("%s left the playlist unsorted\n", sorts[s].name);
+                    return 1;
+                }
+            }
+            // print one row of results
+            printf("%-20s %10zu %12.3f\n", sorts[s].name, size,
+                elapsed * 1e3);
+            // free the playlist
+            playlistFree(&playlist);
+        }
+    }
+    // return success
+    return 0;
+}
+
+/**
+ * Function: benchWriteCsv
+ * Input argument: path - a template for mkstemp, rewritten with the name
+ *                 count - the number of songs to write
+ * Output argument: a playlist CSV with a header and count random rows
+ * Return: the size of the file in bytes, or 0 on failure
+ * Dependencies: benchRandomPlaylist, stdio.h, unistd.h
+ */
+static size_t benchWriteCsv(char *path, size_t count)
+{
+    // generate the songs
+    Playlist playlist;
+    playlistInit(&playlist);
+    if (!benchRandomPlaylist(&playlist, count, 5000, 42))
+    {
+        playlistFree(&playlist);
+        return 0;
+    }
+    // create the file
+    int fd = mkstemp(path);
+    FILE *file = fd >= 0 ? fdopen(fd, "w") : NULL;
+    if (file == NULL)
+    {
+        playlistFree(&playlist);
+        return 0;
+    }
+    // write the header and one row per song
+    fprintf(file, "title,artist,genre\n");
+    Song *song = playlist.head;
+    for (size_t i = 0; i < playlist.length; i++)
+    {
+        fprintf(file, "%s,%s,%d\n", songTitle(song), songArtist(song),
+            (int)song->genre);
+        song = song->next;
+    }
+    // the position after the last row is the file size
+    size_t size = (size_t)ftell(file);
+    fclose(file);
+    playlistFree(&playlist);
+    // return the size
+    return size;
+}
+
+/**
+ * Function: benchSamePlaylist
+ * Input argument: a, b - pointers to the playlists to compare
+ * Output argument: none
+ * Return: true if both hold the same songs in the same order
+ * Dependencies: string.h
+ */
+static bool benchSamePlaylist(const Playlist *a, const Playlist *b)
+{
+    // the lengths must match
+    if (a->length != b->length)
+    {
+        return false;
+    }
+    // and so must every song
+    const Song *x = a->head;
+    const Song *y = b->head;
+    for (size_t i = 0; i < a->length; i++)
+    {
+        if (x->titleLength != y->titleLength ||
+            strcmp(songTitle(x), songTitle(y)) != 0 ||
+            x->artist != y->artist || x->genre != y->genre)
+        {
+            return false;
+        }
+        x = x->next;
+        y = y->next;
+    }
+    // return the result
+    return true;
+}
+
+/**
+ * Function: benchLoad
+ * Input argument: count - the number of songs in the generated CSV
+ * Output argument: timings are printed to stdout
+ * Return: 0 on success, 1 if the file could not be written or a load was
+ *         wrong
+ * Dependencies: benchWriteCsv, benchSamePlaylist, playlistLoadThreads,
+ *               unistd.h, stdio.h
+ *
+ * Compares loading with 1 to 16 threads against plainly reading the same
+ * file, so the parser's cost shows up as the gap to the page cache's
+ * bandwidth. Every threaded load is checked against the serial one.
+ */
+static int benchLoad(size_t count)
+{
+    // write the library once
+    char path[] = "/tmp/music_bench_XXXXXX";
+    size_t size = benchWriteCsv(path, count);
+    if (size == 0)
+    {
+        printf("Could not write the benchmark CSV.\n");
+        return 1;
+    }
+    double megabytes = (double)size / (1 << 20);
+    // time reading the file into a buffer, the best of several runs
+    double best = 1e9;
+    char *buffer = malloc(1 << 20);
+    for (int r = 0; r < BENCH_REPEATS && buffer != NULL; r++)
+    {
+        double start = benchNow();
+        int fd = open(path, O_RDONLY);
+        while (fd >= 0 && read(fd, buffer, 1 << 20) > 0)
+        {
+        }
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        double elapsed = benchNow() - start;
+        best = elapsed < best ? elapsed : best;
+    }
+    free(buffer);
+    // print the header and the bandwidth to beat
+    printf("%-12s %8s %10s %10s %12s %10s\n", "load", "threads", "songs",
+        "MB", "ms", "MB/s");
+    printf("%-12s %8d %10zu %10.1f %12.3f %10.1f\n", "read", 1, count,
+        megabytes, best * 1e3, megabytes / best);
+    // the serial load is the reference for the threaded ones
+    Playlist serial;
+    playlistInit(&serial);
+    if (!playlistLoadThreads(&serial, path, 1) || serial.length != count)
+    {
+        printf("Loaded %zu of %zu songs.\n", serial.length, count);
+        playlistFree(&serial);
+        unlink(path);
+        return 1;
+    }
+    // time each thread count
+    int status = 0;
+    for (int threads = 1; threads <= 16 && status == 0; threads *= 2)
+    {
+        best = 1e9;
+        for (int r = 0; r < BENCH_REPEATS && status == 0; r++)
+        {
+            Playlist playlist;
+            playlistInit(&playlist);
+            double start = benchNow();
+            playlistLoadThreads(&playlist, path, threads);
+            double elapsed = benchNow() - start;
+            best = elapsed < best ? elapsed : best;
+            // every split must give the serial result
+            if (!benchSamePlaylist(&serial, &playlist))
+            {
+                printf("%d threads loaded a different playlist\n", threads);
+                status = 1;
+            }
+            playlistFree(&playlist);
+        }
+        printf("%-12s %8d %10zu %10.1f %12.3f %10.1f\n", "playlistLoad",
+            threads, count, megabytes, best * 1e3, megabytes / best);
+    }
+    // clean up
+    playlistFree(&serial);
+    unlink(path);
+    // return the result
+    return status;
+}
+
+/**
+ * Function: benchSnapshot
+ * Input argument: count - the number of songs in the generated CSV
+ * Output argument: timings are printed to stdout
+ * Return: 0 on success, 1 if a file could not be written or a load was wrong
+ * Dependencies: benchWriteCsv, benchSamePlaylist, playlistLoad,
+ *               playlistSaveSnapshot, playlistLoadSnapshot,
+ *               playlistRebuildIndexes, stdio.h
+ *
+ * Compares a cold start from the CSV with one from a snapshot of it, and
+ * times the index rebuild both of them end with on its own.
+ */
+static int benchSnapshot(size_t count)
+{
+    // write the library and its snapshot
+    char path[] = "/tmp/music_bench_XXXXXX";
+    char snapshot[sizeof(path) + 5];
+    if (benchWriteCsv(path, count) == 0)
+    {
+        printf("Could not write the benchmark CSV.\n");
+        return 1;
+    }
+    snprintf(snapshot, sizeof(snapshot), "%s.snap", path);
+    Playlist csv;
+    playlistInit(&csv);
+    playlistLoad(&csv, path);
+    double start = benchNow();
+    bool saved = playlistSaveSnapshot(&csv, snapshot, path, 0);
+    double saving = benchNow() - start;
+    // time both loads, the best of several runs
+    double csvBest = 1e9;
+    double snapshotBest = 1e9;
+    double indexBest = 1e9;
+    int status = saved ? 0 : 1;
+    for (int r = 0; r < BENCH_REPEATS && status == 0; r++)
+    {
+        Playlist playlist;
+        playlistInit(&playlist);
+        start = benchNow();
+        playlistLoad(&playlist, path);
+        double elapsed = benchNow() - start;
+        csvBest = elapsed < csvBest ? elapsed : csvBest;
+        playlistFree(&playlist);
+        start = benchNow();
+        bool loaded = playlistLoadSnapshot(&playlist, snapshot, path,
+            NULL);
+        elapsed = benchNow() - start;
+        snapshotBest = elapsed < snapshotBest ? elapsed : snapshotBest;
+        // the snapshot must give back the same playlist
+        if (!loaded || !benchSamePlaylist(&csv, &playlist))
+        {
+            printf("The snapshot loaded a different playlist\n");
+            status = 1;
+        }
+        // and the part of either load spent indexing the songs
+        start = benchNow();
+        playlistRebuildIndexes(&playlist);
+        elapsed = benchNow() - start;
+        indexBest = elapsed < indexBest ? elapsed : indexBest;
+        playlistFree(&playlist);
+    }
+    // print the results
+    if (status == 0)
+    {
+        printf("%-20s %10s %12s\n", "start", "songs", "ms");
+        printf("%-20s %10zu %12.3f\n", "save snapshot", count, saving * 1e3);
+        printf("%-20s %10zu %12.3f\n", "load CSV", count, csvBest * 1e3);
+        printf("%-20s %10zu %12.3f\n", "load snapshot", count,
+            snapshotBest * 1e3);
+        printf("%-20s %10zu %12.3f\n", "  of which indexing", count,
+            indexBest * 1e3);
+    }
+    // clean up
+    playlistFree(&csv);
+    unlink(snapshot);
+    unlink(path);
+    return status;
+}
+
+/**
+ * Function: benchMin
+ * Input argument: a, b - two timings
+ * Output argument: none
+ * Return: the smaller one
+ * Dependencies: none
+ */
+static inline double benchMin(double a, double b)
+{
+    return a < b ? a : b;
+}
+
+/**
+ * Function: benchCountGenre
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 genre - the genre to count
+ * Output argument: none
+ * Return: the number of songs of the genre, found by walking the list
+ * Dependencies: none
+ */
+static size_t benchCountGenre(const Playlist *playlist, Genre genre)
+{
+    // walk every song
+    size_t count = 0;
+    const Song *current = playlist->head;
+    for (size_t i = 0; i < playlist->length; i++)
+    {
+        count += current->genre == genre;
+        current = current->next;
+    }
+    // return the count
+    return count;
+}
+
+/**
+ * Function: benchCountArtist
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 artist - the artist to count
+ * Output argument: none
+ * Return: the number of songs by the artist, found by walking the list
+ * Dependencies: artistPoolFind
+ */
+static size_t benchCountArtist(const Playlist *playlist, const char *artist)
+{
+    // look the name up once, then compare numbers
+    uint32_t id = artistPoolFind(artist);
+    // walk every song
+    size_t count = 0;
+    const Song *current = playlist->head;
+    for (size_t i = 0; i < playlist->length; i++)
+    {
+        count += current->artist == id;
+        current = current->next;
+    }
+    // return the count
+    return count;
+}
+
+/**
+ * Function: benchColumnar
+ * Input argument: count - the number of songs to build
+ * Output argument: timings are printed to stdout
+ * Return: 0 on success, 1 if memory ran out or the backends disagree
+ * Dependencies: benchRandomPlaylist, columnarFromPlaylist, the columnar and
+ *               playlist operations, benchMute, benchUnmute, stdio.h
+ *
+ * Runs the same filters, sort and reverse on a Song list and on a columnar
+ * copy of it, best of BENCH_REPEATS each, and compares their footprints.
+ */
+static int benchColumnar(size_t count)
+{
+    // build the list and its columnar copy; neither keeps a title index,
+    // so both sides do the same work
+    Playlist playlist;
+    playlistInit(&playlist);
+    playlist.indexed = false;
+    ColumnarPlaylist columns;
+    columnarInit(&columns);
+    if (!benchRandomPlaylist(&playlist, count, 5000, 42) ||
+        !columnarFromPlaylist(&columns, &playlist))
+    {
+        playlistFree(&playlist);
+        columnarFree(&columns);
+        return 1;
+    }
+    // pick an artist that has songs
+    char artist[STR_LEN];
+    strcpy(artist, songArtist(playlist.head));
+    // best times for list and columns, per operation
+    enum { GENRE, ARTIST, SORT, REVERSE, OPERATIONS };
+    static const char *names[OPERATIONS] = {
+        "count genre", "count artist", "sortByGenre", "reverse"
+    };
+    double list[OPERATIONS];
+    double column[OPERATIONS];
+    for (int o = 0; o < OPERATIONS; o++)
+    {
+        list[o] = column[o] = 1e9;
+    }
+    int status = 0;
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        // the filters must agree
+        double start = benchNow();
+        size_t listGenre = benchCountGenre(&playlist, ROCK);
+        double middle = benchNow();
+        size_t columnGenre = columnarCountByGenre(&columns, ROCK);
+        double end = benchNow();
+        list[GENRE] = benchMin(list[GENRE], middle - start);
+        column[GENRE] = benchMin(column[GENRE], end - middle);
+        start = benchNow();
+        size_t listArtist = benchCountArtist(&playlist, artist);
+        middle = benchNow();
+        size_t columnArtist = columnarCountByArtist(&columns, artist);
+        end = benchNow();
+        list[ARTIST] = benchMin(list[ARTIST], middle - start);
+        column[ARTIST] = benchMin(column[ARTIST], end - middle);
+        if (listGenre != columnGenre || listArtist != columnArtist)
+        {
+            printf("The columnar filters disagree with the list\n");
+            status = 1;
+            break;
+        }
+        // reverse first, so every sort has work to do
+        start = benchNow();
+        playlistReverse(&playlist);
+        middle = benchNow();
+        columnarReverse(&columns);
+        end = benchNow();
+        list[REVERSE] = benchMin(list[REVERSE], middle - start);
+        column[REVERSE] = benchMin(column[REVERSE], end - middle);
+        int saved = benchMute();
+        start = benchNow();
+        playlistSortByGenre(&playlist);
+        middle = benchNow();
+        columnarSortByGenre(&columns);
+        end = benchNow();
+        benchUnmute(saved);
+        list[SORT] = benchMin(list[SORT], middle - start);
+        column[SORT] = benchMin(column[SORT], end - middle);
+    }
+    // both backends must end up in the same order
+    const Song *song = playlist.head;
+    for (uint32_t i = columns.head; status == 0 && i != COLUMNAR_NONE;
+        i = columns.next[i])
+    {
+        if (strcmp(songTitle(song), columnarTitle(&columns, i)) != 0)
+        {
+            printf("The columnar order disagrees with the list\n");
+            status = 1;
+        }
+        song = song->next;
+    }
+    // print the results
+    if (status == 0)
+    {
+        printf("%-14s %10s %12s %12s\n", "operation", "songs", "list ms",
+            "columnar ms");
+        for (int o = 0; o < OPERATIONS; o++)
+        {
+            printf("%-14s %10zu %12.3f %12.3f\n", names[o], count,
+                list[o] * 1e3, column[o] * 1e3);
+        }
+        // bytes per song, counting the columns and the string buffers
+        double columnBytes = (double)(columns.capacity * (1 + 3 *
+            sizeof(uint32_t)) + columns.titleText.capacity +
+            columns.artistNames.names.capacity) / (double)count;
+        printf("%-14s %10zu %12zu %12.1f\n", "bytes per song", count,
+            sizeof(Song), columnBytes);
+    }
+    // free both
+    playlistFree(&playlist);
+    columnarFree(&columns);
+    return status;
+}
+
+/**
+ * Function: benchRealisticTitle
+ * Input argument: buffer - where to write the title
+ *                 size - the size of buffer, at least 256 bytes
+ *                 seed - a pointer to the rand_r state
+ * Output argument: buffer holds a random title
+ * Return: the length of the title
+ * Dependencies: benchRandomWord, stdio.h
+ *
+ * Follows the shape of real catalogues: most titles are one to three words,
+ * a tail runs to ten, and about one in eight carries a featuring credit, a
+ * remaster note or a live venue.
+ */
+static size_t benchRealisticTitle(char *buffer, size_t size, unsigned *seed)
+{
+    // how many words, drawn from a table weighted towards short titles
+    static const int words[] = {
+        1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 5, 6, 8, 10
+    };
+    int count = words[rand_r(seed) % (sizeof(words) / sizeof(words[0]))];
+    // write words of up to six letters separated by spaces
+    char word[16];
+    char other[16];
+    int length = 0;
+    for (int i = 0; i < count; i++)
+    {
+        benchRandomWord(word, 7, seed);
+        length += snprintf(buffer + length, size - (size_t)length, "%s%s",
+            i > 0 ? " " : "", word);
+    }
+    // then maybe a decoration
+    unsigned roll = (unsigned)rand_r(seed) % 100;
+    benchRandomWord(word, sizeof(word), seed);
+    benchRandomWord(other, sizeof(other), seed);
+    if (roll < 6)
+    {
+        length += snprintf(buffer + length, size - (size_t)length,
+            " (feat. %s %s)", word, other);
+    }
+    else if (roll < 10)
+    {
+        length += snprintf(buffer + length, size - (size_t)length,
+            " - Remastered %u", 1990 + (unsigned)rand_r(seed) % 35);
+    }
+    else if (roll < 12)
+    {
+        length += snprintf(buffer + length, size - (size_t)length,
+            " (Live at the %s %s)", word, other);
+    }
+    // return the length
+    return (size_t)length;
+}
+
+// the song layout before titles moved out of line, to measure it against:
+// today's Song with its title union and length swapped for a fixed array,
+// so both rows grow alike as links are added to Song
+typedef struct BenchFixedSong
+{
+    char title[STR_LEN];
+    uint32_t artist;
+    Genre genre;
+    struct Song *next;
+    struct Song *prev;
+    struct Song *artistNext;
+    struct Song *artistPrev;
+    struct Song *genreNext;
+    struct Song *genrePrev;
+    struct Song *orderLeft;
+    struct Song *orderRight;
+    struct Song *orderParent;
+    uint32_t orderSize;
+    uint32_t orderPriority;
+    uint64_t sortKey;
+}
+BenchFixedSong;
+
+// fails to build once Song gains a field this copy lacks
+_Static_assert(sizeof(BenchFixedSong) - offsetof(BenchFixedSong, artist) ==
+    sizeof(Song) - offsetof(Song, artist),
+    "BenchFixedSong must match Song after the title");
+
+/**
+ * Function: benchTitles
+ * Input argument: count - the number of songs to build
+ * Output argument: the title length distribution and the bytes per song are
+ *                  printed to stdout
+ * Return: 0 on success, 1 if memory ran out
+ * Dependencies: benchRealisticTitle, playlistAppendSong, songPoolBytes,
+ *               stdio.h
+ *
+ * Compares the fixed STR_LEN title field with inline titles that spill long
+ * ones into the pool's text blocks, counting slabs and blocks as allocated.
+ */
+static int benchTitles(size_t count)
+{
+    // count the titles of each length; longer ones share the last bucket
+    enum { LENGTHS = 256 };
+    size_t histogram[LENGTHS] = { 0 };
+    // build an unindexed playlist, so only song storage is measured
+    Playlist playlist;
+    playlistInit(&playlist);
+    playlist.indexed = false;
+    unsigned seed = 42;
+    char title[LENGTHS];
+    char artist[STR_LEN];
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t length = benchRealisticTitle(title, sizeof(title), &seed);
+        snprintf(artist, sizeof(artist), "Artist %zu", i % 4096);
+        if (!playlistAppendSong(&playlist, title, length, artist,
+            strlen(artist), (Genre)(i % GENRE_COUNT)))
+        {
+            playlistFree(&playlist);
+            return 1;
+        }
+        histogram[length < LENGTHS ? length : LENGTHS - 1]++;
+        total += length;
+    }
+    // read the percentiles off the histogram
+    size_t seen = 0;
+    size_t median = 0;
+    size_t p90 = 0;
+    size_t p99 = 0;
+    size_t longest = 0;
+    size_t inlined = 0;
+    size_t tooLong = 0;
+    for (size_t length = 0; length < LENGTHS; length++)
+    {
+        if (histogram[length] == 0)
+        {
+            continue;
+        }
+        seen += histogram[length];
+        median = median == 0 && seen * 2 >= count ? length : median;
+        p90 = p90 == 0 && seen * 10 >= count * 9 ? length : p90;
+        p99 = p99 == 0 && seen * 100 >= count * 99 ? length : p99;
+        longest = length;
+        inlined += length < SONG_INLINE_TITLE ? histogram[length] : 0;
+        tooLong += length >= STR_LEN ? histogram[length] : 0;
+    }
+    // print the distribution
+    printf("%-14s %8s %6s %6s %6s %6s %8s %10s\n", "title length", "mean",
+        "p50", "p90", "p99", "max", "inline%", "over cap%");
+    printf("%-14s %8.1f %6zu %6zu %6zu %6zu %8.1f %10.1f\n", "", (double)total /
+        (double)count, median, p90, p99, longest,
+        100.0 * (double)inlined / (double)count,
+        100.0 * (double)tooLong / (double)count);
+    // and the bytes per song of both layouts
+    printf("%-22s %14s\n", "layout", "bytes per song");
+    printf("%-22s %14zu   (titles over %d bytes rejected)\n",
+        "fixed title[STR_LEN]", sizeof(BenchFixedSong), STR_LEN - 1);
+    printf("%-22s %14.1f   (node %zu bytes, long titles in text blocks)\n",
+        "inline + text blocks", (double)songPoolBytes(&playlist.pool) /
+        (double)count, sizeof(Song));
+    // free the playlist
+    playlistFree(&playlist);
+    return 0;
+}
+
+/**
+ * Function: benchPrintfShuffle
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 file - the stream to print to
+ *                 genres - an array with the names of the genres
+ *                 seed - the shuffle seed
+ * Output argument: the songs are printed in shuffled order
+ * Return: true on success, false if memory ran out
+ * Dependencies: rngSeed, rngBelow, stdio.h
+ *
+ * The shuffle as it was played before output sinks: the same order as
+ * playlistPlayShuffle, one fprintf per song.
+ */
+static bool benchPrintfShuffle(const Playlist *playlist, FILE *file,
+    char *genres[], uint64_t seed)
+{
+    // copy the songs in playlist order
+    Song **songs = (Song**)malloc(playlist->length * sizeof(Song*));
+    if (songs == NULL)
+    {
+        return false;
+    }
+    Song *current = playlist->head;
+    for (size_t i = 0; i < playlist->length; i++)
+    {
+        songs[i] = current;
+        current = current->next;
+    }
+    // shuffle them the way playlistPlayShuffle does
+    Rng rng;
+    rngSeed(&rng, seed);
+    for (size_t i = playlist->length - 1; i > 0; i--)
+    {
+        size_t j = (size_t)rngBelow(&rng, i + 1);
+        Song *swap = songs[i];
+        songs[i] = songs[j];
+        songs[j] = swap;
+    }
+    // and print each with the format string
+    for (size_t i = 0; i < playlist->length; i++)
+    {
+        fprintf(file, "Playing '%s' by '%s' (Genre: %s) ...\n",
+            songTitle(songs[i]), songArtist(songs[i]), genres[songs[i]->genre]);
+    }
+    fflush(file);
+    free(songs);
+    return true;
+}
+
+/**
+ * Function: benchSameFiles
+ * Input argument: a, b - two streams open for reading and writing
+ * Output argument: both are rewound and read to the end
+ * Return: true if both hold the same bytes, false otherwise
+ * Dependencies: stdio.h, string.h
+ */
+static bool benchSameFiles(FILE *a, FILE *b)
+{
+    // start both from the beginning
+    rewind(a);
+    rewind(b);
+    // compare them a block at a time
+    char left[4096];
+    char right[4096];
+    for (;;)
+    {
+        size_t n = fread(left, 1, sizeof(left), a);
+        size_t m = fread(right, 1, sizeof(right), b);
+        if (n != m || memcmp(left, right, n) != 0)
+        {
+            return false;
+        }
+        if (n == 0)
+        {
+            return true;
+        }
+    }
+}
+
+/**
+ * Function: benchPlay
+ * Input argument: count - the number of songs to build
+ * Output argument: throughput is printed to stdout
+ * Return: 0 on success, 1 if memory ran out or the outputs disagree
+ * Dependencies: benchRandomPlaylist, benchPrintfShuffle, benchSameFiles,
+ *               playlistPlayShuffle, playlistPlayByArtist, the output sinks,
+ *               stdio.h
+ *
+ * Plays the whole playlist shuffled, and one artist's songs over and over,
+ * to /dev/null with printf and through each kind of sink, best of
+ * BENCH_REPEATS each, after checking that printf and the sink write the
+ * same bytes.
+ */
+static int benchPlay(size_t count)
+{
+    // build the playlist
+    char *genres[] = {"Pop", "Rock", "Jazz", "Classical", "Other"};
+    Playlist playlist;
+    playlistInit(&playlist);
+    if (!benchRandomPlaylist(&playlist, count, 5000, 42))
+    {
+        playlistFree(&playlist);
+        return 1;
+    }
+    // pick an artist that has songs
+    char artist[STR_LEN];
+    strcpy(artist, songArtist(playlist.head));
+    size_t artistSongs = playlistCountByArtist(&playlist, artist);
+    // the sink must write exactly what printf did
+    FILE *expected = tmpfile();
+    FILE *actual = tmpfile();
+    FILE *null = fopen("/dev/null", "w");
+    int nullFd = open("/dev/null", O_WRONLY);
+    bool same = false;
+    if (expected != NULL && actual != NULL && null != NULL && nullFd >= 0 &&
+        benchPrintfShuffle(&playlist, expected, genres, 7))
+    {
+        OutputSink sink;
+        outputInitFile(&sink, actual);
+        playlistPlayShuffle(&playlist, &sink, genres, 7);
+        same = outputFree(&sink) && benchSameFiles(expected, actual);
+    }
+    if (!same)
+    {
+        printf("The sink's output differs from printf's\n");
+    }
+    // best times for shuffle and by-artist play, per way of writing
+    enum { PRINTF, FILE_SINK, FD_SINK, NULL_SINK, WAYS };
+    static const char *names[WAYS] = {
+        "printf", "file sink", "fd sink", "null sink"
+    };
+    double shuffle[WAYS];
+    double byArtist[WAYS];
+    for (int w = 0; w < WAYS; w++)
+    {
+        shuffle[w] = byArtist[w] = 1e9;
+    }
+    // play the artist often enough to take about as long as the shuffle
+    size_t rounds = artistSongs > 0 ? count / artistSongs : 1;
+    for (int r = 0; same && r < BENCH_REPEATS; r++)
+    {
+        for (int w = 0; w < WAYS; w++)
+        {
+            OutputSink sink;
+            if (w == FILE_SINK)
+            {
+                outputInitFile(&sink, null);
+            }
+            else if (w == FD_SINK)
+            {
+                outputInitFd(&sink, nullFd);
+            }
+            else
+            {
+                outputInitNull(&sink);
+            }
+            double start = benchNow();
+            if (w == PRINTF)
+            {
+                benchPrintfShuffle(&playlist, null, genres, (uint64_t)r);
+            }
+            else
+            {
+                playlistPlayShuffle(&playlist, &sink, genres, (uint64_t)r);
+            }
+            double middle = benchNow();
+            for (size_t i = 0; i < rounds; i++)
+            {
+                if (w == PRINTF)
+                {
+                    // the old by-artist loop, walking the posting list
+                    const ArtistEntry *entry = artistIndexFind(
+                        &playlist.artists, artistPoolFind(artist));
+                    for (Song *song = entry->first; song != NULL;
+                        song = song->artistNext)
+                    {
+                        fprintf(null, "Playing '%s' by '%s' (Genre: %s) ...\n",
+                            songTitle(song), artist, genres[song->genre]);
+                    }
+                    fflush(null);
+                }
+                else
+                {
+                    playlistPlayByArtist(&playlist, artist, &sink, genres);
+                }
+            }
+            double end = benchNow();
+            outputFree(&sink);
+            shuffle[w] = benchMin(shuffle[w], middle - start);
+            byArtist[w] = benchMin(byArtist[w], end - middle);
+        }
+    }
+    // print the results
+    if (same)
+    {
+        printf("%-12s %16s %16s\n", "output", "shuffle tracks/s",
+            "artist tracks/s");
+        for (int w = 0; w < WAYS; w++)
+        {
+            printf("%-12s %16.0f %16.0f\n", names[w],
+                (double)count / shuffle[w],
+                (double)(rounds * artistSongs) / byArtist[w]);
+        }
+    }
+    // close the files and free the playlist
+    if (expected != NULL)
+    {
+        fclose(expected);
+    }
+    if (actual != NULL)
+    {
+        fclose(actual);
+    }
+    if (null != NULL)
+    {
+        fclose(null);
+    }
+    if (nullFd >= 0)
+    {
+        close(nullFd);
+    }
+    playlistFree(&playlist);
+    return same ? 0 : 1;
+}
+
+// how long each reader count of the shared benchmark runs, in seconds
+#define BENCH_SHARED_SECONDS 0.5
+// songs a reader handles per read section
+#define BENCH_SHARED_BATCH 256
+
+// one thread of the shared benchmark
+typedef struct BenchSharedThread
+{
+    SharedPlaylist *shared;
+    pthread_t thread;
+    // set once the writer is done
+    const int *stop;
+    // songs read, read sections and broken invariants seen
+    size_t songs;
+    size_t sections;
+    size_t errors;
+}
+BenchSharedThread;
+
+/**
+ * Function: benchTitleHash (helper)
+ * Input argument: song - a song
+ * Output argument: none
+ * Return: an FNV-1a hash of the song's title, artist number and genre
+ * Dependencies: none
+ */
+static uint64_t benchTitleHash(const Song *song)
+{
+    const char *title = songTitle(song);
+    uint64_t hash = 14695981039346656037u;
+    for (size_t i = 0; i < song->titleLength; i++)
+    {
+        hash = (hash ^ (unsigned char)title[i]) * 1099511628211u;
+    }
+    return (hash ^ song->artist ^ ((uint64_t)song->genre << 32)) *
+        1099511628211u;
+}
+
+/**
+ * Function: benchSharedReader (helper)
+ * Input argument: argument - a pointer to the thread's BenchSharedThread
+ * Output argument: the thread plays batches of the current play order to a
+ *                  null sink until told to stop, checking every song twice
+ * Return: NULL
+ * Dependencies: sharedReaderOpen, sharedReadBegin, sharedReadEnd,
+ *               playOrderAt, outputPlaying, benchTitleHash
+ *
+ * A song freed too early goes back to the pool and is reused by the
+ * writer's next add under another title, so it fails the second check.
+ */
+static void *benchSharedReader(void *argument)
+{
+    BenchSharedThread *self = (BenchSharedThread*)argument;
+    char *genres[] = {"Pop", "Rock", "Jazz", "Classical", "Other"};
+    SharedReader reader;
+    if (!sharedReaderOpen(&reader, self->shared))
+    {
+        self->errors++;
+        return NULL;
+    }
+    OutputSink sink;
+    outputInitNull(&sink);
+    Song *songs[BENCH_SHARED_BATCH];
+    uint64_t hashes[BENCH_SHARED_BATCH];
+    size_t position = 0;
+    while (!__atomic_load_n(self->stop, __ATOMIC_RELAXED))
+    {
+        const PlayOrder *order = sharedReadBegin(&reader);
+        // start over at the end, which edits may move
+        if (position >= order->length)
+        {
+            position = 0;
+        }
+        // play a batch, remembering what each song looked like
+        size_t count = 0;
+        while (count < BENCH_SHARED_BATCH && position < order->length)
+        {
+            Song *song = playOrderAt(order, position++);
+            if (song == NULL || song->genre < 0 || song->genre >= GENRE_COUNT
+                || artistPoolLength(song->artist) == 0)
+            {
+                self->errors++;
+                break;
+            }
+            outputPlaying(&sink, songTitle(song), song->titleLength,
+                artistPoolName(song->artist), artistPoolLength(song->artist),
+                genres[song->genre]);
+            songs[count] = song;
+            hashes[count++] = benchTitleHash(song);
+        }
+        // nothing may have changed by the end of the section
+        for (size_t i = 0; i < count; i++)
+        {
+            if (benchTitleHash(songs[i]) != hashes[i])
+            {
+                self->errors++;
+            }
+        }
+        sharedReadEnd(&reader);
+        self->songs += count;
+        self->sections++;
+    }
+    outputFree(&sink);
+    sharedReaderClose(&reader);
+    return NULL;
+}
+
+/**
+ * Function: benchShared
+ * Input argument: count - the number of songs in the shared playlist
+ * Output argument: reader and writer throughput is printed to stdout
+ * Return: 0 on success, 1 if the playlist could not be built or a reader
+ *         saw a broken or freed song
+ * Dependencies: benchWriteCsv, sharedLoad, sharedAddSong, sharedRemoveSong,
+ *               sharedReverse, sharedSortByGenre, benchSharedReader,
+ *               pthread.h, unistd.h, stdio.h
+ *
+ * A stress test as much as a benchmark: for 1 to 8 readers, the readers
+ * play through the playlist without locks while the main thread adds and
+ * removes songs as fast as it can, reversing now and then and sorting by
+ * genre once in a while.
+ */
+static int benchShared(size_t count)
+{
+    // load the playlist the readers share
+    char path[] = "/tmp/music_bench_XXXXXX";
+    SharedPlaylist shared;
+    if (!sharedInit(&shared))
+    {
+        return 1;
+    }
+    int saved = benchMute();
+    bool ready = benchWriteCsv(path, count) > 0 && sharedLoad(&shared, path);
+    benchUnmute(saved);
+    unlink(path);
+    if (!ready)
+    {
+        printf("Could not build the shared playlist.\n");
+        sharedFree(&shared);
+        return 1;
+    }
+    printf("%-8s %16s %16s %12s %10s\n", "readers", "songs read/s",
+        "sections/s", "edits/s", "errors");
+    int status = 0;
+    size_t added = 0;
+    size_t removed = 0;
+    char title[STR_LEN];
+    for (int readers = 1; readers <= 8; readers *= 2)
+    {
+        // start the readers
+        int stop = 0;
+        BenchSharedThread threads[8];
+        int started = 0;
+        for (; started < readers; started++)
+        {
+            threads[started] = (BenchSharedThread){ &shared, 0, &stop, 0, 0,
+                0 };
+            if (pthread_create(&threads[started].thread, NULL,
+                benchSharedReader, &threads[started]) != 0)
+            {
+                break;
+            }
+        }
+        // edit until the time is up, keeping the length about the same
+        size_t edits = 0;
+        saved = benchMute();
+        double start = benchNow();
+        while (benchNow() - start < BENCH_SHARED_SECONDS)
+        {
+            snprintf(title, sizeof(title), "Shared %zu", added++);
+            sharedAddSong(&shared, title, "Shared artist", (Genre)(edits % 5));
+            snprintf(title, sizeof(title), "Shared %zu", removed++);
+            sharedRemoveSong(&shared, title);
+            edits += 2;
+            if (edits % 64 == 0)
+            {
+                sharedReverse(&shared);
+                edits++;
+            }
+            if (edits % 4096 == 1)
+            {
+                sharedSortByGenre(&shared);
+                edits++;
+            }
+        }
+        double elapsed = benchNow() - start;
+        benchUnmute(saved);
+        // stop the readers and add up what they did
+        __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+        size_t songs = 0;
+        size_t sections = 0;
+        size_t errors = started < readers ? 1 : 0;
+        for (int t = 0; t < started; t++)
+        {
+            pthread_join(threads[t].thread, NULL);
+            songs += threads[t].songs;
+            sections += threads[t].sections;
+            errors += threads[t].errors;
+        }
+        printf("%-8d %16.0f %16.0f %12.0f %10zu\n", readers,
+            (double)songs / elapsed, (double)sections / elapsed,
+            (double)edits / elapsed, errors);
+        if (errors > 0)
+        {
+            status = 1;
+        }
+    }
+    sharedFree(&shared);
+    // return the result
+    return status;
+}
+
+// edits timed with group commit, and with a commit after every one
+#define BENCH_JOURNAL_EDITS 20000
+#define BENCH_JOURNAL_SYNCED 200
+// whole snapshots written per edit to compare with
+#define BENCH_JOURNAL_REWRITES 3
+
+/**
+ * Function: benchJournalEdit
+ * Input argument: journal - a pointer to an open journal handle
+ *                 rng - the generator that picks the song to remove
+ *                 i - the number of the edit, which names added songs
+ * Output argument: even edits add a song, odd ones remove a random one, so
+ *                  the playlist keeps its size
+ * Return: true if the edit was made, false otherwise
+ * Dependencies: journalAddSong, journalRemoveSong, playlistSongAt,
+ *               rngBelow, stdio.h, string.h
+ */
+static bool benchJournalEdit(Journal *journal, Rng *rng, size_t i)
+{
+    Playlist *playlist = journal->playlist;
+    // add a song with a title of its own
+    if (i % 2 == 0 || playlist->length == 0)
+    {
+        char title[STR_LEN];
+        snprintf(title, sizeof(title), "Journaled %zu", i);
+        return journalAddSong(journal, title, "Bench Artist",
+            (Genre)(i % GENRE_COUNT));
+    }
+    // or remove one by its title, which the removal must not free first
+    Song *song = playlistSongAt(playlist, rngBelow(rng, playlist->length));
+    char *title = strdup(songTitle(song));
+    bool removed = title != NULL && journalRemoveSong(journal, title);
+    free(title);
+    return removed;
+}
+
+/**
+ * Function: benchJournal
+ * Input argument: count - the number of songs in the generated CSV
+ * Output argument: timings are printed to stdout
+ * Return: 0 on success, 1 if a file could not be written or the replayed
+ *         playlist differs
+ * Dependencies: benchWriteCsv, benchJournalEdit, benchSamePlaylist,
+ *               journalOpen, journalFlush, journalClose,
+ *               playlistSaveSnapshot, stdio.h, unistd.h
+ *
+ * Saves edits by appending them to the journal, with and without group
+ * commit, against rewriting the whole snapshot after each one, then times
+ * a start that replays the journal.
+ */
+static int benchJournal(size_t count)
+{
+    // write the library; the journal and snapshot go next to it
+    char path[] = "/tmp/music_bench_XXXXXX";
+    char snapshot[sizeof(path) + 5];
+    char journalPath[sizeof(path) + 8];
+    char rewritePath[sizeof(path) + 5];
+    if (benchWriteCsv(path, count) == 0)
+    {
+        printf("Could not write the benchmark CSV.\n");
+        return 1;
+    }
+    snprintf(snapshot, sizeof(snapshot), "%s.snap", path);
+    snprintf(journalPath, sizeof(journalPath), "%s.journal", path);
+    snprintf(rewritePath, sizeof(rewritePath), "%s.full", path);
+    Playlist playlist;
+    playlistInit(&playlist);
+    Journal journal;
+    if (!journalOpen(&journal, &playlist, journalPath, snapshot, path))
+    {
+        printf("Could not load the benchmark CSV.\n");
+        unlink(snapshot);
+        unlink(path);
+        return 1;
+    }
+    Rng rng;
+    rngSeed(&rng, 22);
+    int status = journal.fd >= 0 ? 0 : 1;
+    size_t edit = 0;
+
+    // edits the writer commits in groups, all durable at the end
+    double start = benchNow();
+    for (size_t i = 0; i < BENCH_JOURNAL_EDITS && status == 0; i++)
+    {
+        status = benchJournalEdit(&journal, &rng, edit++) ? 0 : 1;
+    }
+    journalFlush(&journal);
+    double grouped = benchNow() - start;
+    // edits each made durable before the next
+    start = benchNow();
+    for (size_t i = 0; i < BENCH_JOURNAL_SYNCED && status == 0; i++)
+    {
+        status = benchJournalEdit(&journal, &rng, edit++) ? 0 : 1;
+        journalFlush(&journal);
+    }
+    double synced = benchNow() - start;
+    // what saving an edit cost before: the whole playlist written again,
+    // next to the snapshot the journal extends
+    start = benchNow();
+    for (size_t i = 0; i < BENCH_JOURNAL_REWRITES && status == 0; i++)
+    {
+        status = playlistSaveSnapshot(&playlist, rewritePath, path, 0) ?
+            0 : 1;
+    }
+    double rewrite = benchNow() - start;
+    journalClose(&journal);
+    // time a start that loads the snapshot and replays the journal
+    Playlist replayed;
+    playlistInit(&replayed);
+    double restart = 0;
+    if (status == 0)
+    {
+        start = benchNow();
+        status = journalOpen(&journal, &replayed, journalPath, snapshot,
+            path) ? 0 : 1;
+        restart = benchNow() - start;
+    }
+    // which must give back the playlist the edits were made to
+    if (status == 0)
+    {
+        if (!benchSamePlaylist(&playlist, &replayed))
+        {
+            printf("The journal replayed a different playlist\n");
+            status = 1;
+        }
+        journalClose(&journal);
+    }
+
+    // print the results
+    if (status == 0)
+    {
+        printf("%-28s %10s %14s\n", "saving edits", "edits", "edits/s");
+        printf("%-28s %10d %14.0f\n", "journal, group commit",
+            BENCH_JOURNAL_EDITS, BENCH_JOURNAL_EDITS / grouped);
+        printf("%-28s %10d %14.0f\n", "journal, commit each edit",
+            BENCH_JOURNAL_SYNCED, BENCH_JOURNAL_SYNCED / synced);
+        printf("%-28s %10d %14.1f\n", "rewrite snapshot each edit",
+            BENCH_JOURNAL_REWRITES, BENCH_JOURNAL_REWRITES / rewrite);
+        printf("%-28s %10zu %14.3f ms\n", "start, replaying journal",
+            edit, restart * 1e3);
+    }
+    else
+    {
+        printf("The journal benchmark failed\n");
+    }
+    // clean up
+    playlistFree(&replayed);
+    playlistFree(&playlist);
+    unlink(rewritePath);
+    unlink(journalPath);
+    unlink(snapshot);
+    unlink(path);
+    return status;
+}
+
+/**
+ * Function: benchContains (helper)
+ * Input argument: text - a string to look in
+ *                 query - a lowercase string to look for
+ * Output argument: none
+ * Return: true if text contains query, ignoring ASCII case
+ * Dependencies: ctype.h
+ */
+static bool benchContains(const char *text, const char *query)
+{
+    // try every place the query could start
+    for (; *text != '\0'; text++)
+    {
+        size_t i = 0;
+        while (query[i] != '\0' &&
+            tolower((unsigned char)text[i]) == query[i])
+        {
+            i++;
+        }
+        if (query[i] == '\0')
+        {
+            return true;
+        }
+    }
+    // an empty query is in the empty string too
+    return *query == '\0';
+}
+
+/**
+ * Function: benchSearch
+ * Input argument: count - the number of songs to search
+ * Output argument: timings are printed to stdout
+ * Return: 0 on success, 1 if memory ran out or the kernels disagree
+ * Dependencies: benchRandomPlaylist, benchContains, searchRefresh,
+ *               searchFind, searchKernelAvailable, stdio.h
+ *
+ * Times a search of every title and artist that walks the list and folds
+ * case song by song, against each kernel over the lowercased copy, on one
+ * thread and on one per processor.
+ */
+static int benchSearch(size_t count)
+{
+    // build the playlist and its copy
+    Playlist playlist;
+    playlistInit(&playlist);
+    SearchIndex search;
+    searchInit(&search);
+    if (!benchRandomPlaylist(&playlist, count, 5000, 42))
+    {
+        playlistFree(&playlist);
+        return 1;
+    }
+    double start = benchNow();
+    bool built = searchRefresh(&search, &playlist);
+    double refresh = benchNow() - start;
+    if (!built)
+    {
+        playlistFree(&playlist);
+        return 1;
+    }
+    // a common piece of a word, a rarer one that spans two, and one that is
+    // nowhere
+    static const char *queries[] = { "Mor", "zen ka", "Quartz" };
+    enum { QUERIES = 3 };
+    static const char *kernels[] = { "scalar", "sse2", "avx2" };
+    printf("copy of %zu songs: %zu bytes, built in %.3f ms\n", count,
+        search.textLength, refresh * 1e3);
+    printf("%-8s %8s %10s %10s %10s %10s %10s\n", "query", "matches",
+        "list ms", "scalar ms", "sse2 ms", "avx2 ms", "threads ms");
+    int status = 0;
+    for (int q = 0; q < QUERIES && status == 0; q++)
+    {
+        // the walk over the list is the reference
+        char query[STR_LEN];
+        size_t length = strlen(queries[q]);
+        for (size_t i = 0; i <= length; i++)
+        {
+            query[i] = (char)tolower((unsigned char)queries[q][i]);
+        }
+        double list = 1e9;
+        size_t expected = 0;
+        for (int r = 0; r < BENCH_REPEATS; r++)
+        {
+            expected = 0;
+            start = benchNow();
+            const Song *song = playlistFirst(&playlist);
+            for (size_t i = 0; i < playlist.length; i++)
+            {
+                expected += benchContains(songTitle(song), query) ||
+                    benchContains(songArtist(song), query);
+                song = playlistNext(&playlist, song);
+            }
+            list = benchMin(list, benchNow() - start);
+        }
+        // each kernel on one thread, then the best one on every processor
+        double kernel[4] = { -1, -1, -1, -1 };
+        for (int k = 0; k < 4 && status == 0; k++)
+        {
+            SearchKernel which = k < 3 ? (SearchKernel)(SEARCH_SCALAR + k) :
+                SEARCH_AUTO;
+            if (!searchKernelAvailable(which))
+            {
+                continue;
+            }
+            kernel[k] = 1e9;
+            for (int r = 0; r < BENCH_REPEATS; r++)
+            {
+                start = benchNow();
+                bool found = searchFind(&search, queries[q], which,
+                    k < 3 ? 1 : 0);
+                kernel[k] = benchMin(kernel[k], benchNow() - start);
+                // every kernel must find what the walk found
+                if (!found || search.matchCount != expected)
+                {
+                    printf("The %s kernel disagrees with the list\n",
+                        k < 3 ? kernels[k] : "threaded");
+                    status = 1;
+                    break;
+                }
+            }
+        }
+        // print the row, with a dash for a kernel this processor lacks
+        printf("%-8s %8zu %10.3f", queries[q], expected, list * 1e3);
+        for (int k = 0; k < 4; k++)
+        {
+            if (kernel[k] < 0)
+            {
+                printf(" %10s", "-");
+            }
+            else
+            {
+                printf(" %10.3f", kernel[k] * 1e3);
+            }
+        }
+        printf("\n");
+    }
+    // free both
+    searchFree(&search);
+    playlistFree(&playlist);
+    return status;
+}
+
+/**
+ * Function: benchPrefix
+ * Input argument: count - the number of songs to complete over
+ * Output argument: timings are printed to stdout
+ * Return: 0 on success, 1 if memory ran out or a completion is wrong
+ * Dependencies: benchRandomPlaylist, playlistComplete, playlistSuggest,
+ *               playlistAddSong, playlistRemoveSong, stdio.h
+ *
+ * Times building the completions, completing a prefix and suggesting for
+ * a misspelled title against a walk over every song, and adding and
+ * removing a song with the completions built and without them.
+ */
+static int benchPrefix(size_t count)
+{
+    // build the playlist
+    Playlist playlist;
+    playlistInit(&playlist);
+    if (!benchRandomPlaylist(&playlist, count, 5000, 42))
+    {
+        playlistFree(&playlist);
+        return 1;
+    }
+    PrefixResults results;
+    prefixResultsInit(&results);
+    // a prefix of some title, and the title with two letters swapped
+    char prefix[STR_LEN];
+    char typo[STR_LEN];
+    const char *title = songTitle(playlist.head);
+    snprintf(prefix, sizeof(prefix), "%.4s", title);
+    snprintf(typo, sizeof(typo), "%s", title);
+    size_t length = strlen(typo);
+    if (length > 3)
+    {
+        char swap = typo[length - 2];
+        typo[length - 2] = typo[length - 3];
+        typo[length - 3] = swap;
+    }
+    // the first call builds the completions
+    double start = benchNow();
+    size_t found = playlistComplete(&playlist, false, prefix, &results, 10);
+    double build = benchNow() - start;
+    // then time the lookups, best of several
+    double complete = 1e9;
+    double suggest = 1e9;
+    double walk = 1e9;
+    size_t suggested = 0;
+    size_t walked = 0;
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        start = benchNow();
+        found = playlistComplete(&playlist, false, prefix, &results, 10);
+        complete = benchMin(complete, benchNow() - start);
+        start = benchNow();
+        suggested = playlistSuggest(&playlist, false, typo, &results, 3);
+        suggest = benchMin(suggest, benchNow() - start);
+        // the walk only counts the titles with the prefix
+        start = benchNow();
+        walked = 0;
+        const Song *song = playlist.head;
+        for (size_t i = 0; i < playlist.length; i++)
+        {
+            walked += strncasecmp(songTitle(song), prefix,
+                strlen(prefix)) == 0;
+            song = song->next;
+        }
+        walk = benchMin(walk, benchNow() - start);
+    }
+    // every completion must start with the prefix, and the swapped title
+    // must bring back the original
+    int status = 0;
+    bool original = false;
+    for (size_t i = 0; i < suggested; i++)
+    {
+        original = original || strcmp(prefixResult(&results, i), title) == 0;
+    }
+    if (found == 0 || !original)
+    {
+        printf("The completions missed '%s'\n", title);
+        status = 1;
+    }
+    // remember the size of the completions before they are dropped
+    size_t entries = playlist.titlePrefixes.entries;
+    size_t buckets = playlist.titlePrefixes.count;
+    // adds and removes, first keeping the completions up to date
+    double edit[2];
+    int saved = benchMute();
+    for (int kept = 1; kept >= 0 && status == 0; kept--)
+    {
+        if (!kept)
+        {
+            playlistRebuildIndexes(&playlist);
+        }
+        char name[STR_LEN];
+        start = benchNow();
+        for (int i = 0; i < 1000; i++)
+        {
+            snprintf(name, sizeof(name), "Bench %d", i);
+            playlistAddSong(&playlist, name, "Bench", POP);
+        }
+        for (int i = 0; i < 1000; i++)
+        {
+            snprintf(name, sizeof(name), "Bench %d", i);
+            playlistRemoveSong(&playlist, name);
+        }
+        edit[kept] = (benchNow() - start) / 2000;
+    }
+    benchUnmute(saved);
+    // print the results
+    if (status == 0)
+    {
+        printf("%zu songs, %zu distinct titles in %zu buckets\n", count,
+            entries, buckets);
+        printf("%-26s %12.3f ms\n", "build", build * 1e3);
+        printf("%-26s %12.3f us\n", "complete 10", complete * 1e6);
+        printf("%-26s %12.3f us\n", "suggest 3", suggest * 1e6);
+        printf("%-26s %12.3f us (%zu titles)\n", "walk for the prefix",
+            walk * 1e6, walked);
+        printf("%-26s %12.3f us\n", "add+remove, kept up", edit[1] * 1e6);
+        printf("%-26s %12.3f us\n", "add+remove, not built", edit[0] * 1e6);
+    }
+    // free both
+    prefixResultsFree(&results);
+    playlistFree(&playlist);
+    return status;
+}
+
+/**
+ * Function: benchGenre
+ * Input argument: count - the number of songs to play from
+ * Output argument: timings are printed to stdout
+ * Return: 0 on success, 1 if memory ran out
+ * Dependencies: benchRandomPlaylist, playlistPlayByGenre,
+ *               playlistCountByGenre, playlistPlayInterleaved, stdio.h
+ *
+ * Times playing a rare genre, counting every genre and playing the genres
+ * in turn along the genre chains, against the same calls walking the whole
+ * playlist with the indexes switched off.
+ */
+static int benchGenre(size_t count)
+{
+    // build the playlist
+    Playlist playlist;
+    playlistInit(&playlist);
+    if (!benchRandomPlaylist(&playlist, count, 5000, 42))
+    {
+        playlistFree(&playlist);
+        return 1;
+    }
+    // make Jazz rare, one song in a hundred, so its chain is short
+    Song *song = playlist.head;
+    for (size_t i = 0; i < playlist.length; i++)
+    {
+        song->genre = i % 100 == 0 ? JAZZ :
+            song->genre == JAZZ ? POP : song->genre;
+        song = song->next;
+    }
+    playlistRebuildIndexes(&playlist);
+    char *genres[] = {"Pop", "Rock", "Jazz", "Classical", "Other"};
+    OutputSink sink;
+    outputInitNull(&sink);
+    // best of several runs, first along the chains and then walking
+    double play[2] = { 1e9, 1e9 };
+    double counts[2] = { 1e9, 1e9 };
+    double turns[2] = { 1e9, 1e9 };
+    size_t total = 0;
+    for (int chained = 1; chained >= 0; chained--)
+    {
+        // no edits are made, so the chains are still right afterwards
+        playlist.indexed = chained;
+        for (int r = 0; r < BENCH_REPEATS; r++)
+        {
+            double start = benchNow();
+            playlistPlayByGenre(&playlist, JAZZ, &sink, genres);
+            play[chained] = benchMin(play[chained], benchNow() - start);
+            start = benchNow();
+            total = 0;
+            for (int g = 0; g < GENRE_COUNT; g++)
+            {
+                total += playlistCountByGenre(&playlist, (Genre)g);
+            }
+            counts[chained] = benchMin(counts[chained], benchNow() - start);
+            start = benchNow();
+            playlistPlayInterleaved(&playlist, &sink, genres);
+            turns[chained] = benchMin(turns[chained], benchNow() - start);
+        }
+    }
+    playlist.indexed = true;
+    // print the results
+    printf("%zu songs, %zu of them Jazz\n", total,
+        playlistCountByGenre(&playlist, JAZZ));
+    printf("%-26s %15s %15s\n", "", "chains", "walk");
+    printf("%-26s %12.3f us %12.3f us\n", "play Jazz", play[1] * 1e6,
+        play[0] * 1e6);
+    printf("%-26s %12.3f us %12.3f us\n", "count every genre",
+        counts[1] * 1e6, counts[0] * 1e6);
+    printf("%-26s %12.3f ms %12.3f ms\n", "play genres in turn",
+        turns[1] * 1e3, turns[0] * 1e3);
+    // free both
+    outputFree(&sink);
+    playlistFree(&playlist);
+    return 0;
+}
+
+/**
+ * Function: benchPermutationIsBijection (helper)
+ * Input argument: size - the number of positions
+ *                 seed - the permutation key
+ *                 seen - room for size flags
+ * Output argument: seen is overwritten
+ * Return: true if the permutation maps [0, size) onto itself one to one
+ * Dependencies: permutationInit, permutationAt, string.h
+ */
+static bool benchPermutationIsBijection(uint64_t size, uint64_t seed,
+    bool *seen)
+{
+    Permutation permutation;
+    permutationInit(&permutation, size, seed);
+    memset(seen, 0, (size_t)size * sizeof(bool));
+    for (uint64_t i = 0; i < size; i++)
+    {
+        // every image must be in range and new
+        uint64_t image = permutationAt(&permutation, i);
+        if (image >= size || seen[image])
+        {
+            return false;
+        }
+        seen[image] = true;
+    }
+    // size distinct images in a set of size cover it
+    return true;
+}
+
+/**
+ * Function: benchShuffle
+ * Input argument: count - the number of songs to shuffle
+ * Output argument: the self-check result and timings are printed to stdout
+ * Return: 0 on success, 1 if memory ran out or a check failed
+ * Dependencies: benchPermutationIsBijection, benchRandomPlaylist,
+ *               benchSameFiles, songViewFromPlaylist, playShuffleStream,
+ *               playlistPlayShuffle, stdio.h
+ *
+ * First checks that the permutation is a bijection for every size below
+ * 50 and for sizes up to 5000 around powers of two, under several seeds,
+ * and that equal seeds play equal orders. Then times the streaming shuffle
+ * over the playlist's order index against the Fisher-Yates shuffle.
+ */
+static int benchShuffle(size_t count)
+{
+    // sizes past 50: around powers of two, where the Feistel block width
+    // changes, and a few others
+    static const uint64_t sampled[] = {
+        50, 63, 64, 65, 100, 127, 128, 129, 255, 256, 257, 1000, 1023,
+        1024, 1025, 2047, 2048, 2049, 3000, 4095, 4096, 4097, 5000
+    };
+    bool *seen = malloc(5000 * sizeof(bool));
+    if (seen == NULL)
+    {
+        return 1;
+    }
+    size_t checked = 0;
+    int status = 0;
+    for (uint64_t seed = 0; seed < 8 && status == 0; seed++)
+    {
+        for (uint64_t size = 1; size < 50 && status == 0; size++)
+        {
+            status = !benchPermutationIsBijection(size, seed, seen);
+            checked++;
+        }
+        for (size_t i = 0; i < sizeof(sampled) / sizeof(sampled[0]) &&
+            status == 0; i++)
+        {
+            status = !benchPermutationIsBijection(sampled[i], seed, seen);
+            checked++;
+        }
+    }
+    free(seen);
+    if (status != 0)
+    {
+        printf("A shuffle permutation is not a bijection\n");
+        return 1;
+    }
+    // build the playlist
+    Playlist playlist;
+    playlistInit(&playlist);
+    if (!benchRandomPlaylist(&playlist, count, 5000, 42))
+    {
+        playlistFree(&playlist);
+        return 1;
+    }
+    char *genres[] = {"Pop", "Rock", "Jazz", "Classical", "Other"};
+    SongView view;
+    songViewFromPlaylist(&view, &playlist);
+    // equal seeds must play equal orders, and another seed another one
+    FILE *first = tmpfile();
+    FILE *again = tmpfile();
+    FILE *other = tmpfile();
+    bool repeatable = false;
+    if (first != NULL && again != NULL && other != NULL)
+    {
+        FILE *files[] = { first, again, other };
+        uint64_t seeds[] = { 7, 7, 8 };
+        bool written = true;
+        for (int i = 0; i < 3; i++)
+        {
+            OutputSink sink;
+            outputInitFile(&sink, files[i]);
+            playShuffleStream(&view, &sink, genres, seeds[i]);
+            written = outputFree(&sink) && written;
+        }
+        repeatable = written && benchSameFiles(first, again) &&
+            (count < 3 || !benchSameFiles(first, other));
+    }
+    if (first != NULL)
+    {
+        fclose(first);
+    }
+    if (again != NULL)
+    {
+        fclose(again);
+    }
+    if (other != NULL)
+    {
+        fclose(other);
+    }
+    if (!repeatable)
+    {
+        printf("The streaming shuffle does not follow its seed\n");
+        playlistFree(&playlist);
+        return 1;
+    }
+    // time both shuffles to a null sink, best of several
+    OutputSink sink;
+    outputInitNull(&sink);
+    double stream = 1e9;
+    double fisherYates = 1e9;
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        double start = benchNow();
+        playShuffleStream(&view, &sink, genres, (uint64_t)r);
+        stream = benchMin(stream, benchNow() - start);
+        start = benchNow();
+        playlistPlayShuffle(&playlist, &sink, genres, (uint64_t)r);
+        fisherYates = benchMin(fisherYates, benchNow() - start);
+    }
+    // the streaming shuffle's first song needs one permutation step and
+    // one lookup; Fisher-Yates copies and shuffles every song first
+    double firstSong = 1e9;
+    bool found = true;
+    for (int r = 0; r < BENCH_REPEATS; r++)
+    {
+        double start = benchNow();
+        Permutation permutation;
+        permutationInit(&permutation, view.length, (uint64_t)r);
+        Song *song = view.songAt(view.context,
+            (size_t)permutationAt(&permutation, 0));
+        firstSong = benchMin(firstSong, benchNow() - start);
+        found = found && song != NULL;
+    }
+    if (!found)
+    {
+        printf("The streaming shuffle missed its first song\n");
+        status = 1;
+    }
+    // print the results
+    printf("permutation checked as a bijection at %zu sizes and seeds\n",
+        checked);
+    printf("%-26s %12.3f ms %10zu bytes extra\n", "streaming shuffle",
+        stream * 1e3, sizeof(Permutation));
+    printf("%-26s %12.3f ms %10zu bytes extra\n", "Fisher-Yates shuffle",
+        fisherYates * 1e3, count * sizeof(Song *));
+    printf("%-26s %12.3f us\n", "streaming first song", firstSong * 1e6);
+    // free both
+    outputFree(&sink);
+    playlistFree(&playlist);
+    return status;
+}
+
+// the shape of a generated library
+typedef struct BenchLibrary
+{
+    // the number of songs and of distinct artists
+    size_t songs;
+    size_t artists;
+    // the Zipf exponent of artist popularity; 0 makes every artist equally
+    // likely, 1 gives the most popular artist twice the songs of the second
+    double zipf;
+    // the relative weight of each genre
+    double genres[GENRE_COUNT];
+    // the generator seed; equal seeds give equal libraries
+    uint64_t seed;
+    // a free-form tag copied into every result, e.g. a commit hash
+    const char *label;
+}
+BenchLibrary;
+
+// draws artists and genres with a library's distributions
+typedef struct BenchSampler
+{
+    // cumulative probability of artists 0..i and of genres 0..g
+    double *artistCdf;
+    double genreCdf[GENRE_COUNT];
+    size_t artists;
+    Rng rng;
+}
+BenchSampler;
+
+/**
+ * Function: benchParseLibrary
+ * Input argument: library - the library to describe
+ *                 count - the number of songs
+ *                 argc, argv - options of the form name=value:
+ *                              artists=N, zipf=S, genres=W,W,W,W,W, seed=N
+ *                              and label=TEXT
+ * Output argument: library holds the defaults overridden by the options
+ * Return: true if every option was understood, false otherwise
+ * Dependencies: stdlib.h, string.h, stdio.h
+ */
+static bool benchParseLibrary(BenchLibrary *library, size_t count, int argc,
+    char *argv[])
+{
+    // a thousandth as many artists as songs, equally likely, in even genres
+    library->songs = count;
+    library->artists = count / 1000 > 0 ? count / 1000 : 1;
+    library->zipf = 0.0;
+    for (int g = 0; g < GENRE_COUNT; g++)
+    {
+        library->genres[g] = 1.0;
+    }
+    library->seed = 42;
+    library->label = "";
+    // read each option
+    for (int i = 0; i < argc; i++)
+    {
+        const char *value = strchr(argv[i], '=');
+        if (value == NULL)
+        {
+            printf("Options look like name=value, not '%s'.\n", argv[i]);
+            return false;
+        }
+        size_t name = (size_t)(value++ - argv[i]);
+        if (strncmp(argv[i], "artists", name) == 0 && name == 7)
+        {
+            library->artists = strtoul(value, NULL, 10);
+        }
+        else if (strncmp(argv[i], "zipf", name) == 0 && name == 4)
+        {
+            library->zipf = strtod(value, NULL);
+        }
+        else if (strncmp(argv[i], "seed", name) == 0 && name == 4)
+        {
+            library->seed = strtoull(value, NULL, 10);
+        }
+        else if (strncmp(argv[i], "label", name) == 0 && name == 5)
+        {
+            library->label = value;
+        }
+        else if (strncmp(argv[i], "genres", name) == 0 && name == 6)
+        {
+            // one weight per genre, in enum order
+            char *end = (char*)value;
+            for (int g = 0; g < GENRE_COUNT; g++)
+            {
+                library->genres[g] = strtod(end, &end);
+                if (library->genres[g] < 0 || (*end != ',' &&
+                    g < GENRE_COUNT - 1))
+                {
+                    printf("genres takes %d weights, e.g. "
+                        "genres=40,30,10,10,10.\n", GENRE_COUNT);
+                    return false;
+                }
+                end += *end == ',';
+            }
+        }
+        else
+        {
+            printf("Unknown option '%s'.\n", argv[i]);
+            return false;
+        }
+    }
+    // the distributions must be usable
+    double total = 0;
+    for (int g = 0; g < GENRE_COUNT; g++)
+    {
+        total += library->genres[g];
+    }
+    if (library->artists == 0 || library->artists > UINT32_MAX ||
+        library->zipf < 0 || total <= 0)
+    {
+        printf("Need at least one artist, zipf >= 0 and a positive genre "
+            "weight.\n");
+        return false;
+    }
+    // return success
+    return true;
+}
+
+/**
+ * Function: benchSamplerInit
+ * Input argument: sampler - the sampler to set up
+ *                 library - the library whose distributions it follows
+ *                 stream - picks an independent sequence for the same seed
+ * Output argument: sampler holds the cumulative distributions
+ * Return: true on success, false if memory ran out
+ * Dependencies: rngSeed, math.h, stdlib.h
+ *
+ * Artist i, counting from 0, gets weight 1 / (i + 1)^zipf.
+ */
+static bool benchSamplerInit(BenchSampler *sampler,
+    const BenchLibrary *library, uint64_t stream)
+{
+    sampler->artists = library->artists;
+    sampler->artistCdf = (double*)malloc(library->artists * sizeof(double));
+    if (sampler->artistCdf == NULL)
+    {
+        return false;
+    }
+    // sum the artist weights
+    double total = 0;
+    for (size_t i = 0; i < library->artists; i++)
+    {
+        total += library->zipf == 0 ? 1.0 :
+            pow((double)(i + 1), -library->zipf);
+        sampler->artistCdf[i] = total;
+    }
+    for (size_t i = 0; i < library->artists; i++)
+    {
+        sampler->artistCdf[i] /= total;
+    }
+    // and the genre weights
+    total = 0;
+    for (int g = 0; g < GENRE_COUNT; g++)
+    {
+        total += library->genres[g];
+        sampler->genreCdf[g] = total;
+    }
+    for (int g = 0; g < GENRE_COUNT; g++)
+    {
+        sampler->genreCdf[g] /= total;
+    }
+    // seed the draws
+    rngSeed(&sampler->rng, library->seed * 0x9e3779b97f4a7c15ull + stream);
+    return true;
+}
+
+/**
+ * Function: benchUniform
+ * Input argument: sampler - a pointer to a sampler
+ * Output argument: the sampler's generator advances
+ * Return: a uniformly distributed number in [0, 1)
+ * Dependencies: rngNext
+ */
+static double benchUniform(BenchSampler *sampler)
+{
+    // the top 53 bits fill a double's mantissa
+    return (double)(rngNext(&sampler->rng) >> 11) * 0x1p-53;
+}
+
+/**
+ * Function: benchSampleArtist
+ * Input argument: sampler - a pointer to a sampler
+ * Output argument: the sampler's generator advances
+ * Return: an artist rank in [0, artists), by the library's distribution
+ * Dependencies: benchUniform
+ */
+static size_t benchSampleArtist(BenchSampler *sampler)
+{
+    // binary search for the first rank whose cumulative weight passes u
+    double u = benchUniform(sampler);
+    size_t low = 0;
+    size_t high = sampler->artists - 1;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (sampler->artistCdf[middle] > u)
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+    return low;
+}
+
+/**
+ * Function: benchSampleGenre
+ * Input argument: sampler - a pointer to a sampler
+ * Output argument: the sampler's generator advances
+ * Return: a genre, by the library's weights
+ * Dependencies: benchUniform
+ */
+static Genre benchSampleGenre(BenchSampler *sampler)
+{
+    double u = benchUniform(sampler);
+    int g = 0;
+    while (g < GENRE_COUNT - 1 && sampler->genreCdf[g] <= u)
+    {
+        g++;
+    }
+    return (Genre)g;
+}
+
+/**
+ * Function: benchArtistName
+ * Input argument: buffer - where to write the name, at least STR_LEN bytes
+ *                 rank - the artist's rank
+ * Output argument: buffer holds the artist's name, the same for every call
+ *                  with the same rank and different for different ranks
+ * Return: none
+ * Dependencies: benchRandomWord, stdio.h
+ */
+static void benchArtistName(char *buffer, size_t rank)
+{
+    // a made-up word, made unique by the rank
+    char word[16];
+    unsigned seed = (unsigned)rank * 2654435761u + 1;
+    benchRandomWord(word, sizeof(word), &seed);
+    snprintf(buffer, STR_LEN, "%s %zu", word, rank);
+}
+
+/**
+ * Function: benchGenerateCsv
+ * Input argument: path - the file to write
+ *                 library - the library to generate
+ * Output argument: a playlist CSV with a header and one row per song
+ * Return: the size of the file in bytes, or 0 on failure
+ * Dependencies: benchSamplerInit, benchRealisticTitle, benchArtistName,
+ *               stdio.h
+ */
+static size_t benchGenerateCsv(const char *path, const BenchLibrary *library)
+{
+    BenchSampler sampler;
+    FILE *file = fopen(path, "w");
+    if (file == NULL || !benchSamplerInit(&sampler, library, 0))
+    {
+        if (file != NULL)
+        {
+            fclose(file);
+        }
+        return 0;
+    }
+    // write the header and one row per song
+    fprintf(file, "title,artist,genre\n");
+    unsigned seed = (unsigned)library->seed;
+    char title[256];
+    char artist[STR_LEN];
+    for (size_t i = 0; i < library->songs; i++)
+    {
+        benchRealisticTitle(title, sizeof(title), &seed);
+        benchArtistName(artist, benchSampleArtist(&sampler));
+        fprintf(file, "%s,%s,%d\n", title, artist,
+            (int)benchSampleGenre(&sampler));
+    }
+    // the position after the last row is the file size
+    size_t size = (size_t)ftell(file);
+    bool ok = fclose(file) == 0;
+    free(sampler.artistCdf);
+    return ok ? size : 0;
+}
+
+// counters read before an operation, to report its share
+typedef struct BenchMark
+{
+    double start;
+    uint64_t allocs;
+    uint64_t bytes;
+}
+BenchMark;
+
+/**
+ * Function: benchMark
+ * Input argument: none
+ * Output argument: none
+ * Return: the clock and the allocation counters right now
+ * Dependencies: benchNow
+ */
+static BenchMark benchMark(void)
+{
+    BenchMark mark;
+    mark.allocs = __atomic_load_n(&benchAllocs, __ATOMIC_RELAXED);
+    mark.bytes = __atomic_load_n(&benchAllocBytes, __ATOMIC_RELAXED);
+    mark.start = benchNow();
+    return mark;
+}
+
+/**
+ * Function: benchReport
+ * Input argument: operation - the name of the function measured
+ *                 library - the library it ran on
+ *                 ops - the number of calls measured
+ *                 items - the songs each call handles, for a per-song cost
+ *                 seconds - the time spent inside the calls
+ *                 mark - the counters read before the first call
+ * Output argument: one JSON object is printed on a line of its own
+ * Return: none
+ * Dependencies: benchMark, sys/resource.h, stdio.h
+ *
+ * peak_rss_kb is the process's high-water mark so far, so it only grows
+ * from one line to the next.
+ */
+static void benchReport(const char *operation, const BenchLibrary *library,
+    size_t ops, size_t items, double seconds, BenchMark mark)
+{
+    BenchMark now = benchMark();
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("{\"label\":\"%s\",\"op\":\"%s\",\"songs\":%zu,\"artists\":%zu,"
+        "\"zipf\":%g,\"ops\":%zu,\"ns_per_op\":%.1f,\"ns_per_song\":%.3f,",
+        library->label, operation, library->songs, library->artists,
+        library->zipf, ops, seconds * 1e9 / (double)ops,
+        seconds * 1e9 / ((double)ops * (double)items));
+    if (BENCH_COUNT_ALLOCS)
+    {
+        printf("\"allocs_per_op\":%.2f,\"alloc_bytes_per_op\":%.1f,",
+            (double)(now.allocs - mark.allocs) / (double)ops,
+            (double)(now.bytes - mark.bytes) / (double)ops);
+    }
+    else
+    {
+        printf("\"allocs_per_op\":-1,\"alloc_bytes_per_op\":-1,");
+    }
+    printf("\"peak_rss_kb\":%ld}\n", usage.ru_maxrss);
+    fflush(stdout);
+}
+
+/**
+ * Function: benchGenerate
+ * Input argument: library - the library to generate
+ * Output argument: FILENAME in the working directory holds the library
+ * Return: 0 on success, 1 if the file could not be written
+ * Dependencies: benchGenerateCsv, stdio.h
+ */
+static int benchGenerate(const BenchLibrary *library)
+{
+    size_t size = benchGenerateCsv(FILENAME, library);
+    if (size == 0)
+    {
+        printf("Could not write %s.\n", FILENAME);
+        return 1;
+    }
+    printf("Wrote %zu songs by %zu artists to %s (%.1f MB).\n",
+        library->songs, library->artists, FILENAME, (double)size / (1 << 20));
+    return 0;
+}
+
+/**
+ * Function: benchSuite
+ * Input argument: library - the library to generate and measure
+ * Output argument: one JSON line per function of the Song ** API
+ * Return: 0 on success, 1 if the library could not be written or loaded
+ * Dependencies: benchGenerateCsv, benchSampler*, benchMute, benchUnmute,
+ *               benchReport, the Song ** API, unistd.h, stdio.h
+ *
+ * Writes the library as FILENAME in a fresh directory under /tmp, loads it
+ * with createPlaylist and times every other call on the loaded list, with
+ * their printing sent to /dev/null. Each call is repeated until
+ * BENCH_BUDGET seconds have gone by, so cheap and O(n) calls alike get a
+ * stable ns/op without the suite taking minutes on large libraries.
+ */
+static int benchSuite(const BenchLibrary *library)
+{
+    // createPlaylist reads FILENAME from the working directory
+    char directory[] = "/tmp/music_suite_XXXXXX";
+    int home = open(".", O_RDONLY);
+    if (home < 0 || mkdtemp(directory) == NULL || chdir(directory) != 0)
+    {
+        printf("Could not make a directory for the benchmark.\n");
+        if (home >= 0)
+        {
+            close(home);
+        }
+        return 1;
+    }
+    BenchSampler sampler;
+    sampler.artistCdf = NULL;
+    bool ready = benchGenerateCsv(FILENAME, library) > 0 &&
+        benchSamplerInit(&sampler, library, 1);
+    char *genres[] = {"Pop", "Rock", "Jazz", "Classical", "Other"};
+    Song *playlist = NULL;
+    // createPlaylist, once: a load is the cost being measured
+    BenchMark mark = benchMark();
+    int saved = benchMute();
+    ready = ready && createPlaylist(&playlist);
+    benchUnmute(saved);
+    double elapsed = benchNow() - mark.start;
+    if (!ready)
+    {
+        printf("Could not generate and load the library.\n");
+        freePlaylist(&playlist);
+        free(sampler.artistCdf);
+        unlink(FILENAME);
+        fchdir(home);
+        close(home);
+        rmdir(directory);
+        return 1;
+    }
+    benchReport("createPlaylist", library, 1, library->songs, elapsed,
+        mark);
+    // addSong: append songs by artists drawn from the distribution
+    char title[STR_LEN];
+    char artist[STR_LEN];
+    size_t added = 0;
+    saved = benchMute();
+    mark = benchMark();
+    do
+    {
+        snprintf(title, sizeof(title), "Bench %zu", added);
+        benchArtistName(artist, benchSampleArtist(&sampler));
+        addSong(&playlist, title, artist, benchSampleGenre(&sampler));
+        added++;
+    }
+    while (benchNow() - mark.start < BENCH_BUDGET && added < BENCH_MAX_OPS);
+    elapsed = benchNow() - mark.start;
+    benchUnmute(saved);
+    benchReport("addSong", library, added, 1, elapsed, mark);
+    // removeSong: take the appended songs out again, oldest first; they sit
+    // at the tail, so each search walks the whole list
+    size_t removed = 0;
+    saved = benchMute();
+    mark = benchMark();
+    do
+    {
+        snprintf(title, sizeof(title), "Bench %zu", removed);
+        removeSong(&playlist, title);
+        removed++;
+    }
+    while (benchNow() - mark.start < BENCH_BUDGET && removed < added);
+    elapsed = benchNow() - mark.start;
+    benchUnmute(saved);
+    benchReport("removeSong", library, removed, 1, elapsed, mark);
+    // and the rest untimed, so every later call sees the loaded library
+    saved = benchMute();
+    for (size_t i = removed; i < added; i++)
+    {
+        snprintf(title, sizeof(title), "Bench %zu", i);
+        removeSong(&playlist, title);
+    }
+    benchUnmute(saved);
+    // playShuffle: the whole list, in a new order each time
+    size_t ops = 0;
+    saved = benchMute();
+    mark = benchMark();
+    do
+    {
+        playShuffle(playlist, genres);
+        ops++;
+    }
+    while (benchNow() - mark.start < BENCH_BUDGET);
+    elapsed = benchNow() - mark.start;
+    benchUnmute(saved);
+    benchReport("playShuffle", library, ops, library->songs, elapsed, mark);
+    // playByArtist: artists drawn from the distribution, so popular ones
+    // come up as often as listeners would pick them
+    ops = 0;
+    saved = benchMute();
+    mark = benchMark();
+    do
+    {
+        benchArtistName(artist, benchSampleArtist(&sampler));
+        playByArtist(playlist, artist, genres);
+        ops++;
+    }
+    while (benchNow() - mark.start < BENCH_BUDGET);
+    elapsed = benchNow() - mark.start;
+    benchUnmute(saved);
+    benchReport("playByArtist", library, ops, library->songs, elapsed, mark);
+    // sortByGenre: reversed in between, untimed, so each sort has work
+    ops = 0;
+    elapsed = 0;
+    saved = benchMute();
+    mark = benchMark();
+    double stop = mark.start + BENCH_BUDGET;
+    do
+    {
+        reversePlaylist(&playlist);
+        double start = benchNow();
+        sortByGenre(&playlist);
+        elapsed += benchNow() - start;
+        ops++;
+    }
+    while (benchNow() < stop);
+    benchUnmute(saved);
+    benchReport("sortByGenre", library, ops, library->songs, elapsed, mark);
+    // reversePlaylist
+    ops = 0;
+    saved = benchMute();
+    mark = benchMark();
+    do
+    {
+        reversePlaylist(&playlist);
+        ops++;
+    }
+    while (benchNow() - mark.start < BENCH_BUDGET);
+    elapsed = benchNow() - mark.start;
+    benchUnmute(saved);
+    benchReport("reversePlaylist", library, ops, library->songs, elapsed,
+        mark);
+    // makePlaylistCircular: made linear again in between, untimed
+    ops = 0;
+    elapsed = 0;
+    saved = benchMute();
+    mark = benchMark();
+    stop = mark.start + BENCH_BUDGET;
+    do
+    {
+        double start = benchNow();
+        makePlaylistCircular(&playlist);
+        elapsed += benchNow() - start;
+        makePlaylistLinear(&playlist);
+        ops++;
+    }
+    while (benchNow() < stop);
+    benchUnmute(saved);
+    benchReport("makePlaylistCircular", library, ops, library->songs,
+        elapsed, mark);
+    // detectCycle, on the linear list
+    ops = 0;
+    size_t cycles = 0;
+    mark = benchMark();
+    do
+    {
+        cycles += detectCycle(playlist);
+        ops++;
+    }
+    while (benchNow() - mark.start < BENCH_BUDGET);
+    elapsed = benchNow() - mark.start;
+    benchReport("detectCycle", library, ops, library->songs, elapsed, mark);
+    // a linear list has no cycle
+    int status = cycles == 0 ? 0 : 1;
+    if (status != 0)
+    {
+        printf("detectCycle found a cycle in a linear playlist\n");
+    }
+    // clean up
+    freePlaylist(&playlist);
+    free(sampler.artistCdf);
+    unlink(FILENAME);
+    fchdir(home);
+    close(home);
+    rmdir(directory);
+    return status;
+}
+
+int main(int argc, char *argv[])
+{
+    // check that a benchmark was named
+    if (argc < 2)
+    {
+        // if not, print the usage
+        printf("Usage: %s pool|sort|load|snapshot|columnar|titles|play|\
+shared|journal|search|prefix|genre|shuffle [songs]\n\
+       %s generate|suite [songs] [artists=N] [zipf=S] \
+[genres=W,W,W,W,W] [seed=N] [label=TEXT]\n", argv[0], argv[0]);
+        // exit with an error code
+        return 1;
+    }
+    // read the number of songs, defaulting to a million
+    size_t count = argc > 2 ? strtoul(argv[2], NULL, 10) :
+        BENCH_DEFAULT_SONGS;
+    // check for a usable size
+    if (count == 0)
+    {
+        printf("The number of songs must be positive.\n");
+        return 1;
+    }
+    // run the pool benchmark
+    if (strcmp(argv[1], "pool") == 0)
+    {
+        return benchPool(count);
+    }
+    // run the sort benchmark
+    if (strcmp(argv[1], "sort") == 0)
+    {
+        return benchSort(count);
+    }
+    // run the CSV loading benchmark
+    if (strcmp(argv[1], "load") == 0)
+    {
+        return benchLoad(count);
+    }
+    // run the snapshot benchmark
+    if (strcmp(argv[1], "snapshot") == 0)
+    {
+        return benchSnapshot(count);
+    }
+    // run the columnar benchmark
+    if (strcmp(argv[1], "columnar") == 0)
+    {
+        return benchColumnar(count);
+    }
+    // run the title storage benchmark
+    if (strcmp(argv[1], "titles") == 0)
+    {
+        return benchTitles(count);
+    }
+    // run the playback output benchmark
+    if (strcmp(argv[1], "play") == 0)
+    {
+        return benchPlay(count);
+    }
+    // run the concurrent playback benchmark
+    if (strcmp(argv[1], "shared") == 0)
+    {
+        return benchShared(count);
+    }
+    // run the journal benchmark
+    if (strcmp(argv[1], "journal") == 0)
+    {
+        return benchJournal(count);
+    }
+    // run the search benchmark
+    if (strcmp(argv[1], "search") == 0)
+    {
+        return benchSearch(count);
+    }
+    // run the completion benchmark
+    if (strcmp(argv[1], "prefix") == 0)
+    {
+        return benchPrefix(count);
+    }
+    // run the genre chain benchmark
+    if (strcmp(argv[1], "genre") == 0)
+    {
+        return benchGenre(count);
+    }
+    // run the shuffle self-check and benchmark
+    if (strcmp(argv[1], "shuffle") == 0)
+    {
+        return benchShuffle(count);
+    }
+    // generate a library, or run the suite on one
+    if (strcmp(argv[1], "generate") == 0 || strcmp(argv[1], "suite") == 0)
+    {
+        BenchLibrary library;
+        if (!benchParseLibrary(&library, count, argc - 3, argv + 3))
+        {
+            return 1;
+        }
+        return argv[1][0] == 'g' ? benchGenerate(&library) :
+            benchSuite(&library);
+    }
+    // otherwise, the benchmark is unknown
+    printf("Unknown benchmark '%s'.\n", argv[1]);
+    // exit with an error code
+    return 1;
+}
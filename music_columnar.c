@@ -0,0 +1,875 @@
+// header files
+#include "music_columnar.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// global definitions
+#define COLUMNAR_MIN_CAPACITY 64
+
+// a function called for every song a filter matches
+typedef void (*ColumnarVisit)(
+    const ColumnarPlaylist *playlist, uint32_t song, void *context);
+
+// what columnarPrint needs to play a song
+typedef struct ColumnarPlayer
+{
+    // where the song is played to
+    OutputSink *sink;
+    // the names of the genres
+    char **genres;
+}
+ColumnarPlayer;
+
+/**
+ * Function: columnarStore (helper)
+ * Input argument: strings - the buffer to append to
+ *                 text - the string to append
+ *                 length - its length
+ *                 offset - where to store the string's offset
+ * Output argument: the string and its terminator are appended
+ * Return: true on success, false if memory ran out or offsets overflowed
+ * Dependencies: stdlib.h, string.h
+ */
+static bool columnarStore(ColumnarStrings *strings, const char *text,
+    size_t length, uint32_t *offset)
+{
+    // make room, doubling the buffer
+    if (strings->length + length + 1 > strings->capacity)
+    {
+        size_t capacity = strings->capacity * 2 + length + 1;
+        char *bytes = (char*)realloc(strings->bytes, capacity);
+        if (bytes == NULL)
+        {
+            return false;
+        }
+        strings->bytes = bytes;
+        strings->capacity = capacity;
+    }
+    // offsets are 32 bits wide
+    if (strings->length + length + 1 > UINT32_MAX)
+    {
+        return false;
+    }
+    // append the string
+    *offset = (uint32_t)strings->length;
+    memcpy(strings->bytes + strings->length, text, length + 1);
+    strings->length += length + 1;
+    // return success
+    return true;
+}
+
+/**
+ * Function: columnarHash (helper)
+ * Input argument: text - the string to hash
+ * Output argument: none
+ * Return: a 32-bit FNV-1a hash of the string
+ * Dependencies: none
+ */
+static uint32_t columnarHash(const char *text)
+{
+    // FNV-1a over the bytes
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *c = (const unsigned char *)text; *c; c++)
+    {
+        hash = (hash ^ *c) * 16777619u;
+    }
+    // return the hash
+    return hash;
+}
+
+/**
+ * Function: columnarArtistSlot (helper)
+ * Input argument: artists - the artist dictionary, with slots allocated
+ *                 name - the artist to look for
+ * Output argument: none
+ * Return: the slot holding the artist, or the empty slot it would take
+ * Dependencies: columnarHash, string.h
+ */
+static size_t columnarArtistSlot(const ColumnarArtists *artists,
+    const char *name)
+{
+    // probe from the slot the hash points at
+    size_t position = columnarHash(name) & artists->mask;
+    while (artists->slots[position] != 0)
+    {
+        // stop at the artist
+        uint32_t artist = artists->slots[position] - 1;
+        if (strcmp(artists->names.bytes + artists->offsets[artist], name) == 0)
+        {
+            break;
+        }
+        position = (position + 1) & artists->mask;
+    }
+    // return the slot
+    return position;
+}
+
+/**
+ * Function: columnarArtistFind (helper)
+ * Input argument: artists - the artist dictionary
+ *                 name - the artist to look for
+ * Output argument: none
+ * Return: the artist's number, or COLUMNAR_NONE if there is none
+ * Dependencies: columnarArtistSlot
+ */
+static uint32_t columnarArtistFind(const ColumnarArtists *artists,
+    const char *name)
+{
+    // an empty dictionary holds nothing
+    if (artists->slots == NULL)
+    {
+        return COLUMNAR_NONE;
+    }
+    // read the slot the artist would be in
+    uint32_t entry = artists->slots[columnarArtistSlot(artists, name)];
+    return entry == 0 ? COLUMNAR_NONE : entry - 1;
+}
+
+/**
+ * Function: columnarArtistIntern (helper)
+ * Input argument: artists - the artist dictionary
+ *                 name - the artist to number
+ * Output argument: the artist is added unless it already was
+ * Return: the artist's number, or COLUMNAR_NONE if memory ran out
+ * Dependencies: columnarArtistSlot, columnarStore, stdlib.h
+ */
+static uint32_t columnarArtistIntern(ColumnarArtists *artists,
+    const char *name)
+{
+    // keep the table at most half full
+    if (artists->slots == NULL || (artists->count + 1) * 2 > artists->mask + 1)
+    {
+        // double it, starting from the minimum, and place every artist again
+        size_t capacity = artists->slots == NULL ? COLUMNAR_MIN_CAPACITY :
+            (artists->mask + 1) * 2;
+        uint32_t *slots = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+        if (slots == NULL)
+        {
+            return COLUMNAR_NONE;
+        }
+        uint32_t *oldSlots = artists->slots;
+        artists->slots = slots;
+        artists->mask = capacity - 1;
+        for (size_t artist = 0; artist < artists->count; artist++)
+        {
+            artists->slots[columnarArtistSlot(artists,
+                artists->names.bytes + artists->offsets[artist])] =
+                (uint32_t)artist + 1;
+        }
+        free(oldSlots);
+    }
+    // return the artist if it is known
+    size_t position = columnarArtistSlot(artists, name);
+    if (artists->slots[position] != 0)
+    {
+        return artists->slots[position] - 1;
+    }
+    // otherwise, make room for its offset
+    if (artists->count == artists->capacity)
+    {
+        size_t capacity = artists->capacity == 0 ? COLUMNAR_MIN_CAPACITY :
+            artists->capacity * 2;
+        uint32_t *offsets = (uint32_t*)realloc(artists->offsets,
+            capacity * sizeof(uint32_t));
+        if (offsets == NULL)
+        {
+            return COLUMNAR_NONE;
+        }
+        artists->offsets = offsets;
+        artists->capacity = capacity;
+    }
+    // store its name
+    if (!columnarStore(&artists->names, name, strlen(name),
+        &artists->offsets[artists->count]))
+    {
+        return COLUMNAR_NONE;
+    }
+    // and number it
+    artists->slots[position] = (uint32_t)artists->count + 1;
+    return (uint32_t)artists->count++;
+}
+
+/**
+ * Function: columnarReserve (helper)
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 slots - the number of song numbers needed
+ * Output argument: every column has room for slots songs
+ * Return: true on success, false if memory ran out
+ * Dependencies: stdlib.h
+ */
+static bool columnarReserve(ColumnarPlaylist *playlist, size_t slots)
+{
+    // nothing to do while there is room
+    if (slots <= playlist->capacity)
+    {
+        return true;
+    }
+    // song numbers are 32 bits wide, with COLUMNAR_NONE kept free
+    if (slots >= COLUMNAR_NONE)
+    {
+        return false;
+    }
+    // double the capacity, starting from the minimum
+    size_t capacity = playlist->capacity == 0 ? COLUMNAR_MIN_CAPACITY :
+        playlist->capacity;
+    while (capacity < slots)
+    {
+        capacity *= 2;
+    }
+    // grow each column, keeping the ones that already grew on failure
+    uint8_t *genres = (uint8_t*)realloc(playlist->genres, capacity);
+    if (genres == NULL)
+    {
+        return false;
+    }
+    playlist->genres = genres;
+    uint32_t *artists = (uint32_t*)realloc(playlist->artists,
+        capacity * sizeof(uint32_t));
+    if (artists == NULL)
+    {
+        return false;
+    }
+    playlist->artists = artists;
+    uint32_t *titles = (uint32_t*)realloc(playlist->titles,
+        capacity * sizeof(uint32_t));
+    if (titles == NULL)
+    {
+        return false;
+    }
+    playlist->titles = titles;
+    uint32_t *next = (uint32_t*)realloc(playlist->next,
+        capacity * sizeof(uint32_t));
+    if (next == NULL)
+    {
+        return false;
+    }
+    playlist->next = next;
+    // every column fits now
+    playlist->capacity = capacity;
+    return true;
+}
+
+/**
+ * Function: columnarInit
+ * Input argument: playlist - a pointer to a columnar playlist
+ * Output argument: playlist is empty; nothing is allocated until the first
+ *                  song is added
+ * Return: none
+ * Dependencies: none
+ */
+void columnarInit(ColumnarPlaylist *playlist)
+{
+    // zero every column, count and buffer
+    memset(playlist, 0, sizeof(*playlist));
+    // an empty playlist has no first or last song
+    playlist->head = COLUMNAR_NONE;
+    playlist->tail = COLUMNAR_NONE;
+}
+
+/**
+ * Function: columnarFree
+ * Input argument: playlist - a pointer to a columnar playlist
+ * Output argument: every column is freed and the playlist is empty again
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void columnarFree(ColumnarPlaylist *playlist)
+{
+    // free the columns
+    free(playlist->genres);
+    free(playlist->artists);
+    free(playlist->titles);
+    free(playlist->next);
+    // and the strings
+    free(playlist->titleText.bytes);
+    free(playlist->artistNames.names.bytes);
+    free(playlist->artistNames.offsets);
+    free(playlist->artistNames.slots);
+    // leave an empty, reusable playlist behind
+    columnarInit(playlist);
+}
+
+/**
+ * Function: columnarAddSong
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 title - a string with the title of the song
+ *                 artist - a string with the artist of the song
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song is appended after the tail
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: columnarReserve, columnarArtistIntern, columnarStore,
+ *               stdio.h, string.h
+ */
+bool columnarAddSong(ColumnarPlaylist *playlist, const char *title,
+    const char *artist, Genre genre)
+{
+    // check if song genre is invalid
+    if (genre < 0 || genre >= GENRE_COUNT)
+    {
+        printf("Invalid genre. Song not added.\n");
+        return false;
+    }
+    // make room for the song, its artist and its title
+    uint32_t song = (uint32_t)playlist->slots;
+    uint32_t artistNumber = COLUMNAR_NONE;
+    uint32_t titleOffset = 0;
+    if (!columnarReserve(playlist, playlist->slots + 1) ||
+        (artistNumber = columnarArtistIntern(&playlist->artistNames, artist))
+        == COLUMNAR_NONE ||
+        !columnarStore(&playlist->titleText, title, strlen(title),
+        &titleOffset))
+    {
+        printf("Out of memory. Song not added.\n");
+        return false;
+    }
+    // fill in its columns
+    playlist->genres[song] = (uint8_t)genre;
+    playlist->artists[song] = artistNumber;
+    playlist->titles[song] = titleOffset;
+    playlist->next[song] = COLUMNAR_NONE;
+    // link it after the tail
+    if (playlist->tail == COLUMNAR_NONE)
+    {
+        playlist->head = song;
+    }
+    else
+    {
+        playlist->next[playlist->tail] = song;
+    }
+    playlist->tail = song;
+    // count it
+    playlist->slots++;
+    playlist->length++;
+    // return success
+    return true;
+}
+
+/**
+ * Function: columnarFromPlaylist
+ * Input argument: playlist - a pointer to an empty columnar playlist
+ *                 songs - a pointer to the playlist handle to copy
+ * Output argument: playlist holds the same songs in the same order
+ * Return: true on success, false if memory ran out
+ * Dependencies: columnarReserve, columnarAddSong, playlistFirst,
+ *               playlistNext
+ */
+bool columnarFromPlaylist(ColumnarPlaylist *playlist, const Playlist *songs)
+{
+    // size the columns once
+    if (!columnarReserve(playlist, playlist->slots + songs->length))
+    {
+        return false;
+    }
+    // append each song in play order
+    Song* current = playlistFirst(songs);
+    for (size_t i = 0; i < songs->length; i++)
+    {
+        if (!columnarAddSong(playlist, songTitle(current), songArtist(current),
+            current->genre))
+        {
+            return false;
+        }
+        current = playlistNext(songs, current);
+    }
+    // return success
+    return true;
+}
+
+/**
+ * Function: columnarTitle
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 song - a song number
+ * Output argument: none
+ * Return: the song's title
+ * Dependencies: none
+ */
+const char *columnarTitle(const ColumnarPlaylist *playlist, uint32_t song)
+{
+    return playlist->titleText.bytes + playlist->titles[song];
+}
+
+/**
+ * Function: columnarArtist
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 song - a song number
+ * Output argument: none
+ * Return: the song's artist
+ * Dependencies: none
+ */
+const char *columnarArtist(const ColumnarPlaylist *playlist, uint32_t song)
+{
+    return playlist->artistNames.names.bytes +
+        playlist->artistNames.offsets[playlist->artists[song]];
+}
+
+/**
+ * Function: columnarPrint (helper)
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 song - the song number to print
+ *                 context - a ColumnarPlayer with the sink and genre names
+ * Output argument: the song is written to the sink as playing
+ * Return: none
+ * Dependencies: columnarTitle, columnarArtist, outputPlaying, string.h
+ */
+static void columnarPrint(const ColumnarPlaylist *playlist, uint32_t song,
+    void *context)
+{
+    // the sink and genre names come in through the context
+    const ColumnarPlayer *player = (const ColumnarPlayer*)context;
+    const char *title = columnarTitle(playlist, song);
+    const char *artist = columnarArtist(playlist, song);
+    outputPlaying(player->sink, title, strlen(title), artist, strlen(artist),
+        player->genres[playlist->genres[song]]);
+}
+
+/**
+ * Function: columnarVisitMask (helper)
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 base - the song number of bit 0
+ *                 mask - one bit per matching song
+ *                 visit - the function to call, or NULL to only count
+ *                 context - passed on to visit
+ * Output argument: visit is called for each set bit, lowest first
+ * Return: the number of set bits
+ * Dependencies: none
+ */
+static inline size_t columnarVisitMask(const ColumnarPlaylist *playlist,
+    size_t base, unsigned mask, ColumnarVisit visit, void *context)
+{
+    // counting needs no loop
+    if (visit == NULL)
+    {
+        return (size_t)__builtin_popcount(mask);
+    }
+    // otherwise, visit the matches in order
+    size_t count = 0;
+    while (mask != 0)
+    {
+        visit(playlist, (uint32_t)(base + (size_t)__builtin_ctz(mask)),
+            context);
+        mask &= mask - 1;
+        count++;
+    }
+    // return the count
+    return count;
+}
+
+/**
+ * Function: columnarScanGenre (helper)
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 genre - the genre byte to match
+ *                 visit - the function to call per match, or NULL
+ *                 context - passed on to visit
+ * Output argument: visit is called for the matching songs in order
+ * Return: the number of matching songs
+ * Dependencies: columnarVisitMask, emmintrin.h
+ */
+static size_t columnarScanGenre(const ColumnarPlaylist *playlist,
+    uint8_t genre, ColumnarVisit visit, void *context)
+{
+    // create variables to hold the count and the next song number
+    size_t count = 0;
+    size_t song = 0;
+#ifdef __SSE2__
+    // compare 16 genres at a time
+    const __m128i wanted = _mm_set1_epi8((char)genre);
+    for (; song + 16 <= playlist->slots; song += 16)
+    {
+        __m128i block = _mm_loadu_si128(
+            (const __m128i*)(playlist->genres + song));
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_cmpeq_epi8(block, wanted));
+        count += columnarVisitMask(playlist, song, mask, visit, context);
+    }
+#endif
+    // finish one at a time
+    for (; song < playlist->slots; song++)
+    {
+        if (playlist->genres[song] == genre)
+        {
+            count += columnarVisitMask(playlist, song, 1u, visit, context);
+        }
+    }
+    // return the count
+    return count;
+}
+
+/**
+ * Function: columnarScanArtist (helper)
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 artist - the artist number to match
+ *                 visit - the function to call per match, or NULL
+ *                 context - passed on to visit
+ * Output argument: visit is called for the matching songs in order
+ * Return: the number of matching songs
+ * Dependencies: columnarVisitMask, emmintrin.h
+ */
+static size_t columnarScanArtist(const ColumnarPlaylist *playlist,
+    uint32_t artist, ColumnarVisit visit, void *context)
+{
+    // create variables to hold the count and the next song number
+    size_t count = 0;
+    size_t song = 0;
+#ifdef __SSE2__
+    // compare 16 artists at a time, four per register
+    const __m128i wanted = _mm_set1_epi32((int)artist);
+    for (; song + 16 <= playlist->slots; song += 16)
+    {
+        const __m128i *block = (const __m128i*)(playlist->artists + song);
+        // pack the four 32-bit results into one byte mask per song
+        __m128i low = _mm_packs_epi32(
+            _mm_cmpeq_epi32(_mm_loadu_si128(block), wanted),
+            _mm_cmpeq_epi32(_mm_loadu_si128(block + 1), wanted));
+        __m128i high = _mm_packs_epi32(
+            _mm_cmpeq_epi32(_mm_loadu_si128(block + 2), wanted),
+            _mm_cmpeq_epi32(_mm_loadu_si128(block + 3), wanted));
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_packs_epi16(low, high));
+        count += columnarVisitMask(playlist, song, mask, visit, context);
+    }
+#endif
+    // finish one at a time
+    for (; song < playlist->slots; song++)
+    {
+        if (playlist->artists[song] == artist)
+        {
+            count += columnarVisitMask(playlist, song, 1u, visit, context);
+        }
+    }
+    // return the count
+    return count;
+}
+
+/**
+ * Function: columnarPlay
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres
+ * Output argument: none
+ * Return: none
+ * Dependencies: columnarPrint, outputFlush, stdio.h, ctype.h
+ */
+void columnarPlay(const ColumnarPlaylist *playlist, OutputSink *sink,
+    char* genres[])
+{
+    // check if there are no songs in the playlist
+    if (playlist->head == COLUMNAR_NONE)
+    {
+        outputString(sink,
+            "Nothing to be played right now. Add songs to continue.\n");
+        outputFlush(sink);
+        return;
+    }
+    ColumnarPlayer player = { sink, genres };
+    // follow the links from the head
+    int count = 0;
+    for (uint32_t song = playlist->head; song != COLUMNAR_NONE;
+        song = playlist->next[song])
+    {
+        // print the song
+        columnarPrint(playlist, song, &player);
+        // check in with the user every MAX_SONGS songs
+        if (++count == MAX_SONGS && playlist->next[song] != COLUMNAR_NONE)
+        {
+            char answer = 0;
+            // the songs so far must show before the question does
+            outputFlush(sink);
+            printf("Are you still listening [Y|N]? ");
+            while (scanf(" %c", &answer) == 1 &&
+                toupper(answer) != 'Y' && toupper(answer) != 'N')
+            {
+                printf("\nI didn't get that. Please type Y to continue \
+listening or N to stop: ");
+            }
+            // stop unless they want to continue
+            if (toupper(answer) != 'Y')
+            {
+                return;
+            }
+            count = 0;
+        }
+    }
+    // hand the last songs to the destination
+    outputFlush(sink);
+}
+
+/**
+ * Function: columnarPlayByArtist
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 artist - a string with the name of the artist
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres
+ * Output argument: none
+ * Return: none
+ * Dependencies: columnarArtistFind, columnarScanArtist, outputFlush
+ */
+void columnarPlayByArtist(const ColumnarPlaylist *playlist,
+    const char *artist, OutputSink *sink, char* genres[])
+{
+    ColumnarPlayer player = { sink, genres };
+    // one string lookup turns the artist into a number
+    uint32_t number = columnarArtistFind(&playlist->artistNames, artist);
+    // then the artist column is scanned for it
+    size_t played = number == COLUMNAR_NONE ? 0 :
+        columnarScanArtist(playlist, number, columnarPrint, &player);
+    // check if the artist is not in the playlist
+    if (played == 0)
+    {
+        outputString(sink, "Nothing to be played by ");
+        outputString(sink, artist);
+        outputString(sink, " right now. Add songs to continue.\n");
+    }
+    // hand the songs to the destination
+    outputFlush(sink);
+}
+
+/**
+ * Function: columnarPlayByGenre
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 genre - the genre to play
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres
+ * Output argument: none
+ * Return: none
+ * Dependencies: columnarScanGenre, outputFlush
+ */
+void columnarPlayByGenre(const ColumnarPlaylist *playlist, Genre genre,
+    OutputSink *sink, char* genres[])
+{
+    ColumnarPlayer player = { sink, genres };
+    // scan the genre column
+    size_t played = genre < 0 || genre >= GENRE_COUNT ? 0 :
+        columnarScanGenre(playlist, (uint8_t)genre, columnarPrint, &player);
+    // check if the genre is not in the playlist
+    if (played == 0)
+    {
+        outputString(sink,
+            "Nothing to be played right now. Add songs to continue.\n");
+    }
+    // hand the songs to the destination
+    outputFlush(sink);
+}
+
+/**
+ * Function: columnarCountByArtist
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 artist - a string with the name of the artist
+ * Output argument: none
+ * Return: the number of songs by the artist
+ * Dependencies: columnarArtistFind, columnarScanArtist
+ */
+size_t columnarCountByArtist(
+    const ColumnarPlaylist *playlist, const char *artist)
+{
+    // look the artist up, then count its entries in the column
+    uint32_t number = columnarArtistFind(&playlist->artistNames, artist);
+    return number == COLUMNAR_NONE ? 0 :
+        columnarScanArtist(playlist, number, NULL, NULL);
+}
+
+/**
+ * Function: columnarCountByGenre
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 genre - the genre to count
+ * Output argument: none
+ * Return: the number of songs of the genre
+ * Dependencies: columnarScanGenre
+ */
+size_t columnarCountByGenre(const ColumnarPlaylist *playlist, Genre genre)
+{
+    // count the genre's entries in the column
+    return genre < 0 || genre >= GENRE_COUNT ? 0 :
+        columnarScanGenre(playlist, (uint8_t)genre, NULL, NULL);
+}
+
+/**
+ * Function: columnarRenumber (helper)
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 order - the old song numbers in their new order, one per
+ *                         song and without holes
+ * Output argument: every column is rebuilt in the new order, so songs are
+ *                  numbered 0 to length - 1 and linked in that order
+ * Return: true on success, false if memory ran out and nothing changed
+ * Dependencies: stdlib.h
+ */
+static bool columnarRenumber(ColumnarPlaylist *playlist,
+    const uint32_t *order)
+{
+    // gather the new columns
+    size_t length = playlist->length;
+    uint8_t *genres = (uint8_t*)malloc(playlist->capacity);
+    uint32_t *artists = (uint32_t*)malloc(
+        playlist->capacity * sizeof(uint32_t));
+    uint32_t *titles = (uint32_t*)malloc(
+        playlist->capacity * sizeof(uint32_t));
+    if (genres == NULL || artists == NULL || titles == NULL)
+    {
+        free(genres);
+        free(artists);
+        free(titles);
+        return false;
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        genres[i] = playlist->genres[order[i]];
+        artists[i] = playlist->artists[order[i]];
+        titles[i] = playlist->titles[order[i]];
+    }
+    // swap them in
+    free(playlist->genres);
+    free(playlist->artists);
+    free(playlist->titles);
+    playlist->genres = genres;
+    playlist->artists = artists;
+    playlist->titles = titles;
+    // link every song to the next number
+    for (size_t i = 0; i < length; i++)
+    {
+        playlist->next[i] = (uint32_t)(i + 1);
+    }
+    playlist->next[length - 1] = COLUMNAR_NONE;
+    // the holes are gone
+    playlist->slots = length;
+    playlist->head = 0;
+    playlist->tail = (uint32_t)(length - 1);
+    // return success
+    return true;
+}
+
+/**
+ * Function: columnarSortByGenre
+ * Input argument: playlist - a pointer to a columnar playlist
+ * Output argument: songs are renumbered in stable genre order, dropping the
+ *                  holes
+ * Return: true on success, false if memory ran out and nothing changed
+ * Dependencies: columnarRenumber, stdlib.h, stdio.h
+ *
+ * A counting sort: one pass over the genre column counts each genre, a
+ * second places each song number after the ones of its genre before it.
+ */
+bool columnarSortByGenre(ColumnarPlaylist *playlist)
+{
+    // check if no songs are in the playlist
+    if (playlist->length == 0)
+    {
+        printf("It is quiet here. Add songs to continue.\n");
+        return true;
+    }
+    // count the songs of each genre, skipping holes
+    size_t starts[GENRE_COUNT + 1] = { 0 };
+    for (size_t song = 0; song < playlist->slots; song++)
+    {
+        if (playlist->genres[song] != COLUMNAR_REMOVED)
+        {
+            starts[playlist->genres[song] + 1]++;
+        }
+    }
+    // turn the counts into the first position of each genre
+    for (int genre = 0; genre < GENRE_COUNT; genre++)
+    {
+        starts[genre + 1] += starts[genre];
+    }
+    // place each song number, in playlist order within its genre
+    uint32_t *order = (uint32_t*)malloc(playlist->length * sizeof(uint32_t));
+    if (order == NULL)
+    {
+        printf("Out of memory. Cannot sort.\n");
+        return false;
+    }
+    for (size_t song = 0; song < playlist->slots; song++)
+    {
+        if (playlist->genres[song] != COLUMNAR_REMOVED)
+        {
+            order[starts[playlist->genres[song]]++] = (uint32_t)song;
+        }
+    }
+    // rebuild the columns in that order
+    bool sorted = columnarRenumber(playlist, order);
+    free(order);
+    // print message to user
+    printf(sorted ? "Playlist will play by genre from here on!\n" :
+        "Out of memory. Cannot sort.\n");
+    return sorted;
+}
+
+/**
+ * Function: columnarReverse
+ * Input argument: playlist - a pointer to a columnar playlist
+ * Output argument: songs are renumbered in reverse order, dropping the holes
+ * Return: true on success, false if memory ran out and nothing changed
+ * Dependencies: columnarRenumber, stdlib.h
+ */
+bool columnarReverse(ColumnarPlaylist *playlist)
+{
+    // nothing to reverse in an empty playlist
+    if (playlist->length == 0)
+    {
+        return true;
+    }
+    // list the song numbers back to front, skipping holes
+    uint32_t *order = (uint32_t*)malloc(playlist->length * sizeof(uint32_t));
+    if (order == NULL)
+    {
+        return false;
+    }
+    size_t position = playlist->length;
+    for (size_t song = 0; song < playlist->slots; song++)
+    {
+        if (playlist->genres[song] != COLUMNAR_REMOVED)
+        {
+            order[--position] = (uint32_t)song;
+        }
+    }
+    // rebuild the columns in that order
+    bool reversed = columnarRenumber(playlist, order);
+    free(order);
+    return reversed;
+}
+
+/**
+ * Function: columnarRemoveSong
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 title - a string with the title of the song to remove
+ * Output argument: the first song with that title is unlinked and its
+ *                  number left as a hole
+ * Return: true if the song was removed, false if it was not found
+ * Dependencies: columnarTitle, stdio.h, string.h
+ */
+bool columnarRemoveSong(ColumnarPlaylist *playlist, const char *title)
+{
+    // walk the links, remembering the song before the current one
+    uint32_t previous = COLUMNAR_NONE;
+    uint32_t song = playlist->head;
+    while (song != COLUMNAR_NONE &&
+        strcmp(columnarTitle(playlist, song), title) != 0)
+    {
+        previous = song;
+        song = playlist->next[song];
+    }
+    // check if the title was not found
+    if (song == COLUMNAR_NONE)
+    {
+        printf("Song '%s' is not in the list.\n", title);
+        return false;
+    }
+    // unlink the song
+    if (previous == COLUMNAR_NONE)
+    {
+        playlist->head = playlist->next[song];
+    }
+    else
+    {
+        playlist->next[previous] = playlist->next[song];
+    }
+    if (playlist->tail == song)
+    {
+        playlist->tail = previous;
+    }
+    // leave a hole no filter matches; its title bytes stay until freed
+    playlist->genres[song] = COLUMNAR_REMOVED;
+    playlist->artists[song] = COLUMNAR_NONE;
+    playlist->length--;
+    // return success
+    return true;
+}
@@ -0,0 +1,218 @@
+#ifndef MUSIC_COLUMNAR_H
+#define MUSIC_COLUMNAR_H
+
+// header files
+#include "music_lib.h"
+
+// global definitions
+// the next index of the tail, and the artist of a removed slot
+#define COLUMNAR_NONE UINT32_MAX
+// the genre of a removed slot, which no filter matches
+#define COLUMNAR_REMOVED 0xFF
+
+// a growable buffer of null terminated strings, addressed by offset
+typedef struct ColumnarStrings
+{
+    char *bytes;
+    size_t length;
+    size_t capacity;
+}
+ColumnarStrings;
+
+// the distinct artists of a columnar playlist, numbered from 0
+typedef struct ColumnarArtists
+{
+    // the names, and the offset of each artist's name in them
+    ColumnarStrings names;
+    uint32_t *offsets;
+    size_t count;
+    size_t capacity;
+    // open-addressing table of artist + 1, 0 for an empty slot
+    uint32_t *slots;
+    size_t mask;
+}
+ColumnarArtists;
+
+// a playlist stored column by column instead of song by song
+//
+// Song number i is described by genres[i], artists[i] and titles[i], and
+// next[i] is the number of the song after it. Songs are numbered in playlist
+// order: appends take the next number, removals leave a hole with genre
+// COLUMNAR_REMOVED, and the sort and reverse renumber the songs densely.
+// So the columns can be filtered front to back, 16 genres or 4 artists per
+// SSE2 compare, and still give songs in playlist order.
+typedef struct ColumnarPlaylist
+{
+    // the columns, one entry per song number
+    uint8_t *genres;
+    uint32_t *artists;
+    uint32_t *titles;
+    uint32_t *next;
+    // song numbers in use, holes included, and allocated
+    size_t slots;
+    size_t capacity;
+    // first and last song number, COLUMNAR_NONE when empty
+    uint32_t head;
+    uint32_t tail;
+    // number of songs, holes excluded
+    size_t length;
+    // the title text, and the artist dictionary
+    ColumnarStrings titleText;
+    ColumnarArtists artistNames;
+}
+ColumnarPlaylist;
+
+// function prototypes
+
+/**
+ * Function: columnarInit
+ * Input argument: playlist - a pointer to a columnar playlist
+ * Output argument: playlist is empty; nothing is allocated until the first
+ *                  song is added
+ * Return: none
+ * Dependencies: none
+ */
+void columnarInit(ColumnarPlaylist *playlist);
+
+/**
+ * Function: columnarFree
+ * Input argument: playlist - a pointer to a columnar playlist
+ * Output argument: every column is freed and the playlist is empty again
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void columnarFree(ColumnarPlaylist *playlist);
+
+/**
+ * Function: columnarAddSong
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 title - a string with the title of the song
+ *                 artist - a string with the artist of the song
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song is appended after the tail
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: stdlib.h, stdio.h, string.h
+ */
+bool columnarAddSong(ColumnarPlaylist *playlist, const char *title,
+    const char *artist, Genre genre);
+
+/**
+ * Function: columnarFromPlaylist
+ * Input argument: playlist - a pointer to an empty columnar playlist
+ *                 songs - a pointer to the playlist handle to copy
+ * Output argument: playlist holds the same songs in the same order
+ * Return: true on success, false if memory ran out
+ * Dependencies: columnarAddSong
+ */
+bool columnarFromPlaylist(ColumnarPlaylist *playlist, const Playlist *songs);
+
+/**
+ * Function: columnarTitle
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 song - a song number
+ * Output argument: none
+ * Return: the song's title
+ * Dependencies: none
+ */
+const char *columnarTitle(const ColumnarPlaylist *playlist, uint32_t song);
+
+/**
+ * Function: columnarArtist
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 song - a song number
+ * Output argument: none
+ * Return: the song's artist
+ * Dependencies: none
+ */
+const char *columnarArtist(const ColumnarPlaylist *playlist, uint32_t song);
+
+/**
+ * Function: columnarPlay
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres
+ * Output argument: none
+ * Return: none
+ * Dependencies: outputPlaying, outputFlush, stdio.h
+ */
+void columnarPlay(const ColumnarPlaylist *playlist, OutputSink *sink,
+    char* genres[]);
+
+/**
+ * Function: columnarPlayByArtist
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 artist - a string with the name of the artist
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres
+ * Output argument: none
+ * Return: none
+ * Dependencies: outputPlaying, outputFlush, emmintrin.h
+ */
+void columnarPlayByArtist(const ColumnarPlaylist *playlist,
+    const char *artist, OutputSink *sink, char* genres[]);
+
+/**
+ * Function: columnarPlayByGenre
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 genre - the genre to play
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres
+ * Output argument: none
+ * Return: none
+ * Dependencies: outputPlaying, outputFlush, emmintrin.h
+ */
+void columnarPlayByGenre(const ColumnarPlaylist *playlist, Genre genre,
+    OutputSink *sink, char* genres[]);
+
+/**
+ * Function: columnarCountByArtist
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 artist - a string with the name of the artist
+ * Output argument: none
+ * Return: the number of songs by the artist
+ * Dependencies: emmintrin.h
+ */
+size_t columnarCountByArtist(
+    const ColumnarPlaylist *playlist, const char *artist);
+
+/**
+ * Function: columnarCountByGenre
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 genre - the genre to count
+ * Output argument: none
+ * Return: the number of songs of the genre
+ * Dependencies: emmintrin.h
+ */
+size_t columnarCountByGenre(const ColumnarPlaylist *playlist, Genre genre);
+
+/**
+ * Function: columnarSortByGenre
+ * Input argument: playlist - a pointer to a columnar playlist
+ * Output argument: songs are renumbered in stable genre order, dropping the
+ *                  holes
+ * Return: true on success, false if memory ran out and nothing changed
+ * Dependencies: stdlib.h, stdio.h
+ */
+bool columnarSortByGenre(ColumnarPlaylist *playlist);
+
+/**
+ * Function: columnarReverse
+ * Input argument: playlist - a pointer to a columnar playlist
+ * Output argument: songs are renumbered in reverse order, dropping the holes
+ * Return: true on success, false if memory ran out and nothing changed
+ * Dependencies: stdlib.h
+ */
+bool columnarReverse(ColumnarPlaylist *playlist);
+
+/**
+ * Function: columnarRemoveSong
+ * Input argument: playlist - a pointer to a columnar playlist
+ *                 title - a string with the title of the song to remove
+ * Output argument: the first song with that title is unlinked and its
+ *                  number left as a hole
+ * Return: true if the song was removed, false if it was not found
+ * Dependencies: stdio.h, string.h
+ */
+bool columnarRemoveSong(ColumnarPlaylist *playlist, const char *title);
+
+#endif // MUSIC_COLUMNAR_H
@@ -0,0 +1,486 @@
+// header files
+#include "music_lib.h"
+#include "music_artist.h"
+#include "music_cursor.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <pthread.h>
+
+// how many malformed rows are reported one by one before only counting
+#define CSV_MAX_REPORTS 20
+// the most threads a load will start
+#define CSV_MAX_THREADS 64
+// chunks smaller than this are not worth a thread of their own
+#define CSV_MIN_CHUNK (256 * 1024)
+
+// a malformed row, held until it can be printed in file order
+typedef struct CsvProblem
+{
+    // the line number, counted from the start of its chunk
+    size_t line;
+    // why the row was skipped
+    const char *reason;
+}
+CsvProblem;
+
+// one slice of the file and the songs parsed from it
+typedef struct CsvChunk
+{
+    // the first byte of the chunk, at the start of a line
+    const char *start;
+    // one past the last byte, just after a newline or at the end of file
+    const char *end;
+    // the chunk's songs, in a pool of their own and without indexes
+    Playlist songs;
+    // the chunk's artists, interned without taking the pool lock per row
+    ArtistCache artists;
+    // the number of lines in the chunk
+    size_t lines;
+    // the number of malformed rows in the chunk
+    size_t malformed;
+    // the first few of them
+    CsvProblem problems[CSV_MAX_REPORTS];
+}
+CsvChunk;
+
+/**
+ * Function: csvReport (helper)
+ * Input argument: chunk - the chunk being parsed
+ *                 reason - why the current row was skipped
+ * Output argument: the row is counted, and kept while under the cap
+ * Return: void
+ * Dependencies: none
+ */
+static void csvReport(CsvChunk *chunk, const char *reason)
+{
+    // keep the first few rows with their line number
+    if (chunk->malformed < CSV_MAX_REPORTS)
+    {
+        chunk->problems[chunk->malformed].line = chunk->lines;
+        chunk->problems[chunk->malformed].reason = reason;
+    }
+    // count every one for the summary
+    chunk->malformed++;
+}
+
+/**
+ * Function: csvIsBlank (helper)
+ * Input argument: c - the byte to test
+ * Output argument: none
+ * Return: true for the spaces and tabs allowed around a genre
+ * Dependencies: none
+ */
+static inline bool csvIsBlank(char c)
+{
+    return c == ' ' || c == '\t';
+}
+
+/**
+ * Function: csvParseGenre (helper)
+ * Input argument: start - the first byte of the field
+ *                 end - one past the last byte of the field
+ *                 genre - where to store the parsed genre
+ * Output argument: genre holds the value on success
+ * Return: true if the field is a number naming a genre, false otherwise
+ * Dependencies: none
+ */
+static bool csvParseGenre(const char *start, const char *end, Genre *genre)
+{
+    // skip leading blanks
+    while (start < end && csvIsBlank(*start))
+    {
+        start++;
+    }
+    // skip trailing blanks
+    while (end > start && csvIsBlank(end[-1]))
+    {
+        end--;
+    }
+    // there must be at least one digit
+    if (start == end)
+    {
+        return false;
+    }
+    // accumulate the digits, stopping early once out of range
+    unsigned value = 0;
+    for (const char *c = start; c < end; c++)
+    {
+        // anything but a digit makes the field malformed
+        unsigned digit = (unsigned)(*c - '0');
+        if (digit > 9)
+        {
+            return false;
+        }
+        value = value * 10 + digit;
+        // no genre is this large, and stopping here avoids overflow
+        if (value >= GENRE_COUNT)
+        {
+            return false;
+        }
+    }
+    // store the genre
+    *genre = (Genre)value;
+    return true;
+}
+
+/**
+ * Function: csvParseRow (helper)
+ * Input argument: chunk - the chunk being parsed
+ *                 start - the first byte of the row
+ *                 end - one past the last byte, without the newline
+ * Output argument: the song is appended, or the row is reported
+ * Return: void
+ * Dependencies: memchr, csvParseGenre, csvReport, artistCacheIntern,
+ *               playlistAppendInterned
+ */
+static void csvParseRow(CsvChunk *chunk, const char *start, const char *end)
+{
+    // the title runs up to the first comma
+    const char *titleEnd = memchr(start, ',', (size_t)(end - start));
+    if (titleEnd == NULL)
+    {
+        csvReport(chunk, "expected 3 fields, found 1");
+        return;
+    }
+    // the artist runs up to the second comma
+    const char *artist = titleEnd + 1;
+    const char *artistEnd = memchr(artist, ',', (size_t)(end - artist));
+    if (artistEnd == NULL)
+    {
+        csvReport(chunk, "expected 3 fields, found 2");
+        return;
+    }
+    // the genre is the rest of the row, which must not hold another comma
+    const char *genreStart = artistEnd + 1;
+    if (memchr(genreStart, ',', (size_t)(end - genreStart)) != NULL)
+    {
+        csvReport(chunk, "expected 3 fields, found more");
+        return;
+    }
+    // measure the strings
+    size_t titleLength = (size_t)(titleEnd - start);
+    size_t artistLength = (size_t)(artistEnd - artist);
+    // both strings must be present
+    if (titleLength == 0 || artistLength == 0)
+    {
+        csvReport(chunk, "empty title or artist");
+        return;
+    }
+    // titles may be any length, artists must fit in the artist pool
+    if (titleLength >= UINT32_MAX)
+    {
+        csvReport(chunk, "title too long");
+        return;
+    }
+    if (artistLength >= STR_LEN)
+    {
+        csvReport(chunk, "artist too long");
+        return;
+    }
+    // the genre must be one of the enum values
+    Genre genre;
+    if (!csvParseGenre(genreStart, end, &genre))
+    {
+        csvReport(chunk, "invalid genre");
+        return;
+    }
+    // turn the artist into a number through the chunk's cache
+    uint32_t id = artistCacheIntern(&chunk->artists, artist, artistLength);
+    if (id == ARTIST_NONE)
+    {
+        printf("Out of memory. Song not added.\n");
+        return;
+    }
+    // copy the title straight from the mapping into a new song
+    if (!playlistAppendInterned(&chunk->songs, start, titleLength, id, genre))
+    {
+        // give the artist reference back if the song was not added
+        artistCacheDrop(&chunk->artists, id);
+    }
+}
+
+/**
+ * Function: csvParseChunk (helper)
+ * Input argument: argument - a pointer to the CsvChunk to parse
+ * Output argument: the chunk's songs, line count and problems are filled in
+ * Return: NULL, as a pthread start routine
+ * Dependencies: csvParseRow, artistCacheFlush, string.h
+ */
+static void *csvParseChunk(void *argument)
+{
+    // create pointers to the chunk and its unread bytes
+    CsvChunk *chunk = (CsvChunk*)argument;
+    const char *current = chunk->start;
+    // parse one line per iteration, including a last line with no newline
+    while (current < chunk->end)
+    {
+        chunk->lines++;
+        // find the end of the line
+        const char *newline = memchr(current, '\n',
+            (size_t)(chunk->end - current));
+        const char *lineEnd = newline != NULL ? newline : chunk->end;
+        // drop the carriage return of a CRLF file
+        const char *rowEnd = lineEnd;
+        if (rowEnd > current && rowEnd[-1] == '\r')
+        {
+            rowEnd--;
+        }
+        // blank lines are not rows
+        if (rowEnd > current)
+        {
+            csvParseRow(chunk, current, rowEnd);
+        }
+        // move past the newline
+        current = lineEnd + 1;
+    }
+    // hand the references counted by the cache to the shared pool
+    artistCacheFlush(&chunk->artists);
+    // nothing to hand back
+    return NULL;
+}
+
+/**
+ * Function: csvSplit (helper)
+ * Input argument: chunks - the chunks to fill in
+ *                 count - the number of chunks
+ *                 start - the first byte after the header
+ *                 end - one past the last byte of the file
+ * Output argument: the bytes are divided into count chunks of about the
+ *                  same size, each ending just after a newline
+ * Return: none
+ * Dependencies: artistCacheInit, string.h
+ */
+static void csvSplit(CsvChunk *chunks, int count, const char *start,
+    const char *end)
+{
+    // create variable to hold the next chunk's start
+    const char *boundary = start;
+    for (int k = 0; k < count; k++)
+    {
+        // each chunk starts where the last one ended
+        chunks[k].start = boundary;
+        // aim for an even share, then move on to the next newline
+        const char *target = start + (size_t)(end - start) * (k + 1) / count;
+        if (target < boundary)
+        {
+            target = boundary;
+        }
+        const char *newline = target < end ?
+            memchr(target, '\n', (size_t)(end - target)) : NULL;
+        // the last chunk, or one with no newline left, runs to the end
+        boundary = k == count - 1 || newline == NULL ? end : newline + 1;
+        chunks[k].end = boundary;
+        // the chunk's songs stay unindexed until they are spliced
+        playlistInit(&chunks[k].songs);
+        chunks[k].songs.indexed = false;
+        // and its artist cache starts empty
+        artistCacheInit(&chunks[k].artists);
+    }
+}
+
+/**
+ * Function: csvThreadCount (helper)
+ * Input argument: threads - the requested number of threads, 0 for automatic
+ *                 bytes - the number of bytes to parse
+ * Output argument: none
+ * Return: the number of chunks to split the file into, at least 1
+ * Dependencies: unistd.h
+ */
+static int csvThreadCount(int threads, size_t bytes)
+{
+    // default to one thread per online processor
+    if (threads <= 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    // cap the count
+    if (threads > CSV_MAX_THREADS)
+    {
+        threads = CSV_MAX_THREADS;
+    }
+    // keep every chunk big enough to be worth its thread
+    size_t useful = bytes / CSV_MIN_CHUNK;
+    if ((size_t)threads > useful)
+    {
+        threads = useful > 0 ? (int)useful : 1;
+    }
+    // return the count
+    return threads;
+}
+
+/**
+ * Function: playlistLoad
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 filename - the path of the CSV file to read
+ * Output argument: songs from the file are appended to the playlist;
+ *                  malformed rows are skipped and reported with their line
+ * Return: true if the playlist is successfully loaded, false if errors occur
+ * Dependencies: playlistLoadThreads
+ */
+bool playlistLoad(Playlist *playlist, const char *filename)
+{
+    // parse on the calling thread
+    return playlistLoadThreads(playlist, filename, 1);
+}
+
+/**
+ * Function: playlistLoadThreads
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 filename - the path of the CSV file to read
+ *                 threads - how many threads parse the file, 0 for one per
+ *                           online processor
+ * Output argument: songs from the file are appended to the playlist in file
+ *                  order; malformed rows are skipped and reported with their
+ *                  line
+ * Return: true if the playlist is successfully loaded, false if errors occur
+ * Dependencies: csvThreadCount, csvSplit, csvParseChunk, songPoolAdopt,
+ *               playlistStraighten, cursorsAppended, playlistRebuildIndexes,
+ *               pthread.h, sys/mman.h, string.h
+ *
+ * The file is memory mapped and parsed in place: memchr finds the commas
+ * and newlines, and fields are copied once, straight into the songs. The
+ * rows are split at newlines into one chunk per thread; each thread builds
+ * its chunk's songs in a pool of its own, and the chunks are spliced in file
+ * order afterwards, so the result is the same for any number of threads.
+ */
+bool playlistLoadThreads(
+    Playlist *playlist, const char *filename, int threads)
+{
+    // open the file
+    int fd = open(filename, O_RDONLY);
+    // if the file could not be open
+    if (fd < 0)
+    {
+        // print a message
+        printf("Could not open file %s\n", filename);
+        // end the function with an error code
+        return false;
+    }
+    // find out how much to map
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        // an empty or unreadable file has no header, so it is an error
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)info.st_size;
+    // map the whole file; the descriptor is no longer needed afterwards
+    const char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        printf("Could not map file %s\n", filename);
+        return false;
+    }
+    // the file is read once, front to back
+    madvise((void *)data, size, MADV_SEQUENTIAL);
+
+    // skip the header line
+    const char *end = data + size;
+    const char *newline = memchr(data, '\n', size);
+    const char *rows = newline != NULL ? newline + 1 : end;
+    // split the rows into chunks
+    int count = csvThreadCount(threads, (size_t)(end - rows));
+    CsvChunk *chunks = (CsvChunk*)calloc((size_t)count, sizeof(CsvChunk));
+    pthread_t *workers = (pthread_t*)calloc((size_t)count, sizeof(pthread_t));
+    bool *started = (bool*)calloc((size_t)count, sizeof(bool));
+    if (chunks == NULL || workers == NULL || started == NULL)
+    {
+        free(chunks);
+        free(workers);
+        free(started);
+        munmap((void *)data, size);
+        printf("Memory allocation failed.\n");
+        return false;
+    }
+    csvSplit(chunks, count, rows, end);
+    // hand every chunk but the first to a thread of its own
+    for (int k = 1; k < count; k++)
+    {
+        started[k] = pthread_create(&workers[k], NULL, csvParseChunk,
+            &chunks[k]) == 0;
+    }
+    // parse the first chunk here, and any chunk whose thread did not start
+    for (int k = 0; k < count; k++)
+    {
+        if (!started[k])
+        {
+            csvParseChunk(&chunks[k]);
+        }
+    }
+    // wait for the threads
+    for (int k = 1; k < count; k++)
+    {
+        if (started[k])
+        {
+            pthread_join(workers[k], NULL);
+        }
+    }
+    // every byte has been copied out of the mapping
+    munmap((void *)data, size);
+
+    // the chunks are linked after the tail, so the links must run in play
+    // order first
+    playlistStraighten(playlist);
+    // the header is line 1, so chunk lines count on from there
+    size_t line = 1;
+    size_t malformed = 0;
+    // splice the chunks in file order and report their problems in order
+    for (int k = 0; k < count; k++)
+    {
+        // print the chunk's problems while under the overall cap
+        size_t kept = chunks[k].malformed < CSV_MAX_REPORTS ?
+            chunks[k].malformed : CSV_MAX_REPORTS;
+        for (size_t p = 0; p < kept && malformed + p < CSV_MAX_REPORTS; p++)
+        {
+            printf("%s:%zu: %s. Row skipped.\n", filename,
+                line + chunks[k].problems[p].line, chunks[k].problems[p].reason);
+        }
+        malformed += chunks[k].malformed;
+        line += chunks[k].lines;
+        // the chunk's songs now belong to the playlist's pool
+        Playlist *songs = &chunks[k].songs;
+        songPoolAdopt(&playlist->pool, &songs->pool);
+        // link its songs after the tail
+        if (songs->length > 0)
+        {
+            // cursors that played every song go on with these
+            cursorsAppended(playlist, songs->head);
+            if (playlist->head == NULL)
+            {
+                playlist->head = songs->head;
+            }
+            else
+            {
+                playlist->tail->next = songs->head;
+                songs->head->prev = playlist->tail;
+            }
+            playlist->tail = songs->tail;
+            playlist->length += songs->length;
+        }
+    }
+    // close the playlist again if it was circular
+    if (playlist->circular && playlist->tail != NULL)
+    {
+        playlist->tail->next = playlist->head;
+        playlist->head->prev = playlist->tail;
+    }
+    free(chunks);
+    free(workers);
+    free(started);
+    // index the new songs along with the old ones
+    playlistRebuildIndexes(playlist);
+    // summarize the skipped rows
+    if (malformed > 0)
+    {
+        printf("%s: skipped %zu malformed row%s.\n", filename, malformed,
+            malformed == 1 ? "" : "s");
+    }
+    // return success
+    return true;
+}
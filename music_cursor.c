@@ -0,0 +1,325 @@
+// header files
+#include "music_cursor.h"
+#include "music_artist.h"
+
+/**
+ * Function: cursorOpen
+ * Input argument: cursor - a pointer to a cursor
+ *                 playlist - a pointer to the playlist handle to walk
+ * Output argument: cursor is on the first song in play order, or past the
+ *                  end of an empty playlist, and registered with playlist
+ * Return: none
+ * Dependencies: playlistFirst
+ */
+void cursorOpen(PlaylistCursor *cursor, Playlist *playlist)
+{
+    // start at the first song, which is position 0 whatever was edited
+    cursor->playlist = playlist;
+    cursor->song = playlistFirst(playlist);
+    cursor->position = 0;
+    cursor->generation = playlist->generation;
+    // put the cursor at the front of the playlist's cursors
+    cursor->nextCursor = playlist->cursors;
+    playlist->cursors = cursor;
+}
+
+/**
+ * Function: cursorClose
+ * Input argument: cursor - a pointer to an open cursor
+ * Output argument: cursor is no longer registered with its playlist
+ * Return: none
+ * Dependencies: none
+ */
+void cursorClose(PlaylistCursor *cursor)
+{
+    // find the link that points at the cursor and skip it
+    PlaylistCursor **link = &cursor->playlist->cursors;
+    while (*link != NULL && *link != cursor)
+    {
+        link = &(*link)->nextCursor;
+    }
+    if (*link == cursor)
+    {
+        *link = cursor->nextCursor;
+    }
+    // the cursor no longer walks anything
+    cursor->playlist = NULL;
+    cursor->song = NULL;
+    cursor->nextCursor = NULL;
+}
+
+/**
+ * Function: cursorNext
+ * Input argument: cursor - a pointer to an open cursor
+ * Output argument: cursor moves past the song it was on; a circular
+ *                  playlist wraps around to its first song
+ * Return: the song the cursor was on, or NULL past the last song of a
+ *         linear or empty playlist
+ * Dependencies: playlistFirst, playlistLast, playlistNext
+ */
+Song *cursorNext(PlaylistCursor *cursor)
+{
+    Playlist *playlist = cursor->playlist;
+    Song *song = cursor->song;
+    // check if the cursor is past the last song
+    if (song == NULL)
+    {
+        // a linear playlist has nothing more to play
+        if (!playlist->circular || playlist->head == NULL)
+        {
+            return NULL;
+        }
+        // a circular one starts over
+        song = playlistFirst(playlist);
+        cursor->position = 0;
+        cursor->generation = playlist->generation;
+    }
+    // step past the song
+    cursor->song = playlistNext(playlist, song);
+    // after the last song the position is known outright
+    if (song == playlistLast(playlist))
+    {
+        cursor->position = playlist->circular ? 0 : playlist->length;
+        cursor->generation = playlist->generation;
+    }
+    // otherwise it moves up by one, if it was known
+    else if (cursor->generation == playlist->generation)
+    {
+        cursor->position++;
+    }
+    // return the song that was current
+    return song;
+}
+
+/**
+ * Function: cursorPrevious
+ * Input argument: cursor - a pointer to an open cursor
+ * Output argument: cursor moves back by one song; a circular playlist wraps
+ *                  around to its last song
+ * Return: the song the cursor moved back to, which cursorNext returns next,
+ *         or NULL on the first song of a linear or empty playlist
+ * Dependencies: playlistFirst, playlistLast, playlistPrevious
+ */
+Song *cursorPrevious(PlaylistCursor *cursor)
+{
+    Playlist *playlist = cursor->playlist;
+    Song *song = cursor->song;
+    // from past the end, or around from the first song of a circular
+    // playlist, the cursor lands on the last song
+    bool toLast = song == NULL ||
+        (song == playlistFirst(playlist) && playlist->circular);
+    Song *back = toLast ? playlistLast(playlist) :
+        playlistPrevious(playlist, song);
+    // the first song of a linear playlist, or an empty one, has none before
+    if (back == NULL)
+    {
+        return NULL;
+    }
+    cursor->song = back;
+    // the last song's position is known outright
+    if (toLast)
+    {
+        cursor->position = playlist->length - 1;
+        cursor->generation = playlist->generation;
+    }
+    // otherwise it moves down by one, if it was known
+    else if (cursor->generation == playlist->generation)
+    {
+        cursor->position--;
+    }
+    // return the song the cursor is on now
+    return back;
+}
+
+/**
+ * Function: cursorSeek
+ * Input argument: cursor - a pointer to an open cursor
+ *                 position - a place in play order, the length for past the
+ *                            last song
+ * Output argument: cursor is on the song at that position
+ * Return: true on success, false if position is beyond the length
+ * Dependencies: playlistSongAt
+ *
+ * O(log N) expected through the playlist's order index.
+ */
+bool cursorSeek(PlaylistCursor *cursor, size_t position)
+{
+    Playlist *playlist = cursor->playlist;
+    // there is nothing beyond the end
+    if (position > playlist->length)
+    {
+        return false;
+    }
+    // the position is known now, and the song there too
+    cursor->song = playlistSongAt(playlist, position);
+    cursor->position = position;
+    cursor->generation = playlist->generation;
+    // return success
+    return true;
+}
+
+/**
+ * Function: cursorPosition
+ * Input argument: cursor - a pointer to an open cursor
+ * Output argument: the cached position is refreshed if edits made it stale
+ * Return: the place in play order of the song the cursor is on, or the
+ *         length past the last song
+ * Dependencies: playlistPosition
+ *
+ * O(1), except after an edit that renumbered songs, where it asks the
+ * playlist's order index once, in O(log N) expected.
+ */
+size_t cursorPosition(PlaylistCursor *cursor)
+{
+    Playlist *playlist = cursor->playlist;
+    // check if an edit renumbered the songs since the position was known
+    if (cursor->generation != playlist->generation)
+    {
+        // ask the playlist, except past the end, which is always the length
+        cursor->position = cursor->song != NULL ?
+            playlistPosition(playlist, cursor->song) : playlist->length;
+        cursor->generation = playlist->generation;
+    }
+    // return the position
+    return cursor->position;
+}
+
+/**
+ * Function: cursorFill
+ * Input argument: cursor - a pointer to an open cursor
+ *                 songs - an array to fill with songs in play order
+ *                 max - the number of elements songs can hold
+ * Output argument: songs holds the next songs, and cursor is past them
+ * Return: the number of songs written, below max only at the end of a
+ *         linear playlist
+ * Dependencies: cursorNext
+ */
+size_t cursorFill(PlaylistCursor *cursor, Song **songs, size_t max)
+{
+    // take songs until the array is full or the playlist ends
+    size_t count = 0;
+    while (count < max)
+    {
+        Song *song = cursorNext(cursor);
+        if (song == NULL)
+        {
+            break;
+        }
+        songs[count++] = song;
+    }
+    // return the number of songs
+    return count;
+}
+
+/**
+ * Function: cursorPlay
+ * Input argument: cursor - a pointer to an open cursor
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres. Genres are
+ *                          listed in the array according to its enum value.
+ *                          For example, "Pop" is at index genres[POP]
+ *                 max - the most songs to play
+ * Output argument: up to max songs are played from the cursor on, and
+ *                  cursor is past them, ready to resume
+ * Return: the number of songs played
+ * Dependencies: cursorNext, outputPlaying, outputFlush
+ *
+ * Never waits for input, so a caller can play in batches between other
+ * work, in circular mode too.
+ */
+size_t cursorPlay(PlaylistCursor *cursor, OutputSink *sink, char* genres[],
+    size_t max)
+{
+    // play songs until the batch is done or the playlist ends
+    size_t count = 0;
+    while (count < max)
+    {
+        Song *song = cursorNext(cursor);
+        if (song == NULL)
+        {
+            break;
+        }
+        outputPlaying(sink, songTitle(song), song->titleLength,
+            artistPoolName(song->artist), artistPoolLength(song->artist),
+            genres[song->genre]);
+        count++;
+    }
+    // hand the batch to the destination
+    outputFlush(sink);
+    // return the number of songs played
+    return count;
+}
+
+/**
+ * Function: cursorsRemoving
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 song - a song that is about to be unlinked
+ * Output argument: every cursor on the song moves on to the song after it
+ *                  in play order, or past the end if there is none
+ * Return: none
+ * Dependencies: playlistNext
+ *
+ * Called by playlist code before it unlinks a song.
+ */
+void cursorsRemoving(Playlist *playlist, const Song *song)
+{
+    // the song that takes over, never the removed song itself
+    Song *next = playlistNext(playlist, song);
+    if (next == song)
+    {
+        next = NULL;
+    }
+    // move every cursor on the song
+    for (PlaylistCursor *cursor = playlist->cursors; cursor != NULL;
+        cursor = cursor->nextCursor)
+    {
+        if (cursor->song == song)
+        {
+            cursor->song = next;
+        }
+    }
+}
+
+/**
+ * Function: cursorsAppended
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 song - the first song just added at the end of play order
+ * Output argument: every cursor past the end is on song
+ * Return: none
+ * Dependencies: none
+ *
+ * Called by playlist code after it appends songs. The position of such a
+ * cursor was the old length, which is the song's, so it stays valid.
+ */
+void cursorsAppended(Playlist *playlist, Song *song)
+{
+    // cursors that ran out of songs resume with the new ones
+    for (PlaylistCursor *cursor = playlist->cursors; cursor != NULL;
+        cursor = cursor->nextCursor)
+    {
+        if (cursor->song == NULL)
+        {
+            cursor->song = song;
+        }
+    }
+}
+
+/**
+ * Function: cursorsDetach
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: every cursor is past the end, as if the playlist were
+ *                  empty
+ * Return: none
+ * Dependencies: none
+ *
+ * Called by playlist code before it frees every song at once.
+ */
+void cursorsDetach(Playlist *playlist)
+{
+    // no cursor may keep pointing at a freed song
+    for (PlaylistCursor *cursor = playlist->cursors; cursor != NULL;
+        cursor = cursor->nextCursor)
+    {
+        cursor->song = NULL;
+    }
+}
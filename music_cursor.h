@@ -0,0 +1,168 @@
+#ifndef MUSIC_CURSOR_H
+#define MUSIC_CURSOR_H
+
+// header files
+#include "music_lib.h"
+
+// a place in a playlist's play order that playback can stop at and resume
+// from
+//
+// A cursor is registered with its playlist, so edits keep it usable: when
+// the song it is on is removed it moves on to the song that followed, and a
+// cursor past the last song moves onto a song appended after it. Its
+// position is cached and worked out again after edits that renumber songs.
+// The playlist handle must not be moved or copied while cursors are open.
+typedef struct PlaylistCursor
+{
+    // the playlist the cursor walks
+    Playlist *playlist;
+    // the song the cursor plays next, NULL past the last song
+    Song *song;
+    // the song's place in play order, the length past the last song; only
+    // valid while generation matches the playlist's
+    size_t position;
+    uint64_t generation;
+    // the next cursor open on the same playlist
+    struct PlaylistCursor *nextCursor;
+}
+PlaylistCursor;
+
+// function prototypes
+
+/**
+ * Function: cursorOpen
+ * Input argument: cursor - a pointer to a cursor
+ *                 playlist - a pointer to the playlist handle to walk
+ * Output argument: cursor is on the first song in play order, or past the
+ *                  end of an empty playlist, and registered with playlist
+ * Return: none
+ * Dependencies: playlistFirst
+ */
+void cursorOpen(PlaylistCursor *cursor, Playlist *playlist);
+
+/**
+ * Function: cursorClose
+ * Input argument: cursor - a pointer to an open cursor
+ * Output argument: cursor is no longer registered with its playlist
+ * Return: none
+ * Dependencies: none
+ */
+void cursorClose(PlaylistCursor *cursor);
+
+/**
+ * Function: cursorNext
+ * Input argument: cursor - a pointer to an open cursor
+ * Output argument: cursor moves past the song it was on; a circular
+ *                  playlist wraps around to its first song
+ * Return: the song the cursor was on, or NULL past the last song of a
+ *         linear or empty playlist
+ * Dependencies: playlistFirst, playlistLast, playlistNext
+ */
+Song *cursorNext(PlaylistCursor *cursor);
+
+/**
+ * Function: cursorPrevious
+ * Input argument: cursor - a pointer to an open cursor
+ * Output argument: cursor moves back by one song; a circular playlist wraps
+ *                  around to its last song
+ * Return: the song the cursor moved back to, which cursorNext returns next,
+ *         or NULL on the first song of a linear or empty playlist
+ * Dependencies: playlistFirst, playlistLast, playlistPrevious
+ */
+Song *cursorPrevious(PlaylistCursor *cursor);
+
+/**
+ * Function: cursorSeek
+ * Input argument: cursor - a pointer to an open cursor
+ *                 position - a place in play order, the length for past the
+ *                            last song
+ * Output argument: cursor is on the song at that position
+ * Return: true on success, false if position is beyond the length
+ * Dependencies: playlistSongAt
+ *
+ * O(log N) expected through the playlist's order index.
+ */
+bool cursorSeek(PlaylistCursor *cursor, size_t position);
+
+/**
+ * Function: cursorPosition
+ * Input argument: cursor - a pointer to an open cursor
+ * Output argument: the cached position is refreshed if edits made it stale
+ * Return: the place in play order of the song the cursor is on, or the
+ *         length past the last song
+ * Dependencies: playlistPosition
+ *
+ * O(1), except after an edit that renumbered songs, where it asks the
+ * playlist's order index once, in O(log N) expected.
+ */
+size_t cursorPosition(PlaylistCursor *cursor);
+
+/**
+ * Function: cursorFill
+ * Input argument: cursor - a pointer to an open cursor
+ *                 songs - an array to fill with songs in play order
+ *                 max - the number of elements songs can hold
+ * Output argument: songs holds the next songs, and cursor is past them
+ * Return: the number of songs written, below max only at the end of a
+ *         linear playlist
+ * Dependencies: cursorNext
+ */
+size_t cursorFill(PlaylistCursor *cursor, Song **songs, size_t max);
+
+/**
+ * Function: cursorPlay
+ * Input argument: cursor - a pointer to an open cursor
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres. Genres are
+ *                          listed in the array according to its enum value.
+ *                          For example, "Pop" is at index genres[POP]
+ *                 max - the most songs to play
+ * Output argument: up to max songs are played from the cursor on, and
+ *                  cursor is past them, ready to resume
+ * Return: the number of songs played
+ * Dependencies: cursorNext, outputPlaying, outputFlush
+ *
+ * Never waits for input, so a caller can play in batches between other
+ * work, in circular mode too.
+ */
+size_t cursorPlay(PlaylistCursor *cursor, OutputSink *sink, char* genres[],
+    size_t max);
+
+/**
+ * Function: cursorsRemoving
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 song - a song that is about to be unlinked
+ * Output argument: every cursor on the song moves on to the song after it
+ *                  in play order, or past the end if there is none
+ * Return: none
+ * Dependencies: playlistNext
+ *
+ * Called by playlist code before it unlinks a song.
+ */
+void cursorsRemoving(Playlist *playlist, const Song *song);
+
+/**
+ * Function: cursorsAppended
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 song - the first song just added at the end of play order
+ * Output argument: every cursor past the end is on song
+ * Return: none
+ * Dependencies: none
+ *
+ * Called by playlist code after it appends songs.
+ */
+void cursorsAppended(Playlist *playlist, Song *song);
+
+/**
+ * Function: cursorsDetach
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: every cursor is past the end, as if the playlist were
+ *                  empty
+ * Return: none
+ * Dependencies: none
+ *
+ * Called by playlist code before it frees every song at once.
+ */
+void cursorsDetach(Playlist *playlist);
+
+#endif // MUSIC_CURSOR_H
@@ -0,0 +1,250 @@
+// header files
+#include "music_epoch.h"
+#include <sched.h>
+#include <stdlib.h>
+
+/**
+ * Function: epochInit
+ * Input argument: domain - a pointer to an epoch domain
+ * Output argument: domain has no readers and nothing retired
+ * Return: none
+ * Dependencies: none
+ */
+void epochInit(EpochDomain *domain)
+{
+    // every slot is free and quiet
+    for (size_t i = 0; i < EPOCH_MAX_READERS; i++)
+    {
+        domain->slots[i].epoch = EPOCH_QUIET;
+        domain->slots[i].taken = 0;
+    }
+    domain->global = EPOCH_QUIET + 1;
+    // nothing is waiting to be released
+    domain->oldest = NULL;
+    domain->newest = NULL;
+    domain->pending = 0;
+}
+
+/**
+ * Function: epochFree
+ * Input argument: domain - a pointer to an epoch domain without readers
+ * Output argument: every retired item is released
+ * Return: none
+ * Dependencies: epochSynchronize
+ */
+void epochFree(EpochDomain *domain)
+{
+    // with no readers left this does not wait
+    epochSynchronize(domain);
+}
+
+/**
+ * Function: epochRegister
+ * Input argument: domain - a pointer to an epoch domain
+ * Output argument: a slot is taken for the calling reader
+ * Return: the slot number, or EPOCH_MAX_READERS if every slot is taken
+ * Dependencies: none
+ */
+size_t epochRegister(EpochDomain *domain)
+{
+    // claim the first free slot; readers may register concurrently
+    for (size_t i = 0; i < EPOCH_MAX_READERS; i++)
+    {
+        uint32_t free = 0;
+        if (__atomic_compare_exchange_n(&domain->slots[i].taken, &free, 1,
+            false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+            return i;
+        }
+    }
+    // every slot is taken
+    return EPOCH_MAX_READERS;
+}
+
+/**
+ * Function: epochUnregister
+ * Input argument: domain - a pointer to an epoch domain
+ *                 slot - a slot number from epochRegister, outside a read
+ *                        section
+ * Output argument: the slot is free for another reader
+ * Return: none
+ * Dependencies: none
+ */
+void epochUnregister(EpochDomain *domain, size_t slot)
+{
+    __atomic_store_n(&domain->slots[slot].taken, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * Function: epochEnter
+ * Input argument: domain - a pointer to an epoch domain
+ *                 slot - the reader's slot number
+ * Output argument: the reader is inside a read section; nothing it loads
+ *                  from now on is released before epochExit
+ * Return: none
+ * Dependencies: none
+ */
+void epochEnter(EpochDomain *domain, size_t slot)
+{
+    // announce the epoch, and make the announcement visible before any
+    // shared pointer is loaded; an epoch that is already stale only holds
+    // the writer back until the reader leaves
+    uint64_t epoch = __atomic_load_n(&domain->global, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&domain->slots[slot].epoch, epoch, __ATOMIC_SEQ_CST);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/**
+ * Function: epochExit
+ * Input argument: domain - a pointer to an epoch domain
+ *                 slot - the reader's slot number, inside a read section
+ * Output argument: the reader no longer holds anything it loaded
+ * Return: none
+ * Dependencies: none
+ */
+void epochExit(EpochDomain *domain, size_t slot)
+{
+    // every load of the section happens before the slot goes quiet
+    __atomic_store_n(&domain->slots[slot].epoch, EPOCH_QUIET,
+        __ATOMIC_RELEASE);
+}
+
+/**
+ * Function: epochAdvance (helper)
+ * Input argument: domain - a pointer to an epoch domain
+ * Output argument: the global epoch moves up by one if every reader inside
+ *                  a read section announced the current one
+ * Return: true if the epoch advanced, false otherwise
+ * Dependencies: none
+ */
+static bool epochAdvance(EpochDomain *domain)
+{
+    // only the writer changes the epoch
+    uint64_t global = domain->global;
+    // the writer's unpublishing stores come before reading the slots
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    for (size_t i = 0; i < EPOCH_MAX_READERS; i++)
+    {
+        uint64_t epoch = __atomic_load_n(&domain->slots[i].epoch,
+            __ATOMIC_SEQ_CST);
+        if (epoch != EPOCH_QUIET && epoch != global)
+        {
+            return false;
+        }
+    }
+    __atomic_store_n(&domain->global, global + 1, __ATOMIC_RELEASE);
+    // return success
+    return true;
+}
+
+/**
+ * Function: epochRelease (helper)
+ * Input argument: domain - a pointer to an epoch domain
+ *                 safe - items retired before this epoch are released
+ * Output argument: those items are released, oldest first
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+static void epochRelease(EpochDomain *domain, uint64_t safe)
+{
+    // the list is in epoch order, so stop at the first item still held
+    while (domain->oldest != NULL && domain->oldest->epoch < safe)
+    {
+        EpochRetired *retired = domain->oldest;
+        domain->oldest = retired->next;
+        retired->release(retired->context, retired->item);
+        free(retired);
+        domain->pending--;
+    }
+    if (domain->oldest == NULL)
+    {
+        domain->newest = NULL;
+    }
+}
+
+/**
+ * Function: epochRetire
+ * Input argument: domain - a pointer to an epoch domain
+ *                 item - memory that new readers can no longer reach
+ *                 release - frees item, called as release(context, item)
+ *                 context - passed to release
+ * Output argument: item is released once no reader can hold it, by a later
+ *                  epochCollect or epochSynchronize; if memory for the
+ *                  record ran out, after waiting for the readers right away
+ * Return: none
+ * Dependencies: epochSynchronize, stdlib.h
+ */
+void epochRetire(EpochDomain *domain, void *item,
+    void (*release)(void *context, void *item), void *context)
+{
+    EpochRetired *retired = (EpochRetired*)malloc(sizeof(EpochRetired));
+    // without a record, wait out the readers and release it now
+    if (retired == NULL)
+    {
+        epochSynchronize(domain);
+        release(context, item);
+        return;
+    }
+    // otherwise queue it behind the items retired before
+    retired->item = item;
+    retired->release = release;
+    retired->context = context;
+    retired->epoch = domain->global;
+    retired->next = NULL;
+    if (domain->newest == NULL)
+    {
+        domain->oldest = retired;
+    }
+    else
+    {
+        domain->newest->next = retired;
+    }
+    domain->newest = retired;
+    domain->pending++;
+}
+
+/**
+ * Function: epochCollect
+ * Input argument: domain - a pointer to an epoch domain
+ * Output argument: the epoch advances if every reader has caught up, and
+ *                  the items no reader can hold any more are released
+ * Return: none
+ * Dependencies: epochAdvance, epochRelease
+ *
+ * Never waits, so writers call it after every change.
+ */
+void epochCollect(EpochDomain *domain)
+{
+    // nothing to do while nothing is retired
+    if (domain->oldest == NULL)
+    {
+        return;
+    }
+    epochAdvance(domain);
+    // a reader that could hold an item retired at epoch e announced e or
+    // e + 1, so the item is free once the epoch is past e + 1
+    epochRelease(domain, domain->global - 1);
+}
+
+/**
+ * Function: epochSynchronize
+ * Input argument: domain - a pointer to an epoch domain
+ * Output argument: waits until every read section open at the call has
+ *                  ended, then releases every retired item
+ * Return: none
+ * Dependencies: epochAdvance, epochRelease, sched.h
+ */
+void epochSynchronize(EpochDomain *domain)
+{
+    // two advances push every reader of the current epoch out
+    uint64_t target = domain->global + 2;
+    while (domain->global < target)
+    {
+        if (!epochAdvance(domain))
+        {
+            sched_yield();
+        }
+    }
+    // and everything retired so far is free
+    epochRelease(domain, target - 1);
+}
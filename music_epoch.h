@@ -0,0 +1,160 @@
+#ifndef MUSIC_EPOCH_H
+#define MUSIC_EPOCH_H
+
+// header files
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// global definitions
+// readers that can be registered with one domain at a time
+#define EPOCH_MAX_READERS 64
+// bytes per cache line, so readers never share one
+#define EPOCH_CACHE_LINE 64
+// the epoch a slot holds while its reader is outside a read section
+#define EPOCH_QUIET 0
+
+// one reader's announcement, alone on its cache line
+typedef struct EpochSlot
+{
+    // the epoch the reader entered its read section in, EPOCH_QUIET outside
+    _Alignas(EPOCH_CACHE_LINE) uint64_t epoch;
+    // whether a reader has registered the slot
+    uint32_t taken;
+}
+EpochSlot;
+
+// memory that is no longer reachable for new readers, waiting until the
+// readers that might still hold it are gone
+typedef struct EpochRetired
+{
+    // what to release, and how
+    void *item;
+    void (*release)(void *context, void *item);
+    void *context;
+    // the global epoch when it was retired
+    uint64_t epoch;
+    // the next item, retired at the same epoch or later
+    struct EpochRetired *next;
+}
+EpochRetired;
+
+// epoch-based reclamation for lock-free readers
+//
+// Readers announce the global epoch when they enter a read section and
+// clear it when they leave. The writer advances the epoch only once every
+// reader inside a section has seen the current one, so memory retired at
+// epoch e is out of every reader's hands when the epoch reaches e + 2.
+// Readers never wait; writers must be serialized by the caller.
+typedef struct EpochDomain
+{
+    EpochSlot slots[EPOCH_MAX_READERS];
+    // the current epoch, starting above EPOCH_QUIET
+    uint64_t global;
+    // retired items, oldest first
+    EpochRetired *oldest;
+    EpochRetired *newest;
+    // number of retired items not yet released
+    size_t pending;
+}
+EpochDomain;
+
+// function prototypes
+
+/**
+ * Function: epochInit
+ * Input argument: domain - a pointer to an epoch domain
+ * Output argument: domain has no readers and nothing retired
+ * Return: none
+ * Dependencies: none
+ */
+void epochInit(EpochDomain *domain);
+
+/**
+ * Function: epochFree
+ * Input argument: domain - a pointer to an epoch domain without readers
+ * Output argument: every retired item is released
+ * Return: none
+ * Dependencies: epochSynchronize
+ */
+void epochFree(EpochDomain *domain);
+
+/**
+ * Function: epochRegister
+ * Input argument: domain - a pointer to an epoch domain
+ * Output argument: a slot is taken for the calling reader
+ * Return: the slot number, or EPOCH_MAX_READERS if every slot is taken
+ * Dependencies: none
+ */
+size_t epochRegister(EpochDomain *domain);
+
+/**
+ * Function: epochUnregister
+ * Input argument: domain - a pointer to an epoch domain
+ *                 slot - a slot number from epochRegister, outside a read
+ *                        section
+ * Output argument: the slot is free for another reader
+ * Return: none
+ * Dependencies: none
+ */
+void epochUnregister(EpochDomain *domain, size_t slot);
+
+/**
+ * Function: epochEnter
+ * Input argument: domain - a pointer to an epoch domain
+ *                 slot - the reader's slot number
+ * Output argument: the reader is inside a read section; nothing it loads
+ *                  from now on is released before epochExit
+ * Return: none
+ * Dependencies: none
+ */
+void epochEnter(EpochDomain *domain, size_t slot);
+
+/**
+ * Function: epochExit
+ * Input argument: domain - a pointer to an epoch domain
+ *                 slot - the reader's slot number, inside a read section
+ * Output argument: the reader no longer holds anything it loaded
+ * Return: none
+ * Dependencies: none
+ */
+void epochExit(EpochDomain *domain, size_t slot);
+
+/**
+ * Function: epochRetire
+ * Input argument: domain - a pointer to an epoch domain
+ *                 item - memory that new readers can no longer reach
+ *                 release - frees item, called as release(context, item)
+ *                 context - passed to release
+ * Output argument: item is released once no reader can hold it, by a later
+ *                  epochCollect or epochSynchronize; if memory for the
+ *                  record ran out, after waiting for the readers right away
+ * Return: none
+ * Dependencies: epochSynchronize, stdlib.h
+ */
+void epochRetire(EpochDomain *domain, void *item,
+    void (*release)(void *context, void *item), void *context);
+
+/**
+ * Function: epochCollect
+ * Input argument: domain - a pointer to an epoch domain
+ * Output argument: the epoch advances if every reader has caught up, and
+ *                  the items no reader can hold any more are released
+ * Return: none
+ * Dependencies: epochAdvance, epochRelease
+ *
+ * Never waits, so writers call it after every change.
+ */
+void epochCollect(EpochDomain *domain);
+
+/**
+ * Function: epochSynchronize
+ * Input argument: domain - a pointer to an epoch domain
+ * Output argument: waits until every read section open at the call has
+ *                  ended, then releases every retired item
+ * Return: none
+ * Dependencies: epochAdvance, epochRelease, sched.h
+ */
+void epochSynchronize(EpochDomain *domain);
+
+#endif // MUSIC_EPOCH_H
@@ -0,0 +1,878 @@
+// header files
+#include "music_lib.h"
+
+// global definitions
+#define INDEX_MIN_CAPACITY 16
+
+/**
+ * Function: indexHash (helper)
+ * Input argument: title - the title to hash
+ * Output argument: none
+ * Return: a 32-bit hash of the string
+ * Dependencies: none
+ */
+static uint32_t indexHash(const char *title)
+{
+    // FNV-1a over the bytes
+    uint32_t hash = 2166136261u;
+    for (const unsigned char *c = (const unsigned char *)title; *c; c++)
+    {
+        hash = (hash ^ *c) * 16777619u;
+    }
+    // finish with a mixer so the low bits used for slots are well spread
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+    // return the hash
+    return hash;
+}
+
+/**
+ * Function: titleIndexPlace (helper)
+ * Input argument: index - a pointer to a title index with a free slot
+ *                 entry - the entry to place, with distance set to zero
+ * Output argument: the entry is placed Robin Hood style: whenever it has
+ *                  probed further than a resident entry, they swap places and
+ *                  the resident one moves on
+ * Return: none
+ * Dependencies: none
+ */
+static void titleIndexPlace(TitleIndex *index, TitleSlot entry)
+{
+    // start at the slot the hash points at
+    size_t position = entry.hash & index->mask;
+    // probe until a free slot takes the entry being carried
+    while (index->slots[position].song != NULL)
+    {
+        // create a pointer to the resident entry
+        TitleSlot *slot = &index->slots[position];
+        // take the slot from an entry that is closer to its home
+        if (slot->distance < entry.distance)
+        {
+            TitleSlot swap = *slot;
+            *slot = entry;
+            entry = swap;
+        }
+        // move on to the next slot
+        position = (position + 1) & index->mask;
+        entry.distance++;
+    }
+    // store the entry being carried
+    index->slots[position] = entry;
+}
+
+/**
+ * Function: titleIndexResize (helper)
+ * Input argument: index - a pointer to a title index
+ *                 capacity - the new number of slots, a power of two large
+ *                            enough for every entry
+ * Output argument: the slot array is replaced and every entry placed again
+ * Return: true on success, false if memory ran out
+ * Dependencies: titleIndexPlace, stdlib.h
+ */
+static bool titleIndexResize(TitleIndex *index, size_t capacity)
+{
+    // remember the old size
+    size_t oldCapacity = index->slots == NULL ? 0 : index->mask + 1;
+    // allocate the new slots, all empty
+    TitleSlot *slots = (TitleSlot*)calloc(capacity, sizeof(TitleSlot));
+    // give up if the allocation failed
+    if (slots == NULL)
+    {
+        return false;
+    }
+    // swap in the new slots
+    TitleSlot *oldSlots = index->slots;
+    index->slots = slots;
+    index->mask = capacity - 1;
+    // place every old entry again
+    for (size_t i = 0; i < oldCapacity; i++)
+    {
+        if (oldSlots[i].song != NULL)
+        {
+            oldSlots[i].distance = 0;
+            titleIndexPlace(index, oldSlots[i]);
+        }
+    }
+    // free the old slots
+    free(oldSlots);
+    // return success
+    return true;
+}
+
+/**
+ * Function: titleIndexGrow (helper)
+ * Input argument: index - a pointer to a title index
+ * Output argument: the slot array doubles and every entry is placed again
+ * Return: true on success, false if memory ran out
+ * Dependencies: titleIndexResize
+ */
+static bool titleIndexGrow(TitleIndex *index)
+{
+    // double the capacity, starting from the minimum
+    return titleIndexResize(index, index->slots == NULL ?
+        INDEX_MIN_CAPACITY : (index->mask + 1) * 2);
+}
+
+/**
+ * Function: titleIndexSlotOf (helper)
+ * Input argument: index - a pointer to a title index
+ *                 song - an indexed song
+ * Output argument: none
+ * Return: the slot number holding the song, or the capacity if it is absent
+ * Dependencies: indexHash
+ */
+static size_t titleIndexSlotOf(const TitleIndex *index, const Song *song)
+{
+    // an empty index holds nothing
+    if (index->slots == NULL)
+    {
+        return index->mask + 1;
+    }
+    // start at the slot the title's hash points at
+    uint32_t hash = indexHash(songTitle(song));
+    size_t position = hash & index->mask;
+    // probe while entries could still belong here
+    for (uint32_t distance = 0; ; distance++)
+    {
+        // create a pointer to the slot
+        const TitleSlot *slot = &index->slots[position];
+        // Robin Hood order means the song would have been placed by now
+        if (slot->song == NULL || slot->distance < distance)
+        {
+            return index->mask + 1;
+        }
+        // stop at the song itself
+        if (slot->song == song)
+        {
+            return position;
+        }
+        // move on to the next slot
+        position = (position + 1) & index->mask;
+    }
+}
+
+/**
+ * Function: titleIndexInit
+ * Input argument: index - a pointer to a title index
+ * Output argument: index is empty; no memory is allocated until the first
+ *                  insert
+ * Return: none
+ * Dependencies: none
+ */
+void titleIndexInit(TitleIndex *index)
+{
+    // no slots yet
+    index->slots = NULL;
+    index->mask = 0;
+    // and no entries
+    index->count = 0;
+}
+
+/**
+ * Function: titleIndexFree
+ * Input argument: index - a pointer to a title index
+ * Output argument: the slots are freed and the index is empty again
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void titleIndexFree(TitleIndex *index)
+{
+    // free the slots
+    free(index->slots);
+    // leave an empty index behind
+    titleIndexInit(index);
+}
+
+/**
+ * Function: titleIndexClear
+ * Input argument: index - a pointer to a title index
+ * Output argument: every entry is removed, the slots are kept
+ * Return: none
+ * Dependencies: string.h
+ */
+void titleIndexClear(TitleIndex *index)
+{
+    // empty every slot
+    if (index->slots != NULL)
+    {
+        memset(index->slots, 0, (index->mask + 1) * sizeof(TitleSlot));
+    }
+    // no entries are left
+    index->count = 0;
+}
+
+/**
+ * Function: titleIndexInsert
+ * Input argument: index - a pointer to a title index
+ *                 song - the song to index under its title
+ * Output argument: the entry is added
+ * Return: true on success, false if the table could not grow
+ * Dependencies: titleIndexGrow, titleIndexPlace, indexHash
+ */
+bool titleIndexInsert(TitleIndex *index, Song *song)
+{
+    // keep the table at most 7/8 full, so probes stay short
+    if (index->slots == NULL || (index->count + 1) * 8 > (index->mask + 1) * 7)
+    {
+        // grow it, giving up if memory ran out
+        if (!titleIndexGrow(index))
+        {
+            return false;
+        }
+    }
+    // build the entry
+    TitleSlot entry;
+    entry.song = song;
+    entry.hash = indexHash(songTitle(song));
+    entry.distance = 0;
+    // place it
+    titleIndexPlace(index, entry);
+    // count it
+    index->count++;
+    // return success
+    return true;
+}
+
+/**
+ * Function: titleIndexReserve
+ * Input argument: index - a pointer to a title index
+ *                 count - the number of entries the index should hold
+ * Output argument: the slot array is sized so that count entries fit
+ *                  without growing again
+ * Return: true on success, false if memory ran out
+ * Dependencies: titleIndexResize
+ */
+bool titleIndexReserve(TitleIndex *index, size_t count)
+{
+    // find the smallest capacity that stays within the 7/8 load limit
+    size_t capacity = INDEX_MIN_CAPACITY;
+    while (count * 8 > capacity * 7)
+    {
+        capacity *= 2;
+    }
+    // only ever grow
+    if (index->slots != NULL && capacity <= index->mask + 1)
+    {
+        return true;
+    }
+    // rebuild the table at the new size
+    return titleIndexResize(index, capacity);
+}
+
+/**
+ * Function: titleIndexPrefetch
+ * Input argument: index - a pointer to a title index
+ *                 song - a song that is about to be inserted or looked up
+ * Output argument: the slot the song's title hashes to starts loading into
+ *                  the cache
+ * Return: none
+ * Dependencies: indexHash
+ */
+void titleIndexPrefetch(const TitleIndex *index, const Song *song)
+{
+    // there is nothing to fetch before the first insert
+    if (index->slots != NULL)
+    {
+        __builtin_prefetch(
+            &index->slots[indexHash(songTitle(song)) & index->mask], 1);
+    }
+}
+
+/**
+ * Function: titleIndexFind
+ * Input argument: index - a pointer to a title index
+ *                 title - the title to look up
+ *                 last - true for the last match in link order rather than
+ *                        the first
+ * Output argument: none
+ * Return: the first or last song with that title, or NULL
+ * Dependencies: indexHash, orderRank, string.h
+ *
+ * Duplicate titles are told apart by their rank in the playlist's order
+ * index, which only costs anything when a title has more than one song.
+ */
+Song *titleIndexFind(const TitleIndex *index, const char *title, bool last)
+{
+    // an empty index holds nothing
+    if (index->slots == NULL)
+    {
+        return NULL;
+    }
+    // start at the slot the title's hash points at
+    uint32_t hash = indexHash(title);
+    size_t position = hash & index->mask;
+    // create a pointer to the best match so far
+    const TitleSlot *found = NULL;
+    // probe while entries could still belong here, checking every duplicate
+    for (uint32_t distance = 0; ; distance++)
+    {
+        // create a pointer to the slot
+        const TitleSlot *slot = &index->slots[position];
+        // Robin Hood order means no match lies beyond this point
+        if (slot->song == NULL || slot->distance < distance)
+        {
+            break;
+        }
+        // keep the earliest, or latest, linked entry whose title matches;
+        // only duplicates need their ranks
+        if (slot->hash == hash && strcmp(songTitle(slot->song), title) == 0 &&
+            (found == NULL ||
+            (orderRank(slot->song) < orderRank(found->song)) != last))
+        {
+            found = slot;
+        }
+        // move on to the next slot
+        position = (position + 1) & index->mask;
+    }
+    // return the song, or NULL if there was no match
+    return found != NULL ? found->song : NULL;
+}
+
+/**
+ * Function: titleIndexRemove
+ * Input argument: index - a pointer to a title index
+ *                 song - an indexed song
+ * Output argument: the song's entry is removed
+ * Return: none
+ * Dependencies: titleIndexSlotOf
+ */
+void titleIndexRemove(TitleIndex *index, const Song *song)
+{
+    // find the song's slot
+    size_t position = titleIndexSlotOf(index, song);
+    // nothing to do if the song is not indexed
+    if (position > index->mask)
+    {
+        return;
+    }
+    // shift the following entries back until one is already at home, which
+    // keeps probes short without tombstones
+    size_t next = (position + 1) & index->mask;
+    while (index->slots[next].song != NULL && index->slots[next].distance > 0)
+    {
+        index->slots[position] = index->slots[next];
+        index->slots[position].distance--;
+        position = next;
+        next = (next + 1) & index->mask;
+    }
+    // the last shifted slot is free now
+    memset(&index->slots[position], 0, sizeof(TitleSlot));
+    // one entry fewer
+    index->count--;
+}
+
+/**
+ * Function: artistIndexHash (helper)
+ * Input argument: artist - the artist number to hash
+ * Output argument: none
+ * Return: a 32-bit hash of the number
+ * Dependencies: none
+ */
+static uint32_t artistIndexHash(uint32_t artist)
+{
+    // artist numbers are dense, so mix them before using the low bits
+    uint32_t hash = artist;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+    hash ^= hash >> 16;
+    // return the hash
+    return hash;
+}
+
+/**
+ * Function: artistIndexPlace (helper)
+ * Input argument: index - a pointer to an artist index with a free slot
+ *                 entry - the entry to place, with distance set to zero
+ * Output argument: the entry is placed Robin Hood style
+ * Return: none
+ * Dependencies: none
+ */
+static void artistIndexPlace(ArtistIndex *index, ArtistEntry entry)
+{
+    // start at the slot the hash points at
+    size_t position = entry.hash & index->mask;
+    // probe until a free slot takes the entry being carried
+    while (index->slots[position].first != NULL)
+    {
+        // create a pointer to the resident entry
+        ArtistEntry *slot = &index->slots[position];
+        // take the slot from an entry that is closer to its home
+        if (slot->distance < entry.distance)
+        {
+            ArtistEntry swap = *slot;
+            *slot = entry;
+            entry = swap;
+        }
+        // move on to the next slot
+        position = (position + 1) & index->mask;
+        entry.distance++;
+    }
+    // store the entry being carried
+    index->slots[position] = entry;
+}
+
+/**
+ * Function: artistIndexGrow (helper)
+ * Input argument: index - a pointer to an artist index
+ * Output argument: the slot array doubles and every entry is placed again
+ * Return: true on success, false if memory ran out
+ * Dependencies: artistIndexPlace, stdlib.h
+ */
+static bool artistIndexGrow(ArtistIndex *index)
+{
+    // double the capacity, starting from the minimum
+    size_t oldCapacity = index->slots == NULL ? 0 : index->mask + 1;
+    size_t capacity = oldCapacity == 0 ? INDEX_MIN_CAPACITY :
+        oldCapacity * 2;
+    // allocate the new slots, all empty
+    ArtistEntry *slots = (ArtistEntry*)calloc(capacity, sizeof(ArtistEntry));
+    // give up if the allocation failed
+    if (slots == NULL)
+    {
+        return false;
+    }
+    // swap in the new slots
+    ArtistEntry *oldSlots = index->slots;
+    index->slots = slots;
+    index->mask = capacity - 1;
+    // place every old entry again
+    for (size_t i = 0; i < oldCapacity; i++)
+    {
+        if (oldSlots[i].first != NULL)
+        {
+            oldSlots[i].distance = 0;
+            artistIndexPlace(index, oldSlots[i]);
+        }
+    }
+    // free the old slots
+    free(oldSlots);
+    // return success
+    return true;
+}
+
+/**
+ * Function: artistIndexSlotOf (helper)
+ * Input argument: index - a pointer to an artist index
+ *                 artist - the artist number to look up
+ *                 hash - the artist's hash
+ * Output argument: none
+ * Return: the slot number of the artist's entry, or the capacity if absent
+ * Dependencies: none
+ */
+static size_t artistIndexSlotOf(
+    const ArtistIndex *index, uint32_t artist, uint32_t hash)
+{
+    // an empty index holds nothing
+    if (index->slots == NULL)
+    {
+        return index->mask + 1;
+    }
+    // start at the slot the hash points at
+    size_t position = hash & index->mask;
+    // probe while entries could still belong here
+    for (uint32_t distance = 0; ; distance++)
+    {
+        // create a pointer to the slot
+        const ArtistEntry *slot = &index->slots[position];
+        // Robin Hood order means the artist would have been placed by now
+        if (slot->first == NULL || slot->distance < distance)
+        {
+            return index->mask + 1;
+        }
+        // stop at the artist's entry
+        if (slot->first->artist == artist)
+        {
+            return position;
+        }
+        // move on to the next slot
+        position = (position + 1) & index->mask;
+    }
+}
+
+/**
+ * Function: artistIndexInit
+ * Input argument: index - a pointer to an artist index
+ * Output argument: index is empty; no memory is allocated until the first
+ *                  append
+ * Return: none
+ * Dependencies: none
+ */
+void artistIndexInit(ArtistIndex *index)
+{
+    // no slots yet
+    index->slots = NULL;
+    index->mask = 0;
+    // and no artists
+    index->count = 0;
+}
+
+/**
+ * Function: artistIndexFree
+ * Input argument: index - a pointer to an artist index
+ * Output argument: the slots are freed and the index is empty again
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void artistIndexFree(ArtistIndex *index)
+{
+    // free the slots
+    free(index->slots);
+    // leave an empty index behind
+    artistIndexInit(index);
+}
+
+/**
+ * Function: artistIndexClear
+ * Input argument: index - a pointer to an artist index
+ * Output argument: every posting list is dropped, the slots are kept
+ * Return: none
+ * Dependencies: string.h
+ */
+void artistIndexClear(ArtistIndex *index)
+{
+    // empty every slot
+    if (index->slots != NULL)
+    {
+        memset(index->slots, 0, (index->mask + 1) * sizeof(ArtistEntry));
+    }
+    // no artists are left
+    index->count = 0;
+}
+
+/**
+ * Function: artistIndexAppend
+ * Input argument: index - a pointer to an artist index
+ *                 song - a song that is now the last of its artist in
+ *                        playlist order
+ * Output argument: the song ends its artist's posting list
+ * Return: true on success, false if the table could not grow
+ * Dependencies: artistIndexSlotOf, artistIndexGrow, artistIndexPlace
+ */
+bool artistIndexAppend(ArtistIndex *index, Song *song)
+{
+    // the song ends its posting list
+    song->artistNext = NULL;
+    // look the artist up
+    uint32_t hash = artistIndexHash(song->artist);
+    size_t position = artistIndexSlotOf(index, song->artist, hash);
+    // check if the artist already has songs
+    if (position <= index->mask)
+    {
+        // if so, link the song after the artist's last one
+        ArtistEntry *entry = &index->slots[position];
+        song->artistPrev = entry->last;
+        entry->last->artistNext = song;
+        entry->last = song;
+        entry->count++;
+        // return success
+        return true;
+    }
+    // otherwise, the artist needs a new entry; keep the table 7/8 full at most
+    if (index->slots == NULL || (index->count + 1) * 8 > (index->mask + 1) * 7)
+    {
+        // grow it, giving up if memory ran out
+        if (!artistIndexGrow(index))
+        {
+            return false;
+        }
+    }
+    // the song is the whole posting list
+    song->artistPrev = NULL;
+    ArtistEntry entry = { song, song, 1, hash, 0 };
+    // place the entry
+    artistIndexPlace(index, entry);
+    // count the artist
+    index->count++;
+    // return success
+    return true;
+}
+
+/**
+ * Function: artistIndexInsertAfter
+ * Input argument: index - a pointer to an artist index
+ *                 song - a song to add to its artist's posting list
+ *                 previous - the artist's song right before it in link
+ *                            order, or NULL if it comes first
+ * Output argument: the song is linked into its artist's posting list
+ * Return: true on success, false if the table could not grow
+ * Dependencies: artistIndexSlotOf, artistIndexAppend
+ */
+bool artistIndexInsertAfter(ArtistIndex *index, Song *song, Song *previous)
+{
+    // look the artist up
+    size_t position = artistIndexSlotOf(index, song->artist,
+        artistIndexHash(song->artist));
+    // a new artist's posting list is just the song, wherever it goes; so is
+    // one that goes after the artist's last song
+    if (position > index->mask ||
+        previous == index->slots[position].last)
+    {
+        return artistIndexAppend(index, song);
+    }
+    // otherwise, link the song between previous and the song after it
+    ArtistEntry *entry = &index->slots[position];
+    Song *next = previous != NULL ? previous->artistNext : entry->first;
+    song->artistPrev = previous;
+    song->artistNext = next;
+    next->artistPrev = song;
+    if (previous != NULL)
+    {
+        previous->artistNext = song;
+    }
+    else
+    {
+        entry->first = song;
+    }
+    entry->count++;
+    // return success
+    return true;
+}
+
+/**
+ * Function: artistIndexReverse
+ * Input argument: index - a pointer to an artist index
+ * Output argument: every posting list is turned around, to match songs
+ *                  whose links were reversed
+ * Return: none
+ * Dependencies: none
+ */
+void artistIndexReverse(ArtistIndex *index)
+{
+    // visit every artist's entry
+    for (size_t i = 0; index->slots != NULL && i <= index->mask; i++)
+    {
+        ArtistEntry *entry = &index->slots[i];
+        if (entry->first == NULL)
+        {
+            continue;
+        }
+        // swap the links of each song in the posting list
+        for (Song *song = entry->first; song != NULL; )
+        {
+            Song *next = song->artistNext;
+            song->artistNext = song->artistPrev;
+            song->artistPrev = next;
+            song = next;
+        }
+        // and the ends of the list
+        Song *first = entry->first;
+        entry->first = entry->last;
+        entry->last = first;
+    }
+}
+
+/**
+ * Function: artistIndexRemove
+ * Input argument: index - a pointer to an artist index
+ *                 song - an indexed song
+ * Output argument: the song is unlinked from its posting list in O(1), and
+ *                  the artist's entry is dropped with its last song
+ * Return: none
+ * Dependencies: artistIndexSlotOf
+ */
+void artistIndexRemove(ArtistIndex *index, Song *song)
+{
+    // find the artist's entry
+    size_t position = artistIndexSlotOf(index, song->artist,
+        artistIndexHash(song->artist));
+    // nothing to do if the artist is not indexed
+    if (position > index->mask)
+    {
+        return;
+    }
+    // create a pointer to the entry
+    ArtistEntry *entry = &index->slots[position];
+    // check if this was the artist's only song
+    if (entry->count == 1)
+    {
+        // if so, shift the following entries back until one is at home
+        size_t next = (position + 1) & index->mask;
+        while (index->slots[next].first != NULL &&
+            index->slots[next].distance > 0)
+        {
+            index->slots[position] = index->slots[next];
+            index->slots[position].distance--;
+            position = next;
+            next = (next + 1) & index->mask;
+        }
+        // the last shifted slot is free now
+        memset(&index->slots[position], 0, sizeof(ArtistEntry));
+        // one artist fewer
+        index->count--;
+        // done
+        return;
+    }
+    // otherwise, bypass the song in the posting list
+    if (song->artistPrev != NULL)
+    {
+        song->artistPrev->artistNext = song->artistNext;
+    }
+    else
+    {
+        entry->first = song->artistNext;
+    }
+    if (song->artistNext != NULL)
+    {
+        song->artistNext->artistPrev = song->artistPrev;
+    }
+    else
+    {
+        entry->last = song->artistPrev;
+    }
+    // one song fewer
+    entry->count--;
+}
+
+/**
+ * Function: artistIndexFind
+ * Input argument: index - a pointer to an artist index
+ *                 artist - the artist number to look up
+ * Output argument: none
+ * Return: the artist's posting list, or NULL if the artist has no songs
+ * Dependencies: artistIndexSlotOf
+ */
+const ArtistEntry *artistIndexFind(const ArtistIndex *index, uint32_t artist)
+{
+    // look the artist up
+    size_t position = artistIndexSlotOf(index, artist,
+        artistIndexHash(artist));
+    // return the entry, or NULL if it is absent
+    return position <= index->mask ? &index->slots[position] : NULL;
+}
+
+/**
+ * Function: genreChainInit
+ * Input argument: chain - a pointer to a genre chain
+ * Output argument: chain holds no songs
+ * Return: none
+ * Dependencies: none
+ */
+void genreChainInit(GenreChain *chain)
+{
+    chain->first = NULL;
+    chain->last = NULL;
+    chain->count = 0;
+}
+
+/**
+ * Function: genreChainAppend
+ * Input argument: chain - a pointer to the chain of the song's genre
+ *                 song - a song that is now the last of its genre in link
+ *                        order
+ * Output argument: the song ends the chain in O(1)
+ * Return: none
+ * Dependencies: none
+ */
+void genreChainAppend(GenreChain *chain, Song *song)
+{
+    // link the song after the genre's last one, if it has any
+    song->genreNext = NULL;
+    song->genrePrev = chain->last;
+    if (chain->last != NULL)
+    {
+        chain->last->genreNext = song;
+    }
+    else
+    {
+        chain->first = song;
+    }
+    chain->last = song;
+    // one song more
+    chain->count++;
+}
+
+/**
+ * Function: genreChainInsertAfter
+ * Input argument: chain - a pointer to the chain of the song's genre
+ *                 song - a song to add to the chain
+ *                 previous - the genre's song right before it in link order,
+ *                            or NULL if it comes first
+ * Output argument: the song is linked into the chain in O(1)
+ * Return: none
+ * Dependencies: genreChainAppend
+ */
+void genreChainInsertAfter(GenreChain *chain, Song *song, Song *previous)
+{
+    // a song after the genre's last one ends the chain, which also covers
+    // the first song of an empty chain
+    if (previous == chain->last)
+    {
+        genreChainAppend(chain, song);
+        return;
+    }
+    // otherwise, link the song between previous and the song after it
+    Song *next = previous != NULL ? previous->genreNext : chain->first;
+    song->genrePrev = previous;
+    song->genreNext = next;
+    next->genrePrev = song;
+    if (previous != NULL)
+    {
+        previous->genreNext = song;
+    }
+    else
+    {
+        chain->first = song;
+    }
+    // one song more
+    chain->count++;
+}
+
+/**
+ * Function: genreChainReverse
+ * Input argument: chain - a pointer to a genre chain
+ * Output argument: the chain is turned around, to match songs whose links
+ *                  were reversed
+ * Return: none
+ * Dependencies: none
+ */
+void genreChainReverse(GenreChain *chain)
+{
+    // swap the links of each song in the chain
+    for (Song *song = chain->first; song != NULL; )
+    {
+        Song *next = song->genreNext;
+        song->genreNext = song->genrePrev;
+        song->genrePrev = next;
+        song = next;
+    }
+    // and the ends of the chain
+    Song *first = chain->first;
+    chain->first = chain->last;
+    chain->last = first;
+}
+
+/**
+ * Function: genreChainRemove
+ * Input argument: chain - a pointer to the chain of the song's genre
+ *                 song - a song in the chain
+ * Output argument: the song is unlinked from the chain in O(1)
+ * Return: none
+ * Dependencies: none
+ */
+void genreChainRemove(GenreChain *chain, Song *song)
+{
+    // bypass the song from both neighbours, or from the chain's ends
+    if (song->genrePrev != NULL)
+    {
+        song->genrePrev->genreNext = song->genreNext;
+    }
+    else
+    {
+        chain->first = song->genreNext;
+    }
+    if (song->genreNext != NULL)
+    {
+        song->genreNext->genrePrev = song->genrePrev;
+    }
+    else
+    {
+        chain->last = song->genrePrev;
+    }
+    // one song fewer
+    chain->count--;
+}
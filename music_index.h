@@ -0,0 +1,308 @@
+#ifndef MUSIC_INDEX_H
+#define MUSIC_INDEX_H
+
+// header files
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// global definitions
+// how many songs ahead bulk inserts prefetch their title slots
+#define INDEX_PREFETCH_DISTANCE 16
+
+// one slot of the open-addressing table
+typedef struct TitleSlot
+{
+    // the indexed song, or NULL for an empty slot
+    struct Song *song;
+    // the title's hash, checked before comparing strings
+    uint32_t hash;
+    // distance from the slot the hash points at
+    uint32_t distance;
+}
+TitleSlot;
+
+// Robin Hood hash table from titles to songs
+typedef struct TitleIndex
+{
+    // the slots, a power of two of them
+    TitleSlot *slots;
+    // capacity - 1, for masking hashes into slot numbers
+    size_t mask;
+    // number of occupied slots
+    size_t count;
+}
+TitleIndex;
+
+// one artist's posting list, linked through the songs' artist links
+typedef struct ArtistEntry
+{
+    // the artist's first song in link order, or NULL for an empty slot;
+    // its artist field is the entry's key
+    struct Song *first;
+    // the artist's last song in link order
+    struct Song *last;
+    // number of songs by the artist
+    size_t count;
+    // the hash of the artist's number
+    uint32_t hash;
+    // distance from the slot the hash points at
+    uint32_t distance;
+}
+ArtistEntry;
+
+// Robin Hood hash table from artist numbers to posting lists
+typedef struct ArtistIndex
+{
+    // the slots, a power of two of them
+    ArtistEntry *slots;
+    // capacity - 1, for masking hashes into slot numbers
+    size_t mask;
+    // number of artists with at least one song
+    size_t count;
+}
+ArtistIndex;
+
+// one genre's songs, linked through the songs' genre links
+//
+// Genres are a small closed enum, so a playlist keeps one chain per genre
+// in an array and needs no table to find them.
+typedef struct GenreChain
+{
+    // the genre's first and last songs in link order, NULL when it has none
+    struct Song *first;
+    struct Song *last;
+    // number of songs of the genre
+    size_t count;
+}
+GenreChain;
+
+// function prototypes
+
+/**
+ * Function: titleIndexInit
+ * Input argument: index - a pointer to a title index
+ * Output argument: index is empty; no memory is allocated until the first
+ *                  insert
+ * Return: none
+ * Dependencies: none
+ */
+void titleIndexInit(TitleIndex *index);
+
+/**
+ * Function: titleIndexFree
+ * Input argument: index - a pointer to a title index
+ * Output argument: the slots are freed and the index is empty again
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void titleIndexFree(TitleIndex *index);
+
+/**
+ * Function: titleIndexClear
+ * Input argument: index - a pointer to a title index
+ * Output argument: every entry is removed, the slots are kept
+ * Return: none
+ * Dependencies: string.h
+ */
+void titleIndexClear(TitleIndex *index);
+
+/**
+ * Function: titleIndexInsert
+ * Input argument: index - a pointer to a title index
+ *                 song - the song to index under its title
+ * Output argument: the entry is added
+ * Return: true on success, false if the table could not grow
+ * Dependencies: stdlib.h
+ */
+bool titleIndexInsert(TitleIndex *index, struct Song *song);
+
+/**
+ * Function: titleIndexReserve
+ * Input argument: index - a pointer to a title index
+ *                 count - the number of entries the index should hold
+ * Output argument: the slot array is sized so that count entries fit
+ *                  without growing again
+ * Return: true on success, false if memory ran out
+ * Dependencies: stdlib.h
+ */
+bool titleIndexReserve(TitleIndex *index, size_t count);
+
+/**
+ * Function: titleIndexPrefetch
+ * Input argument: index - a pointer to a title index
+ *                 song - a song that is about to be inserted or looked up
+ * Output argument: the slot the song's title hashes to starts loading into
+ *                  the cache
+ * Return: none
+ * Dependencies: none
+ *
+ * Bulk inserts call this a few songs ahead, so the cache misses of
+ * consecutive inserts overlap instead of being paid one after another.
+ */
+void titleIndexPrefetch(const TitleIndex *index, const struct Song *song);
+
+/**
+ * Function: titleIndexFind
+ * Input argument: index - a pointer to a title index
+ *                 title - the title to look up
+ *                 last - true for the last match in link order rather than
+ *                        the first
+ * Output argument: none
+ * Return: the first or last song with that title, or NULL
+ * Dependencies: orderRank, string.h
+ *
+ * Duplicate titles are told apart by their rank in the playlist's order
+ * index, which only costs anything when a title has more than one song.
+ */
+struct Song *titleIndexFind(
+    const TitleIndex *index, const char *title, bool last);
+
+/**
+ * Function: titleIndexRemove
+ * Input argument: index - a pointer to a title index
+ *                 song - an indexed song
+ * Output argument: the song's entry is removed
+ * Return: none
+ * Dependencies: string.h
+ */
+void titleIndexRemove(TitleIndex *index, const struct Song *song);
+
+/**
+ * Function: artistIndexInit
+ * Input argument: index - a pointer to an artist index
+ * Output argument: index is empty; no memory is allocated until the first
+ *                  append
+ * Return: none
+ * Dependencies: none
+ */
+void artistIndexInit(ArtistIndex *index);
+
+/**
+ * Function: artistIndexFree
+ * Input argument: index - a pointer to an artist index
+ * Output argument: the slots are freed and the index is empty again
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void artistIndexFree(ArtistIndex *index);
+
+/**
+ * Function: artistIndexClear
+ * Input argument: index - a pointer to an artist index
+ * Output argument: every posting list is dropped, the slots are kept
+ * Return: none
+ * Dependencies: string.h
+ */
+void artistIndexClear(ArtistIndex *index);
+
+/**
+ * Function: artistIndexAppend
+ * Input argument: index - a pointer to an artist index
+ *                 song - a song that is now the last of its artist in
+ *                        playlist order
+ * Output argument: the song ends its artist's posting list
+ * Return: true on success, false if the table could not grow
+ * Dependencies: stdlib.h, string.h
+ */
+bool artistIndexAppend(ArtistIndex *index, struct Song *song);
+
+/**
+ * Function: artistIndexInsertAfter
+ * Input argument: index - a pointer to an artist index
+ *                 song - a song to add to its artist's posting list
+ *                 previous - the artist's song right before it in link
+ *                            order, or NULL if it comes first
+ * Output argument: the song is linked into its artist's posting list
+ * Return: true on success, false if the table could not grow
+ * Dependencies: stdlib.h, string.h
+ */
+bool artistIndexInsertAfter(ArtistIndex *index, struct Song *song,
+    struct Song *previous);
+
+/**
+ * Function: artistIndexReverse
+ * Input argument: index - a pointer to an artist index
+ * Output argument: every posting list is turned around, to match songs
+ *                  whose links were reversed
+ * Return: none
+ * Dependencies: none
+ */
+void artistIndexReverse(ArtistIndex *index);
+
+/**
+ * Function: artistIndexRemove
+ * Input argument: index - a pointer to an artist index
+ *                 song - an indexed song
+ * Output argument: the song is unlinked from its posting list in O(1), and
+ *                  the artist's entry is dropped with its last song
+ * Return: none
+ * Dependencies: string.h
+ */
+void artistIndexRemove(ArtistIndex *index, struct Song *song);
+
+/**
+ * Function: artistIndexFind
+ * Input argument: index - a pointer to an artist index
+ *                 artist - the artist number to look up
+ * Output argument: none
+ * Return: the artist's posting list, or NULL if the artist has no songs
+ * Dependencies: none
+ */
+const ArtistEntry *artistIndexFind(
+    const ArtistIndex *index, uint32_t artist);
+
+/**
+ * Function: genreChainInit
+ * Input argument: chain - a pointer to a genre chain
+ * Output argument: chain holds no songs
+ * Return: none
+ * Dependencies: none
+ */
+void genreChainInit(GenreChain *chain);
+
+/**
+ * Function: genreChainAppend
+ * Input argument: chain - a pointer to the chain of the song's genre
+ *                 song - a song that is now the last of its genre in link
+ *                        order
+ * Output argument: the song ends the chain in O(1)
+ * Return: none
+ * Dependencies: none
+ */
+void genreChainAppend(GenreChain *chain, struct Song *song);
+
+/**
+ * Function: genreChainInsertAfter
+ * Input argument: chain - a pointer to the chain of the song's genre
+ *                 song - a song to add to the chain
+ *                 previous - the genre's song right before it in link order,
+ *                            or NULL if it comes first
+ * Output argument: the song is linked into the chain in O(1)
+ * Return: none
+ * Dependencies: genreChainAppend
+ */
+void genreChainInsertAfter(GenreChain *chain, struct Song *song,
+    struct Song *previous);
+
+/**
+ * Function: genreChainReverse
+ * Input argument: chain - a pointer to a genre chain
+ * Output argument: the chain is turned around, to match songs whose links
+ *                  were reversed
+ * Return: none
+ * Dependencies: none
+ */
+void genreChainReverse(GenreChain *chain);
+
+/**
+ * Function: genreChainRemove
+ * Input argument: chain - a pointer to the chain of the song's genre
+ *                 song - a song in the chain
+ * Output argument: the song is unlinked from the chain in O(1)
+ * Return: none
+ * Dependencies: none
+ */
+void genreChainRemove(GenreChain *chain, struct Song *song);
+
+#endif // MUSIC_INDEX_H
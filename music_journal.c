@@ -0,0 +1,1022 @@
+// header files
+#include "music_journal.h"
+#include "music_artist.h"
+#include "music_snapshot.h"
+#include "music_sort.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// global definitions
+#define JOURNAL_MAGIC "TUNEJRNL"
+#define JOURNAL_BYTE_ORDER 0x01020304u
+// bytes copied at a time when a journal is started over
+#define JOURNAL_COPY_BYTES 65536
+
+/**
+ * Function: journalChecksum (helper)
+ * Input argument: data - the bytes to checksum
+ *                 bytes - how many there are
+ *                 hash - the checksum so far, or 2166136261 to start
+ * Output argument: none
+ * Return: the 32-bit FNV-1a hash continued over data
+ * Dependencies: none
+ */
+static uint32_t journalChecksum(const void *data, size_t bytes, uint32_t hash)
+{
+    // FNV-1a over the bytes
+    const unsigned char *current = (const unsigned char*)data;
+    for (size_t i = 0; i < bytes; i++)
+    {
+        hash = (hash ^ current[i]) * 16777619u;
+    }
+    // return the checksum
+    return hash;
+}
+
+/**
+ * Function: journalComparator (helper)
+ * Input argument: order - a sort order
+ * Output argument: none
+ * Return: the comparator that sorts in that order
+ * Dependencies: none
+ */
+static SongComparator journalComparator(JournalSort order)
+{
+    // genre sorts are stable, so the merge sort matches playlistSortByGenre
+    return order == JOURNAL_SORT_GENRE ? songCompareByGenre :
+        order == JOURNAL_SORT_ARTIST ? songCompareByArtist :
+        order == JOURNAL_SORT_TITLE ? songCompareByTitle :
+        songCompareByGenreArtistTitle;
+}
+
+/**
+ * Function: journalApply (helper)
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 record - a record whose checksum matched
+ *                 strings - the title and artist after the record
+ * Output argument: the edit is made to the playlist, without the messages
+ *                  the menu prints for it
+ * Return: true if the edit was made, false otherwise
+ * Dependencies: artistPoolIntern, artistPoolRelease, playlistInsertInterned,
+ *               playlistRemoveAt, sortPlaylist, playlistReverse
+ */
+static bool journalApply(Playlist *playlist, const JournalRecord *record,
+    const char *strings)
+{
+    switch (record->type)
+    {
+        // number the artist, then insert a song with it
+        case JOURNAL_INSERT:
+        {
+            uint32_t artist = artistPoolIntern(strings + record->titleLength,
+                record->artistLength);
+            if (artist == ARTIST_NONE)
+            {
+                return false;
+            }
+            // give the reference back if the song was not added
+            if (!playlistInsertInterned(playlist, record->position, strings,
+                record->titleLength, artist, (Genre)record->argument))
+            {
+                artistPoolRelease(artist);
+                return false;
+            }
+            return true;
+        }
+
+        // removes are journaled by position, so no title is looked up
+        case JOURNAL_REMOVE:
+            return playlistRemoveAt(playlist, record->position);
+
+        // sorts take the quiet path, even by genre
+        case JOURNAL_SORT:
+            if (record->argument >= JOURNAL_SORT_COUNT)
+            {
+                return false;
+            }
+            sortPlaylist(playlist,
+                journalComparator((JournalSort)record->argument));
+            return true;
+
+        // turn play order around
+        case JOURNAL_REVERSE:
+            playlistReverse(playlist);
+            return true;
+
+        // anything else was not written by this version
+        default:
+            return false;
+    }
+}
+
+/**
+ * Function: journalReplay (helper)
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 data - the contents of a journal file
+ *                 size - the number of bytes in data
+ *                 source - the size and modification time of the CSV
+ *                 sequence - the last record the playlist includes
+ * Output argument: the records after sequence are applied to the playlist
+ *                  in order, and sequence is the last one applied
+ * Return: the number of bytes up to the end of the last whole record, or 0
+ *         if the journal belongs to another CSV or starts after sequence
+ * Dependencies: journalChecksum, journalApply, string.h
+ *
+ * A record cut short or damaged by a crash, a gap in the numbering, or an
+ * edit that cannot be made ends the journal.
+ */
+static size_t journalReplay(Playlist *playlist, const char *data, size_t size,
+    const struct stat *source, uint64_t *sequence)
+{
+    // check that the header belongs to this CSV and continues the playlist
+    const JournalHeader *header = (const JournalHeader*)data;
+    if (size < sizeof(JournalHeader) ||
+        memcmp(header->magic, JOURNAL_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != JOURNAL_VERSION ||
+        header->byteOrder != JOURNAL_BYTE_ORDER ||
+        header->sourceSize != (uint64_t)source->st_size ||
+        header->sourceSeconds != (int64_t)source->st_mtim.tv_sec ||
+        header->sourceNanoseconds != (int64_t)source->st_mtim.tv_nsec ||
+        header->first > *sequence + 1)
+    {
+        return 0;
+    }
+    // then apply the records one by one
+    size_t offset = sizeof(JournalHeader);
+    while (size - offset >= sizeof(JournalRecord))
+    {
+        // records are not aligned in the file
+        JournalRecord record;
+        memcpy(&record, data + offset, sizeof(record));
+        const char *strings = data + offset + sizeof(record);
+        size_t stringBytes = (size_t)record.titleLength + record.artistLength;
+        // stop at a record the file ends in the middle of
+        if (size - offset - sizeof(record) < stringBytes)
+        {
+            break;
+        }
+        // or one whose bytes are not the ones written
+        uint32_t checksum = record.checksum;
+        record.checksum = 0;
+        if (journalChecksum(strings, stringBytes, journalChecksum(&record,
+            sizeof(record), 2166136261u)) != checksum)
+        {
+            break;
+        }
+        // records the playlist already includes are skipped, and one that
+        // does not follow it ends the journal
+        if (record.sequence > *sequence + 1)
+        {
+            break;
+        }
+        if (record.sequence == *sequence + 1)
+        {
+            if (!journalApply(playlist, &record, strings))
+            {
+                break;
+            }
+            *sequence = record.sequence;
+        }
+        offset += sizeof(record) + stringBytes;
+    }
+    // return the bytes that were whole
+    return offset;
+}
+
+/**
+ * Function: journalWriteAll (helper)
+ * Input argument: fd - a file open for writing
+ *                 data - the bytes to write
+ *                 bytes - how many there are
+ *                 offset - where in the file they go
+ * Output argument: every byte is written, however many calls it takes
+ * Return: true on success, false if a write failed
+ * Dependencies: errno.h, unistd.h
+ */
+static bool journalWriteAll(int fd, const void *data, size_t bytes,
+    uint64_t offset)
+{
+    const char *current = (const char*)data;
+    while (bytes > 0)
+    {
+        ssize_t written = pwrite(fd, current, bytes, (off_t)offset);
+        // retry interrupted writes, give up on anything else
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            return false;
+        }
+        current += written;
+        bytes -= (size_t)written;
+        offset += (uint64_t)written;
+    }
+    // return success
+    return true;
+}
+
+/**
+ * Function: journalSetAside (helper)
+ * Input argument: path - a journal or snapshot holding edits that no longer
+ *                        apply
+ *                 source - the CSV they were made over
+ * Output argument: the file is renamed to the first free name of path with
+ *                  JOURNAL_STALE_SUFFIX added, then with a number too, and
+ *                  a warning says where it went
+ * Return: true if the file was moved, false if it was left where it is
+ * Dependencies: stdio.h, stdlib.h, string.h, unistd.h
+ *
+ * The journal and snapshot are started over from the CSV afterwards, so
+ * this keeps the edits for the user to recover instead of overwriting them.
+ */
+static bool journalSetAside(const char *path, const char *source)
+{
+    // room for the path, the suffix, a dot and a number
+    size_t size = strlen(path) + sizeof(JOURNAL_STALE_SUFFIX) + 16;
+    char *stale = (char*)malloc(size);
+    bool moved = false;
+    // take the first name nothing is using yet
+    for (int i = 0; stale != NULL && i < JOURNAL_STALE_TRIES && !moved; i++)
+    {
+        if (i == 0)
+        {
+            snprintf(stale, size, "%s%s", path, JOURNAL_STALE_SUFFIX);
+        }
+        else
+        {
+            snprintf(stale, size, "%s%s.%d", path, JOURNAL_STALE_SUFFIX, i);
+        }
+        if (access(stale, F_OK) != 0)
+        {
+            moved = rename(path, stale) == 0;
+            break;
+        }
+    }
+    // say what happened to the edits either way
+    if (moved)
+    {
+        printf("Edits saved in %s do not apply to %s as it is now. They "
+            "were moved to %s.\n", path, source, stale);
+    }
+    else
+    {
+        printf("Edits saved in %s do not apply to %s as it is now, and "
+            "could not be moved aside. They will be overwritten.\n", path,
+            source);
+    }
+    free(stale);
+    return moved;
+}
+
+/**
+ * Function: journalCreate (helper)
+ * Input argument: journal - a pointer to a journal handle
+ *                 first - the sequence number of the journal's first record
+ *                 from - the journal being replaced, -1 for none
+ *                 start - the offset in from of the first record to keep
+ *                 end - the offset in from where the records end
+ * Output argument: a journal holding the records between start and end
+ *                  replaces the journal file atomically, durable before it
+ *                  is renamed over it
+ * Return: the new journal open for writing, or -1 if it could not be made
+ * Dependencies: journalWriteAll, stdlib.h, string.h, sys/stat.h, unistd.h
+ */
+static int journalCreate(Journal *journal, uint64_t first, int from,
+    uint64_t start, uint64_t end)
+{
+    // the journal is only useful alongside the CSV under it
+    struct stat info;
+    if (stat(journal->source, &info) != 0)
+    {
+        return -1;
+    }
+    // fill in the header
+    JournalHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+    header.version = JOURNAL_VERSION;
+    header.byteOrder = JOURNAL_BYTE_ORDER;
+    header.sourceSize = (uint64_t)info.st_size;
+    header.sourceSeconds = (int64_t)info.st_mtim.tv_sec;
+    header.sourceNanoseconds = (int64_t)info.st_mtim.tv_nsec;
+    header.first = first;
+
+    // write it to a temporary file next to the journal
+    size_t nameLength = strlen(journal->filename) + sizeof(".XXXXXX");
+    char *temporary = (char*)malloc(nameLength);
+    char *buffer = (char*)malloc(JOURNAL_COPY_BYTES);
+    int fd = -1;
+    if (temporary != NULL && buffer != NULL)
+    {
+        snprintf(temporary, nameLength, "%s.XXXXXX", journal->filename);
+        fd = mkstemp(temporary);
+    }
+    // as readable as the CSV, like the snapshot
+    if (fd >= 0)
+    {
+        fchmod(fd, info.st_mode & 0666);
+    }
+    bool ok = fd >= 0 && journalWriteAll(fd, &header, sizeof(header), 0);
+    // followed by the records to keep
+    for (uint64_t at = start; ok && at < end;)
+    {
+        size_t chunk = end - at < JOURNAL_COPY_BYTES ?
+            (size_t)(end - at) : JOURNAL_COPY_BYTES;
+        ssize_t got = pread(from, buffer, chunk, (off_t)at);
+        ok = got > 0 && journalWriteAll(fd, buffer, (size_t)got,
+            sizeof(header) + at - start);
+        at += got > 0 ? (uint64_t)got : 0;
+    }
+    // make the data durable before it can replace the old journal
+    ok = ok && fsync(fd) == 0;
+    // swap it in, or throw it away
+    if (fd >= 0)
+    {
+        if (ok)
+        {
+            ok = rename(temporary, journal->filename) == 0;
+        }
+        if (!ok)
+        {
+            close(fd);
+            unlink(temporary);
+            fd = -1;
+        }
+    }
+    // free the buffers
+    free(temporary);
+    free(buffer);
+    // return the new journal
+    return fd;
+}
+
+/**
+ * Function: journalThreshold (helper)
+ * Input argument: journal - a pointer to a journal handle
+ * Output argument: none
+ * Return: the number of record bytes that starts a compaction
+ * Dependencies: sys/stat.h
+ *
+ * Growing with the snapshot keeps replay a fraction of the load, and the
+ * cost of compacting a fraction of the edits that led to it.
+ */
+static uint64_t journalThreshold(const Journal *journal)
+{
+    // a fixed floor, or a share of the snapshot when that is larger
+    struct stat info;
+    uint64_t share = stat(journal->snapshot, &info) == 0 ?
+        (uint64_t)info.st_size / JOURNAL_COMPACT_RATIO : 0;
+    return share > JOURNAL_COMPACT_BYTES ? share : JOURNAL_COMPACT_BYTES;
+}
+
+/**
+ * Function: journalAppend (helper)
+ * Input argument: journal - a pointer to an open journal handle
+ *                 type - the edit that was made
+ *                 position - the place in play order it was made at
+ *                 argument - the genre of an insert, the order of a sort
+ *                 title - the title of an inserted song, NULL otherwise
+ *                 artist - the artist of an inserted song, NULL otherwise
+ * Output argument: the record is numbered and buffered for the writer,
+ *                  which is woken for the first record of a group and for
+ *                  a full one
+ * Return: none
+ * Dependencies: journalChecksum, pthread.h, stdlib.h, string.h, time.h
+ *
+ * Once a record cannot be buffered no later one is, so the journal always
+ * holds a prefix of the edits.
+ */
+static void journalAppend(Journal *journal, JournalType type,
+    size_t position, int argument, const char *title, const char *artist)
+{
+    // describe the edit; only inserts have strings
+    JournalRecord record;
+    memset(&record, 0, sizeof(record));
+    title = title != NULL ? title : "";
+    artist = artist != NULL ? artist : "";
+    size_t titleLength = strlen(title);
+    size_t artistLength = strlen(artist);
+    record.position = (uint32_t)position;
+    record.titleLength = (uint32_t)titleLength;
+    record.artistLength = (uint8_t)artistLength;
+    record.type = (uint8_t)type;
+    record.argument = (uint8_t)argument;
+    size_t bytes = sizeof(record) + titleLength + artistLength;
+
+    pthread_mutex_lock(&journal->lock);
+    // nothing more is saved once the journal has failed
+    if (journal->fd < 0 || journal->failed)
+    {
+        pthread_mutex_unlock(&journal->lock);
+        return;
+    }
+    // make room in the buffer, doubling it
+    if (journal->pendingBytes + bytes > journal->pendingCapacity)
+    {
+        size_t capacity = journal->pendingCapacity * 2;
+        if (capacity < journal->pendingBytes + bytes)
+        {
+            capacity = journal->pendingBytes + bytes;
+        }
+        char *grown = (char*)realloc(journal->pending, capacity);
+        if (grown == NULL)
+        {
+            journal->failed = true;
+            printf("Out of memory. Edits will not be saved.\n");
+            pthread_mutex_unlock(&journal->lock);
+            return;
+        }
+        journal->pending = grown;
+        journal->pendingCapacity = capacity;
+    }
+    // number the record and checksum it with its strings
+    record.sequence = journal->appended + 1;
+    uint32_t checksum = journalChecksum(&record, sizeof(record), 2166136261u);
+    checksum = journalChecksum(title, titleLength, checksum);
+    record.checksum = journalChecksum(artist, artistLength, checksum);
+    // copy it to the end of the buffer
+    char *end = journal->pending + journal->pendingBytes;
+    memcpy(end, &record, sizeof(record));
+    memcpy(end + sizeof(record), title, titleLength);
+    memcpy(end + sizeof(record) + titleLength, artist, artistLength);
+    journal->pendingBytes += bytes;
+    journal->appended = record.sequence;
+    // the first record of a group starts its clock
+    if (++journal->pendingCount == 1)
+    {
+        clock_gettime(CLOCK_REALTIME, &journal->pendingSince);
+        pthread_cond_signal(&journal->pendingReady);
+    }
+    // and a full group goes out without waiting for it to run out
+    else if (journal->pendingCount == JOURNAL_GROUP_RECORDS)
+    {
+        pthread_cond_signal(&journal->pendingReady);
+    }
+    pthread_mutex_unlock(&journal->lock);
+}
+
+/**
+ * Function: journalWriter (helper)
+ * Input argument: argument - a pointer to an open journal handle
+ * Output argument: buffered records are written in groups, each made
+ *                  durable with one fsync, until the journal closes
+ * Return: NULL
+ * Dependencies: journalWriteAll, pthread.h, stdio.h, time.h, unistd.h
+ *
+ * A group is written once it has JOURNAL_GROUP_RECORDS records, its first
+ * record has waited JOURNAL_GROUP_MILLISECONDS, or someone waits for it.
+ */
+static void *journalWriter(void *argument)
+{
+    Journal *journal = (Journal*)argument;
+    pthread_mutex_lock(&journal->lock);
+    while (true)
+    {
+        // sleep until there are records to write
+        while (journal->pendingCount == 0 && !journal->closing)
+        {
+            pthread_cond_wait(&journal->pendingReady, &journal->lock);
+        }
+        // stop once closing with everything written
+        if (journal->pendingCount == 0)
+        {
+            break;
+        }
+        // give later records until the deadline to join the group
+        struct timespec deadline = journal->pendingSince;
+        deadline.tv_nsec += JOURNAL_GROUP_MILLISECONDS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        while (journal->pendingCount < JOURNAL_GROUP_RECORDS &&
+            journal->flushing == 0 && !journal->closing &&
+            pthread_cond_timedwait(&journal->pendingReady, &journal->lock,
+            &deadline) == 0)
+        {
+            // woken early; check again
+        }
+        // take the group, leaving the other buffer for new records
+        char *group = journal->pending;
+        size_t bytes = journal->pendingBytes;
+        size_t capacity = journal->pendingCapacity;
+        journal->pending = journal->writing;
+        journal->pendingCapacity = journal->writingCapacity;
+        journal->writing = group;
+        journal->writingCapacity = capacity;
+        journal->pendingBytes = 0;
+        journal->pendingCount = 0;
+        uint64_t last = journal->appended;
+        pthread_mutex_unlock(&journal->lock);
+
+        // write it after the last group and make it durable at once
+        pthread_mutex_lock(&journal->fileLock);
+        bool ok = journalWriteAll(journal->fd, group, bytes,
+            journal->fileBytes) && fdatasync(journal->fd) == 0;
+        pthread_mutex_lock(&journal->lock);
+        if (ok)
+        {
+            journal->fileBytes += bytes;
+        }
+        // a journal that failed once saves nothing more
+        else if (!journal->failed)
+        {
+            journal->failed = true;
+            printf("Journal %s could not be written. "
+                "Edits will not be saved.\n", journal->filename);
+        }
+        // either way nobody waits for these records any longer
+        journal->committed = last;
+        pthread_cond_broadcast(&journal->committedReady);
+        // hand a grown journal to the compactor
+        if (ok && !journal->compacting &&
+            journal->fileBytes >= journal->compactAt)
+        {
+            journal->compacting = true;
+            pthread_cond_signal(&journal->compactReady);
+        }
+        pthread_mutex_unlock(&journal->fileLock);
+    }
+    pthread_mutex_unlock(&journal->lock);
+    return NULL;
+}
+
+/**
+ * Function: journalCompact (helper)
+ * Input argument: journal - a pointer to an open journal handle
+ *                 bytes - the size of the journal's durable part
+ *                 sequence - the last record in that part
+ * Output argument: the snapshot is replaced by one that includes every
+ *                  record up to sequence, and the journal by one with only
+ *                  the records after it
+ * Return: true on success, false if nothing was replaced or only the
+ *         snapshot was
+ * Dependencies: playlistLoadSnapshot, journalReplay, playlistSaveSnapshot,
+ *               playlistFree, journalThreshold, journalCreate, fcntl.h,
+ *               pthread.h, sys/mman.h, sys/stat.h, unistd.h
+ *
+ * Runs without either lock until the new snapshot is saved. The old
+ * journal still replays over it, so a crash in between loses nothing.
+ */
+static bool journalCompact(Journal *journal, uint64_t bytes,
+    uint64_t sequence)
+{
+    // map the durable part of the journal through a descriptor of its own
+    struct stat source;
+    int fd = open(journal->filename, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    const char *data = stat(journal->source, &source) == 0 ?
+        mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    if (data == MAP_FAILED)
+    {
+        close(fd);
+        return false;
+    }
+    // replay it over the snapshot into a playlist of its own
+    Playlist playlist;
+    playlistInit(&playlist);
+    uint64_t replayed = 0;
+    bool ok = playlistLoadSnapshot(&playlist, journal->snapshot,
+        journal->source, &replayed) &&
+        journalReplay(&playlist, data, bytes, &source, &replayed) == bytes &&
+        replayed == sequence;
+    // which becomes the new snapshot
+    ok = ok && playlistSaveSnapshot(&playlist, journal->snapshot,
+        journal->source, sequence);
+    playlistFree(&playlist);
+    munmap((void *)data, bytes);
+
+    // start the journal over with the records written since
+    if (ok)
+    {
+        uint64_t threshold = journalThreshold(journal);
+        pthread_mutex_lock(&journal->fileLock);
+        int fresh = journalCreate(journal, sequence + 1, fd, bytes,
+            journal->fileBytes);
+        if (fresh >= 0)
+        {
+            pthread_mutex_lock(&journal->lock);
+            close(journal->fd);
+            journal->fd = fresh;
+            journal->fileBytes = sizeof(JournalHeader) +
+                journal->fileBytes - bytes;
+            journal->compactAt = sizeof(JournalHeader) + threshold;
+            pthread_mutex_unlock(&journal->lock);
+        }
+        ok = fresh >= 0;
+        pthread_mutex_unlock(&journal->fileLock);
+    }
+    close(fd);
+    // return the result
+    return ok;
+}
+
+/**
+ * Function: journalCompactor (helper)
+ * Input argument: argument - a pointer to an open journal handle
+ * Output argument: the journal is compacted whenever the writer hands it
+ *                  over, until the journal closes
+ * Return: NULL
+ * Dependencies: journalCompact, journalThreshold, pthread.h
+ */
+static void *journalCompactor(void *argument)
+{
+    Journal *journal = (Journal*)argument;
+    pthread_mutex_lock(&journal->lock);
+    while (true)
+    {
+        // sleep until the journal has grown
+        while (!journal->compacting && !journal->closing)
+        {
+            pthread_cond_wait(&journal->compactReady, &journal->lock);
+        }
+        // a closing journal is compacted on a later start instead
+        if (journal->closing)
+        {
+            break;
+        }
+        // fold in what is durable now; the writer goes on meanwhile
+        uint64_t bytes = journal->fileBytes;
+        uint64_t sequence = journal->committed;
+        bool failed = journal->failed;
+        pthread_mutex_unlock(&journal->lock);
+        bool ok = !failed && journalCompact(journal, bytes, sequence);
+        uint64_t threshold = ok ? 0 : journalThreshold(journal);
+        pthread_mutex_lock(&journal->lock);
+        // after a failure, wait for another threshold before trying again
+        if (!ok)
+        {
+            journal->compactAt = journal->fileBytes + threshold;
+        }
+        journal->compacting = false;
+    }
+    pthread_mutex_unlock(&journal->lock);
+    return NULL;
+}
+
+/**
+ * Function: journalOpen
+ * Input argument: journal - a pointer to a journal handle
+ *                 playlist - a pointer to an empty playlist handle
+ *                 filename - the path of the journal
+ *                 snapshot - the path of the snapshot the journal extends
+ *                 source - the path of the CSV under the snapshot
+ * Output argument: the playlist is loaded from the snapshot, or from the
+ *                  CSV when the snapshot is missing or stale, and the
+ *                  journal's edits are replayed over it; later edits
+ *                  through journal are appended to the journal
+ * Return: true if the playlist is successfully loaded, false if errors
+ *         occur; the playlist is left empty and journal closed then
+ * Dependencies: playlistLoadSnapshot, playlistSnapshotSequence,
+ *               journalSetAside, playlistLoad, playlistSaveSnapshot,
+ *               journalReplay, journalCreate, journalThreshold,
+ *               journalWriter, journalCompactor, playlistFree, fcntl.h,
+ *               pthread.h, sys/mman.h, sys/stat.h, unistd.h
+ *
+ * A journal that belongs to another version of the CSV, or that starts
+ * after the snapshot ends, is replaced by an empty one. If it or a stale
+ * snapshot holds edits, it is first moved aside with a warning, so even a
+ * touch of the CSV loses nothing. If the journal cannot be written the
+ * playlist still loads, and edits are not saved.
+ */
+bool journalOpen(Journal *journal, Playlist *playlist, const char *filename,
+    const char *snapshot, const char *source)
+{
+    // nothing is open or waiting yet
+    journal->playlist = playlist;
+    journal->filename = strdup(filename);
+    journal->snapshot = strdup(snapshot);
+    journal->source = strdup(source);
+    pthread_mutex_init(&journal->fileLock, NULL);
+    pthread_mutex_init(&journal->lock, NULL);
+    pthread_cond_init(&journal->pendingReady, NULL);
+    pthread_cond_init(&journal->compactReady, NULL);
+    pthread_cond_init(&journal->committedReady, NULL);
+    journal->fd = -1;
+    journal->fileBytes = 0;
+    journal->compactAt = 0;
+    journal->pending = NULL;
+    journal->pendingBytes = 0;
+    journal->pendingCapacity = 0;
+    journal->pendingCount = 0;
+    journal->writing = NULL;
+    journal->writingCapacity = 0;
+    journal->appended = 0;
+    journal->committed = 0;
+    journal->flushing = 0;
+    journal->failed = false;
+    journal->compacting = false;
+    journal->closing = false;
+    journal->started = false;
+
+    // start from the snapshot when it is up to date with the CSV
+    uint64_t sequence = 0;
+    bool ok = journal->filename != NULL && journal->snapshot != NULL &&
+        journal->source != NULL;
+    if (ok && !playlistLoadSnapshot(playlist, snapshot, source, &sequence))
+    {
+        // a snapshot the journal was folded into holds edits, so it is
+        // kept rather than replaced
+        if (playlistSnapshotSequence(snapshot) > 0)
+        {
+            journalSetAside(snapshot, source);
+        }
+        // otherwise from the CSV, saving a snapshot for the next start,
+        // which is fine to fail
+        ok = playlistLoad(playlist, source);
+        if (ok)
+        {
+            playlistSaveSnapshot(playlist, snapshot, source, 0);
+        }
+    }
+    if (!ok)
+    {
+        playlistFree(playlist);
+        journalClose(journal);
+        return false;
+    }
+
+    // replay the journal over it, if there is one for this CSV
+    struct stat info;
+    struct stat sourceInfo;
+    size_t valid = 0;
+    int fd = open(filename, O_RDWR);
+    if (fd >= 0 && fstat(fd, &info) == 0 && info.st_size > 0 &&
+        stat(source, &sourceInfo) == 0)
+    {
+        const char *data = mmap(NULL, (size_t)info.st_size, PROT_READ,
+            MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            valid = journalReplay(playlist, data, (size_t)info.st_size,
+                &sourceInfo, &sequence);
+            munmap((void *)data, (size_t)info.st_size);
+        }
+    }
+    // start an empty journal if there was none to replay
+    if (valid == 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        // keeping one that holds records which do not apply
+        if (fd >= 0 && (size_t)info.st_size > sizeof(JournalHeader))
+        {
+            journalSetAside(filename, source);
+        }
+        fd = journalCreate(journal, sequence + 1, -1, 0, 0);
+        valid = sizeof(JournalHeader);
+    }
+    // otherwise cut off a record torn by a crash, so new ones follow the
+    // last whole one
+    else if (valid < (size_t)info.st_size &&
+        (ftruncate(fd, (off_t)valid) != 0 || fsync(fd) != 0))
+    {
+        close(fd);
+        fd = -1;
+    }
+    journal->fd = fd;
+    journal->fileBytes = valid;
+    journal->compactAt = sizeof(JournalHeader) + journalThreshold(journal);
+    journal->compacting = valid >= journal->compactAt;
+    journal->appended = sequence;
+    journal->committed = sequence;
+
+    // start the writer and the compactor
+    if (fd >= 0)
+    {
+        bool writer = pthread_create(&journal->writer, NULL, journalWriter,
+            journal) == 0;
+        journal->started = writer && pthread_create(&journal->compactor, NULL,
+            journalCompactor, journal) == 0;
+        // without both, stop the one that started
+        if (writer && !journal->started)
+        {
+            pthread_mutex_lock(&journal->lock);
+            journal->closing = true;
+            pthread_cond_signal(&journal->pendingReady);
+            pthread_mutex_unlock(&journal->lock);
+            pthread_join(journal->writer, NULL);
+            journal->closing = false;
+        }
+        if (!journal->started)
+        {
+            close(fd);
+            journal->fd = -1;
+        }
+    }
+    // the playlist is usable either way
+    if (journal->fd < 0)
+    {
+        printf("Journal %s could not be opened. Edits will not be saved.\n",
+            filename);
+    }
+    // return success
+    return true;
+}
+
+/**
+ * Function: journalClose
+ * Input argument: journal - a pointer to an open journal handle
+ * Output argument: every edit is durable, the threads are stopped and the
+ *                  file is closed; the playlist is left alone
+ * Return: none
+ * Dependencies: pthread.h, stdlib.h, unistd.h
+ */
+void journalClose(Journal *journal)
+{
+    // the writer writes what is left before it stops
+    if (journal->started)
+    {
+        pthread_mutex_lock(&journal->lock);
+        journal->closing = true;
+        pthread_cond_signal(&journal->pendingReady);
+        pthread_cond_signal(&journal->compactReady);
+        pthread_mutex_unlock(&journal->lock);
+        pthread_join(journal->writer, NULL);
+        pthread_join(journal->compactor, NULL);
+        journal->started = false;
+    }
+    if (journal->fd >= 0)
+    {
+        close(journal->fd);
+        journal->fd = -1;
+    }
+    // free the buffers, the names and the locks
+    free(journal->pending);
+    free(journal->writing);
+    free(journal->filename);
+    free(journal->snapshot);
+    free(journal->source);
+    journal->pending = NULL;
+    journal->writing = NULL;
+    journal->filename = NULL;
+    journal->snapshot = NULL;
+    journal->source = NULL;
+    pthread_cond_destroy(&journal->committedReady);
+    pthread_cond_destroy(&journal->compactReady);
+    pthread_cond_destroy(&journal->pendingReady);
+    pthread_mutex_destroy(&journal->lock);
+    pthread_mutex_destroy(&journal->fileLock);
+}
+
+/**
+ * Function: journalFlush
+ * Input argument: journal - a pointer to an open journal handle
+ * Output argument: waits until every edit made so far is durable, or can
+ *                  no longer be saved
+ * Return: none
+ * Dependencies: pthread.h
+ */
+void journalFlush(Journal *journal)
+{
+    pthread_mutex_lock(&journal->lock);
+    // have the writer commit what it holds without waiting for more
+    uint64_t target = journal->appended;
+    journal->flushing++;
+    pthread_cond_signal(&journal->pendingReady);
+    while (journal->committed < target)
+    {
+        pthread_cond_wait(&journal->committedReady, &journal->lock);
+    }
+    journal->flushing--;
+    pthread_mutex_unlock(&journal->lock);
+}
+
+/**
+ * Function: journalAddSong
+ * Input argument: journal - a pointer to an open journal handle
+ *                 title - a string with the title of the song
+ *                 artist - a string with the artist of the song
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song is added at the end of play order and the edit
+ *                  is journaled
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: playlistAddSong, journalAppend
+ */
+bool journalAddSong(
+    Journal *journal, const char *title, const char *artist, Genre genre)
+{
+    // add the song, then record where it went
+    if (!playlistAddSong(journal->playlist, title, artist, genre))
+    {
+        return false;
+    }
+    journalAppend(journal, JOURNAL_INSERT, journal->playlist->length - 1,
+        genre, title, artist);
+    // return success
+    return true;
+}
+
+/**
+ * Function: journalInsertSong
+ * Input argument: journal - a pointer to an open journal handle
+ *                 position - where the song goes in play order, at most the
+ *                            length
+ *                 title - a string with the title of the song
+ *                 artist - a string with the artist of the song
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song plays at that position and the edit is
+ *                  journaled
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: playlistInsertSong, journalAppend
+ */
+bool journalInsertSong(Journal *journal, size_t position, const char *title,
+    const char *artist, Genre genre)
+{
+    // insert the song, then record where
+    if (!playlistInsertSong(journal->playlist, position, title, artist,
+        genre))
+    {
+        return false;
+    }
+    journalAppend(journal, JOURNAL_INSERT, position, genre, title, artist);
+    // return success
+    return true;
+}
+
+/**
+ * Function: journalRemoveSong
+ * Input argument: journal - a pointer to an open journal handle
+ *                 title - a string with the title of the song
+ * Output argument: the first song in play order with that title is removed
+ *                  and the edit is journaled by its position
+ * Return: true if the song is successfully removed, false otherwise
+ * Dependencies: playlistFindSong, playlistPosition, playlistRemoveSong,
+ *               journalAppend
+ */
+bool journalRemoveSong(Journal *journal, const char *title)
+{
+    // find where the song plays before it goes
+    Song *song = playlistFindSong(journal->playlist, title);
+    size_t position = song != NULL ?
+        playlistPosition(journal->playlist, song) : 0;
+    // remove it, which reports a title that is not there
+    if (!playlistRemoveSong(journal->playlist, title))
+    {
+        return false;
+    }
+    journalAppend(journal, JOURNAL_REMOVE, position, 0, NULL, NULL);
+    // return success
+    return true;
+}
+
+/**
+ * Function: journalSort
+ * Input argument: journal - a pointer to an open journal handle
+ *                 order - the order to sort the playlist in
+ * Output argument: the playlist is sorted and the edit is journaled
+ * Return: none
+ * Dependencies: playlistSortByGenre, sortPlaylist, journalComparator,
+ *               journalAppend
+ */
+void journalSort(Journal *journal, JournalSort order)
+{
+    // there are only so many orders
+    if (order < 0 || order >= JOURNAL_SORT_COUNT)
+    {
+        return;
+    }
+    // genre has its own linear-time sort, the others go through the merge
+    // sort
+    if (order == JOURNAL_SORT_GENRE)
+    {
+        playlistSortByGenre(journal->playlist);
+    }
+    else
+    {
+        sortPlaylist(journal->playlist, journalComparator(order));
+    }
+    // an empty playlist did not change
+    if (journal->playlist->length > 0)
+    {
+        journalAppend(journal, JOURNAL_SORT, 0, order, NULL, NULL);
+    }
+}
+
+/**
+ * Function: journalReverse
+ * Input argument: journal - a pointer to an open journal handle
+ * Output argument: play order is reversed and the edit is journaled
+ * Return: none
+ * Dependencies: playlistReverse, journalAppend
+ */
+void journalReverse(Journal *journal)
+{
+    // reverse the playlist; an empty one did not change
+    playlistReverse(journal->playlist);
+    if (journal->playlist->length > 0)
+    {
+        journalAppend(journal, JOURNAL_REVERSE, 0, 0, NULL, NULL);
+    }
+}
@@ -0,0 +1,263 @@
+#ifndef MUSIC_JOURNAL_H
+#define MUSIC_JOURNAL_H
+
+// header files
+#include <pthread.h>
+#include "music_lib.h"
+
+// global definitions
+#define JOURNAL_FILENAME "playlist.journal"
+#define JOURNAL_VERSION 1
+// records that make a group big enough to commit without waiting for more
+#define JOURNAL_GROUP_RECORDS 64
+// the longest the first record of a group waits for others to join it
+#define JOURNAL_GROUP_MILLISECONDS 10
+// the journal is folded into a new snapshot once it holds this many bytes
+// and a JOURNAL_COMPACT_RATIO-th of the snapshot's size
+#define JOURNAL_COMPACT_BYTES (1u << 20)
+#define JOURNAL_COMPACT_RATIO 4
+// saved edits that no longer apply to the CSV are moved aside under their
+// name with this added, and a number if that is taken
+#define JOURNAL_STALE_SUFFIX ".stale"
+// the most numbered names tried before edits are left where they are
+#define JOURNAL_STALE_TRIES 100
+
+// the edits a record can hold
+typedef enum
+{
+    // a song inserted at a position in play order; adds insert at the end
+    JOURNAL_INSERT = 1,
+    // the song at a position in play order removed
+    JOURNAL_REMOVE,
+    // the playlist sorted in a JournalSort order
+    JOURNAL_SORT,
+    // play order turned around
+    JOURNAL_REVERSE
+}
+JournalType;
+
+// the orders a playlist can be sorted in, numbered as in the menu
+typedef enum
+{
+    JOURNAL_SORT_GENRE,
+    JOURNAL_SORT_ARTIST,
+    JOURNAL_SORT_TITLE,
+    JOURNAL_SORT_GENRE_ARTIST_TITLE,
+    JOURNAL_SORT_COUNT
+}
+JournalSort;
+
+// the fixed-size start of a journal file; all fields are in host byte order
+typedef struct JournalHeader
+{
+    // "TUNEJRNL", to recognize the file
+    char magic[8];
+    // JOURNAL_VERSION when the file was written
+    uint32_t version;
+    // 0x01020304 as written, to reject files from the other byte order
+    uint32_t byteOrder;
+    // size and modification time of the CSV the edits were made over
+    uint64_t sourceSize;
+    int64_t sourceSeconds;
+    int64_t sourceNanoseconds;
+    // the sequence number of the first record; the journal only replays
+    // over a snapshot that includes every record before it
+    uint64_t first;
+}
+JournalHeader;
+
+// one edit; records follow the header back to back, an insert's title and
+// artist right after its record
+typedef struct JournalRecord
+{
+    // one more than the record before
+    uint64_t sequence;
+    // checksum of the record, with this field zero, and of its strings
+    uint32_t checksum;
+    // the place in play order an insert or remove is at
+    uint32_t position;
+    // lengths of the title and artist that follow, zero but for inserts
+    uint32_t titleLength;
+    uint8_t artistLength;
+    // the JournalType
+    uint8_t type;
+    // the Genre of an insert, the JournalSort of a sort
+    uint8_t argument;
+    // zero
+    uint8_t reserved;
+}
+JournalRecord;
+
+// a playlist whose edits are saved by appending them to a journal
+//
+// Edits change the playlist on the caller's thread and encode a record into
+// a buffer. A writer thread writes the buffered records and makes the whole
+// group durable with one fsync. Once the journal passes the threshold a
+// compactor thread replays it over the snapshot into a playlist of its own,
+// saves that as the new snapshot and starts the journal over, so the
+// caller's playlist is never touched off its thread. The handle must not be
+// moved or copied after journalOpen.
+typedef struct Journal
+{
+    // the playlist the edits are made to
+    Playlist *playlist;
+    // the journal, the snapshot it extends and the CSV under both
+    char *filename;
+    char *snapshot;
+    char *source;
+    // held while the journal file is written or replaced, before lock
+    pthread_mutex_t fileLock;
+    // guards everything below
+    pthread_mutex_t lock;
+    // wake the writer, the compactor and callers waiting for a commit
+    pthread_cond_t pendingReady;
+    pthread_cond_t compactReady;
+    pthread_cond_t committedReady;
+    // the journal file open for appending, -1 when edits are not saved;
+    // changed with both locks held
+    int fd;
+    // bytes written to the file and made durable, and the size that
+    // starts a compaction
+    uint64_t fileBytes;
+    uint64_t compactAt;
+    // records encoded but not yet handed to the writer, and when the first
+    // of them was
+    char *pending;
+    size_t pendingBytes;
+    size_t pendingCapacity;
+    size_t pendingCount;
+    struct timespec pendingSince;
+    // the buffer the writer writes from, swapped with pending
+    char *writing;
+    size_t writingCapacity;
+    // sequence numbers of the last record encoded and the last one durable
+    uint64_t appended;
+    uint64_t committed;
+    // number of callers waiting for every record to be durable
+    size_t flushing;
+    // set once a record could not be buffered or written; no later one is,
+    // so the journal keeps a prefix of the edits
+    bool failed;
+    // whether the compactor has work, and whether the threads must stop
+    bool compacting;
+    bool closing;
+    // the background threads, running while started is true
+    pthread_t writer;
+    pthread_t compactor;
+    bool started;
+}
+Journal;
+
+// function prototypes
+
+/**
+ * Function: journalOpen
+ * Input argument: journal - a pointer to a journal handle
+ *                 playlist - a pointer to an empty playlist handle
+ *                 filename - the path of the journal
+ *                 snapshot - the path of the snapshot the journal extends
+ *                 source - the path of the CSV under the snapshot
+ * Output argument: the playlist is loaded from the snapshot, or from the
+ *                  CSV when the snapshot is missing or stale, and the
+ *                  journal's edits are replayed over it; later edits
+ *                  through journal are appended to the journal
+ * Return: true if the playlist is successfully loaded, false if errors
+ *         occur; the playlist is left empty and journal closed then
+ * Dependencies: playlistLoadSnapshot, playlistSnapshotSequence,
+ *               journalSetAside, playlistLoad, playlistSaveSnapshot,
+ *               journalReplay, journalCreate, journalThreshold,
+ *               journalWriter, journalCompactor, playlistFree, fcntl.h,
+ *               pthread.h, sys/mman.h, sys/stat.h, unistd.h
+ *
+ * A journal that belongs to another version of the CSV, or that starts
+ * after the snapshot ends, is replaced by an empty one. If it or a stale
+ * snapshot holds edits, it is first moved aside with a warning, so even a
+ * touch of the CSV loses nothing. If the journal cannot be written the
+ * playlist still loads, and edits are not saved.
+ */
+bool journalOpen(Journal *journal, Playlist *playlist, const char *filename,
+    const char *snapshot, const char *source);
+
+/**
+ * Function: journalClose
+ * Input argument: journal - a pointer to an open journal handle
+ * Output argument: every edit is durable, the threads are stopped and the
+ *                  file is closed; the playlist is left alone
+ * Return: none
+ * Dependencies: pthread.h, stdlib.h, unistd.h
+ */
+void journalClose(Journal *journal);
+
+/**
+ * Function: journalFlush
+ * Input argument: journal - a pointer to an open journal handle
+ * Output argument: waits until every edit made so far is durable, or can
+ *                  no longer be saved
+ * Return: none
+ * Dependencies: pthread.h
+ */
+void journalFlush(Journal *journal);
+
+/**
+ * Function: journalAddSong
+ * Input argument: journal - a pointer to an open journal handle
+ *                 title - a string with the title of the song
+ *                 artist - a string with the artist of the song
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song is added at the end of play order and the edit
+ *                  is journaled
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: playlistAddSong, journalAppend
+ */
+bool journalAddSong(
+    Journal *journal, const char *title, const char *artist, Genre genre);
+
+/**
+ * Function: journalInsertSong
+ * Input argument: journal - a pointer to an open journal handle
+ *                 position - where the song goes in play order, at most the
+ *                            length
+ *                 title - a string with the title of the song
+ *                 artist - a string with the artist of the song
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song plays at that position and the edit is
+ *                  journaled
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: playlistInsertSong, journalAppend
+ */
+bool journalInsertSong(Journal *journal, size_t position, const char *title,
+    const char *artist, Genre genre);
+
+/**
+ * Function: journalRemoveSong
+ * Input argument: journal - a pointer to an open journal handle
+ *                 title - a string with the title of the song
+ * Output argument: the first song in play order with that title is removed
+ *                  and the edit is journaled by its position
+ * Return: true if the song is successfully removed, false otherwise
+ * Dependencies: playlistFindSong, playlistPosition, playlistRemoveSong,
+ *               journalAppend
+ */
+bool journalRemoveSong(Journal *journal, const char *title);
+
+/**
+ * Function: journalSort
+ * Input argument: journal - a pointer to an open journal handle
+ *                 order - the order to sort the playlist in
+ * Output argument: the playlist is sorted and the edit is journaled
+ * Return: none
+ * Dependencies: playlistSortByGenre, sortPlaylist, journalComparator,
+ *               journalAppend
+ */
+void journalSort(Journal *journal, JournalSort order);
+
+/**
+ * Function: journalReverse
+ * Input argument: journal - a pointer to an open journal handle
+ * Output argument: play order is reversed and the edit is journaled
+ * Return: none
+ * Dependencies: playlistReverse, journalAppend
+ */
+void journalReverse(Journal *journal);
+
+#endif // MUSIC_JOURNAL_H
@@ -1,102 +1,271 @@
 // header files
 #include "music_lib.h"
+#include "music_rng.h"
+#include "music_artist.h"
+#include "music_cursor.h"
+
+// songs created through the Song ** wrappers live in this shared pool
+static SongPool legacyPool;
 
 /**
- * Function: createPlaylist (provided)
- * Input argument: playlist - a double pointer to a list of songs
- * Output argument: updated head of the playlist
- * Return: true if the playlist is successfully loaded, false if errors occur
- * Dependencies: addSong, stdio.h, string.h
+ * Function: songListShape (helper)
+ * Input argument: head - the first song of a list, not NULL
+ * Output argument: length - the number of distinct songs reachable
+ *                  tail - the last of them: the song before NULL, or the
+ *                         song that links back into the list
+ *                  entry - where a loop starts, counted from the head, or
+ *                          SIZE_MAX if the list ends in NULL
+ * Return: none
+ * Dependencies: none
+ *
+ * Brent's cycle finding: the hare walks ahead while the tortoise jumps to
+ * it at every power of two, so the loop length is known the first time
+ * they meet. A list ending in NULL is walked once; one that loops, be it
+ * back to the head or into the middle, a few times over, and no walk can
+ * run forever.
  */
-bool createPlaylist(Song **playlist) 
+static void songListShape(
+    const Song *head, size_t *length, Song **tail, size_t *entry)
 {
-    // open the file
-    FILE *file = fopen(FILENAME, "r");
-    // if the file could not be open
-    if (file == NULL)
+    // the hare starts one song ahead of the tortoise
+    const Song *tortoise = head;
+    const Song *hare = head->next;
+    const Song *last = head;
+    size_t power = 1;
+    size_t loop = 1;
+    size_t walked = 1;
+    while (hare != tortoise)
     {
-        // print a message
-        printf("Could not open file %s\n", FILENAME);
-        // end the function with an error code
-        return false;
+        // the list ended, so there is no loop
+        if (hare == NULL)
+        {
+            *length = walked;
+            *tail = (Song*)last;
+            *entry = SIZE_MAX;
+            return;
+        }
+        // move the tortoise up at every power of two
+        if (loop == power)
+        {
+            tortoise = hare;
+            power *= 2;
+            loop = 0;
+        }
+        // and the hare ahead by one song
+        last = hare;
+        hare = hare->next;
+        loop++;
+        walked++;
+    }
+    // the hare is one loop ahead of a tortoise started at the head, so
+    // they meet where the loop begins
+    tortoise = head;
+    hare = head;
+    for (size_t i = 0; i < loop; i++)
+    {
+        hare = hare->next;
+    }
+    size_t start = 0;
+    while (tortoise != hare)
+    {
+        tortoise = tortoise->next;
+        hare = hare->next;
+        start++;
     }
+    // the tail is the last song around the loop
+    const Song *current = tortoise;
+    for (size_t i = 1; i < loop; i++)
+    {
+        current = current->next;
+    }
+    *length = start + loop;
+    *tail = (Song*)current;
+    *entry = start;
+}
+
+/**
+ * Function: playlistView (helper)
+ * Input argument: view - a pointer to the playlist handle to fill in
+ *                 head - a pointer to a bare list of songs
+ * Output argument: view describes the list starting at head, whose prev
+ *                  links are set from its next links
+ * Return: none
+ * Dependencies: songListShape
+ *
+ * Lets the Song ** wrappers reuse the playlist handle functions. It walks the
+ * list to find the tail and to link each song back to the one before, so
+ * only the handle API is O(1). A list that loops back into its middle rather
+ * than to the head counts as circular, so makePlaylistLinear cuts the loop
+ * where it closes.
+ */
+static void playlistView(Playlist *view, Song *head)
+{
+    // start from an empty handle
+    playlistInit(view);
+    // bare lists allocate from the shared pool
+    view->pool = legacyPool;
+    // and have no indexes, as the view is thrown away after each call
+    view->indexed = false;
+    // nothing else to find for an empty list
+    if (head == NULL)
+    {
+        return;
+    }
+    // the head is the first song
+    view->head = head;
+    // find the length and the tail without trusting the links to end
+    size_t entry;
+    songListShape(head, &view->length, &view->tail, &entry);
+    // the list is circular if it loops anywhere
+    view->circular = entry != SIZE_MAX;
+    // bare lists may be linked forward only, so point each song back at the
+    // one before it, and the head at the tail when the list loops
+    Song* current = head;
+    for (size_t i = 1; i < view->length; i++)
+    {
+        current->next->prev = current;
+        current = current->next;
+    }
+    head->prev = view->circular ? view->tail : NULL;
+}
 
-    // create variables to hold the readings
-    char line[256];
-    char title[100];
-    char artist[100];
-    int genre;
+/**
+ * Function: playlistUnview (helper)
+ * Input argument: view - a pointer to a handle filled in by playlistView
+ *                 head - a double pointer to the bare list it describes
+ * Output argument: updated head of the list and of the shared pool
+ * Return: none
+ * Dependencies: playlistStraighten
+ */
+static void playlistUnview(Playlist *view, Song **head)
+{
+    // a bare list has no direction flag, so a reverse is made real
+    playlistStraighten(view);
+    // hand the head back to the caller
+    *head = view->head;
+    // keep any slabs the handle allocated or released
+    legacyPool = view->pool;
+}
 
-    // if it is the end of the file after the header
-    if (fgets(line, sizeof(line), file) == NULL)
+/**
+ * Function: playlistInit
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: playlist is empty and linear
+ * Return: none
+ * Dependencies: none
+ */
+void playlistInit(Playlist *playlist)
+{
+    // no songs yet
+    playlist->head = NULL;
+    // so there is no tail either
+    playlist->tail = NULL;
+    // and the length is zero
+    playlist->length = 0;
+    // an empty playlist is never circular
+    playlist->circular = false;
+    // and plays from the head
+    playlist->reversed = false;
+    // no slabs are allocated until the first song is added
+    songPoolInit(&playlist->pool);
+    // keep the indexes up to date
+    playlist->indexed = true;
+    titleIndexInit(&playlist->titles);
+    artistIndexInit(&playlist->artists);
+    for (int genre = 0; genre < GENRE_COUNT; genre++)
     {
-        // close the file
-        fclose(file);
-        // file is empty, return false
-        return false;
+        genreChainInit(&playlist->genreChains[genre]);
     }
+    orderInit(&playlist->order);
+    // completions are only built once asked for
+    playlist->prefixed = false;
+    prefixInit(&playlist->titlePrefixes);
+    prefixInit(&playlist->artistPrefixes);
+    // and no cursors walk it yet
+    playlist->cursors = NULL;
+    playlist->generation = 0;
+}
 
-    // while there is another line to read
-    while (fgets(line, sizeof(line), file) != NULL)
+/**
+ * Function: playlistScanTitle (helper)
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 title - a string with the title of the song
+ * Output argument: none
+ * Return: the first song in play order with that title, or NULL if there is
+ *         none
+ * Dependencies: playlistFirst, playlistNext, string.h
+ *
+ * The linear fallback for playlists without indexes.
+ */
+static Song *playlistScanTitle(const Playlist *playlist, const char *title)
+{
+    // measure the title once; songs keep their own lengths
+    size_t length = strlen(title);
+    // create variable to store current song
+    Song* current = playlistFirst(playlist);
+    // walk each song once, which also stops on circular playlists
+    for (size_t i = 0; i < playlist->length; i++)
     {
-        // parse the line using the comma separator
-        char *token = strtok(line, ",");
-        // if the token is not null
-        if (token != NULL)
-        {
-            // copy the data into the title
-            strcpy(title, token);
-        }
-        // move to the next token
-        token = strtok(NULL, ",");
-        // if the token is not null
-        if (token != NULL)
-        {
-            // copy the data into the artist
-            strcpy(artist, token);
-        }
-        // move to the next token
-        token = strtok(NULL, ",");
-        // if the token is not null
-        if (token != NULL)
+        // stop when the title matches, comparing bytes only on equal lengths
+        if (current->titleLength == length &&
+            memcmp(title, songTitle(current), length) == 0)
         {
-            // copy into genre as an integer
-            genre = atoi(token);
+            return current;
         }
-
-        // add the song to the playlist casting Genre to the correct enum
-        addSong(playlist, title, artist, (Genre)genre);
+        // move ahead by one song
+        current = playlistNext(playlist, current);
     }
-    // close the file
-    fclose(file);
-    // return success
-    return true;
+    // the whole playlist was walked without a match
+    return NULL;
 }
 
 /**
- * Task 1: Play the Playlist
- * Input argument: playlist - a pointer to a list of songs
- *                 genres - an array with the names of the genres. Genres are 
+ * Function: songPlay (helper)
+ * Input argument: sink - where the song is played to
+ *                 song - the song to play
+ *                 genres - an array with the names of the genres
+ * Output argument: the song's "Playing ..." line is written to the sink
+ * Return: none
+ * Dependencies: outputPlaying, artistPoolName, artistPoolLength
+ */
+static void songPlay(OutputSink *sink, const Song *song, char* genres[])
+{
+    // every piece's length is already known, so nothing is scanned
+    outputPlaying(sink, songTitle(song), song->titleLength,
+        artistPoolName(song->artist), artistPoolLength(song->artist),
+        genres[song->genre]);
+}
+
+/**
+ * Function: playlistPlayFrom (helper)
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres. Genres are
  *                          listed in the array according to its enum value.
  *                          For example, "Pop" is at index genres[POP]
+ *                 backward - true to play from the last song to the first
  * Output argument: none
  * Return: none
- * Dependencies: stdio.h, ctype.h
+ * Dependencies: playlistFirst, playlistLast, playlistNext,
+ *               playlistPrevious, songPlay, stdio.h, ctype.h
  */
-void play(Song *playlist, char* genres[])
+static void playlistPlayFrom(const Playlist *playlist, OutputSink *sink,
+    char* genres[], bool backward)
 {
     // check if there are no songs in the playlist
-    if (playlist == NULL)
+    if (playlist->head == NULL)
     {
         // if so, print a message
-        printf("Nothing to be played right now. Add songs to continue.\n");
+        outputString(sink,
+            "Nothing to be played right now. Add songs to continue.\n");
     }
     // otherwise, print out the songs playing
     else
     {
         // create a pointer to track the current song playing and set it to the
-        // first song
-        Song* current = playlist;
+        // song to start from
+        Song* current = backward ? playlistLast(playlist) :
+            playlistFirst(playlist);
         // create an integer variable to store the song count and set equal to
         // zero
         int count = 0;
@@ -105,10 +274,10 @@ void play(Song *playlist, char* genres[])
         while (current != NULL && count < MAX_SONGS)
         {
             // print out the current song playing
-            printf("Playing '%s' by '%s' (Genre: %s) ...\n", current->title,
-            current->artist, genres[current->genre]);
+            songPlay(sink, current, genres);
             // move to next song
-            current = current->next;
+            current = backward ? playlistPrevious(playlist, current) :
+                playlistNext(playlist, current);
             // increment count
             count++;
             // check if count equals maximum songs
@@ -116,6 +285,8 @@ void play(Song *playlist, char* genres[])
             {
                 // if so, create character variable to store user input
                 char answer;
+                // the songs so far must show before the question does
+                outputFlush(sink);
                 // ask if the user is still listening
                 printf("Are you still listening [Y|N]? ");
                 // read their answer
@@ -142,497 +313,2256 @@ listening or N to stop: ");
             }
         }
     }
+    // hand the last songs to the destination
+    outputFlush(sink);
 }
 
+/**
+ * Function: playlistPlay
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres. Genres are
+ *                          listed in the array according to its enum value.
+ *                          For example, "Pop" is at index genres[POP]
+ * Output argument: none
+ * Return: none
+ * Dependencies: playlistPlayFrom
+ */
+void playlistPlay(const Playlist *playlist, OutputSink *sink,
+    char* genres[])
+{
+    // play from the first song onwards
+    playlistPlayFrom(playlist, sink, genres, false);
+}
 
 /**
- * Task 2: Adding a New Song to the Playlist
- * Input argument: playlist - a double pointer to a list of songs
+ * Function: playlistPlayBackward
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres. Genres are
+ *                          listed in the array according to its enum value.
+ *                          For example, "Pop" is at index genres[POP]
+ * Output argument: none
+ * Return: none
+ * Dependencies: playlistPlayFrom
+ */
+void playlistPlayBackward(const Playlist *playlist, OutputSink *sink,
+    char* genres[])
+{
+    // play from the last song back, one previous track at a time
+    playlistPlayFrom(playlist, sink, genres, true);
+}
+
+/**
+ * Function: playlistAddSong
+ * Input argument: playlist - a pointer to a playlist handle
  *                 title - a string with the title of the song
  *                 artist - a string with the artist of the song
  *                 genre - a Genre enum for the genre of the song
- * Output argument: updated head of the playlist, if needed
+ * Output argument: the song is added at the end of play order without
+ *                  walking the list
  * Return: true if the song is successfully added, false otherwise
  * Dependencies: stdlib.h, stdio.h, string.h
  */
-bool addSong(
-    Song **playlist, const char *title, const char *artist, Genre genre)
+bool playlistAddSong(
+    Playlist *playlist, const char *title, const char *artist, Genre genre)
 {
-    // check if song genre is invalid
-    if (genre < 0 || genre >= GENRE_COUNT)
+    // measure the strings once and append them
+    return playlistAppendSong(playlist, title, strlen(title), artist,
+        strlen(artist), genre);
+}
+
+/**
+ * Function: playlistInsertNamed (helper)
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 position - where the song goes in play order, at most the
+ *                            length
+ *                 title - the title, not necessarily null terminated
+ *                 titleLength - the number of bytes in the title
+ *                 artist - the artist, not necessarily null terminated
+ *                 artistLength - the number of bytes in the artist
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song plays at that position
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: artistPoolIntern, artistPoolRelease, playlistInsertInterned,
+ *               stdio.h
+ */
+static bool playlistInsertNamed(Playlist *playlist, size_t position,
+    const char *title, size_t titleLength, const char *artist,
+    size_t artistLength, Genre genre)
+{
+    // check if the artist would not fit in the artist pool
+    if (artistLength >= STR_LEN)
     {
         // print error message
-        printf("Invalid genre. Song not added.\n");
+        printf("Artist must be shorter than %d characters. "
+            "Song not added.\n", STR_LEN);
         // return false
         return false;
     }
-    // otherwise, dynamically allocate new song
-    Song* newSong = (Song*)malloc(sizeof(Song));
-    // copy the given title into the song's title
-    strcpy(newSong->title, title);
-    // copy the given artist into the song's artist name
-    strcpy(newSong->artist, artist);
-    // set the song's genre to the given genre
-    newSong->genre = genre;
-    // check if there are no songs in the playlist so far
-    if (*playlist == NULL)
+    // look the artist up in the shared pool, adding it if it is new
+    uint32_t id = artistPoolIntern(artist, artistLength);
+    // check if the pool could not grow
+    if (id == ARTIST_NONE)
     {
-        // if so, place the new song in the playlist
-        *playlist = newSong;
-        // set its pointer to the next song equal to null
-        newSong->next = NULL;
+        // print error message
+        printf("Out of memory. Song not added.\n");
+        // return false
+        return false;
     }
-    // otherwise, loop to the end of the playlist
-    else
+    // insert the song, which takes over the artist reference
+    if (!playlistInsertInterned(playlist, position, title, titleLength, id,
+        genre))
     {
-        // create pointer to keep track of current song
-        Song* currentSong = *playlist;
-        // loop until the last song is reached
-        while (currentSong->next != NULL)
-        {
-            // move ahead by one song
-            currentSong = currentSong->next;
-        }
-        // place the new song at the end of the playlist
-        currentSong->next = newSong;
-        // set its pointer to the next song equal to null
-        newSong->next = NULL;
+        // give the reference back if the song was not added
+        artistPoolRelease(id);
+        // return false
+        return false;
     }
     // return success
     return true;
 }
 
+/**
+ * Function: playlistAppendSong
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 title - the title, not necessarily null terminated
+ *                 titleLength - the number of bytes in the title
+ *                 artist - the artist, not necessarily null terminated
+ *                 artistLength - the number of bytes in the artist
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song is added at the end of play order without
+ *                  walking the list
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: playlistInsertNamed
+ */
+bool playlistAppendSong(Playlist *playlist, const char *title,
+    size_t titleLength, const char *artist, size_t artistLength, Genre genre)
+{
+    // the end of play order is the position after the last song
+    return playlistInsertNamed(playlist, playlist->length, title, titleLength,
+        artist, artistLength, genre);
+}
 
 /**
- * Task 3: Removing a Song from the Playlist
- * Input argument: playlist - a double pointer to a list of songs
+ * Function: playlistInsertSong
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 position - where the song goes in play order, at most the
+ *                            length
  *                 title - a string with the title of the song
- * Output argument: updated head of the playlist, if needed
- * Return: true if the song is successfully removed, false otherwise
- * Dependencies: stdlib.h, stdio.h, string.h
+ *                 artist - a string with the artist of the song
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song plays at that position, and the songs from
+ *                  there on one later
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: playlistInsertNamed, string.h
  */
-bool removeSong(Song **playlist, const char *title)
+bool playlistInsertSong(Playlist *playlist, size_t position,
+    const char *title, const char *artist, Genre genre)
 {
-    // check if playlist is empty
-    if (*playlist == NULL)
-    {
-        // if so, return false
-        return false;
-    }
-    // create variable to store current song
-    Song* current = *playlist;
-    // check if song is at the beginning of the playlist
-    if (strcmp(title, current->title) == 0)
-    {
-        // if so, shift the playlist so it points to the second song
-        *playlist = current->next;
-        // free the first song
-        free(current);
-        // return true
-        return true;
-    }
-    // loop while the title has not been found in the next song and the next
-    // song is not null
-    while (current->next != NULL && strcmp(title, (current->next)->title) != 0)
-    {
-        // move ahead by one song
-        current = current->next;
-    }
-    // check if next song is null, indicating the title has not been found
-    if (current->next == NULL)
-    {
-        // if so, print error message
-        printf("Song '%s' is not in the list.\n", title);
-        // return false
-        return false;
-    }
-    // otherwise, delete the song
-    else
-    {
-        // create a pointer that tracks the song to be deleted
-        Song* delete = current->next;
-        // have the current song point to the song following the song to be
-        // deleted (or to null, if the deleted song is the last song)
-        current->next = delete->next;
-        // free the song
-        free(delete);
-        // return success
-        return true;
-    }
+    // measure the strings once and insert them
+    return playlistInsertNamed(playlist, position, title, strlen(title),
+        artist, strlen(artist), genre);
 }
 
+/**
+ * Function: playlistAppendInterned
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 title - the title, not necessarily null terminated
+ *                 titleLength - the number of bytes in the title
+ *                 artist - an artist number the caller holds a reference to
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song is added at the end of play order in O(log N)
+ *                  expected, and takes over the caller's reference; on
+ *                  failure the caller keeps it
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: playlistInsertInterned
+ */
+bool playlistAppendInterned(Playlist *playlist, const char *title,
+    size_t titleLength, uint32_t artist, Genre genre)
+{
+    // the end of play order is the position after the last song
+    return playlistInsertInterned(playlist, playlist->length, title,
+        titleLength, artist, genre);
+}
 
 /**
- * Task 4: Shuffle Play
- * Input argument: playlist - a pointer to a list of songs
- *                 genres - an array with the names of the genres. Genres are 
- *                          listed in the array according to its enum value.
- *                          For example, "Pop" is at index genres[POP]
+ * Function: playlistLinkAt (helper)
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 link - a place in link order, below the length
  * Output argument: none
- * Return: none
- * Dependencies: stdlib.h, stdio.h
+ * Return: the song there, through the order index when there is one,
+ *         otherwise by walking from the nearer end
+ * Dependencies: orderAt
  */
-void playShuffle(Song *playlist, char* genres[])
+static Song *playlistLinkAt(const Playlist *playlist, size_t link)
 {
-    // create variable to store current song
-    Song* current = playlist;
-    // create variable to store length of playlist
-    int length = 0;
-    // loop through playlist
-    while (current != NULL)
-    {
-        // increment length
-        length++;
-        // move ahead to next song
-        current = current->next;
-    }
-    // set current pointer back to the beginning of the playlist
-    current = playlist;
-    // allocate memory for a shuffled list of song pointers
-    Song** shuffledList = (Song**)malloc(length*sizeof(Song*));
-    // loop through shuffled list
-    for (int i = 0; i < length; i++)
+    // the order index finds it in O(log N)
+    if (playlist->indexed)
     {
-        // set each value in it equal to null
-        shuffledList[i] = NULL;
+        return orderAt(&playlist->order, link);
     }
-    // create variable to store index in the shuffled list
-    int index;
-    // loop through playlist
-    while (current != NULL)
+    // otherwise walk forward from the head to a place in the first half
+    Song *song = NULL;
+    if (link <= playlist->length / 2)
     {
-        // calculate random index
-        index = rand() % length;
-        // if there is already a song at that index, loop until an unused
-        // index is reached
-        while (shuffledList[index] != NULL)
+        song = playlist->head;
+        for (size_t i = 0; i < link; i++)
         {
-            // calculate new random index
-            index = rand() % length;
+            song = song->next;
         }
-        // place the current song at that index
-        shuffledList[index] = current;
-        // move ahead to the next song
-        current = current->next;
     }
-    // loop through shuffled playlist
-    for (int i = 0; i < length; i++)
+    // and back from the tail to one in the second half
+    else
     {
-        // print each song in the playlist
-        printf("Playing '%s' by '%s' (Genre: %s) ...\n", 
-        shuffledList[i]->title, shuffledList[i]->artist, 
-        genres[shuffledList[i]->genre]);
+        song = playlist->tail;
+        for (size_t i = playlist->length - 1; i > link; i--)
+        {
+            song = song->prev;
+        }
     }
-    // free the memory used to create the shuffled list
-    free(shuffledList);
+    // return the song
+    return song;
 }
 
-
 /**
- * Task 5: Play Songs by Artist
- * Input argument: playlist - a pointer to a list of songs
- *                 artist - a string representing the artist name
- *                 genres - an array with the names of the genres. Genres are 
- *                          listed in the array according to its enum value.
- *                          For example, "Pop" is at index genres[POP]
+ * Function: playlistArtistBefore (helper)
+ * Input argument: playlist - a pointer to an indexed playlist handle
+ *                 song - a song about to be linked, with its artist set
+ *                 after - the song it is about to be linked after
+ *                 link - the new song's place in link order, above 0
  * Output argument: none
- * Return: none
- * Dependencies: string.h, stdio.h
+ * Return: the last song of the same artist before link in link order, or
+ *         NULL if there is none
+ * Dependencies: artistIndexFind, orderRank
+ *
+ * Two searches take turns: one walks the playlist back from after until it
+ * meets the artist, the other walks the artist's posting list back from its
+ * last song until it is before link. Whichever stops first has the answer,
+ * after O(min(gap, k)) steps, where gap is the distance back to the
+ * artist's nearest song and k the number of its songs at or after link.
+ * Each step of the posting list walk ranks a song in O(log N), so this is
+ * O(min(gap, k) * log N) expected.
  */
-void playByArtist(Song *playlist, const char *artist, char* genres[])
+static Song *playlistArtistBefore(const Playlist *playlist, const Song *song,
+    Song *after, size_t link)
 {
-    // create variable to store current song
-    Song* current = playlist;
-    // create variable to indicate if the artist's name has been found
-    bool artistFound = false;
-    // loop through playlist
-    while (current != NULL) 
+    // an artist without songs has none before the new one
+    const ArtistEntry *entry = artistIndexFind(&playlist->artists,
+        song->artist);
+    if (entry == NULL)
     {
-        // check if the current song is by the given artist
-        if (strcmp(current->artist, artist) == 0)
-        {
-            // if so, print out that song
-            printf("Playing '%s' by '%s' (Genre: %s) ...\n", current->title,
-            artist, genres[current->genre]);
-            // set artist found variable to true
-            artistFound = true;
-        }
-        // move ahead to next song
-        current = current->next;
+        return NULL;
     }
-    // check if the artist is not in the playlist
-    if (!artistFound)
+    Song *near = after;
+    size_t left = link;
+    Song *posting = entry->last;
+    // step both walks until one of them finds the song or runs out
+    while (left > 0 && posting != NULL)
     {
-        // if so, print a message to the users
-        printf("Nothing to be played by %s right now. Add songs to \
-continue.\n", artist);
+        // the nearest song before link that has the artist
+        if (near->artist == song->artist)
+        {
+            return near;
+        }
+        near = near->prev;
+        left--;
+        // the artist's latest song that comes before link
+        if (orderRank(posting) < link)
+        {
+            return posting;
+        }
+        posting = posting->artistPrev;
     }
+    // a walk that ran out saw every song before link
+    return NULL;
 }
 
-
 /**
- * Task 6: Sorting the Playlist by Genre
- * Input argument: playlist - a double pointer to a list of songs
- * Output argument: playlist sorted by genre
- * Return: void
- * Dependencies: stdio.h - printf
+ * Function: playlistGenreBefore (helper)
+ * Input argument: playlist - a pointer to an indexed playlist handle
+ *                 song - a song about to be linked, with its genre set
+ *                 after - the song it is about to be linked after
+ *                 link - the new song's place in link order, above 0
+ * Output argument: none
+ * Return: the last song of the same genre before link in link order, or
+ *         NULL if there is none
+ * Dependencies: orderRank
+ *
+ * Searches both ways at once like playlistArtistBefore: back through the
+ * playlist from after, and back along the genre's chain from its end, in
+ * O(min(gap, k) * log N) expected. With only GENRE_COUNT genres gap is
+ * short in a mixed playlist, but after a sort by genre both can be large.
  */
-void sortByGenre(Song **playlist)
+static Song *playlistGenreBefore(const Playlist *playlist, const Song *song,
+    Song *after, size_t link)
 {
-    // check if no songs are in the playlist
-    if (*playlist == NULL)
-    {
-        // if so, print message to user
-        printf("It is quiet here. Add songs to continue.\n");
-    }
-    // otherwise, sort the playlist
-    else
+    Song *near = after;
+    size_t left = link;
+    Song *chained = playlist->genreChains[song->genre].last;
+    // step both walks until one of them finds the song or runs out
+    while (left > 0 && chained != NULL)
     {
-        // create variable to store number of swaps
-        int swaps = 1;
-        // create pointer to current song
-        Song* current = *playlist;
-        // create pointer to first song being swapped
-        Song* swap1 = NULL;
-        // create pointer to second song being swapped
-        Song* swap2 = NULL;
-        // loop until no swaps are needed
-        while (swaps > 0)
-        {
-            // set swaps equal to zero
-            swaps = 0;
-            // loop until the second-to-last song is reached
-            while ((current->next)->next != NULL)
-            {
-                // check if the first and second songs need to be swapped
-                if (current == *playlist && current->genre > 
-                (current->next)->genre)
-                {
-                    // if so, set swap1 to the first song
-                    swap1 = current;
-                    // set swap2 to the second song
-                    swap2 = current->next;
-                    // have the first song point to the song after the second
-                    swap1->next = swap2->next;
-                    // have the second song point to the first
-                    swap2->next = swap1;
-                    // increment number of swaps
-                    swaps ++;
-                    // move current pointer to second song
-                    current = swap1;
-                    // have playlist pointer point to the new first song
-                    *playlist = swap2;
-                }
-                // otherwise, the current pointer is in the middle of the 
-                // playlist
-                else 
-                {
-                    // set swap1 to the first song after current
-                    swap1 = current->next;
-                    // set swap2 to the second song after current
-                    swap2 = (current->next)->next;
-                    // check if swap1's genre exceeds swap2's
-                    if (swap1->genre > swap2->genre)
-                    {
-                        // if so, have current point to the second song
-                        current->next = swap2;
-                        // have the first song point to the song after the 
-                        // second song
-                        swap1->next = swap2->next;
-                        // have the second song point to the first
-                        swap2->next = swap1;
-                        // have the current pointer move to the second song
-                        current = swap2;
-                        // increment number of swaps
-                        swaps++;
-                    }
-                    // if not, no swaps need to be performed
-                    else
-                    {
-                        // have current point to the next song in the playlist
-                        current = current->next;
-                    }
-                }
-            }
-            // reset current to point to the beginning of the playlist
-            current = *playlist;
+        // the nearest song before link that has the genre
+        if (near->genre == song->genre)
+        {
+            return near;
         }
-        // print message to user
-        printf("Playlist will play by genre from here on!\n");
+        near = near->prev;
+        left--;
+        // the genre's latest song that comes before link
+        if (orderRank(chained) < link)
+        {
+            return chained;
+        }
+        chained = chained->genrePrev;
     }
+    // a walk that ran out saw every song before link
+    return NULL;
 }
 
+/**
+ * Function: playlistPrefixDrop (helper)
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: the completions are freed, to be built again on next use
+ * Return: none
+ * Dependencies: prefixFree
+ */
+static void playlistPrefixDrop(Playlist *playlist)
+{
+    prefixFree(&playlist->titlePrefixes);
+    prefixFree(&playlist->artistPrefixes);
+    playlist->prefixed = false;
+}
 
 /**
- * Task 7: Detecting a Cycle in the Playlist
- * Input argument: playlist - a pointer to a list of songs
- * Output argument: none
- * Return: true if the last song points to the head of the playlist,
- *         false otherwise
- * Dependencies: none
+ * Function: playlistPrefixChange (helper)
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 song - a song being added or removed
+ *                 add - true if it is being added, false if removed
+ * Output argument: the song's title and artist are counted in or out of
+ *                  the completions, if they are built
+ * Return: none
+ * Dependencies: prefixAdd, prefixRemove, playlistPrefixDrop,
+ *               artistPoolName, artistPoolLength
+ *
+ * Completions that cannot be changed are dropped rather than left wrong.
  */
-bool detectCycle(Song *playlist)
+static void playlistPrefixChange(Playlist *playlist, const Song *song,
+    bool add)
 {
-    // create pointer to current song
-    Song* currentSong = playlist;
-    // loop through playlist
-    while (currentSong != NULL)
+    // nothing to keep up to date before the first use
+    if (!playlist->prefixed)
     {
-        // move ahead by one song
-        currentSong = currentSong->next;
-        // check if the current variable points to the same song as the
-        // head of the playlist
-        if (currentSong == playlist)
-        {
-            // if so, the playlist is on a loop, so return true
-            return true;
-        }
+        return;
+    }
+    const char *title = songTitle(song);
+    const char *artist = artistPoolName(song->artist);
+    size_t artistLength = artistPoolLength(song->artist);
+    bool changed = add ?
+        prefixAdd(&playlist->titlePrefixes, title, song->titleLength) &&
+        prefixAdd(&playlist->artistPrefixes, artist, artistLength) :
+        prefixRemove(&playlist->titlePrefixes, title, song->titleLength) &&
+        prefixRemove(&playlist->artistPrefixes, artist, artistLength);
+    if (!changed)
+    {
+        playlistPrefixDrop(playlist);
     }
-    // return false if the end of the playlist has been reached
-    return false;
 }
 
-
 /**
- * Task 8: Play Non-Stop
- * Input argument: playlist - a double pointer to a list of songs
- * Output argument: playlist is configured to be circular
- * Return: void
- * Dependencies: detectCycle, stdio.h
+ * Function: playlistInsertInterned
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 position - where the song goes in play order, at most the
+ *                            length
+ *                 title - the title, not necessarily null terminated
+ *                 titleLength - the number of bytes in the title
+ *                 artist - an artist number the caller holds a reference to
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song plays at that position and takes over the
+ *                  caller's reference; on failure the caller keeps it
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: songPoolAlloc, titleIndexInsert, artistIndexAppend,
+ *               artistIndexInsertAfter, genreChainAppend,
+ *               genreChainInsertAfter, orderAt, orderInsert,
+ *               cursorsAppended, playlistPrefixChange, stdio.h, string.h
+ *
+ * In an indexed playlist an append costs O(log N) expected, since even it
+ * joins the order index along a spine. Anywhere else the song's place in
+ * its artist's posting list and its genre's chain is searched from both
+ * sides at once, which takes O(min(gap, k) * log N) expected: gap is the
+ * number of songs back to the nearest earlier one of the same artist or
+ * genre, k the number of that artist's or genre's songs after position,
+ * and each step of the chain walk ranks a song. A song of a genre that is
+ * sorted far from position can cost a millisecond on a million songs. An
+ * unindexed playlist links a song at either end in O(1) and walks to a
+ * middle position.
  */
-void makePlaylistCircular(Song **playlist)
+bool playlistInsertInterned(Playlist *playlist, size_t position,
+    const char *title, size_t titleLength, uint32_t artist, Genre genre)
 {
-    // check if no songs are in the playlist
-    if (*playlist == NULL)
+    // check if the position is past the end of the playlist
+    if (position > playlist->length)
     {
-        // if so, print a message to the user
-        printf("It is quiet here. Add songs to continue.\n");
+        // print error message
+        printf("Position is past the end. Song not added.\n");
+        // return false
+        return false;
     }
-    // check if music is already playing continuously
-    else if (detectCycle(*playlist))
+    // check if song genre is invalid
+    if (genre < 0 || genre >= GENRE_COUNT)
+    {
+        // print error message
+        printf("Invalid genre. Song not added.\n");
+        // return false
+        return false;
+    }
+    // check if the title's length would not fit in the song
+    if (titleLength >= UINT32_MAX)
+    {
+        // print error message
+        printf("Title is too long. Song not added.\n");
+        // return false
+        return false;
+    }
+    // otherwise, take a new song from the playlist's slabs
+    Song* newSong = songPoolAlloc(&playlist->pool);
+    // check if the allocation failed
+    if (newSong == NULL)
+    {
+        // print error message
+        printf("Out of memory. Song not added.\n");
+        // return false
+        return false;
+    }
+    // copy the given title into the song, or into the pool's text blocks
+    if (!songSetTitle(newSong, &playlist->pool, title, titleLength))
+    {
+        // give the song back if the title did not fit anywhere
+        songPoolFree(&playlist->pool, newSong);
+        // print error message
+        printf("Out of memory. Song not added.\n");
+        // return false
+        return false;
+    }
+    // the song refers to its artist by number
+    newSong->artist = artist;
+    // set the song's genre to the given genre
+    newSong->genre = genre;
+    // play order runs against the links when reversed
+    size_t length = playlist->length;
+    size_t link = playlist->reversed ? length - position : position;
+    // the song the new one is linked after, NULL at the front
+    Song *after = link == length ? playlist->tail :
+        link == 0 ? NULL : playlistLinkAt(playlist, link - 1);
+    // index the title; copies are told apart by their place in the order
+    if (playlist->indexed && !titleIndexInsert(&playlist->titles, newSong))
+    {
+        // give the song back if the index could not grow
+        songPoolFree(&playlist->pool, newSong);
+        // print error message
+        printf("Out of memory. Song not added.\n");
+        // return false
+        return false;
+    }
+    // link the song into its artist's posting list where it goes
+    if (playlist->indexed && !(link == length ?
+        artistIndexAppend(&playlist->artists, newSong) :
+        artistIndexInsertAfter(&playlist->artists, newSong, link == 0 ? NULL :
+            playlistArtistBefore(playlist, newSong, after, link))))
+    {
+        // undo the title entry and give the song back
+        titleIndexRemove(&playlist->titles, newSong);
+        songPoolFree(&playlist->pool, newSong);
+        // print error message
+        printf("Out of memory. Song not added.\n");
+        // return false
+        return false;
+    }
+    // and into its genre's chain, which cannot fail
+    if (playlist->indexed)
+    {
+        GenreChain *chain = &playlist->genreChains[genre];
+        if (link == length)
+        {
+            genreChainAppend(chain, newSong);
+        }
+        else
+        {
+            genreChainInsertAfter(chain, newSong, link == 0 ? NULL :
+                playlistGenreBefore(playlist, newSong, after, link));
+        }
+    }
+    // check if there are no songs in the playlist so far
+    if (playlist->head == NULL)
+    {
+        // if so, the new song is the whole playlist
+        playlist->head = newSong;
+        playlist->tail = newSong;
+        // a circular playlist of one points at itself both ways
+        newSong->next = playlist->circular ? newSong : NULL;
+        newSong->prev = newSong->next;
+    }
+    // otherwise, link it between its neighbours without walking
+    else
+    {
+        // at the front, a circular playlist wraps back to the tail
+        newSong->prev = after != NULL ? after :
+            playlist->circular ? playlist->tail : NULL;
+        // and the tail of a linear one has nothing after it
+        newSong->next = after != NULL ? after->next : playlist->head;
+        if (newSong->prev != NULL)
+        {
+            newSong->prev->next = newSong;
+        }
+        if (newSong->next != NULL)
+        {
+            newSong->next->prev = newSong;
+        }
+        // the new song may be a new head or tail
+        if (link == 0)
+        {
+            playlist->head = newSong;
+        }
+        if (link == length)
+        {
+            playlist->tail = newSong;
+        }
+    }
+    // give it its rank, which moves the songs after it up by one
+    if (playlist->indexed)
+    {
+        orderInsert(&playlist->order, newSong, link);
+    }
+    // count it
+    playlist->length++;
+    // a song before the end renumbers the songs after it
+    if (position < length)
+    {
+        playlist->generation++;
+    }
+    // cursors that played every song go on with one added at the end
+    else
+    {
+        cursorsAppended(playlist, newSong);
+    }
+    // count its title and artist in the completions
+    playlistPrefixChange(playlist, newSong, true);
+    // return success
+    return true;
+}
+
+/**
+ * Function: playlistDetachSong
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 current - a song of the playlist
+ * Output argument: the song is unlinked but not freed; cursors on it move on
+ *                  to the next song
+ * Return: none
+ * Dependencies: cursorsRemoving, titleIndexRemove, artistIndexRemove,
+ *               genreChainRemove, orderRemove, playlistPrefixChange
+ *
+ * The song keeps its title, artist and genre until playlistReleaseSong, so
+ * readers that may still hold it can finish with it first.
+ */
+void playlistDetachSong(Playlist *playlist, Song *current)
+{
+    // move cursors off the song while its links are intact, and renumber
+    // the songs after it
+    cursorsRemoving(playlist, current);
+    playlist->generation++;
+    // drop the song from the indexes
+    if (playlist->indexed)
+    {
+        titleIndexRemove(&playlist->titles, current);
+        artistIndexRemove(&playlist->artists, current);
+        genreChainRemove(&playlist->genreChains[current->genre], current);
+        orderRemove(&playlist->order, current);
+    }
+    // and from the completions
+    playlistPrefixChange(playlist, current, false);
+    // check if this is the only song
+    if (playlist->length == 1)
+    {
+        // if so, the playlist becomes empty and linear again
+        playlist->head = NULL;
+        playlist->tail = NULL;
+        playlist->length = 0;
+        playlist->circular = false;
+        playlist->reversed = false;
+    }
+    // otherwise, bypass it from both neighbours without walking
+    else
+    {
+        // the neighbours of a circular playlist wrap around, so only the
+        // head's prev and the tail's next of a linear one are missing
+        if (current->prev != NULL)
+        {
+            current->prev->next = current->next;
+        }
+        if (current->next != NULL)
+        {
+            current->next->prev = current->prev;
+        }
+        // the second song becomes the head if the head was removed
+        if (current == playlist->head)
+        {
+            playlist->head = current->next;
+        }
+        // the song before becomes the tail if the tail was removed
+        if (current == playlist->tail)
+        {
+            playlist->tail = current->prev;
+        }
+        // one song fewer
+        playlist->length--;
+    }
+}
+
+/**
+ * Function: playlistReleaseSong
+ * Input argument: playlist - a pointer to the playlist handle the song was
+ *                            detached from
+ *                 song - a detached song
+ * Output argument: the song gives its artist reference back and is freed
+ * Return: none
+ * Dependencies: artistPoolRelease, songPoolFree
+ */
+void playlistReleaseSong(Playlist *playlist, Song *song)
+{
+    // the song no longer needs its artist's name
+    artistPoolRelease(song->artist);
+    // return the song to the playlist's slabs
+    songPoolFree(&playlist->pool, song);
+}
+
+/**
+ * Function: playlistRemoveSong
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 title - a string with the title of the song
+ * Output argument: the first song in play order with that title is
+ *                  unlinked and freed; cursors on it move on to the next song
+ * Return: true if the song is successfully removed, false otherwise
+ * Dependencies: titleIndexFind, playlistScanTitle, playlistDetachSong,
+ *               playlistReleaseSong, stdio.h, string.h
+ */
+bool playlistRemoveSong(Playlist *playlist, const char *title)
+{
+    // check if playlist is empty
+    if (playlist->head == NULL)
+    {
+        // if so, return false
+        return false;
+    }
+    // find the song through the index, or by walking the playlist
+    Song* current = playlist->indexed ?
+        titleIndexFind(&playlist->titles, title, playlist->reversed) :
+        playlistScanTitle(playlist, title);
+    // check if the title was not found
+    if (current == NULL)
+    {
+        // if so, print error message
+        printf("Song '%s' is not in the list.\n", title);
+        // return false
+        return false;
+    }
+    // unlink and free it
+    playlistDetachSong(playlist, current);
+    playlistReleaseSong(playlist, current);
+    // return success
+    return true;
+}
+
+/**
+ * Function: playlistRemoveAt
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 position - a place in play order
+ * Output argument: the song there is unlinked and freed; cursors on it
+ *                  move on to the next song
+ * Return: true if the song is successfully removed, false if position is
+ *         past the end
+ * Dependencies: playlistSongAt, playlistDetachSong, playlistReleaseSong
+ */
+bool playlistRemoveAt(Playlist *playlist, size_t position)
+{
+    // find the song by its place in play order
+    Song *current = playlistSongAt(playlist, position);
+    // check if there is no song there
+    if (current == NULL)
+    {
+        // if so, return false
+        return false;
+    }
+    // unlink and free it
+    playlistDetachSong(playlist, current);
+    playlistReleaseSong(playlist, current);
+    // return success
+    return true;
+}
+
+/**
+ * Function: playlistPlayShuffle
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres. Genres are
+ *                          listed in the array according to its enum value.
+ *                          For example, "Pop" is at index genres[POP]
+ *                 seed - the shuffle seed; equal seeds give equal orders
+ * Output argument: none
+ * Return: none
+ * Dependencies: rngSeed, rngBelow, songPlay, stdlib.h, stdio.h
+ */
+void playlistPlayShuffle(const Playlist *playlist, OutputSink *sink,
+    char* genres[], uint64_t seed)
+{
+    // the handle already knows the length
+    size_t length = playlist->length;
+    // nothing to shuffle in an empty playlist
+    if (length == 0)
+    {
+        return;
+    }
+    // allocate memory for a shuffled list of song pointers
+    Song** shuffledList = (Song**)malloc(length*sizeof(Song*));
+    // give up if the allocation failed
+    if (shuffledList == NULL)
+    {
+        printf("Out of memory. Cannot shuffle.\n");
+        return;
+    }
+    // create variable to store current song
+    Song* current = playlistFirst(playlist);
+    // copy each song once in play order
+    for (size_t i = 0; i < length; i++)
+    {
+        // place the current song at the next index
+        shuffledList[i] = current;
+        // move ahead to the next song
+        current = playlistNext(playlist, current);
+    }
+    // seed the generator so equal seeds give equal shuffles
+    Rng rng;
+    rngSeed(&rng, seed);
+    // Fisher-Yates: swap each slot, from the back, with a random slot at or
+    // before it, which makes every order equally likely in one pass
+    for (size_t i = length - 1; i > 0; i--)
+    {
+        // pick a slot in [0, i]
+        size_t j = (size_t)rngBelow(&rng, i + 1);
+        // swap the two songs
+        Song* swap = shuffledList[i];
+        shuffledList[i] = shuffledList[j];
+        shuffledList[j] = swap;
+    }
+    // loop through shuffled playlist
+    for (size_t i = 0; i < length; i++)
+    {
+        // print each song in the playlist
+        songPlay(sink, shuffledList[i], genres);
+    }
+    // free the memory used to create the shuffled list
+    free(shuffledList);
+    // hand the songs to the destination
+    outputFlush(sink);
+}
+
+/**
+ * Function: songViewArrayAt (helper)
+ * Input argument: context - the array of song pointers behind the view
+ *                 index - a position in the array
+ * Output argument: none
+ * Return: the song at that position
+ * Dependencies: none
+ */
+static Song *songViewArrayAt(const void *context, size_t index)
+{
+    // read the position straight from the array
+    return ((Song *const *)context)[index];
+}
+
+/**
+ * Function: songViewFromArray
+ * Input argument: view - a pointer to the view to fill in
+ *                 songs - an array of song pointers, in play order
+ *                 length - the number of songs in the array
+ * Output argument: view reads positions straight from the array
+ * Return: void
+ * Dependencies: songViewArrayAt
+ */
+void songViewFromArray(SongView *view, Song *const *songs, size_t length)
+{
+    // the view covers the whole array
+    view->length = length;
+    // and looks positions up in it
+    view->songAt = songViewArrayAt;
+    view->context = songs;
+}
+
+/**
+ * Function: songViewPlaylistAt (helper)
+ * Input argument: context - the playlist handle behind the view
+ *                 index - a position in play order
+ * Output argument: none
+ * Return: the song at that position
+ * Dependencies: playlistSongAt
+ */
+static Song *songViewPlaylistAt(const void *context, size_t index)
+{
+    // look the position up through the order index
+    return playlistSongAt((const Playlist *)context, index);
+}
+
+/**
+ * Function: songViewFromPlaylist
+ * Input argument: view - a pointer to the view to fill in
+ *                 playlist - a pointer to a playlist handle
+ * Output argument: view reads positions in play order from the playlist
+ * Return: void
+ * Dependencies: songViewPlaylistAt
+ *
+ * Each lookup is O(log N) expected through the order index, with nothing
+ * copied, so the view costs O(1) memory. The playlist must not be edited
+ * while the view is read.
+ */
+void songViewFromPlaylist(SongView *view, const Playlist *playlist)
+{
+    // the view covers the whole playlist
+    view->length = playlist->length;
+    // and looks positions up in it
+    view->songAt = songViewPlaylistAt;
+    view->context = playlist;
+}
+
+/**
+ * Function: playShuffleStream
+ * Input argument: view - songs with positional access
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres. Genres are
+ *                          listed in the array according to its enum value.
+ *                          For example, "Pop" is at index genres[POP]
+ *                 seed - the shuffle seed; equal seeds give equal orders
+ * Output argument: none
+ * Return: none
+ * Dependencies: permutationInit, permutationAt, songPlay
+ *
+ * A keyed Feistel permutation maps each play position to a song position,
+ * so the shuffle needs O(1) extra memory and the first song plays at once.
+ */
+void playShuffleStream(const SongView *view, OutputSink *sink,
+    char* genres[], uint64_t seed)
+{
+    // nothing to shuffle in an empty view
+    if (view->length == 0)
+    {
+        return;
+    }
+    // build the permutation for this seed
+    Permutation permutation;
+    permutationInit(&permutation, view->length, seed);
+    // play each position in turn
+    for (size_t i = 0; i < view->length; i++)
+    {
+        // find the song the permutation puts here
+        Song* song = view->songAt(view->context,
+            (size_t)permutationAt(&permutation, i));
+        // print it
+        songPlay(sink, song, genres);
+    }
+    // hand the songs to the destination
+    outputFlush(sink);
+}
+
+/**
+ * Function: playlistPlayByArtist
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 artist - a string representing the artist name
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres. Genres are
+ *                          listed in the array according to its enum value.
+ *                          For example, "Pop" is at index genres[POP]
+ * Output argument: none
+ * Return: none
+ * Dependencies: artistPoolFind, artistIndexFind, playlistFirst,
+ *               playlistNext, songPlay
+ */
+void playlistPlayByArtist(const Playlist *playlist, const char *artist,
+    OutputSink *sink, char* genres[])
+{
+    // create variable to indicate if the artist's name has been found
+    bool artistFound = false;
+    // one string lookup turns the name into a number; an unknown name has
+    // no songs anywhere
+    uint32_t id = artistPoolFind(artist);
+    // check if the artist index can answer
+    if (id != ARTIST_NONE && playlist->indexed)
+    {
+        // look up the artist's posting list
+        const ArtistEntry* entry = artistIndexFind(&playlist->artists, id);
+        // walk only the artist's songs, which are in link order, from the
+        // end that comes first in play order
+        bool backward = playlist->reversed;
+        Song* start = entry == NULL ? NULL :
+            backward ? entry->last : entry->first;
+        for (Song* current = start; current != NULL;
+            current = backward ? current->artistPrev : current->artistNext)
+        {
+            // print out that song
+            songPlay(sink, current, genres);
+            // set artist found variable to true
+            artistFound = true;
+        }
+    }
+    // otherwise, scan the whole playlist comparing numbers
+    else if (id != ARTIST_NONE)
+    {
+        // create variable to store current song
+        Song* current = playlistFirst(playlist);
+        // loop through each song once, which also stops on circular playlists
+        for (size_t i = 0; i < playlist->length; i++)
+        {
+            // check if the current song is by the given artist
+            if (current->artist == id)
+            {
+                // if so, print out that song
+                songPlay(sink, current, genres);
+                // set artist found variable to true
+                artistFound = true;
+            }
+            // move ahead to next song
+            current = playlistNext(playlist, current);
+        }
+    }
+    // check if the artist is not in the playlist
+    if (!artistFound)
+    {
+        // if so, print a message to the users
+        outputString(sink, "Nothing to be played by ");
+        outputString(sink, artist);
+        outputString(sink, " right now. Add songs to continue.\n");
+    }
+    // hand the songs to the destination
+    outputFlush(sink);
+}
+
+/**
+ * Function: playlistCountByArtist
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 artist - a string representing the artist name
+ * Output argument: none
+ * Return: the number of songs by the artist, in O(1) expected time
+ * Dependencies: artistPoolFind, artistIndexFind
+ */
+size_t playlistCountByArtist(const Playlist *playlist, const char *artist)
+{
+    // an unknown name has no songs anywhere
+    uint32_t id = artistPoolFind(artist);
+    if (id == ARTIST_NONE)
+    {
+        return 0;
+    }
+    // check if the artist index can answer
+    if (playlist->indexed)
+    {
+        // the posting list keeps its own count
+        const ArtistEntry* entry = artistIndexFind(&playlist->artists, id);
+        return entry != NULL ? entry->count : 0;
+    }
+    // otherwise, count while walking the playlist
+    size_t count = 0;
+    Song* current = playlist->head;
+    for (size_t i = 0; i < playlist->length; i++)
+    {
+        count += current->artist == id;
+        current = current->next;
+    }
+    // return the count
+    return count;
+}
+
+/**
+ * Function: playlistListArtists
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 artists - an array to fill with artist names, may be NULL
+ *                 counts - an array to fill with song counts, may be NULL
+ *                 max - the number of elements each array can hold
+ * Output argument: the first max artists, in no particular order, and
+ *                  their song counts
+ * Return: the number of distinct artists in the playlist
+ * Dependencies: none
+ */
+size_t playlistListArtists(const Playlist *playlist, const char **artists,
+    size_t *counts, size_t max)
+{
+    // only the artist index knows the distinct artists
+    if (!playlist->indexed || playlist->artists.slots == NULL)
+    {
+        return 0;
+    }
+    // create variable to count the artists written so far
+    size_t written = 0;
+    // loop through every slot of the index
+    for (size_t i = 0; i <= playlist->artists.mask && written < max; i++)
+    {
+        // create a pointer to the slot
+        const ArtistEntry* entry = &playlist->artists.slots[i];
+        // skip empty slots
+        if (entry->first == NULL)
+        {
+            continue;
+        }
+        // copy out the artist and its count
+        if (artists != NULL)
+        {
+            artists[written] = songArtist(entry->first);
+        }
+        if (counts != NULL)
+        {
+            counts[written] = entry->count;
+        }
+        written++;
+    }
+    // return the total number of artists
+    return playlist->artists.count;
+}
+
+/**
+ * Function: playlistGenreNext (helper)
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 genre - a Genre enum for the genre to follow
+ *                 song - a song of that genre, or NULL to start
+ * Output argument: none
+ * Return: the genre's next song in play order after song, or its first one
+ *         for NULL; NULL once the genre has no more songs
+ * Dependencies: playlistFirst, playlistNext
+ *
+ * O(1) along the genre's chain in an indexed playlist; otherwise a walk
+ * that stops at the end of play order, even on a circular playlist.
+ */
+static Song *playlistGenreNext(const Playlist *playlist, Genre genre,
+    const Song *song)
+{
+    // the chains run in link order, so read them backwards when reversed
+    if (playlist->indexed)
+    {
+        const GenreChain *chain = &playlist->genreChains[genre];
+        if (song == NULL)
+        {
+            return playlist->reversed ? chain->last : chain->first;
+        }
+        return playlist->reversed ? song->genrePrev : song->genreNext;
+    }
+    // otherwise, walk on from the song to the next one of the genre
+    Song *first = playlistFirst(playlist);
+    Song *current = song == NULL ? first : playlistNext(playlist, song);
+    // a circular playlist is over once it wraps around to the first song
+    if (song != NULL && current == first)
+    {
+        return NULL;
+    }
+    while (current != NULL)
+    {
+        if (current->genre == genre)
+        {
+            return current;
+        }
+        current = playlistNext(playlist, current);
+        if (current == first)
+        {
+            return NULL;
+        }
+    }
+    // a linear playlist ran out
+    return NULL;
+}
+
+/**
+ * Function: playlistPlayByGenre
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 genre - a Genre enum for the genre to play
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres
+ * Output argument: none
+ * Return: none
+ * Dependencies: playlistGenreNext, songPlay
+ *
+ * Walks only the genre's chain, so it costs O(k) for k songs.
+ */
+void playlistPlayByGenre(const Playlist *playlist, Genre genre,
+    OutputSink *sink, char* genres[])
+{
+    // check if the genre is invalid
+    if (genre < 0 || genre >= GENRE_COUNT)
+    {
+        outputString(sink, "Invalid genre.\n");
+        outputFlush(sink);
+        return;
+    }
+    // play the genre's songs in play order
+    Song* current = playlistGenreNext(playlist, genre, NULL);
+    bool genreFound = current != NULL;
+    for (; current != NULL;
+        current = playlistGenreNext(playlist, genre, current))
+    {
+        songPlay(sink, current, genres);
+    }
+    // check if the genre has no songs in the playlist
+    if (!genreFound)
+    {
+        // if so, print a message to the users
+        outputString(sink, "Nothing to be played in ");
+        outputString(sink, genres[genre]);
+        outputString(sink, " right now. Add songs to continue.\n");
+    }
+    // hand the songs to the destination
+    outputFlush(sink);
+}
+
+/**
+ * Function: playlistCountByGenre
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 genre - a Genre enum for the genre to count
+ * Output argument: none
+ * Return: the number of songs of the genre, in O(1) in an indexed playlist
+ * Dependencies: none
+ */
+size_t playlistCountByGenre(const Playlist *playlist, Genre genre)
+{
+    // an invalid genre has no songs
+    if (genre < 0 || genre >= GENRE_COUNT)
+    {
+        return 0;
+    }
+    // the chain keeps its own count
+    if (playlist->indexed)
+    {
+        return playlist->genreChains[genre].count;
+    }
+    // otherwise, count while walking the playlist
+    size_t count = 0;
+    Song* current = playlist->head;
+    for (size_t i = 0; i < playlist->length; i++)
+    {
+        count += current->genre == genre;
+        current = current->next;
+    }
+    // return the count
+    return count;
+}
+
+/**
+ * Function: playlistPlayInterleaved
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres
+ * Output argument: none
+ * Return: none
+ * Dependencies: playlistGenreNext, songPlay
+ *
+ * Plays every song once, taking turns between the genres in enum order:
+ * each turn plays the next song in play order of a genre that has songs
+ * left. O(N) in an indexed playlist, since each chain is read once.
+ */
+void playlistPlayInterleaved(const Playlist *playlist, OutputSink *sink,
+    char* genres[])
+{
+    // check if there are no songs in the playlist
+    if (playlist->head == NULL)
+    {
+        outputString(sink,
+            "Nothing to be played right now. Add songs to continue.\n");
+        outputFlush(sink);
+        return;
+    }
+    // each genre's next song to play
+    Song* next[GENRE_COUNT];
+    int left = 0;
+    for (int genre = 0; genre < GENRE_COUNT; genre++)
+    {
+        next[genre] = playlistGenreNext(playlist, (Genre)genre, NULL);
+        left += next[genre] != NULL;
+    }
+    // go round the genres until every one has run out
+    while (left > 0)
+    {
+        for (int genre = 0; genre < GENRE_COUNT; genre++)
+        {
+            // skip genres that already ran out
+            if (next[genre] == NULL)
+            {
+                continue;
+            }
+            // play the genre's song and move on to its next one
+            songPlay(sink, next[genre], genres);
+            next[genre] = playlistGenreNext(playlist, (Genre)genre,
+                next[genre]);
+            left -= next[genre] == NULL;
+        }
+    }
+    // hand the songs to the destination
+    outputFlush(sink);
+}
+
+/**
+ * Function: playlistPrefixBuild (helper)
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: the completions hold every song's title and artist,
+ *                  unless they already did
+ * Return: true on success, false if memory ran out
+ * Dependencies: prefixBuild, playlistListArtists, playlistPrefixDrop,
+ *               songTitle, artistPoolName, stdlib.h
+ */
+static bool playlistPrefixBuild(Playlist *playlist)
+{
+    // built once, then kept up to date
+    if (playlist->prefixed)
+    {
+        return true;
+    }
+    // gather the names, one per song, so each is counted per song
+    const char **names = malloc((playlist->length + 1) * sizeof(char*));
+    if (names == NULL)
+    {
+        printf("Memory allocation failed.\n");
+        return false;
+    }
+    Song *current = playlist->head;
+    for (size_t i = 0; i < playlist->length; i++)
+    {
+        names[i] = songTitle(current);
+        current = current->next;
+    }
+    bool built = prefixBuild(&playlist->titlePrefixes, names, NULL,
+        playlist->length);
+    // the artist index already counts each artist's songs
+    size_t *counts = NULL;
+    size_t artists = 0;
+    if (built && playlist->indexed)
+    {
+        counts = malloc((playlist->artists.count + 1) * sizeof(size_t));
+        artists = playlistListArtists(playlist, names, counts,
+            playlist->artists.count);
+        built = counts != NULL;
+    }
+    // otherwise, each song's artist is counted once
+    else if (built)
+    {
+        current = playlist->head;
+        for (size_t i = 0; i < playlist->length; i++)
+        {
+            names[i] = artistPoolName(current->artist);
+            current = current->next;
+        }
+        artists = playlist->length;
+    }
+    built = built && prefixBuild(&playlist->artistPrefixes, names, counts,
+        artists);
+    free(names);
+    free(counts);
+    // keep both or neither
+    playlist->prefixed = built;
+    if (!built)
+    {
+        playlistPrefixDrop(playlist);
+        printf("Memory allocation failed.\n");
+    }
+    return built;
+}
+
+/**
+ * Function: playlistComplete
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 artists - true to complete artists, false for titles
+ *                 prefix - the start of the names wanted, in any case
+ *                 results - where to put the names
+ *                 max - the most names wanted, at most PREFIX_MAX_RESULTS
+ * Output argument: results holds the first names in alphabetical order
+ *                  that start with prefix, ignoring ASCII case, with their
+ *                  song counts
+ * Return: the number of names found
+ * Dependencies: playlistPrefixBuild, prefixComplete
+ *
+ * O(log N + prefix + max) once the completions are built; the first call
+ * builds them in O(N log N).
+ */
+size_t playlistComplete(Playlist *playlist, bool artists, const char *prefix,
+    PrefixResults *results, size_t max)
+{
+    // build the completions on first use
+    if (!playlistPrefixBuild(playlist))
+    {
+        results->count = 0;
+        return 0;
+    }
+    return prefixComplete(artists ? &playlist->artistPrefixes :
+        &playlist->titlePrefixes, prefix, results, max);
+}
+
+/**
+ * Function: playlistSuggest
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 artists - true to suggest artists, false for titles
+ *                 query - a name that may be misspelled or cut short
+ *                 results - where to put the suggestions
+ *                 max - the most suggestions wanted, at most
+ *                       PREFIX_MAX_RESULTS
+ * Output argument: results holds the names that start closest to query,
+ *                  fewest edits away first
+ * Return: the number of suggestions
+ * Dependencies: playlistPrefixBuild, prefixSuggest
+ */
+size_t playlistSuggest(Playlist *playlist, bool artists, const char *query,
+    PrefixResults *results, size_t max)
+{
+    // build the completions on first use
+    if (!playlistPrefixBuild(playlist))
+    {
+        results->count = 0;
+        return 0;
+    }
+    return prefixSuggest(artists ? &playlist->artistPrefixes :
+        &playlist->titlePrefixes, query, results, max);
+}
+
+/**
+ * Function: playlistPrintSuggestions
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 artists - true to suggest artists, false for titles
+ *                 query - a name that matched nothing
+ * Output argument: "Did you mean ...?" is printed with up to
+ *                  PLAYLIST_SUGGESTIONS names, or nothing if none is close
+ * Return: none
+ * Dependencies: playlistSuggest, prefixResult, stdio.h
+ */
+void playlistPrintSuggestions(Playlist *playlist, bool artists,
+    const char *query)
+{
+    // look for names close to the query
+    PrefixResults results;
+    prefixResultsInit(&results);
+    size_t count = playlistSuggest(playlist, artists, query, &results,
+        PLAYLIST_SUGGESTIONS);
+    // list them as "'a', 'b' or 'c'"
+    if (count > 0)
+    {
+        printf("Did you mean ");
+        for (size_t i = 0; i < count; i++)
+        {
+            printf("%s'%s'", i == 0 ? "" : i + 1 == count ? " or " : ", ",
+                prefixResult(&results, i));
+        }
+        printf("?\n");
+    }
+    // free the names
+    prefixResultsFree(&results);
+}
+
+/**
+ * Function: playlistSortByGenre
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: playlist sorted by genre, tail and circularity kept
+ * Return: void
+ * Dependencies: playlistFirst, playlistNext, playlistRebuildIndexes,
+ *               stdio.h - printf
+ *
+ * Genre is a small closed enum, so one pass relinks every song onto the end
+ * of its genre's chain and the chains are spliced in enum order. This is a
+ * stable O(N) sort that allocates nothing.
+ */
+void playlistSortByGenre(Playlist *playlist)
+{
+    // check if no songs are in the playlist
+    if (playlist->head == NULL)
+    {
+        // if so, print message to user
+        printf("It is quiet here. Add songs to continue.\n");
+        // nothing to sort
+        return;
+    }
+    // create the head and tail of one chain per genre
+    Song* heads[GENRE_COUNT] = { NULL };
+    Song* tails[GENRE_COUNT] = { NULL };
+    // create a pointer to the current song
+    Song* current = playlistFirst(playlist);
+    // walk each song once in play order, which also stops on circular
+    // playlists
+    for (size_t i = 0; i < playlist->length; i++)
+    {
+        // remember the song after the current one
+        Song* next = playlistNext(playlist, current);
+        // the current song ends its genre's chain for now
+        current->next = NULL;
+        current->prev = tails[current->genre];
+        // append it to the chain of its genre, which keeps songs of the same
+        // genre in their play order
+        if (tails[current->genre] == NULL)
+        {
+            heads[current->genre] = current;
+        }
+        else
+        {
+            tails[current->genre]->next = current;
+        }
+        tails[current->genre] = current;
+        // move ahead to the next song
+        current = next;
+    }
+    // every song may have a new position
+    playlist->generation++;
+    // start the sorted playlist empty, its links in play order
+    playlist->head = NULL;
+    playlist->tail = NULL;
+    playlist->reversed = false;
+    // splice the chains together in genre order
+    for (int genre = 0; genre < GENRE_COUNT; genre++)
+    {
+        // skip genres without songs
+        if (heads[genre] == NULL)
+        {
+            continue;
+        }
+        // the first chain becomes the head, later ones follow the tail
+        if (playlist->tail == NULL)
+        {
+            playlist->head = heads[genre];
+        }
+        else
+        {
+            playlist->tail->next = heads[genre];
+            heads[genre]->prev = playlist->tail;
+        }
+        // the end of this chain is the tail so far
+        playlist->tail = tails[genre];
+    }
+    // close the playlist again if it was circular
+    if (playlist->circular)
+    {
+        playlist->tail->next = playlist->head;
+        playlist->head->prev = playlist->tail;
+    }
+    // songs have new predecessors
+    playlistRebuildIndexes(playlist);
+    // print message to user
+    printf("Playlist will play by genre from here on!\n");
+}
+
+/**
+ * Function: playlistDetectCycle
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: none
+ * Return: true if the last song points to the head of the playlist,
+ *         false otherwise; answered in O(1) from the handle
+ * Dependencies: none
+ */
+bool playlistDetectCycle(const Playlist *playlist)
+{
+    // the handle tracks circularity, so there is nothing to walk
+    return playlist->circular;
+}
+
+/**
+ * Function: playlistMakeCircular
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: the tail is linked back to the head in O(1)
+ * Return: void
+ * Dependencies: playlistDetectCycle, stdio.h
+ */
+void playlistMakeCircular(Playlist *playlist)
+{
+    // check if no songs are in the playlist
+    if (playlist->head == NULL)
+    {
+        // if so, print a message to the user
+        printf("It is quiet here. Add songs to continue.\n");
+    }
+    // check if music is already playing continuously
+    else if (playlistDetectCycle(playlist))
     {
         // if so, print a message to the user
         printf("Music is already playing continuously!\n");
     }
-    // otherwise, change the playlist to be continuous
+    // otherwise, change the playlist to be continuous
+    else
+    {
+        // have the last song point to the head of the playlist, and back
+        playlist->tail->next = playlist->head;
+        playlist->head->prev = playlist->tail;
+        // remember the playlist is circular now
+        playlist->circular = true;
+        // print message to user
+        printf("Music will play continuously from here on!\n");
+    }
+}
+
+/**
+ * Function: playlistMakeLinear
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: the tail is unlinked from the head in O(1)
+ * Return: void
+ * Dependencies: playlistDetectCycle, stdio.h
+ */
+void playlistMakeLinear(Playlist *playlist)
+{
+    // check if no songs are in the playlist
+    if (playlist->head == NULL)
+    {
+        // if so, print a message to the user
+        printf("It is quiet here. Add songs to continue.\n");
+    }
+    // check if music is already playing to the last song
+    else if (!playlistDetectCycle(playlist))
+    {
+        // if so, print a message to the user
+        printf("Music is already playing up to the last song!\n");
+    }
+    // otherwise, change the playlist to be linear
+    else
+    {
+        // have the last song point to null, and the head back to null
+        playlist->tail->next = NULL;
+        playlist->head->prev = NULL;
+        // remember the playlist is linear now
+        playlist->circular = false;
+        // print message to user
+        printf("Music will stop playing when the playlist is over!\n");
+    }
+}
+
+/**
+ * Function: playlistValidate
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: none
+ * Return: true if the links agree with the handle and each other, false
+ *         otherwise
+ * Dependencies: songListShape, orderCount, orderRank
+ */
+bool playlistValidate(const Playlist *playlist)
+{
+    // an empty playlist has no songs at either end
+    if (playlist->head == NULL)
+    {
+        return playlist->tail == NULL && playlist->length == 0 &&
+            (!playlist->indexed || orderCount(&playlist->order) == 0);
+    }
+    // follow the links, however they are tangled
+    size_t length;
+    Song *tail;
+    size_t entry;
+    songListShape(playlist->head, &length, &tail, &entry);
+    // the length and tail must be the ones the handle tracks
+    if (length != playlist->length || tail != playlist->tail)
+    {
+        return false;
+    }
+    // a circular playlist loops back to the head, a linear one not at all
+    if (playlist->circular ? entry != 0 : entry != SIZE_MAX)
+    {
+        return false;
+    }
+    // every song must be the one before its successor
+    if (playlist->head->prev != (playlist->circular ? tail : NULL))
+    {
+        return false;
+    }
+    Song* current = playlist->head;
+    for (size_t i = 1; i < length; i++)
+    {
+        if (current->next->prev != current)
+        {
+            return false;
+        }
+        current = current->next;
+    }
+    // the order index must rank every song at its place in the links
+    if (playlist->indexed)
+    {
+        if (orderCount(&playlist->order) != length)
+        {
+            return false;
+        }
+        current = playlist->head;
+        for (size_t i = 0; i < length; i++)
+        {
+            if (orderRank(current) != i)
+            {
+                return false;
+            }
+            current = current->next;
+        }
+        // every song must be in its genre's chain, in link order
+        size_t chained = 0;
+        for (int genre = 0; genre < GENRE_COUNT; genre++)
+        {
+            const GenreChain *chain = &playlist->genreChains[genre];
+            size_t count = 0;
+            Song* previous = NULL;
+            for (current = chain->first; current != NULL && count <= length;
+                current = current->genreNext)
+            {
+                if (current->genre != (Genre)genre ||
+                    current->genrePrev != previous ||
+                    (previous != NULL &&
+                        orderRank(previous) >= orderRank(current)))
+                {
+                    return false;
+                }
+                previous = current;
+                count++;
+            }
+            if (count != chain->count || previous != chain->last)
+            {
+                return false;
+            }
+            chained += count;
+        }
+        if (chained != length)
+        {
+            return false;
+        }
+    }
+    // return success
+    return true;
+}
+
+/**
+ * Function: playlistReverse
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: playlist plays in the opposite order from here on, and
+ *                  stays circular if it was
+ * Return: void
+ * Dependencies: none
+ *
+ * Songs are linked both ways, so reversing only flips which way the
+ * playlist is read, in O(1); no link or index entry changes.
+ */
+void playlistReverse(Playlist *playlist)
+{
+    // nothing to reverse in an empty playlist
+    if (playlist->head == NULL)
+    {
+        return;
+    }
+    // read the links the other way, which renumbers every song
+    playlist->reversed = !playlist->reversed;
+    playlist->generation++;
+}
+
+/**
+ * Function: playlistStraighten
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: the links run in play order and playlist is no longer
+ *                  reversed; songs and indexes keep their play order
+ * Return: void
+ * Dependencies: artistIndexReverse, genreChainReverse, orderBuild
+ *
+ * O(N) for a reversed playlist, O(1) otherwise. Code that follows the next
+ * links directly calls this first.
+ */
+void playlistStraighten(Playlist *playlist)
+{
+    // nothing to do unless the links run against play order
+    if (!playlist->reversed)
+    {
+        return;
+    }
+    // swap the two links of every song
+    Song* current = playlist->head;
+    for (size_t i = 0; i < playlist->length; i++)
+    {
+        Song* next = current->next;
+        current->next = current->prev;
+        current->prev = next;
+        current = next;
+    }
+    // the ends trade places
+    Song* head = playlist->head;
+    playlist->head = playlist->tail;
+    playlist->tail = head;
+    // the indexes follow the links; title copies are ordered by rank
+    if (playlist->indexed)
+    {
+        artistIndexReverse(&playlist->artists);
+        for (int genre = 0; genre < GENRE_COUNT; genre++)
+        {
+            genreChainReverse(&playlist->genreChains[genre]);
+        }
+        orderBuild(&playlist->order, playlist->head, playlist->length);
+    }
+    // and the links run in play order again
+    playlist->reversed = false;
+}
+
+/**
+ * Function: playlistFirst
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: none
+ * Return: the song that plays first, or NULL for an empty playlist
+ * Dependencies: none
+ */
+Song *playlistFirst(const Playlist *playlist)
+{
+    // a reversed playlist starts from its tail
+    return playlist->reversed ? playlist->tail : playlist->head;
+}
+
+/**
+ * Function: playlistLast
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: none
+ * Return: the song that plays last, or NULL for an empty playlist
+ * Dependencies: none
+ */
+Song *playlistLast(const Playlist *playlist)
+{
+    // a reversed playlist ends at its head
+    return playlist->reversed ? playlist->head : playlist->tail;
+}
+
+/**
+ * Function: playlistNext
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 song - a song in the playlist
+ * Output argument: none
+ * Return: the song that plays after it; NULL after the last song of a
+ *         linear playlist, the first song after the last of a circular one
+ * Dependencies: none
+ */
+Song *playlistNext(const Playlist *playlist, const Song *song)
+{
+    // follow the link that points forward in play order
+    return playlist->reversed ? song->prev : song->next;
+}
+
+/**
+ * Function: playlistPrevious
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 song - a song in the playlist
+ * Output argument: none
+ * Return: the song that plays before it; NULL before the first song of a
+ *         linear playlist, the last song before the first of a circular one
+ * Dependencies: none
+ */
+Song *playlistPrevious(const Playlist *playlist, const Song *song)
+{
+    // follow the link that points backward in play order
+    return playlist->reversed ? song->next : song->prev;
+}
+
+/**
+ * Function: playlistSongAt
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 position - a place in play order
+ * Output argument: none
+ * Return: the song there, or NULL past the end; O(log N) expected through
+ *         the order index, otherwise a walk from the nearer end
+ * Dependencies: playlistLinkAt
+ */
+Song *playlistSongAt(const Playlist *playlist, size_t position)
+{
+    // there is no song past the end
+    if (position >= playlist->length)
+    {
+        return NULL;
+    }
+    // play order counts from the tail when reversed
+    return playlistLinkAt(playlist, playlist->reversed ?
+        playlist->length - 1 - position : position);
+}
+
+/**
+ * Function: playlistPosition
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 song - a song of the playlist
+ * Output argument: none
+ * Return: the song's place in play order; O(log N) expected through the
+ *         order index, otherwise a walk from the head
+ * Dependencies: orderRank
+ */
+size_t playlistPosition(const Playlist *playlist, const Song *song)
+{
+    // the order index knows the song's place in the links
+    size_t link = 0;
+    if (playlist->indexed)
+    {
+        link = orderRank(song);
+    }
+    // otherwise count the songs before it
     else
     {
-        // create a pointer to the current song
-        Song* current = *playlist;
-        // loop until the last song is reached
-        while (current->next != NULL)
+        for (const Song *current = playlist->head; current != song;
+            current = current->next)
         {
-            // move ahead by one song
-            current = current->next;
+            link++;
         }
-        // have the last song point to the head of the playlist
-        current->next = *playlist;
-        // print message to user
-        printf("Music will play continuously from here on!\n");
     }
+    // play order counts from the tail when reversed
+    return playlist->reversed ? playlist->length - 1 - link : link;
 }
 
 /**
- * Task 9: Play Up to the End
- * Input argument: playlist - a double pointer to a list of songs
- * Output argument: playlist is configured to be linear (last points to null)
+ * Function: playlistFree
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: every song is freed with its slab and the playlist is
+ *                  empty again; open cursors stay open, past the end
  * Return: void
- * Dependencies: detectCycle
+ * Dependencies: artistPoolRelease, songPoolDestroy, cursorsDetach,
+ *               playlistPrefixDrop
  */
-void makePlaylistLinear(Song **playlist)
+void playlistFree(Playlist *playlist)
 {
-    // check if no songs are in the playlist
-    if (*playlist == NULL)
+    // no cursor may point at a freed song
+    cursorsDetach(playlist);
+    // every song gives its artist reference back
+    Song* current = playlist->head;
+    for (size_t i = 0; i < playlist->length; i++)
     {
-        // if so, print a message to the user
-        printf("It is quiet here. Add songs to continue.\n");
+        artistPoolRelease(current->artist);
+        current = current->next;
     }
-    // check if music is already playing to the last song
-    else if (!detectCycle(*playlist))
+    // then every slab is freed at once
+    songPoolDestroy(&playlist->pool);
+    // and the indexes
+    titleIndexFree(&playlist->titles);
+    artistIndexFree(&playlist->artists);
+    playlistPrefixDrop(playlist);
+    // leave an empty, reusable handle behind, keeping its cursors
+    PlaylistCursor *cursors = playlist->cursors;
+    uint64_t generation = playlist->generation;
+    playlistInit(playlist);
+    playlist->cursors = cursors;
+    playlist->generation = generation + 1;
+}
+
+
+/**
+ * Function: playlistRebuildIndexes
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: every index is rebuilt from the current song order;
+ *                  the completions are dropped until next used
+ * Return: void
+ * Dependencies: playlistPrefixDrop, titleIndexClear, titleIndexReserve,
+ *               titleIndexPrefetch, titleIndexInsert, artistIndexAppend,
+ *               genreChainInit, genreChainAppend, orderBuild
+ */
+void playlistRebuildIndexes(Playlist *playlist)
+{
+    // songs may have been spliced in, so the completions are built again
+    // on next use
+    playlistPrefixDrop(playlist);
+    // playlists without indexes have nothing else to rebuild
+    if (!playlist->indexed)
     {
-        // if so, print a message to the user
-        printf("Music is already playing up to the last song!\n");
+        return;
     }
-    // otherwise, change the playlist to be linear
+    // empty the indexes, keeping their slots
+    titleIndexClear(&playlist->titles);
+    artistIndexClear(&playlist->artists);
+    for (int genre = 0; genre < GENRE_COUNT; genre++)
+    {
+        genreChainInit(&playlist->genreChains[genre]);
+    }
+    // make room for songs spliced in since the last insert
+    titleIndexReserve(&playlist->titles, playlist->length);
+    // create a pointer to the current song
+    Song* current = playlist->head;
+    // and to the song whose slot is fetched ahead of its insert
+    Song* ahead = playlist->head;
+    size_t aheadIndex = 0;
+    for (; aheadIndex < INDEX_PREFETCH_DISTANCE &&
+        aheadIndex < playlist->length; aheadIndex++)
+    {
+        titleIndexPrefetch(&playlist->titles, ahead);
+        ahead = ahead->next;
+    }
+    // index each song in link order, so duplicates are found in order
+    for (size_t i = 0; i < playlist->length; i++)
+    {
+        // start fetching the slot of a song further on
+        if (aheadIndex < playlist->length)
+        {
+            titleIndexPrefetch(&playlist->titles, ahead);
+            ahead = ahead->next;
+            aheadIndex++;
+        }
+        // the slots were reserved for every song, so this cannot fail
+        titleIndexInsert(&playlist->titles, current);
+        artistIndexAppend(&playlist->artists, current);
+        genreChainAppend(&playlist->genreChains[current->genre], current);
+        // move ahead by one song
+        current = current->next;
+    }
+    // and rank the songs in link order
+    orderBuild(&playlist->order, playlist->head, playlist->length);
+}
+
+/**
+ * Function: playlistFindSong
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 title - a string with the title of the song
+ * Output argument: none
+ * Return: the first song in play order with that title, or NULL if there
+ *         is none; O(1) expected through the title index
+ * Dependencies: titleIndexFind, playlistScanTitle
+ */
+Song *playlistFindSong(const Playlist *playlist, const char *title)
+{
+    // look the title up in the index when there is one; the first copy in
+    // play order is the last in link order when reversed
+    if (playlist->indexed)
+    {
+        return titleIndexFind(&playlist->titles, title, playlist->reversed);
+    }
+    // otherwise, walk the playlist
+    return playlistScanTitle(playlist, title);
+}
+
+
+/**
+ * Function: songArtist
+ * Input argument: song - a pointer to a song
+ * Output argument: none
+ * Return: the name of the song's artist
+ * Dependencies: artistPoolName
+ */
+const char *songArtist(const Song *song)
+{
+    // the pool keeps the name while the song holds its reference
+    return artistPoolName(song->artist);
+}
+
+
+/**
+ * Function: songTitle
+ * Input argument: song - a pointer to a song
+ * Output argument: none
+ * Return: the song's null terminated title
+ * Dependencies: none
+ */
+const char *songTitle(const Song *song)
+{
+    // short titles are stored in the song, long ones behind a pointer
+    return song->titleLength < SONG_INLINE_TITLE ? song->title.text :
+        song->title.external;
+}
+
+/**
+ * Function: songSetTitle
+ * Input argument: song - a pointer to the song to fill in
+ *                 pool - the pool the song was allocated from
+ *                 title - the title, not necessarily null terminated
+ *                 length - the number of bytes in the title
+ * Output argument: the title is stored inline when it fits, otherwise in
+ *                  the pool's text blocks, and its length is cached
+ * Return: true on success, false if memory ran out
+ * Dependencies: songPoolText, string.h
+ */
+bool songSetTitle(Song *song, SongPool *pool, const char *title,
+    size_t length)
+{
+    // a short title is copied into the song with its terminator
+    if (length < SONG_INLINE_TITLE)
+    {
+        memcpy(song->title.text, title, length);
+        song->title.text[length] = '\0';
+    }
+    // a long one is appended to the pool's text blocks
     else
     {
-        // create a pointer to the current song
-        Song* current = *playlist;
-        // loop until the last song is reached before the playlist repeats
-        while (current->next != *playlist)
+        song->title.external = songPoolText(pool, title, length);
+        if (song->title.external == NULL)
         {
-            // move ahead by one song
-            current = current->next;
+            return false;
         }
-        // have the last song point to null
-        current->next = NULL;
-        // print message to user
-        printf("Music will stop playing when the playlist is over!\n");
     }
+    // cache the length, which also says where the title is
+    song->titleLength = (uint32_t)length;
+    // return success
+    return true;
+}
+
+/**
+ * Function: createPlaylist (provided)
+ * Input argument: playlist - a double pointer to a list of songs
+ * Output argument: updated head of the playlist
+ * Return: true if the playlist is successfully loaded, false if errors occur
+ * Dependencies: playlistView, playlistLoad
+ */
+bool createPlaylist(Song **playlist)
+{
+    // wrap the bare list in a playlist handle
+    Playlist view;
+    playlistView(&view, *playlist);
+    // load the file through the handle
+    bool loaded = playlistLoad(&view, FILENAME);
+    // hand the head back to the caller
+    playlistUnview(&view, playlist);
+    // return the result of the load
+    return loaded;
+}
+
+/**
+ * Task 1: Play the Playlist
+ * Input argument: playlist - a pointer to a list of songs
+ *                 genres - an array with the names of the genres. Genres are
+ *                          listed in the array according to its enum value.
+ *                          For example, "Pop" is at index genres[POP]
+ * Output argument: none
+ * Return: none
+ * Dependencies: playlistView, playlistPlay, outputInitFile, outputFree
+ */
+void play(Song *playlist, char* genres[])
+{
+    // wrap the bare list in a playlist handle
+    Playlist view;
+    playlistView(&view, playlist);
+    // play through the handle to stdout
+    OutputSink sink;
+    outputInitFile(&sink, stdout);
+    playlistPlay(&view, &sink, genres);
+    outputFree(&sink);
+}
+
+
+/**
+ * Task 2: Adding a New Song to the Playlist
+ * Input argument: playlist - a double pointer to a list of songs
+ *                 title - a string with the title of the song
+ *                 artist - a string with the artist of the song
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: updated head of the playlist, if needed
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: playlistView, playlistAddSong
+ */
+bool addSong(
+    Song **playlist, const char *title, const char *artist, Genre genre)
+{
+    // wrap the bare list in a playlist handle
+    Playlist view;
+    playlistView(&view, *playlist);
+    // append through the handle
+    bool added = playlistAddSong(&view, title, artist, genre);
+    // hand the head back to the caller
+    playlistUnview(&view, playlist);
+    // return the result of the append
+    return added;
+}
+
+
+/**
+ * Task 3: Removing a Song from the Playlist
+ * Input argument: playlist - a double pointer to a list of songs
+ *                 title - a string with the title of the song
+ * Output argument: updated head of the playlist, if needed
+ * Return: true if the song is successfully removed, false otherwise
+ * Dependencies: playlistView, playlistRemoveSong
+ */
+bool removeSong(Song **playlist, const char *title)
+{
+    // wrap the bare list in a playlist handle
+    Playlist view;
+    playlistView(&view, *playlist);
+    // remove through the handle
+    bool removed = playlistRemoveSong(&view, title);
+    // hand the head back to the caller
+    playlistUnview(&view, playlist);
+    // return the result of the removal
+    return removed;
+}
+
+
+/**
+ * Task 4: Shuffle Play
+ * Input argument: playlist - a pointer to a list of songs
+ *                 genres - an array with the names of the genres. Genres are
+ *                          listed in the array according to its enum value.
+ *                          For example, "Pop" is at index genres[POP]
+ * Output argument: none
+ * Return: none
+ * Dependencies: playlistView, playlistPlayShuffle, outputInitFile,
+ *               outputFree
+ */
+void playShuffle(Song *playlist, char* genres[])
+{
+    // wrap the bare list in a playlist handle
+    Playlist view;
+    playlistView(&view, playlist);
+    // draw the seed from rand so srand still decides the order
+    uint64_t seed = ((uint64_t)rand() << 32) ^ (uint64_t)rand();
+    // shuffle through the handle to stdout
+    OutputSink sink;
+    outputInitFile(&sink, stdout);
+    playlistPlayShuffle(&view, &sink, genres, seed);
+    outputFree(&sink);
+}
+
+
+/**
+ * Task 5: Play Songs by Artist
+ * Input argument: playlist - a pointer to a list of songs
+ *                 artist - a string representing the artist name
+ *                 genres - an array with the names of the genres. Genres are
+ *                          listed in the array according to its enum value.
+ *                          For example, "Pop" is at index genres[POP]
+ * Output argument: none
+ * Return: none
+ * Dependencies: playlistView, playlistPlayByArtist, outputInitFile,
+ *               outputFree
+ */
+void playByArtist(Song *playlist, const char *artist, char* genres[])
+{
+    // wrap the bare list in a playlist handle
+    Playlist view;
+    playlistView(&view, playlist);
+    // play the artist through the handle to stdout
+    OutputSink sink;
+    outputInitFile(&sink, stdout);
+    playlistPlayByArtist(&view, artist, &sink, genres);
+    outputFree(&sink);
+}
+
+
+/**
+ * Task 6: Sorting the Playlist by Genre
+ * Input argument: playlist - a double pointer to a list of songs
+ * Output argument: playlist sorted by genre
+ * Return: void
+ * Dependencies: playlistView, playlistSortByGenre
+ */
+void sortByGenre(Song **playlist)
+{
+    // wrap the bare list in a playlist handle
+    Playlist view;
+    playlistView(&view, *playlist);
+    // sort through the handle
+    playlistSortByGenre(&view);
+    // hand the head back to the caller
+    playlistUnview(&view, playlist);
+}
+
+
+/**
+ * Task 7: Detecting a Cycle in the Playlist
+ * Input argument: playlist - a pointer to a list of songs
+ * Output argument: none
+ * Return: true if the list loops, back to the head or into its middle,
+ *         false if it ends in NULL
+ * Dependencies: playlistView, playlistDetectCycle
+ */
+bool detectCycle(Song *playlist)
+{
+    // wrap the bare list in a playlist handle
+    Playlist view;
+    playlistView(&view, playlist);
+    // the walk that built the handle already answered the question
+    return playlistDetectCycle(&view);
+}
+
+
+/**
+ * Task 8: Play Non-Stop
+ * Input argument: playlist - a double pointer to a list of songs
+ * Output argument: playlist is configured to be circular
+ * Return: void
+ * Dependencies: playlistView, playlistMakeCircular
+ */
+void makePlaylistCircular(Song **playlist)
+{
+    // wrap the bare list in a playlist handle
+    Playlist view;
+    playlistView(&view, *playlist);
+    // close the loop through the handle
+    playlistMakeCircular(&view);
+    // hand the head back to the caller
+    playlistUnview(&view, playlist);
+}
+
+/**
+ * Task 9: Play Up to the End
+ * Input argument: playlist - a double pointer to a list of songs
+ * Output argument: playlist is configured to be linear (last points to null)
+ * Return: void
+ * Dependencies: playlistView, playlistMakeLinear
+ */
+void makePlaylistLinear(Song **playlist)
+{
+    // wrap the bare list in a playlist handle
+    Playlist view;
+    playlistView(&view, *playlist);
+    // open the loop through the handle
+    playlistMakeLinear(&view);
+    // hand the head back to the caller
+    playlistUnview(&view, playlist);
 }
 
 
 /**
  * Task 10: Reversing the Playlist
  * Input argument: playlist - a double pointer to a list of songs
- * Output argument: playlist is reversed
+ * Output argument: playlist is reversed, staying circular if it was
  * Return: void
- * Dependencies: detectCycle
+ * Dependencies: playlistView, playlistReverse
  */
 void reversePlaylist(Song **playlist)
 {
-    // create a pointer to the current song
-    Song* current = *playlist;
-    // check if the playlist is continuous
-    if (detectCycle(*playlist))
+    // wrap the bare list in a playlist handle
+    Playlist view;
+    playlistView(&view, *playlist);
+    // reverse through the handle
+    playlistReverse(&view);
+    // hand the head back to the caller
+    playlistUnview(&view, playlist);
+}
+
+
+/**
+ * Function: freePlaylist
+ * Input argument: playlist - a double pointer to a list of songs
+ * Output argument: every song is released and the head is set to null
+ * Return: void
+ * Dependencies: playlistView, songPoolFree, songPoolDestroy
+ */
+void freePlaylist(Song **playlist)
+{
+    // wrap the bare list in a playlist handle
+    Playlist view;
+    playlistView(&view, *playlist);
+    // create variable to store current song
+    Song* current = view.head;
+    // other bare lists may share the pool, so release songs one at a time
+    for (size_t i = 0; i < view.length; i++)
     {
-        // loop until the last song is reached before the playlist repeats
-        while (current->next != *playlist)
-        {
-            // move ahead by one song
-            current = current->next;
-        }
-        // have the last song point to null
-        current->next = NULL;
+        // remember the song after the current one
+        Song* next = current->next;
+        // give its artist reference back and return it to the shared pool
+        artistPoolRelease(current->artist);
+        songPoolFree(&view.pool, current);
+        // move ahead to the next song
+        current = next;
     }
-    // reset current to the head of the playlist
-    current = *playlist;
-    // create pointer to previous song
-    Song* previous = NULL;
-    // create pointer to next song
-    Song* next = current->next;
-    // loop until the last song in the playlist is reached
-    while (current->next != NULL)
-    {
-        // check if the loop is only at the first song
-        if (previous == NULL)
-        {
-            // have the first song in the playlist point to null
-            current->next = NULL;
-            // have previous point to the first song
-            previous = current;
-            // move current pointer to the next song
-            current = next;
-            // move next pointer to the song after current
-            next = current->next;
-        }
-        // otherwise, the loop is in the middle of the playlist
-        else
-        {
-            // have the current song point to the song before it
-            current->next = previous;
-            // have previous point to the current song
-            previous = current;
-            // have current point to the next song
-            current = next;
-            // move the next pointer to the next song
-            next = current->next;
-        }
+    // once no bare list uses the pool, give its slabs back in one go
+    if (view.pool.live == 0)
+    {
+        songPoolDestroy(&view.pool);
     }
-    // have the last song point to the previous song
-    current->next = previous;
-    // have the playlist point to the last song, so it's now at the head of
-    // the playlist
-    *playlist = current;
+    // the list is empty now
+    view.head = NULL;
+    // hand the head back to the caller
+    playlistUnview(&view, playlist);
 }
 
+
+/**
+ * Function: findSong
+ * Input argument: playlist - a pointer to a list of songs
+ *                 title - a string with the title of the song
+ * Output argument: none
+ * Return: the first song with that title, or NULL if there is none
+ * Dependencies: playlistView, playlistFindSong
+ */
+Song *findSong(Song *playlist, const char *title)
+{
+    // wrap the bare list in a playlist handle
+    Playlist view;
+    playlistView(&view, playlist);
+    // look the title up through the handle
+    return playlistFindSong(&view, title);
+}
@@ -8,11 +8,22 @@
 #include <string.h>
 #include <time.h>
 #include <ctype.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "music_pool.h"
+#include "music_index.h"
+#include "music_order.h"
+#include "music_output.h"
+#include "music_prefix.h"
 
 // global definitions
 #define FILENAME "playlist.csv"
 #define MAX_SONGS 150
 #define STR_LEN 50
+// names offered when a title or artist typed in the menu matches nothing
+#define PLAYLIST_SUGGESTIONS 3
+// titles shorter than this are stored inside the song itself
+#define SONG_INLINE_TITLE 24
 
 typedef enum 
 {
@@ -27,21 +38,100 @@ Genre;
 
 typedef struct Song 
 {
-    char title[50];
-    char artist[50];
+    // the title: inline when shorter than SONG_INLINE_TITLE, otherwise a
+    // copy in the pool's text blocks; see songTitle
+    union
+    {
+        char text[SONG_INLINE_TITLE];
+        const char *external;
+    }
+    title;
+    // the number of bytes in the title, so it is never measured again
+    uint32_t titleLength;
+    // the artist's number in the shared artist pool; see songArtist
+    uint32_t artist;
     Genre genre;
+    // neighbours in link order; a playlist plays them from head to tail,
+    // or from tail to head once reversed
     struct Song *next;
+    struct Song *prev;
+    // neighbours in the artist index's posting list
+    struct Song *artistNext;
+    struct Song *artistPrev;
+    // neighbours in the chain of the song's genre
+    struct Song *genreNext;
+    struct Song *genrePrev;
+    // the song's node in the order index: its children and parent, the
+    // number of songs in its subtree and its heap priority
+    struct Song *orderLeft;
+    struct Song *orderRight;
+    struct Song *orderParent;
+    uint32_t orderSize;
+    uint32_t orderPriority;
+    // scratch key filled in by sortPlaylist's fast paths
+    uint64_t sortKey;
 }
 Song;
 
+typedef struct Playlist
+{
+    // first song in link order, the first to play unless reversed
+    Song *head;
+    // last song in link order, so appends never walk the list
+    Song *tail;
+    // number of songs currently linked into the playlist
+    size_t length;
+    // true when the tail links back to the head, and the head to the tail
+    bool circular;
+    // true when play order runs from the tail to the head along the prev
+    // links, which is how playlistReverse turns a playlist around in O(1)
+    bool reversed;
+    // slabs every song of this playlist is allocated from
+    SongPool pool;
+    // true when the indexes below are kept up to date
+    bool indexed;
+    // title lookup for removeSong and findSong
+    TitleIndex titles;
+    // posting lists for playByArtist
+    ArtistIndex artists;
+    // one chain per genre, for playByGenre and the genre counts
+    GenreChain genreChains[GENRE_COUNT];
+    // positions in link order for playlistSongAt and playlistInsertSong
+    OrderIndex order;
+    // completions of the titles and of the artists, built on first use by
+    // playlistComplete or playlistSuggest and kept up to date from then on
+    bool prefixed;
+    PrefixIndex titlePrefixes;
+    PrefixIndex artistPrefixes;
+    // the cursors open on this playlist, moved along by removals
+    struct PlaylistCursor *cursors;
+    // counts the edits that change songs' positions in play order, so a
+    // cursor knows when its cached position is stale
+    uint64_t generation;
+}
+Playlist;
+
+typedef struct SongView
+{
+    // number of songs reachable through the view
+    size_t length;
+    // returns the song at a position in [0, length)
+    Song *(*songAt)(const void *context, size_t index);
+    // whatever songAt needs to find a song
+    const void *context;
+}
+SongView;
+
 // function prototypes
+// these work on bare lists of songs and wrap the playlist handle functions
+// below, walking the list once per call to find its tail
 
 /**
  * Function: createPlaylist (provided)
  * Input argument: playlist - a double pointer to a list of songs
  * Output argument: updated head of the playlist
  * Return: true if the playlist is successfully loaded, false if errors occur
- * Dependencies: addSong, stdio.h, string.h
+ * Dependencies: playlistLoad (wrapper over a playlist handle)
  */
 bool createPlaylist(Song **playlist);
 
@@ -53,7 +143,7 @@ bool createPlaylist(Song **playlist);
  *                          For example, "Pop" is at index genres[POP]
  * Output argument: none
  * Return: none
- * Dependencies: stdio.h, ctype.h
+ * Dependencies: playlistPlay (wrapper over a playlist handle)
  */
 void play(Song *playlist, char* genres[]);
 
@@ -65,7 +155,7 @@ void play(Song *playlist, char* genres[]);
  *                 genre - a Genre enum for the genre of the song
  * Output argument: updated head of the playlist, if needed
  * Return: true if the song is successfully added, false otherwise
- * Dependencies: stdlib.h, stdio.h, string.h
+ * Dependencies: playlistAddSong (wrapper over a playlist handle)
  */
 bool addSong(
     Song **playlist, const char *title, const char *artist, Genre genre);
@@ -76,7 +166,7 @@ bool addSong(
  *                 title - a string with the title of the song
  * Output argument: updated head of the playlist, if needed
  * Return: true if the song is successfully removed, false otherwise
- * Dependencies: stdlib.h, stdio.h, string.h
+ * Dependencies: playlistRemoveSong (wrapper over a playlist handle)
  */
 bool removeSong(Song **playlist, const char *title);
 
@@ -88,7 +178,8 @@ bool removeSong(Song **playlist, const char *title);
  *                          For example, "Pop" is at index genres[POP]
  * Output argument: none
  * Return: none
- * Dependencies: stdlib.h, stdio.h
+ * Dependencies: playlistPlayShuffle (wrapper over a playlist handle),
+ *               seeded from rand
  */
 void playShuffle(Song *playlist, char* genres[]);
 
@@ -101,7 +192,7 @@ void playShuffle(Song *playlist, char* genres[]);
  *                          For example, "Pop" is at index genres[POP]
  * Output argument: none
  * Return: none
- * Dependencies: string.h, stdio.h
+ * Dependencies: playlistPlayByArtist (wrapper over a playlist handle)
  */
 void playByArtist(Song *playlist, const char *artist, char* genres[]);
 
@@ -110,7 +201,7 @@ void playByArtist(Song *playlist, const char *artist, char* genres[]);
  * Input argument: playlist - a double pointer to a list of songs
  * Output argument: playlist sorted by genre
  * Return: void
- * Dependencies: stdio.h - printf
+ * Dependencies: playlistSortByGenre (wrapper over a playlist handle)
  */
 void sortByGenre(Song **playlist); 
 
@@ -118,18 +209,19 @@ void sortByGenre(Song **playlist);
  * Function: detectCycle
  * Input argument: playlist - a pointer to a list of songs
  * Output argument: none
- * Return: true if the last song points to the head of the playlist,
- *         false otherwise
- * Dependencies: none
+ * Return: true if the list loops, back to the head or into its middle,
+ *         false if it ends in NULL
+ * Dependencies: playlistDetectCycle (wrapper over a playlist handle)
  */
 bool detectCycle(Song *playlist);  
 
+
 /**
  * Function: makePlaylistCircular
  * Input argument: playlist - a double pointer to a list of songs
  * Output argument: playlist is configured to be circular
  * Return: void
- * Dependencies: detectCycle
+ * Dependencies: playlistMakeCircular (wrapper over a playlist handle)
  */
 void makePlaylistCircular(Song **playlist);
 
@@ -138,17 +230,648 @@ void makePlaylistCircular(Song **playlist);
  * Input argument: playlist - a double pointer to a list of songs
  * Output argument: playlist is configured to be linear (last points to null)
  * Return: void
- * Dependencies: detectCycle
+ * Dependencies: playlistMakeLinear (wrapper over a playlist handle)
  */
 void makePlaylistLinear(Song **playlist);
 
 /**
  * Function: reversePlaylist
  * Input argument: playlist - a double pointer to a list of songs
- * Output argument: playlist is reversed
+ * Output argument: playlist is reversed, staying circular if it was
  * Return: void
- * Dependencies: detectCycle
+ * Dependencies: playlistReverse (wrapper over a playlist handle)
  */
 void reversePlaylist(Song **playlist);
 
+/**
+ * Function: freePlaylist
+ * Input argument: playlist - a double pointer to a list of songs
+ * Output argument: every song is released and the head is set to null
+ * Return: void
+ * Dependencies: playlistFree (wrapper over a playlist handle)
+ */
+void freePlaylist(Song **playlist);
+
+/**
+ * Function: findSong
+ * Input argument: playlist - a pointer to a list of songs
+ *                 title - a string with the title of the song
+ * Output argument: none
+ * Return: the first song with that title, or NULL if there is none
+ * Dependencies: playlistFindSong (wrapper over a playlist handle)
+ */
+Song *findSong(Song *playlist, const char *title);
+
+// playlist handle prototypes
+
+/**
+ * Function: playlistInit
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: playlist is empty and linear
+ * Return: none
+ * Dependencies: none
+ */
+void playlistInit(Playlist *playlist);
+
+/**
+ * Function: playlistLoad
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 filename - the path of the CSV file to read
+ * Output argument: songs from the file are appended to the playlist;
+ *                  malformed rows are skipped and reported with their line
+ * Return: true if the playlist is successfully loaded, false if errors occur
+ * Dependencies: playlistLoadThreads
+ */
+bool playlistLoad(Playlist *playlist, const char *filename);
+
+/**
+ * Function: playlistLoadThreads
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 filename - the path of the CSV file to read
+ *                 threads - how many threads parse the file, 0 for one per
+ *                           online processor
+ * Output argument: songs from the file are appended to the playlist in file
+ *                  order; malformed rows are skipped and reported with their
+ *                  line
+ * Return: true if the playlist is successfully loaded, false if errors occur
+ * Dependencies: playlistAppendSong, songPoolAdopt, playlistRebuildIndexes,
+ *               pthread.h, sys/mman.h, string.h (music_csv.c)
+ *
+ * The file is memory mapped and parsed in place: memchr finds the commas
+ * and newlines, and fields are copied once, straight into the songs. The
+ * rows are split at newlines into one chunk per thread; each thread builds
+ * its chunk's songs in a pool of its own, and the chunks are spliced in file
+ * order afterwards, so the result is the same for any number of threads.
+ */
+bool playlistLoadThreads(
+    Playlist *playlist, const char *filename, int threads);
+
+/**
+ * Function: playlistPlay
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres
+ * Output argument: none
+ * Return: none
+ * Dependencies: songPlay, outputFlush, stdio.h, ctype.h
+ *
+ * The sink is flushed before asking whether the user is still listening
+ * and once the songs are over.
+ */
+void playlistPlay(const Playlist *playlist, OutputSink *sink,
+    char* genres[]);
+
+/**
+ * Function: playlistPlayBackward
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres
+ * Output argument: none
+ * Return: none
+ * Dependencies: playlistLast, playlistPrevious, songPlay, outputFlush,
+ *               stdio.h, ctype.h
+ *
+ * Plays from the last song to the first without changing the play order,
+ * asking every MAX_SONGS songs like playlistPlay.
+ */
+void playlistPlayBackward(const Playlist *playlist, OutputSink *sink,
+    char* genres[]);
+
+/**
+ * Function: playlistAddSong
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 title - a string with the title of the song
+ *                 artist - a string with the artist of the song
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song is added at the end of play order without
+ *                  walking the list
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: stdlib.h, stdio.h, string.h
+ */
+bool playlistAddSong(
+    Playlist *playlist, const char *title, const char *artist, Genre genre);
+
+/**
+ * Function: playlistAppendSong
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 title - the title, not necessarily null terminated
+ *                 titleLength - the number of bytes in the title
+ *                 artist - the artist, not necessarily null terminated
+ *                 artistLength - the number of bytes in the artist
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song is added at the end of play order without
+ *                  walking the list
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: playlistInsertNamed
+ */
+bool playlistAppendSong(Playlist *playlist, const char *title,
+    size_t titleLength, const char *artist, size_t artistLength, Genre genre);
+
+/**
+ * Function: playlistAppendInterned
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 title - the title, not necessarily null terminated
+ *                 titleLength - the number of bytes in the title
+ *                 artist - an artist number the caller holds a reference to
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song is added at the end of play order in O(log N)
+ *                  expected, and takes over the caller's reference; on
+ *                  failure the caller keeps it
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: playlistInsertInterned
+ */
+bool playlistAppendInterned(Playlist *playlist, const char *title,
+    size_t titleLength, uint32_t artist, Genre genre);
+
+/**
+ * Function: playlistInsertSong
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 position - where the song goes in play order, at most the
+ *                            length
+ *                 title - a string with the title of the song
+ *                 artist - a string with the artist of the song
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song plays at that position, and the songs from
+ *                  there on one later
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: playlistInsertNamed, string.h
+ */
+bool playlistInsertSong(Playlist *playlist, size_t position,
+    const char *title, const char *artist, Genre genre);
+
+/**
+ * Function: playlistInsertInterned
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 position - where the song goes in play order, at most the
+ *                            length
+ *                 title - the title, not necessarily null terminated
+ *                 titleLength - the number of bytes in the title
+ *                 artist - an artist number the caller holds a reference to
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song plays at that position and takes over the
+ *                  caller's reference; on failure the caller keeps it
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: songPoolAlloc, titleIndexInsert, artistIndexAppend,
+ *               artistIndexInsertAfter, genreChainAppend,
+ *               genreChainInsertAfter, orderAt, orderInsert,
+ *               cursorsAppended, playlistPrefixChange, stdio.h, string.h
+ *
+ * In an indexed playlist an append costs O(log N) expected, since even it
+ * joins the order index along a spine. Anywhere else the song's place in
+ * its artist's posting list and its genre's chain is searched from both
+ * sides at once, which takes O(min(gap, k) * log N) expected: gap is the
+ * number of songs back to the nearest earlier one of the same artist or
+ * genre, k the number of that artist's or genre's songs after position,
+ * and each step of the chain walk ranks a song. A song of a genre that is
+ * sorted far from position can cost a millisecond on a million songs. An
+ * unindexed playlist links a song at either end in O(1) and walks to a
+ * middle position.
+ */
+bool playlistInsertInterned(Playlist *playlist, size_t position,
+    const char *title, size_t titleLength, uint32_t artist, Genre genre);
+
+/**
+ * Function: playlistRemoveAt
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 position - a place in play order
+ * Output argument: the song there is unlinked and freed; cursors on it
+ *                  move on to the next song
+ * Return: true if the song is successfully removed, false if position is
+ *         past the end
+ * Dependencies: playlistSongAt, playlistDetachSong, playlistReleaseSong
+ */
+bool playlistRemoveAt(Playlist *playlist, size_t position);
+
+/**
+ * Function: playlistSongAt
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 position - a place in play order
+ * Output argument: none
+ * Return: the song there, or NULL past the end; O(log N) expected through
+ *         the order index, otherwise a walk from the nearer end
+ * Dependencies: playlistLinkAt
+ */
+Song *playlistSongAt(const Playlist *playlist, size_t position);
+
+/**
+ * Function: playlistPosition
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 song - a song of the playlist
+ * Output argument: none
+ * Return: the song's place in play order; O(log N) expected through the
+ *         order index, otherwise a walk from the head
+ * Dependencies: orderRank
+ */
+size_t playlistPosition(const Playlist *playlist, const Song *song);
+
+/**
+ * Function: songArtist
+ * Input argument: song - a pointer to a song
+ * Output argument: none
+ * Return: the name of the song's artist
+ * Dependencies: artistPoolName
+ */
+const char *songArtist(const Song *song);
+
+/**
+ * Function: songTitle
+ * Input argument: song - a pointer to a song
+ * Output argument: none
+ * Return: the song's null terminated title
+ * Dependencies: none
+ */
+const char *songTitle(const Song *song);
+
+/**
+ * Function: songSetTitle
+ * Input argument: song - a pointer to the song to fill in
+ *                 pool - the pool the song was allocated from
+ *                 title - the title, not necessarily null terminated
+ *                 length - the number of bytes in the title
+ * Output argument: the title is stored inline when it fits, otherwise in
+ *                  the pool's text blocks, and its length is cached
+ * Return: true on success, false if memory ran out
+ * Dependencies: songPoolText, string.h
+ */
+bool songSetTitle(Song *song, SongPool *pool, const char *title,
+    size_t length);
+
+/**
+ * Function: playlistRemoveSong
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 title - a string with the title of the song
+ * Output argument: the first song in play order with that title is
+ *                  unlinked and freed, in O(1) expected time through the
+ *                  title index; cursors on it move on to the next song
+ * Return: true if the song is successfully removed, false otherwise
+ * Dependencies: titleIndexFind, playlistScanTitle, playlistDetachSong,
+ *               playlistReleaseSong, stdio.h, string.h
+ */
+bool playlistRemoveSong(Playlist *playlist, const char *title);
+
+/**
+ * Function: playlistDetachSong
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 current - a song of the playlist
+ * Output argument: the song is unlinked but not freed; cursors on it move on
+ *                  to the next song
+ * Return: none
+ * Dependencies: cursorsRemoving, titleIndexRemove, artistIndexRemove,
+ *               genreChainRemove, orderRemove, playlistPrefixChange
+ *
+ * The song keeps its title, artist and genre until playlistReleaseSong, so
+ * readers that may still hold it can finish with it first.
+ */
+void playlistDetachSong(Playlist *playlist, Song *current);
+
+/**
+ * Function: playlistReleaseSong
+ * Input argument: playlist - a pointer to the playlist handle the song was
+ *                            detached from
+ *                 song - a detached song
+ * Output argument: the song gives its artist reference back and is freed
+ * Return: none
+ * Dependencies: artistPoolRelease, songPoolFree
+ */
+void playlistReleaseSong(Playlist *playlist, Song *song);
+
+/**
+ * Function: playlistFindSong
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 title - a string with the title of the song
+ * Output argument: none
+ * Return: the first song with that title, or NULL if there is none; O(1)
+ *         expected through the title index
+ * Dependencies: titleIndexFind, string.h
+ */
+Song *playlistFindSong(const Playlist *playlist, const char *title);
+
+/**
+ * Function: playlistPlayShuffle
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres
+ *                 seed - the shuffle seed; equal seeds give equal orders
+ * Output argument: none
+ * Return: none
+ * Dependencies: rngSeed, rngBelow, songPlay, stdlib.h, stdio.h
+ */
+void playlistPlayShuffle(const Playlist *playlist, OutputSink *sink,
+    char* genres[], uint64_t seed);
+
+/**
+ * Function: playlistPlayByArtist
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 artist - a string representing the artist name
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres
+ * Output argument: none
+ * Return: none
+ * Dependencies: artistPoolFind, artistIndexFind, songPlay
+ *
+ * Walks only the artist's posting list, so it costs O(k) for k songs.
+ */
+void playlistPlayByArtist(const Playlist *playlist, const char *artist,
+    OutputSink *sink, char* genres[]);
+
+/**
+ * Function: playlistCountByArtist
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 artist - a string representing the artist name
+ * Output argument: none
+ * Return: the number of songs by the artist, in O(1) expected time
+ * Dependencies: artistPoolFind, artistIndexFind
+ */
+size_t playlistCountByArtist(const Playlist *playlist, const char *artist);
+
+/**
+ * Function: playlistListArtists
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 artists - an array to fill with artist names, may be NULL
+ *                 counts - an array to fill with song counts, may be NULL
+ *                 max - the number of elements each array can hold
+ * Output argument: the first max artists, in no particular order, and
+ *                  their song counts
+ * Return: the number of distinct artists in the playlist
+ * Dependencies: none
+ */
+size_t playlistListArtists(const Playlist *playlist, const char **artists,
+    size_t *counts, size_t max);
+
+/**
+ * Function: playlistPlayByGenre
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 genre - a Genre enum for the genre to play
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres
+ * Output argument: none
+ * Return: none
+ * Dependencies: playlistGenreNext, songPlay
+ *
+ * Walks only the genre's chain, so it costs O(k) for k songs.
+ */
+void playlistPlayByGenre(const Playlist *playlist, Genre genre,
+    OutputSink *sink, char* genres[]);
+
+/**
+ * Function: playlistCountByGenre
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 genre - a Genre enum for the genre to count
+ * Output argument: none
+ * Return: the number of songs of the genre, in O(1) in an indexed playlist
+ * Dependencies: none
+ */
+size_t playlistCountByGenre(const Playlist *playlist, Genre genre);
+
+/**
+ * Function: playlistPlayInterleaved
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres
+ * Output argument: none
+ * Return: none
+ * Dependencies: playlistGenreNext, songPlay
+ *
+ * Plays every song once, taking turns between the genres in enum order:
+ * each turn plays the next song in play order of a genre that has songs
+ * left. O(N) in an indexed playlist, since each chain is read once.
+ */
+void playlistPlayInterleaved(const Playlist *playlist, OutputSink *sink,
+    char* genres[]);
+
+/**
+ * Function: playlistComplete
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 artists - true to complete artists, false for titles
+ *                 prefix - the start of the names wanted, in any case
+ *                 results - where to put the names
+ *                 max - the most names wanted, at most PREFIX_MAX_RESULTS
+ * Output argument: results holds the first names in alphabetical order
+ *                  that start with prefix, ignoring ASCII case, with their
+ *                  song counts
+ * Return: the number of names found
+ * Dependencies: playlistPrefixBuild, prefixComplete
+ *
+ * O(log N + prefix + max) once the completions are built; the first call
+ * builds them in O(N log N).
+ */
+size_t playlistComplete(Playlist *playlist, bool artists, const char *prefix,
+    PrefixResults *results, size_t max);
+
+/**
+ * Function: playlistSuggest
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 artists - true to suggest artists, false for titles
+ *                 query - a name that may be misspelled or cut short
+ *                 results - where to put the suggestions
+ *                 max - the most suggestions wanted, at most
+ *                       PREFIX_MAX_RESULTS
+ * Output argument: results holds the names that start closest to query,
+ *                  fewest edits away first
+ * Return: the number of suggestions
+ * Dependencies: playlistPrefixBuild, prefixSuggest
+ */
+size_t playlistSuggest(Playlist *playlist, bool artists, const char *query,
+    PrefixResults *results, size_t max);
+
+/**
+ * Function: playlistPrintSuggestions
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 artists - true to suggest artists, false for titles
+ *                 query - a name that matched nothing
+ * Output argument: "Did you mean ...?" is printed with up to
+ *                  PLAYLIST_SUGGESTIONS names, or nothing if none is close
+ * Return: none
+ * Dependencies: playlistSuggest, prefixResult, stdio.h
+ */
+void playlistPrintSuggestions(Playlist *playlist, bool artists,
+    const char *query);
+
+/**
+ * Function: playlistSortByGenre
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: playlist sorted by genre in one stable O(N) pass, tail
+ *                  and circularity kept
+ * Return: void
+ * Dependencies: stdio.h - printf
+ */
+void playlistSortByGenre(Playlist *playlist);
+
+/**
+ * Function: playlistDetectCycle
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: none
+ * Return: true if the last song points to the head of the playlist,
+ *         false otherwise; answered in O(1) from the handle
+ * Dependencies: none
+ */
+bool playlistDetectCycle(const Playlist *playlist);
+
+/**
+ * Function: playlistMakeCircular
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: the tail is linked back to the head in O(1)
+ * Return: void
+ * Dependencies: playlistDetectCycle, stdio.h
+ */
+void playlistMakeCircular(Playlist *playlist);
+
+/**
+ * Function: playlistMakeLinear
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: the tail is unlinked from the head in O(1)
+ * Return: void
+ * Dependencies: playlistDetectCycle, stdio.h
+ */
+void playlistMakeLinear(Playlist *playlist);
+
+/**
+ * Function: playlistValidate
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: none
+ * Return: true if the links agree with the handle, false otherwise
+ * Dependencies: songListShape, orderCount, orderRank
+ *
+ * An integrity check rather than a query: it walks the links with Brent's
+ * cycle finding, so it stops even on a loop into the middle of the list,
+ * and checks the length, the tail and that the list loops back to the head
+ * exactly when the handle says it is circular, and that the order index
+ * ranks every song at its place in the links. O(n log n) with the order
+ * index and O(n) without, where playlistDetectCycle is O(1).
+ */
+bool playlistValidate(const Playlist *playlist);
+
+/**
+ * Function: playlistReverse
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: play order is turned around in O(1); a circular
+ *                  playlist stays circular
+ * Return: void
+ * Dependencies: none
+ *
+ * Only the direction flag changes. Walkers go through playlistFirst and
+ * playlistNext, and bulk relinks call playlistStraighten first.
+ */
+void playlistReverse(Playlist *playlist);
+
+/**
+ * Function: playlistStraighten
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: a reversed playlist is relinked so that link order is
+ *                  play order again; nothing changes otherwise
+ * Return: void
+ * Dependencies: artistIndexReverse, genreChainReverse, orderBuild
+ *
+ * O(n) once after a reverse, for code that walks or splices links
+ * directly: the sorts and the loader.
+ */
+void playlistStraighten(Playlist *playlist);
+
+/**
+ * Function: playlistFirst
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: none
+ * Return: the first song in play order, or NULL for an empty playlist
+ * Dependencies: none
+ */
+Song *playlistFirst(const Playlist *playlist);
+
+/**
+ * Function: playlistLast
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: none
+ * Return: the last song in play order, or NULL for an empty playlist
+ * Dependencies: none
+ */
+Song *playlistLast(const Playlist *playlist);
+
+/**
+ * Function: playlistNext
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 song - a song of the playlist
+ * Output argument: none
+ * Return: the song that plays after it, wrapping around a circular
+ *         playlist, or NULL after the last song of a linear one
+ * Dependencies: none
+ */
+Song *playlistNext(const Playlist *playlist, const Song *song);
+
+/**
+ * Function: playlistPrevious
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 song - a song of the playlist
+ * Output argument: none
+ * Return: the song that played before it, wrapping around a circular
+ *         playlist, or NULL before the first song of a linear one; O(1)
+ * Dependencies: none
+ */
+Song *playlistPrevious(const Playlist *playlist, const Song *song);
+
+/**
+ * Function: playlistFree
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: every song is freed with its slab and the playlist is
+ *                  empty again; open cursors stay open, past the end
+ * Return: void
+ * Dependencies: artistPoolRelease, songPoolDestroy, cursorsDetach,
+ *               playlistPrefixDrop
+ */
+void playlistFree(Playlist *playlist);
+
+/**
+ * Function: playlistRebuildIndexes
+ * Input argument: playlist - a pointer to a playlist handle
+ * Output argument: every index is rebuilt from the current song order;
+ *                  the completions are dropped until next used
+ * Return: void
+ * Dependencies: playlistPrefixDrop, titleIndexClear, titleIndexReserve,
+ *               titleIndexPrefetch, titleIndexInsert, artistIndexAppend,
+ *               genreChainInit, genreChainAppend, orderBuild
+ *
+ * Functions that relink songs in bulk, such as the sorts and the loader,
+ * call this once they are done.
+ */
+void playlistRebuildIndexes(Playlist *playlist);
+
+/**
+ * Function: songViewFromArray
+ * Input argument: view - a pointer to the view to fill in
+ *                 songs - an array of song pointers, in play order
+ *                 length - the number of songs in the array
+ * Output argument: view reads positions straight from the array
+ * Return: void
+ * Dependencies: none
+ */
+void songViewFromArray(SongView *view, Song *const *songs, size_t length);
+
+/**
+ * Function: songViewFromPlaylist
+ * Input argument: view - a pointer to the view to fill in
+ *                 playlist - a pointer to a playlist handle
+ * Output argument: view reads positions in play order from the playlist
+ * Return: void
+ * Dependencies: songViewPlaylistAt
+ *
+ * Each lookup is O(log N) expected through the order index, with nothing
+ * copied, so the view costs O(1) memory. The playlist must not be edited
+ * while the view is read.
+ */
+void songViewFromPlaylist(SongView *view, const Playlist *playlist);
+
+/**
+ * Function: playShuffleStream
+ * Input argument: view - songs with positional access
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres
+ *                 seed - the shuffle seed; equal seeds give equal orders
+ * Output argument: none
+ * Return: none
+ * Dependencies: permutationInit, permutationAt, songPlay
+ *
+ * Plays every song once in a random order computed one position at a time,
+ * so playback starts at once and no array of the shuffled order is built.
+ */
+void playShuffleStream(const SongView *view, OutputSink *sink,
+    char* genres[], uint64_t seed);
+
 #endif // MUSIC_LIB_H
\ No newline at end of file
@@ -1,31 +1,56 @@
 #include "music_lib.h"
+#include "music_sort.h"
+#include "music_snapshot.h"
+#include "music_cursor.h"
+#include "music_journal.h"
+#include "music_search.h"
 
 int main() 
 {
-    // seed a random number generator
-    srand(time(NULL));
+    // seed for shuffle play, advanced after every shuffle
+    uint64_t seed = (uint64_t)time(NULL);
     // variable to store user menu choice
-    int choice = 0; 
-    // arrays to store song title and artist name
-    char title[50], artist[50];
+    int choice = -1; 
+    // song title and artist name, allocated by scanf to fit whatever was
+    // typed, so long input can neither overflow nor be cut short
+    char *title = NULL, *artist = NULL;
     // variable to store genre choice
     int genre;
+    // variable to store sort order choice
+    int order;
+    // variable to store a track number, counted from 1
+    size_t track;
     // array of genre names
     char* genres[] = {"Pop", "Rock", "Jazz", "Classical", "Other"};
+    // songs are played to stdout through one buffered sink
+    OutputSink out;
+    outputInitFile(&out, stdout);
     // create an initial playlist
         // declare a variable to hold the playlist
-    Song *playlist = NULL;
-        // create an initial playlist
-    if(!createPlaylist(&playlist))
+    Playlist playlist;
+    playlistInit(&playlist);
+        // load it from the snapshot or the CSV, and replay the edits the
+        // journal saved since; later edits are appended to the journal
+    Journal journal;
+    if (!journalOpen(&journal, &playlist, JOURNAL_FILENAME, SNAPSHOT_FILENAME,
+        FILENAME))
     {
         // print a message if something went wrong
         printf("Something went wrong. Please give it another try.\n");
+        // release the output buffer; nothing was loaded
+        outputFree(&out);
         // exit with an error code
         return 1;
     }
         // print an initial message
     printf("\nTuneStream Music Player\n\n");
-    printf("Initial playlist created with 20 songs!\n"); 
+    printf("Initial playlist created with %zu songs!\n", playlist.length); 
+    // remember where resumed playback stopped, across edits
+    PlaylistCursor cursor;
+    cursorOpen(&cursor, &playlist);
+    // a lowercased copy of the titles and artists, made on the first search
+    SearchIndex search;
+    searchInit(&search);
 
     // Infinite loop to keep the program running
     while (choice != 10)
@@ -36,17 +61,36 @@ int main()
         printf("3. Play by Artist\n");
         printf("4. Add a song to the playlist\n");
         printf("5. Remove a song by name\n");
-        printf("6. Sort by Genre\n");
+        printf("6. Sort playlist\n");
         printf("7. Set to Continuous Play Mode\n");
         printf("8. Set to Single Execution Play Mode\n");
         printf("9. Reverse Playlist\n");
         printf("10. Exit\n");
+        printf("11. List artists\n");
+        printf("12. Check playlist integrity\n");
+        printf("13. Play backwards\n");
+        printf("14. Resume playback\n");
+        printf("15. Jump to track\n");
+        printf("16. Play next\n");
+        printf("17. Search titles and artists\n");
+        printf("18. Play by genre\n");
+        printf("19. Play genres in turn\n");
 
         // prompt user for choice
         printf("Choose an option: "); 
 
-        // read the user's choice
-        scanf("%d", &choice); 
+        // read the user's choice, treating the end of input as exit
+        int read = scanf("%d", &choice);
+        if (read == EOF)
+        {
+            choice = 10;
+        }
+        // skip the rest of a line that was not a number
+        else if (read == 0)
+        {
+            scanf("%*[^\n]");
+            choice = -1;
+        }
 
         // switch case to handle different menu options
         switch (choice) 
@@ -54,25 +98,39 @@ int main()
             // case for playing the songs
             case 1:
                 // play the songs
-                play(playlist, genres);
+                playlistPlay(&playlist, &out, genres);
                 // end of case
                 break;
 
             // case for shuffling play 
             case 2: 
-                // play songs in the shuffle mode
-                playShuffle(playlist, genres);
+            {
+                // play songs in the shuffle mode, each position looked up
+                // through the order index, so no shuffled copy is built
+                SongView view;
+                songViewFromPlaylist(&view, &playlist);
+                playShuffleStream(&view, &out, genres, seed++);
                 // exit the case
                 break;
+            }
 
             // case for searching by artist    
             case 3:
                 // prompt for artist name 
                 printf("Enter artist name to search: "); 
-                // read the artist name from user
-                scanf(" %[^\n]%*c", artist); 
-                // play by artist
-                playByArtist(playlist, artist, genres);
+                // read the artist name from user, then play by artist
+                if (scanf(" %m[^\n]%*c", &artist) == 1)
+                {
+                    playlistPlayByArtist(&playlist, artist, &out, genres);
+                    // offer the names the user may have meant
+                    if (playlistCountByArtist(&playlist, artist) == 0)
+                    {
+                        playlistPrintSuggestions(&playlist, true, artist);
+                    }
+                }
+                // release the name
+                free(artist);
+                artist = NULL;
                 // exit the case
                 break;
 
@@ -81,23 +139,32 @@ int main()
                 // prompt for song title
                 printf("Enter song title: "); 
                 // read the song title from user
-                scanf(" %[^\n]%*c", title);
+                scanf(" %m[^\n]%*c", &title);
                 // prompt for artist name
                 printf("Enter artist: "); 
                 // read the artist name from user
-                scanf(" %[^\n]%*c", artist);
+                scanf(" %m[^\n]%*c", &artist);
                 // prompt for genre
                 printf("Enter genre (0: POP, 1: ROCK, 2: JAZZ, 3: CLASSICAL, " 
                         "4: OTHER): ");
                 // read the genre from user
-                scanf("%d", &genre); 
+                if (scanf("%d", &genre) != 1)
+                {
+                    genre = -1;
+                }
 
                 // try to add a new song
-                if(addSong(&playlist, title, artist, (Genre)genre))
+                if(title != NULL && artist != NULL &&
+                    journalAddSong(&journal, title, artist, (Genre)genre))
                 {
                     // print a confirmation message if successfully
                     puts("Song added successfully!\n");
                 }
+                // release the strings, which the song has copied
+                free(title);
+                free(artist);
+                title = NULL;
+                artist = NULL;
                 // exit the case
                 break;
 
@@ -106,49 +173,261 @@ int main()
                 // prompt for song title to remove
                 printf("Enter song title to remove: ");
                 // read the song title from user
-                scanf(" %[^\n]%*c", title);
+                scanf(" %m[^\n]%*c", &title);
                 // try to remove the song
-                if(removeSong(&playlist, title))
+                if(title != NULL && journalRemoveSong(&journal, title))
                 {
                     puts("Song removed successfully\n");
                 }
+                // otherwise, offer the titles the user may have meant
+                else if (title != NULL)
+                {
+                    playlistPrintSuggestions(&playlist, false, title);
+                }
+                // release the title
+                free(title);
+                title = NULL;
                 // exit the case
                 break;
 
             // case for sorting by genre    
             case 6:
-                // sort the list by genre
-                sortByGenre(&playlist);
+                // prompt for the sort order
+                printf("Sort by (0: Genre, 1: Artist, 2: Title, "
+                        "3: Genre, artist and title): ");
+                // read the sort order from user
+                if (scanf("%d", &order) != 1)
+                {
+                    order = -1;
+                }
+                // genre sorting prints its own message
+                if (order == JOURNAL_SORT_GENRE)
+                {
+                    journalSort(&journal, JOURNAL_SORT_GENRE);
+                }
+                // the other orders go through the merge sort
+                else if (order > JOURNAL_SORT_GENRE &&
+                    order < JOURNAL_SORT_COUNT)
+                {
+                    // sort the list
+                    journalSort(&journal, (JournalSort)order);
+                    // print message to user
+                    printf("Playlist sorted.\n");
+                }
+                // otherwise, the order is unknown
+                else
+                {
+                    printf("Invalid sort order.\n");
+                }
                 // exit the case
                 break;
 
             // case for making the playlist circular    
             case 7: 
                 // make the playlist circular
-                makePlaylistCircular(&playlist);
+                playlistMakeCircular(&playlist);
                 // exit case
                 break;
 
             // case for making the playlist singly linked
             case 8:
                 // set the playlist for single execution
-                makePlaylistLinear(&playlist);
+                playlistMakeLinear(&playlist);
                 // exit the case
                 break;
 
             // Case for reversing the playlist    
             case 9: 
                 // Call function to reverse the playlist
-                reversePlaylist(&playlist); 
+                journalReverse(&journal); 
 
                 // Confirmation message
                 printf("Playlist reversed.\n"); 
                 break; // Exit the case
 
+            // case for listing the artists
+            case 11:
+            {
+                // ask the index how many artists there are
+                size_t count = playlistListArtists(&playlist, NULL, NULL, 0);
+                // allocate room for their names and song counts
+                const char **names = malloc(count * sizeof(char *));
+                size_t *counts = malloc(count * sizeof(size_t));
+                // print them if the allocation worked
+                if (count > 0 && names != NULL && counts != NULL)
+                {
+                    playlistListArtists(&playlist, names, counts, count);
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        printf("%s (%zu %s)\n", names[i], counts[i],
+                            counts[i] == 1 ? "song" : "songs");
+                    }
+                }
+                // otherwise, say there is nothing to list
+                else if (count == 0)
+                {
+                    printf("It is quiet here. Add songs to continue.\n");
+                }
+                // free the arrays
+                free(names);
+                free(counts);
+                // exit the case
+                break;
+            }
+
+            // case for checking that the links match the playlist
+            case 12:
+                // walk the whole list, whatever state it is in
+                if (playlistValidate(&playlist))
+                {
+                    printf("Playlist is intact: %zu songs, %s.\n",
+                        playlist.length,
+                        playlist.circular ? "circular" : "linear");
+                }
+                else
+                {
+                    printf("Playlist links are damaged.\n");
+                }
+                break;
+
+            // case for playing from the last song to the first
+            case 13:
+                // step back through the playlist
+                playlistPlayBackward(&playlist, &out, genres);
+                break;
+
+            // case for playing on from where the last resume stopped
+            case 14:
+                // check if no songs are in the playlist
+                if (playlist.head == NULL)
+                {
+                    printf("It is quiet here. Add songs to continue.\n");
+                }
+                // play the next batch without asking; at the end, start over
+                // next time
+                else if (cursorPlay(&cursor, &out, genres, MAX_SONGS) == 0)
+                {
+                    printf("End of the playlist. Playback will start over.\n");
+                    cursorSeek(&cursor, 0);
+                }
+                break;
+
+            // case for moving the resume point to a track by its number
+            case 15:
+                // prompt for the track number
+                printf("Enter track number (1-%zu): ", playlist.length);
+                // read it, then find the track without walking the playlist
+                if (scanf("%zu", &track) == 1 && track >= 1 &&
+                    cursorSeek(&cursor, track - 1) && cursor.song != NULL)
+                {
+                    printf("Playback will resume at track %zu, '%s'.\n",
+                        track, songTitle(cursor.song));
+                }
+                else
+                {
+                    printf("There is no such track.\n");
+                }
+                break;
+
+            // case for adding a song that resumed playback plays next
+            case 16:
+                // prompt for song title
+                printf("Enter song title: ");
+                // read the song title from user
+                scanf(" %m[^\n]%*c", &title);
+                // prompt for artist name
+                printf("Enter artist: ");
+                // read the artist name from user
+                scanf(" %m[^\n]%*c", &artist);
+                // prompt for genre
+                printf("Enter genre (0: POP, 1: ROCK, 2: JAZZ, 3: CLASSICAL, "
+                        "4: OTHER): ");
+                // read the genre from user
+                if (scanf("%d", &genre) != 1)
+                {
+                    genre = -1;
+                }
+                // insert it where the cursor is, and put the cursor on it
+                track = cursorPosition(&cursor);
+                if(title != NULL && artist != NULL &&
+                    journalInsertSong(&journal, track, title, artist,
+                        (Genre)genre))
+                {
+                    cursorSeek(&cursor, track);
+                    puts("Song will play next!\n");
+                }
+                // release the strings, which the song has copied
+                free(title);
+                free(artist);
+                title = NULL;
+                artist = NULL;
+                break;
+
+            // case for playing the songs whose title or artist has a word
+            case 17:
+                // prompt for the text to look for
+                printf("Enter text to search for: ");
+                // read it, bring the copy up to date and scan it
+                if (scanf(" %m[^\n]%*c", &title) == 1 &&
+                    searchRefresh(&search, &playlist) &&
+                    searchFind(&search, title, SEARCH_AUTO, 0))
+                {
+                    // say what was found, then play it
+                    if (search.matchCount == 0)
+                    {
+                        printf("No songs match '%s'.\n", title);
+                    }
+                    else
+                    {
+                        printf("%zu %s '%s'.\n", search.matchCount,
+                            search.matchCount == 1 ? "song matches" :
+                            "songs match", title);
+                        searchPlay(&search, &out, genres);
+                    }
+                }
+                // release the text
+                free(title);
+                title = NULL;
+                break;
+
+            // case for playing one genre
+            case 18:
+                // prompt for the genre, with how many songs each one has
+                printf("Enter genre (");
+                for (int i = 0; i < GENRE_COUNT; i++)
+                {
+                    size_t count = playlistCountByGenre(&playlist, (Genre)i);
+                    printf("%s%d: %s, %zu %s", i > 0 ? "; " : "", i,
+                        genres[i], count, count == 1 ? "song" : "songs");
+                }
+                printf("): ");
+                // read the genre from user, then play its songs
+                if (scanf("%d", &genre) != 1)
+                {
+                    genre = -1;
+                }
+                playlistPlayByGenre(&playlist, (Genre)genre, &out, genres);
+                break;
+
+            // case for taking turns between the genres
+            case 19:
+                playlistPlayInterleaved(&playlist, &out, genres);
+                break;
+
             // Case for exiting the program    
             case 10: 
                 // Message indicating exit
                 printf("Exiting...\n"); 
+                // Stop walking the playlist
+                cursorClose(&cursor);
+                // Drop the search copy, which points at the songs
+                searchFree(&search);
+                // Make every edit durable before letting go of the songs
+                journalClose(&journal);
+                // Release every song of the playlist at once
+                playlistFree(&playlist);
+                // and the output buffer
+                outputFree(&out);
 
                 return 0; // Exit the program
 
@@ -158,6 +437,6 @@ int main()
         }
     }
 
-    // Return statement for main function (not reached due to infinite loop)
+    // Return statement for main function (not reached, case 0 returns)
     return 0; 
 }
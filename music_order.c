@@ -0,0 +1,347 @@
+// header files
+#include "music_order.h"
+#include "music_lib.h"
+
+/**
+ * Function: orderSize (helper)
+ * Input argument: song - the root of a subtree, may be NULL
+ * Output argument: none
+ * Return: the number of songs in the subtree
+ * Dependencies: none
+ */
+static size_t orderSize(const Song *song)
+{
+    return song != NULL ? song->orderSize : 0;
+}
+
+/**
+ * Function: orderUpdate (helper)
+ * Input argument: song - a song whose children are final
+ * Output argument: the song's subtree size counts its children's songs
+ * Return: none
+ * Dependencies: orderSize
+ */
+static void orderUpdate(Song *song)
+{
+    song->orderSize = (uint32_t)(1 + orderSize(song->orderLeft) +
+        orderSize(song->orderRight));
+}
+
+/**
+ * Function: orderSplitNodes (helper)
+ * Input argument: song - the root of a subtree, may be NULL
+ *                 rank - how many of its songs go left
+ * Output argument: left - the root of the first rank songs
+ *                  right - the root of the others
+ * Return: none
+ * Dependencies: orderSize, orderUpdate
+ *
+ * Recurses once per level, so O(log N) expected deep.
+ */
+static void orderSplitNodes(Song *song, size_t rank, Song **left,
+    Song **right)
+{
+    // an empty subtree splits into two empty ones
+    if (song == NULL)
+    {
+        *left = NULL;
+        *right = NULL;
+        return;
+    }
+    // the cut is in the left subtree, so the song goes right
+    if (rank <= orderSize(song->orderLeft))
+    {
+        orderSplitNodes(song->orderLeft, rank, left, &song->orderLeft);
+        if (song->orderLeft != NULL)
+        {
+            song->orderLeft->orderParent = song;
+        }
+        *right = song;
+    }
+    // otherwise it is in the right subtree, and the song goes left
+    else
+    {
+        orderSplitNodes(song->orderRight,
+            rank - orderSize(song->orderLeft) - 1, &song->orderRight, right);
+        if (song->orderRight != NULL)
+        {
+            song->orderRight->orderParent = song;
+        }
+        *left = song;
+    }
+    // the song lost part of a subtree
+    orderUpdate(song);
+}
+
+/**
+ * Function: orderMergeNodes (helper)
+ * Input argument: left - the root of a subtree, may be NULL
+ *                 right - the root of a subtree whose songs follow, may be
+ *                         NULL
+ * Output argument: the two subtrees are joined, keeping priorities in heap
+ *                  order
+ * Return: the root of the joined subtree
+ * Dependencies: orderUpdate
+ */
+static Song *orderMergeNodes(Song *left, Song *right)
+{
+    // joining an empty subtree changes nothing
+    if (left == NULL)
+    {
+        return right;
+    }
+    if (right == NULL)
+    {
+        return left;
+    }
+    // the higher priority becomes the root; its inner side is merged
+    if (left->orderPriority >= right->orderPriority)
+    {
+        left->orderRight = orderMergeNodes(left->orderRight, right);
+        left->orderRight->orderParent = left;
+        orderUpdate(left);
+        return left;
+    }
+    right->orderLeft = orderMergeNodes(left, right->orderLeft);
+    right->orderLeft->orderParent = right;
+    orderUpdate(right);
+    return right;
+}
+
+/**
+ * Function: orderInit
+ * Input argument: index - a pointer to an order index
+ * Output argument: index is empty, with its priorities seeded
+ * Return: none
+ * Dependencies: rngSeed
+ */
+void orderInit(OrderIndex *index)
+{
+    index->root = NULL;
+    rngSeed(&index->rng, ORDER_SEED);
+}
+
+/**
+ * Function: orderBuild
+ * Input argument: index - a pointer to an order index
+ *                 first - the first song in link order, NULL if count is 0
+ *                 count - the number of songs to follow through next links
+ * Output argument: index holds exactly those songs, in link order
+ * Return: none
+ * Dependencies: rngNext
+ *
+ * O(N): each song is pushed onto the tree's right spine once, popping the
+ * songs of lower priority below it, and its size is final when it is
+ * popped.
+ */
+void orderBuild(OrderIndex *index, Song *first, size_t count)
+{
+    // start from an empty tree
+    index->root = NULL;
+    // the end of the right spine, where the next song goes
+    Song *last = NULL;
+    Song *song = first;
+    for (size_t i = 0; i < count; i++)
+    {
+        song->orderPriority = (uint32_t)(rngNext(&index->rng) >> 32);
+        song->orderRight = NULL;
+        // pop the spine songs the new one outranks; they are complete now
+        Song *popped = NULL;
+        Song *top = last;
+        while (top != NULL && top->orderPriority < song->orderPriority)
+        {
+            orderUpdate(top);
+            popped = top;
+            top = top->orderParent;
+        }
+        // they become its left subtree, and it ends the spine
+        song->orderLeft = popped;
+        if (popped != NULL)
+        {
+            popped->orderParent = song;
+        }
+        song->orderParent = top;
+        if (top != NULL)
+        {
+            top->orderRight = song;
+        }
+        else
+        {
+            index->root = song;
+        }
+        last = song;
+        song = song->next;
+    }
+    // finish the sizes along the spine, from the bottom up
+    for (Song *top = last; top != NULL; top = top->orderParent)
+    {
+        orderUpdate(top);
+    }
+}
+
+/**
+ * Function: orderCount
+ * Input argument: index - a pointer to an order index
+ * Output argument: none
+ * Return: the number of songs in the index
+ * Dependencies: orderSize
+ */
+size_t orderCount(const OrderIndex *index)
+{
+    return orderSize(index->root);
+}
+
+/**
+ * Function: orderAt
+ * Input argument: index - a pointer to an order index
+ *                 rank - a place in link order, below the count
+ * Output argument: none
+ * Return: the song at that rank, in O(log N) expected time
+ * Dependencies: orderSize
+ */
+Song *orderAt(const OrderIndex *index, size_t rank)
+{
+    // descend towards the rank, dropping the songs passed on the left
+    Song *song = index->root;
+    while (song != NULL)
+    {
+        size_t left = orderSize(song->orderLeft);
+        if (rank < left)
+        {
+            song = song->orderLeft;
+        }
+        else if (rank == left)
+        {
+            return song;
+        }
+        else
+        {
+            rank -= left + 1;
+            song = song->orderRight;
+        }
+    }
+    // the rank was beyond the count
+    return NULL;
+}
+
+/**
+ * Function: orderRank
+ * Input argument: song - a song in an order index
+ * Output argument: none
+ * Return: the number of songs before it in link order, in O(log N)
+ *         expected time
+ * Dependencies: orderSize
+ */
+size_t orderRank(const Song *song)
+{
+    // the songs in its left subtree come first
+    size_t rank = orderSize(song->orderLeft);
+    // and, climbing up, every parent passed from its right with that
+    // parent's left subtree
+    for (const Song *node = song; node->orderParent != NULL;
+        node = node->orderParent)
+    {
+        if (node == node->orderParent->orderRight)
+        {
+            rank += orderSize(node->orderParent->orderLeft) + 1;
+        }
+    }
+    // return the rank
+    return rank;
+}
+
+/**
+ * Function: orderSplit
+ * Input argument: index - a pointer to an order index
+ *                 rank - where to cut, at most the count
+ *                 rest - a pointer to an empty order index
+ * Output argument: index keeps the songs ranked below rank, and rest takes
+ *                  the others, in order
+ * Return: none
+ * Dependencies: orderSplitNodes
+ */
+void orderSplit(OrderIndex *index, size_t rank, OrderIndex *rest)
+{
+    orderSplitNodes(index->root, rank, &index->root, &rest->root);
+    // both halves have roots of their own now
+    if (index->root != NULL)
+    {
+        index->root->orderParent = NULL;
+    }
+    if (rest->root != NULL)
+    {
+        rest->root->orderParent = NULL;
+    }
+}
+
+/**
+ * Function: orderConcat
+ * Input argument: index - a pointer to an order index
+ *                 rest - a pointer to an order index whose songs follow
+ *                        those of index
+ * Output argument: index holds its songs and then those of rest, and rest
+ *                  is empty
+ * Return: none
+ * Dependencies: orderMergeNodes
+ */
+void orderConcat(OrderIndex *index, OrderIndex *rest)
+{
+    index->root = orderMergeNodes(index->root, rest->root);
+    if (index->root != NULL)
+    {
+        index->root->orderParent = NULL;
+    }
+    rest->root = NULL;
+}
+
+/**
+ * Function: orderInsert
+ * Input argument: index - a pointer to an order index
+ *                 song - a song in no order index
+ *                 rank - where the song goes, at most the count
+ * Output argument: song has that rank, and the songs from there on move
+ *                  up by one
+ * Return: none
+ * Dependencies: rngNext, orderCount, orderSplit, orderConcat
+ */
+void orderInsert(OrderIndex *index, Song *song, size_t rank)
+{
+    // the song is a tree of its own
+    song->orderLeft = NULL;
+    song->orderRight = NULL;
+    song->orderParent = NULL;
+    song->orderSize = 1;
+    song->orderPriority = (uint32_t)(rngNext(&index->rng) >> 32);
+    OrderIndex single = { .root = song };
+    // appending needs no cut, which keeps building a playlist cheap
+    if (rank == orderCount(index))
+    {
+        orderConcat(index, &single);
+        return;
+    }
+    // otherwise cut the tree where the song goes and join the three pieces
+    OrderIndex rest = { .root = NULL };
+    orderSplit(index, rank, &rest);
+    orderConcat(index, &single);
+    orderConcat(index, &rest);
+}
+
+/**
+ * Function: orderRemove
+ * Input argument: index - a pointer to an order index
+ *                 song - a song in index
+ * Output argument: song is taken out, and the songs after it move down by
+ *                  one
+ * Return: none
+ * Dependencies: orderRank, orderSplit, orderConcat
+ */
+void orderRemove(OrderIndex *index, Song *song)
+{
+    // cut the song out and join what was around it
+    size_t rank = orderRank(song);
+    OrderIndex rest = { .root = NULL };
+    OrderIndex after = { .root = NULL };
+    orderSplit(index, rank, &rest);
+    orderSplit(&rest, 1, &after);
+    orderConcat(index, &after);
+}
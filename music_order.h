@@ -0,0 +1,132 @@
+#ifndef MUSIC_ORDER_H
+#define MUSIC_ORDER_H
+
+// header files
+#include <stddef.h>
+#include <stdint.h>
+#include "music_rng.h"
+
+// global definitions
+// seeds the priorities, so equal edits build equal trees
+#define ORDER_SEED UINT64_C(0x6f72646572696478)
+
+// an implicit treap over songs in link order
+//
+// Every song is a node, through its order fields. A song's rank, its place
+// in link order, is the number of songs before it in an in-order walk, and
+// the subtree sizes give it in O(log N). No rank is stored, so inserting or
+// removing a song renumbers every song after it for free. Priorities are
+// random and kept in heap order, which keeps the tree O(log N) deep in
+// expectation.
+typedef struct OrderIndex
+{
+    // the root song, or NULL when the index is empty
+    struct Song *root;
+    // draws the priorities of new songs
+    Rng rng;
+}
+OrderIndex;
+
+// function prototypes
+
+/**
+ * Function: orderInit
+ * Input argument: index - a pointer to an order index
+ * Output argument: index is empty, with its priorities seeded
+ * Return: none
+ * Dependencies: rngSeed
+ */
+void orderInit(OrderIndex *index);
+
+/**
+ * Function: orderBuild
+ * Input argument: index - a pointer to an order index
+ *                 first - the first song in link order, NULL if count is 0
+ *                 count - the number of songs to follow through next links
+ * Output argument: index holds exactly those songs, in link order
+ * Return: none
+ * Dependencies: rngNext
+ *
+ * O(N): each song is pushed onto the tree's right spine once, popping the
+ * songs of lower priority below it, and its size is final when it is
+ * popped.
+ */
+void orderBuild(OrderIndex *index, struct Song *first, size_t count);
+
+/**
+ * Function: orderCount
+ * Input argument: index - a pointer to an order index
+ * Output argument: none
+ * Return: the number of songs in the index
+ * Dependencies: orderSize
+ */
+size_t orderCount(const OrderIndex *index);
+
+/**
+ * Function: orderAt
+ * Input argument: index - a pointer to an order index
+ *                 rank - a place in link order, below the count
+ * Output argument: none
+ * Return: the song at that rank, in O(log N) expected time
+ * Dependencies: orderSize
+ */
+struct Song *orderAt(const OrderIndex *index, size_t rank);
+
+/**
+ * Function: orderRank
+ * Input argument: song - a song in an order index
+ * Output argument: none
+ * Return: the number of songs before it in link order, in O(log N)
+ *         expected time
+ * Dependencies: orderSize
+ */
+size_t orderRank(const struct Song *song);
+
+/**
+ * Function: orderSplit
+ * Input argument: index - a pointer to an order index
+ *                 rank - where to cut, at most the count
+ *                 rest - a pointer to an empty order index
+ * Output argument: index keeps the songs ranked below rank, and rest takes
+ *                  the others, in order
+ * Return: none
+ * Dependencies: orderSplitNodes
+ */
+void orderSplit(OrderIndex *index, size_t rank, OrderIndex *rest);
+
+/**
+ * Function: orderConcat
+ * Input argument: index - a pointer to an order index
+ *                 rest - a pointer to an order index whose songs follow
+ *                        those of index
+ * Output argument: index holds its songs and then those of rest, and rest
+ *                  is empty
+ * Return: none
+ * Dependencies: orderMergeNodes
+ */
+void orderConcat(OrderIndex *index, OrderIndex *rest);
+
+/**
+ * Function: orderInsert
+ * Input argument: index - a pointer to an order index
+ *                 song - a song in no order index
+ *                 rank - where the song goes, at most the count
+ * Output argument: song has that rank, and the songs from there on move
+ *                  up by one
+ * Return: none
+ * Dependencies: rngNext, orderCount, orderSplit, orderConcat
+ */
+void orderInsert(OrderIndex *index, struct Song *song, size_t rank);
+
+/**
+ * Function: orderRemove
+ * Input argument: index - a pointer to an order index
+ *                 song - a song in index
+ * Output argument: song is taken out, and the songs after it move down by
+ *                  one
+ * Return: none
+ * Dependencies: orderRank, orderSplit, orderConcat
+ */
+void orderRemove(OrderIndex *index, struct Song *song);
+
+#endif // MUSIC_ORDER_H
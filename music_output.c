@@ -0,0 +1,329 @@
+// header files
+#include "music_output.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/**
+ * Function: outputDrainFile (helper)
+ * Input argument: sink - a pointer to a file sink
+ *                 extra - bytes to write after the buffer, may be NULL
+ *                 extraLength - the number of extra bytes
+ * Output argument: the buffer and the extra bytes are handed to the stream
+ * Return: true if the stream took every byte, false otherwise
+ * Dependencies: stdio.h
+ */
+static bool outputDrainFile(
+    OutputSink *sink, const char *extra, size_t extraLength)
+{
+    // write the buffer, then the extra bytes
+    bool ok = fwrite(sink->buffer, 1, sink->length, sink->file) ==
+        sink->length;
+    ok = ok && (extraLength == 0 ||
+        fwrite(extra, 1, extraLength, sink->file) == extraLength);
+    // the buffer is empty either way
+    sink->length = 0;
+    // return the result
+    return ok;
+}
+
+/**
+ * Function: outputDrainFd (helper)
+ * Input argument: sink - a pointer to a descriptor sink
+ *                 extra - bytes to write after the buffer, may be NULL
+ *                 extraLength - the number of extra bytes
+ * Output argument: the buffer and the extra bytes are written with writev,
+ *                  one call unless the descriptor takes them in parts
+ * Return: true if every byte was written, false otherwise
+ * Dependencies: sys/uio.h, errno.h
+ */
+static bool outputDrainFd(
+    OutputSink *sink, const char *extra, size_t extraLength)
+{
+    // describe both pieces
+    struct iovec pieces[2] = {
+        { sink->buffer, sink->length },
+        { (void *)extra, extraLength }
+    };
+    struct iovec *next = pieces;
+    int count = 2;
+    // the buffer is empty either way
+    sink->length = 0;
+    // write until both pieces are gone
+    while (count > 0)
+    {
+        // skip pieces that are already written
+        if (next->iov_len == 0)
+        {
+            next++;
+            count--;
+            continue;
+        }
+        ssize_t written = writev(sink->fd, next, count);
+        // retry after a signal, give up on any other error
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        // move past what was written
+        while (count > 0 && (size_t)written >= next->iov_len)
+        {
+            written -= (ssize_t)next->iov_len;
+            next++;
+            count--;
+        }
+        if (count > 0)
+        {
+            next->iov_base = (char *)next->iov_base + written;
+            next->iov_len -= (size_t)written;
+        }
+    }
+    // return success
+    return true;
+}
+
+/**
+ * Function: outputDrainNull (helper)
+ * Input argument: sink - a pointer to a null sink
+ *                 extra - ignored
+ *                 extraLength - ignored
+ * Output argument: the buffer is emptied
+ * Return: true
+ * Dependencies: none
+ */
+static bool outputDrainNull(
+    OutputSink *sink, const char *extra, size_t extraLength)
+{
+    // drop everything
+    (void)extra;
+    (void)extraLength;
+    sink->length = 0;
+    return true;
+}
+
+/**
+ * Function: outputInit (helper)
+ * Input argument: sink - a pointer to an output sink
+ *                 drain - how the sink empties its buffer
+ * Output argument: sink is empty, with a buffer of OUTPUT_BUFFER_SIZE bytes
+ *                  or, if that could not be allocated, none
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+static void outputInit(OutputSink *sink,
+    bool (*drain)(OutputSink *, const char *, size_t))
+{
+    sink->drain = drain;
+    sink->file = NULL;
+    sink->fd = -1;
+    // an unbuffered sink still works, one write per piece
+    sink->buffer = (char*)malloc(OUTPUT_BUFFER_SIZE);
+    sink->capacity = sink->buffer != NULL ? OUTPUT_BUFFER_SIZE : 0;
+    sink->length = 0;
+    sink->ok = true;
+}
+
+/**
+ * Function: outputInitFile
+ * Input argument: sink - a pointer to an output sink
+ *                 file - the stream to write to, e.g. stdout
+ * Output argument: sink writes to file with fwrite and flushes it with
+ *                  fflush, so it stays in order with printf on the same file
+ * Return: none
+ * Dependencies: outputInit
+ */
+void outputInitFile(OutputSink *sink, FILE *file)
+{
+    outputInit(sink, outputDrainFile);
+    sink->file = file;
+}
+
+/**
+ * Function: outputInitFd
+ * Input argument: sink - a pointer to an output sink
+ *                 fd - the file descriptor to write to
+ * Output argument: sink writes to fd with writev, bypassing stdio
+ * Return: none
+ * Dependencies: outputInit
+ */
+void outputInitFd(OutputSink *sink, int fd)
+{
+    outputInit(sink, outputDrainFd);
+    sink->fd = fd;
+}
+
+/**
+ * Function: outputInitNull
+ * Input argument: sink - a pointer to an output sink
+ * Output argument: sink formats into its buffer and then drops the bytes,
+ *                  for benchmarking everything but the destination
+ * Return: none
+ * Dependencies: outputInit
+ */
+void outputInitNull(OutputSink *sink)
+{
+    outputInit(sink, outputDrainNull);
+}
+
+/**
+ * Function: outputFree
+ * Input argument: sink - a pointer to an output sink
+ * Output argument: the sink is flushed and its buffer freed
+ * Return: true if every byte reached the destination, false otherwise
+ * Dependencies: outputFlush, stdlib.h
+ */
+bool outputFree(OutputSink *sink)
+{
+    // hand over what is left
+    bool ok = outputFlush(sink);
+    // and release the buffer
+    free(sink->buffer);
+    sink->buffer = NULL;
+    sink->capacity = 0;
+    // return the result
+    return ok;
+}
+
+/**
+ * Function: outputFlush
+ * Input argument: sink - a pointer to an output sink
+ * Output argument: the buffered bytes reach the destination
+ * Return: true if every byte so far reached the destination, false otherwise
+ * Dependencies: stdio.h
+ */
+bool outputFlush(OutputSink *sink)
+{
+    // empty the buffer
+    if (sink->length > 0 && !sink->drain(sink, NULL, 0))
+    {
+        sink->ok = false;
+    }
+    // a file sink also pushes the stream's own buffer out
+    if (sink->file != NULL && fflush(sink->file) != 0)
+    {
+        sink->ok = false;
+    }
+    // return whether anything failed so far
+    return sink->ok;
+}
+
+/**
+ * Function: outputWrite
+ * Input argument: sink - a pointer to an output sink
+ *                 bytes - the bytes to write
+ *                 length - the number of bytes
+ * Output argument: the bytes are buffered, or written along with the buffer
+ *                  in one call when they do not fit
+ * Return: none
+ * Dependencies: string.h
+ */
+void outputWrite(OutputSink *sink, const char *bytes, size_t length)
+{
+    // nothing to do for no bytes
+    if (length == 0)
+    {
+        return;
+    }
+    // the common case: append to the buffer
+    if (length <= sink->capacity - sink->length)
+    {
+        memcpy(sink->buffer + sink->length, bytes, length);
+        sink->length += length;
+        return;
+    }
+    // bytes that would fill most of an empty buffer go out right behind it
+    if (length >= sink->capacity / 2)
+    {
+        if (!sink->drain(sink, bytes, length))
+        {
+            sink->ok = false;
+        }
+        return;
+    }
+    // otherwise, empty the buffer and start it over with the bytes
+    if (!sink->drain(sink, NULL, 0))
+    {
+        sink->ok = false;
+    }
+    memcpy(sink->buffer, bytes, length);
+    sink->length = length;
+}
+
+/**
+ * Function: outputString
+ * Input argument: sink - a pointer to an output sink
+ *                 text - a null terminated string
+ * Output argument: the string is written without its terminator
+ * Return: none
+ * Dependencies: outputWrite, string.h
+ */
+void outputString(OutputSink *sink, const char *text)
+{
+    outputWrite(sink, text, strlen(text));
+}
+
+/**
+ * Function: outputPlaying
+ * Input argument: sink - a pointer to an output sink
+ *                 title, titleLength - the song's title and its length
+ *                 artist, artistLength - the song's artist and its length
+ *                 genre - the name of the song's genre
+ * Output argument: "Playing '<title>' by '<artist>' (Genre: <genre>) ...\n"
+ *                  is written
+ * Return: none
+ * Dependencies: outputWrite, string.h
+ */
+void outputPlaying(OutputSink *sink, const char *title, size_t titleLength,
+    const char *artist, size_t artistLength, const char *genre)
+{
+    // the fixed pieces of the template
+    static const char before[] = "Playing '";
+    static const char middle[] = "' by '";
+    static const char label[] = "' (Genre: ";
+    static const char after[] = ") ...\n";
+    size_t genreLength = strlen(genre);
+    size_t length = sizeof(before) - 1 + titleLength + sizeof(middle) - 1 +
+        artistLength + sizeof(label) - 1 + genreLength + sizeof(after) - 1;
+    // make room for the whole line unless it is too long to buffer
+    if (length > sink->capacity - sink->length && length <= sink->capacity)
+    {
+        if (!sink->drain(sink, NULL, 0))
+        {
+            sink->ok = false;
+        }
+    }
+    // copy the pieces straight into the buffer
+    if (length <= sink->capacity - sink->length)
+    {
+        char *out = sink->buffer + sink->length;
+        memcpy(out, before, sizeof(before) - 1);
+        out += sizeof(before) - 1;
+        memcpy(out, title, titleLength);
+        out += titleLength;
+        memcpy(out, middle, sizeof(middle) - 1);
+        out += sizeof(middle) - 1;
+        memcpy(out, artist, artistLength);
+        out += artistLength;
+        memcpy(out, label, sizeof(label) - 1);
+        out += sizeof(label) - 1;
+        memcpy(out, genre, genreLength);
+        out += genreLength;
+        memcpy(out, after, sizeof(after) - 1);
+        sink->length += length;
+        return;
+    }
+    // a line longer than the buffer goes out piece by piece
+    outputWrite(sink, before, sizeof(before) - 1);
+    outputWrite(sink, title, titleLength);
+    outputWrite(sink, middle, sizeof(middle) - 1);
+    outputWrite(sink, artist, artistLength);
+    outputWrite(sink, label, sizeof(label) - 1);
+    outputWrite(sink, genre, genreLength);
+    outputWrite(sink, after, sizeof(after) - 1);
+}
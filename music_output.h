@@ -0,0 +1,127 @@
+#ifndef MUSIC_OUTPUT_H
+#define MUSIC_OUTPUT_H
+
+// header files
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// global definitions
+// bytes a sink collects before handing them to its destination
+#define OUTPUT_BUFFER_SIZE (64 * 1024)
+
+// where the play functions write the songs they play
+//
+// Bytes collect in a large buffer and reach the destination in one call
+// when it fills up or the sink is flushed, so playing a track costs a few
+// memcpy calls instead of a printf.
+typedef struct OutputSink
+{
+    // hands the buffered bytes, then extra bytes that did not fit, to the
+    // destination and empties the buffer; false if the destination failed
+    bool (*drain)(struct OutputSink *sink, const char *extra,
+        size_t extraLength);
+    // the destination of the file and descriptor sinks
+    FILE *file;
+    int fd;
+    // the buffered bytes; capacity is 0 when the buffer could not be
+    // allocated, and every write then goes straight to the destination
+    char *buffer;
+    size_t length;
+    size_t capacity;
+    // false once a write to the destination failed
+    bool ok;
+}
+OutputSink;
+
+// function prototypes
+
+/**
+ * Function: outputInitFile
+ * Input argument: sink - a pointer to an output sink
+ *                 file - the stream to write to, e.g. stdout
+ * Output argument: sink writes to file with fwrite and flushes it with
+ *                  fflush, so it stays in order with printf on the same file
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void outputInitFile(OutputSink *sink, FILE *file);
+
+/**
+ * Function: outputInitFd
+ * Input argument: sink - a pointer to an output sink
+ *                 fd - the file descriptor to write to
+ * Output argument: sink writes to fd with writev, bypassing stdio
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void outputInitFd(OutputSink *sink, int fd);
+
+/**
+ * Function: outputInitNull
+ * Input argument: sink - a pointer to an output sink
+ * Output argument: sink formats into its buffer and then drops the bytes,
+ *                  for benchmarking everything but the destination
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void outputInitNull(OutputSink *sink);
+
+/**
+ * Function: outputFree
+ * Input argument: sink - a pointer to an output sink
+ * Output argument: the sink is flushed and its buffer freed
+ * Return: true if every byte reached the destination, false otherwise
+ * Dependencies: outputFlush, stdlib.h
+ */
+bool outputFree(OutputSink *sink);
+
+/**
+ * Function: outputFlush
+ * Input argument: sink - a pointer to an output sink
+ * Output argument: the buffered bytes reach the destination
+ * Return: true if every byte so far reached the destination, false otherwise
+ * Dependencies: stdio.h
+ */
+bool outputFlush(OutputSink *sink);
+
+/**
+ * Function: outputWrite
+ * Input argument: sink - a pointer to an output sink
+ *                 bytes - the bytes to write
+ *                 length - the number of bytes
+ * Output argument: the bytes are buffered, or written along with the buffer
+ *                  in one call when they do not fit
+ * Return: none
+ * Dependencies: string.h
+ */
+void outputWrite(OutputSink *sink, const char *bytes, size_t length);
+
+/**
+ * Function: outputString
+ * Input argument: sink - a pointer to an output sink
+ *                 text - a null terminated string
+ * Output argument: the string is written without its terminator
+ * Return: none
+ * Dependencies: outputWrite, string.h
+ */
+void outputString(OutputSink *sink, const char *text);
+
+/**
+ * Function: outputPlaying
+ * Input argument: sink - a pointer to an output sink
+ *                 title, titleLength - the song's title and its length
+ *                 artist, artistLength - the song's artist and its length
+ *                 genre - the name of the song's genre
+ * Output argument: "Playing '<title>' by '<artist>' (Genre: <genre>) ...\n"
+ *                  is written
+ * Return: none
+ * Dependencies: outputWrite, string.h
+ *
+ * Copies the pieces of the fixed template straight into the buffer instead
+ * of parsing a format string.
+ */
+void outputPlaying(OutputSink *sink, const char *title, size_t titleLength,
+    const char *artist, size_t artistLength, const char *genre);
+
+#endif // MUSIC_OUTPUT_H
@@ -0,0 +1,259 @@
+// header files
+#include "music_lib.h"
+
+struct SongSlab
+{
+    // the slab allocated before this one
+    SongSlab *next;
+    // songs carved out of this slab
+    Song songs[SONG_SLAB_SIZE];
+};
+
+struct SongText
+{
+    // the block allocated before this one
+    SongText *next;
+    // bytes handed out so far, and the block's size
+    size_t used;
+    size_t capacity;
+    // the strings, each followed by its terminator
+    char bytes[];
+};
+
+/**
+ * Function: songPoolInit
+ * Input argument: pool - a pointer to a song pool
+ * Output argument: pool is empty
+ * Return: none
+ * Dependencies: none
+ */
+void songPoolInit(SongPool *pool)
+{
+    // no slabs yet
+    pool->slabs = NULL;
+    // so nothing to reuse either
+    pool->freeList = NULL;
+    // and nothing handed out
+    pool->live = 0;
+    // no long titles either
+    pool->text = NULL;
+}
+
+/**
+ * Function: songPoolAlloc
+ * Input argument: pool - a pointer to a song pool
+ * Output argument: a slab is added to the pool when the free list is empty
+ * Return: a pointer to an uninitialized song, or NULL if out of memory
+ * Dependencies: stdlib.h
+ */
+Song *songPoolAlloc(SongPool *pool)
+{
+    // check if every song handed out so far is still in use
+    if (pool->freeList == NULL)
+    {
+        // if so, allocate a new slab
+        SongSlab *slab = (SongSlab*)malloc(sizeof(SongSlab));
+        // give up if the allocation failed
+        if (slab == NULL)
+        {
+            return NULL;
+        }
+        // link the slab into the pool so it can be freed in one go
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+        // thread the slab's songs onto the free list back to front, so they
+        // are handed out in address order and consecutive appends stay
+        // adjacent in memory
+        for (size_t i = SONG_SLAB_SIZE; i > 0; i--)
+        {
+            slab->songs[i - 1].next = pool->freeList;
+            pool->freeList = &slab->songs[i - 1];
+        }
+    }
+    // pop the first free song
+    Song *song = pool->freeList;
+    pool->freeList = song->next;
+    // count it as in use
+    pool->live++;
+    // return the song
+    return song;
+}
+
+/**
+ * Function: songPoolFree
+ * Input argument: pool - the pool the song was allocated from
+ *                 song - a pointer to the song to release
+ * Output argument: the song is pushed onto the pool's free list
+ * Return: none
+ * Dependencies: none
+ */
+void songPoolFree(SongPool *pool, Song *song)
+{
+    // push the song onto the free list, reusing its next pointer
+    song->next = pool->freeList;
+    pool->freeList = song;
+    // it is no longer in use
+    pool->live--;
+}
+
+/**
+ * Function: songPoolDestroy
+ * Input argument: pool - a pointer to a song pool
+ * Output argument: every slab and text block is freed at once and the pool
+ *                  is empty again
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void songPoolDestroy(SongPool *pool)
+{
+    // create pointer to the current slab
+    SongSlab *slab = pool->slabs;
+    // loop through every slab
+    while (slab != NULL)
+    {
+        // remember the slab after this one
+        SongSlab *next = slab->next;
+        // free the whole slab, which frees all of its songs
+        free(slab);
+        // move ahead to the next slab
+        slab = next;
+    }
+    // free the text blocks the same way
+    SongText *block = pool->text;
+    while (block != NULL)
+    {
+        SongText *next = block->next;
+        free(block);
+        block = next;
+    }
+    // leave the pool empty and ready for reuse
+    songPoolInit(pool);
+}
+
+/**
+ * Function: songPoolAdopt
+ * Input argument: pool - a pointer to the song pool that takes over
+ *                 other - a pointer to the song pool to empty into it
+ * Output argument: other's slabs, text blocks, free songs and live count
+ *                  move to pool, and other is empty again
+ * Return: none
+ * Dependencies: songPoolInit
+ */
+void songPoolAdopt(SongPool *pool, SongPool *other)
+{
+    // walk to the last slab of the other pool
+    SongSlab *last = other->slabs;
+    while (last != NULL && last->next != NULL)
+    {
+        last = last->next;
+    }
+    // put its slabs in front of ours
+    if (last != NULL)
+    {
+        last->next = pool->slabs;
+        pool->slabs = other->slabs;
+    }
+    // walk to the end of its free list
+    Song *tail = other->freeList;
+    while (tail != NULL && tail->next != NULL)
+    {
+        tail = tail->next;
+    }
+    // and put its free songs in front of ours
+    if (tail != NULL)
+    {
+        tail->next = pool->freeList;
+        pool->freeList = other->freeList;
+    }
+    // walk to its oldest text block
+    SongText *oldest = other->text;
+    while (oldest != NULL && oldest->next != NULL)
+    {
+        oldest = oldest->next;
+    }
+    // and put its text blocks in front of ours
+    if (oldest != NULL)
+    {
+        oldest->next = pool->text;
+        pool->text = other->text;
+    }
+    // its songs are now ours to count
+    pool->live += other->live;
+    // leave the other pool empty
+    songPoolInit(other);
+}
+
+/**
+ * Function: songPoolText
+ * Input argument: pool - a pointer to a song pool
+ *                 text - the bytes to store, not necessarily null terminated
+ *                 length - the number of bytes in text
+ * Output argument: a copy of the bytes is appended to the pool's text blocks
+ * Return: the null terminated copy, which stays put until the pool is
+ *         destroyed, or NULL if out of memory
+ * Dependencies: stdlib.h, string.h
+ */
+const char *songPoolText(SongPool *pool, const char *text, size_t length)
+{
+    // check if the newest block is missing or too full for the copy
+    SongText *block = pool->text;
+    if (block == NULL || block->capacity - block->used < length + 1)
+    {
+        // if so, start a new block, big enough for a very long string
+        size_t capacity = length + 1 > SONG_TEXT_BLOCK ? length + 1 :
+            SONG_TEXT_BLOCK;
+        block = (SongText*)malloc(sizeof(SongText) + capacity);
+        // give up if the allocation failed
+        if (block == NULL)
+        {
+            return NULL;
+        }
+        block->used = 0;
+        block->capacity = capacity;
+        // a string with a block of its own fills it, so it goes behind the
+        // block being filled instead of replacing it
+        if (capacity > SONG_TEXT_BLOCK && pool->text != NULL)
+        {
+            block->next = pool->text->next;
+            pool->text->next = block;
+        }
+        // otherwise, the new block is filled from now on
+        else
+        {
+            block->next = pool->text;
+            pool->text = block;
+        }
+    }
+    // copy the bytes and the terminator to the end of the block
+    char *copy = block->bytes + block->used;
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    block->used += length + 1;
+    // return the copy
+    return copy;
+}
+
+/**
+ * Function: songPoolBytes
+ * Input argument: pool - a pointer to a song pool
+ * Output argument: none
+ * Return: the bytes the pool holds in slabs and text blocks
+ * Dependencies: none
+ */
+size_t songPoolBytes(const SongPool *pool)
+{
+    // count every slab
+    size_t bytes = 0;
+    for (const SongSlab *slab = pool->slabs; slab != NULL; slab = slab->next)
+    {
+        bytes += sizeof(SongSlab);
+    }
+    // and every text block
+    for (const SongText *block = pool->text; block != NULL;
+        block = block->next)
+    {
+        bytes += sizeof(SongText) + block->capacity;
+    }
+    // return the total
+    return bytes;
+}
@@ -0,0 +1,110 @@
+#ifndef MUSIC_POOL_H
+#define MUSIC_POOL_H
+
+// header files
+#include <stdbool.h>
+#include <stddef.h>
+
+// global definitions
+#define SONG_SLAB_SIZE 4096
+// bytes in a block of long titles; longer strings get a block of their own
+#define SONG_TEXT_BLOCK (64 * 1024)
+
+// slabs and text blocks are only ever handled through the pool
+typedef struct SongSlab SongSlab;
+typedef struct SongText SongText;
+
+typedef struct SongPool
+{
+    // every slab allocated so far, newest first
+    SongSlab *slabs;
+    // released songs waiting to be reused, linked through their next pointer
+    struct Song *freeList;
+    // number of songs handed out and not yet released
+    size_t live;
+    // append-only blocks holding titles too long to fit in a song, newest
+    // first; the newest one is filled next
+    SongText *text;
+}
+SongPool;
+
+// function prototypes
+
+/**
+ * Function: songPoolInit
+ * Input argument: pool - a pointer to a song pool
+ * Output argument: pool is empty
+ * Return: none
+ * Dependencies: none
+ */
+void songPoolInit(SongPool *pool);
+
+/**
+ * Function: songPoolAlloc
+ * Input argument: pool - a pointer to a song pool
+ * Output argument: a slab is added to the pool when the free list is empty
+ * Return: a pointer to an uninitialized song, or NULL if out of memory
+ * Dependencies: stdlib.h
+ */
+struct Song *songPoolAlloc(SongPool *pool);
+
+/**
+ * Function: songPoolFree
+ * Input argument: pool - the pool the song was allocated from
+ *                 song - a pointer to the song to release
+ * Output argument: the song is pushed onto the pool's free list
+ * Return: none
+ * Dependencies: none
+ */
+void songPoolFree(SongPool *pool, struct Song *song);
+
+/**
+ * Function: songPoolDestroy
+ * Input argument: pool - a pointer to a song pool
+ * Output argument: every slab and text block is freed at once and the pool
+ *                  is empty again
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void songPoolDestroy(SongPool *pool);
+
+/**
+ * Function: songPoolAdopt
+ * Input argument: pool - a pointer to the song pool that takes over
+ *                 other - a pointer to the song pool to empty into it
+ * Output argument: other's slabs, text blocks, free songs and live count
+ *                  move to pool, and other is empty again
+ * Return: none
+ * Dependencies: songPoolInit
+ *
+ * Songs and titles keep their addresses, so lists built from other stay
+ * valid. This walks other's slab, text and free lists once and touches no
+ * song otherwise.
+ */
+void songPoolAdopt(SongPool *pool, SongPool *other);
+
+/**
+ * Function: songPoolText
+ * Input argument: pool - a pointer to a song pool
+ *                 text - the bytes to store, not necessarily null terminated
+ *                 length - the number of bytes in text
+ * Output argument: a copy of the bytes is appended to the pool's text blocks
+ * Return: the null terminated copy, which stays put until the pool is
+ *         destroyed, or NULL if out of memory
+ * Dependencies: stdlib.h, string.h
+ *
+ * Copies are never freed one by one: a removed song's long title stays in
+ * its block until the whole pool goes.
+ */
+const char *songPoolText(SongPool *pool, const char *text, size_t length);
+
+/**
+ * Function: songPoolBytes
+ * Input argument: pool - a pointer to a song pool
+ * Output argument: none
+ * Return: the bytes the pool holds in slabs and text blocks
+ * Dependencies: none
+ */
+size_t songPoolBytes(const SongPool *pool);
+
+#endif // MUSIC_POOL_H
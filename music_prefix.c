@@ -0,0 +1,1145 @@
+// header files
+#include "music_prefix.h"
+#include <stdlib.h>
+#include <string.h>
+
+// global definitions
+// buckets a prefix index has room for at first
+#define PREFIX_MIN_BUCKETS 16
+// bytes a number takes at most, seven bits to a byte
+#define PREFIX_NUMBER_BYTES 10
+
+// the entries of one bucket, decoded to make a change to them
+typedef struct PrefixScratch
+{
+    // the decoded spellings, back to back and not null terminated
+    char *text;
+    size_t capacity;
+    // each entry's spelling, in text or wherever an added one is, its
+    // length and its count; one spare slot for an added entry before the
+    // bucket is split
+    const char *spellings[PREFIX_BUCKET_MAX + 1];
+    size_t lengths[PREFIX_BUCKET_MAX + 1];
+    size_t counts[PREFIX_BUCKET_MAX + 1];
+    size_t count;
+}
+PrefixScratch;
+
+// a spelling being sorted by prefixBuild, with its first bytes folded into
+// a number so most comparisons never look at the string
+typedef struct PrefixKey
+{
+    uint64_t key;
+    const char *spelling;
+    size_t length;
+    size_t count;
+}
+PrefixKey;
+
+/**
+ * Function: prefixFold (helper)
+ * Input argument: c - a byte of a spelling
+ * Output argument: none
+ * Return: the byte with ASCII letters in lowercase, as an unsigned value
+ * Dependencies: none
+ *
+ * Does what tolower does in the C locale without a table lookup, so other
+ * bytes, such as those of UTF-8 letters, compare as they are.
+ */
+static inline int prefixFold(char c)
+{
+    unsigned char byte = (unsigned char)c;
+    return byte >= 'A' && byte <= 'Z' ? byte + ('a' - 'A') : byte;
+}
+
+/**
+ * Function: prefixCompare (helper)
+ * Input argument: a, aLength - a spelling and its length
+ *                 b, bLength - another spelling and its length
+ * Output argument: none
+ * Return: less than, equal to or greater than zero as a comes before, is,
+ *         or comes after b: by folded bytes, then shorter first, then by
+ *         the bytes themselves
+ * Dependencies: prefixFold, string.h
+ */
+static int prefixCompare(const char *a, size_t aLength, const char *b,
+    size_t bLength)
+{
+    // compare the folded bytes both have
+    size_t shorter = aLength < bLength ? aLength : bLength;
+    for (size_t i = 0; i < shorter; i++)
+    {
+        int difference = prefixFold(a[i]) - prefixFold(b[i]);
+        if (difference != 0)
+        {
+            return difference;
+        }
+    }
+    // a folded prefix comes first
+    if (aLength != bLength)
+    {
+        return aLength < bLength ? -1 : 1;
+    }
+    // spellings that only differ in case are ordered by their bytes
+    return memcmp(a, b, aLength);
+}
+
+/**
+ * Function: prefixBefore (helper)
+ * Input argument: spelling, length - a spelling and its length
+ *                 prefix, prefixLength - a prefix and its length
+ * Output argument: none
+ * Return: true if the spelling comes before every spelling that starts
+ *         with the prefix, ignoring case
+ * Dependencies: prefixFold
+ */
+static bool prefixBefore(const char *spelling, size_t length,
+    const char *prefix, size_t prefixLength)
+{
+    // the first folded byte that differs decides
+    size_t shorter = length < prefixLength ? length : prefixLength;
+    for (size_t i = 0; i < shorter; i++)
+    {
+        int difference = prefixFold(spelling[i]) - prefixFold(prefix[i]);
+        if (difference != 0)
+        {
+            return difference < 0;
+        }
+    }
+    // otherwise, only a spelling shorter than the prefix comes before it
+    return length < prefixLength;
+}
+
+/**
+ * Function: prefixStarts (helper)
+ * Input argument: spelling, length - a spelling and its length
+ *                 prefix, prefixLength - a prefix and its length
+ * Output argument: none
+ * Return: true if the spelling starts with the prefix, ignoring case
+ * Dependencies: prefixFold
+ */
+static bool prefixStarts(const char *spelling, size_t length,
+    const char *prefix, size_t prefixLength)
+{
+    // a shorter spelling cannot
+    if (length < prefixLength)
+    {
+        return false;
+    }
+    // every byte of the prefix must match
+    for (size_t i = 0; i < prefixLength; i++)
+    {
+        if (prefixFold(spelling[i]) != prefixFold(prefix[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Function: prefixPutNumber (helper)
+ * Input argument: out - where to write the number
+ *                 number - the number
+ * Output argument: the number is written seven bits to a byte, low bits
+ *                  first, with the top bit set on every byte but the last
+ * Return: a pointer just past the number
+ * Dependencies: none
+ */
+static uint8_t *prefixPutNumber(uint8_t *out, size_t number)
+{
+    while (number >= 0x80)
+    {
+        *out++ = (uint8_t)(number | 0x80);
+        number >>= 7;
+    }
+    *out++ = (uint8_t)number;
+    return out;
+}
+
+/**
+ * Function: prefixGetNumber (helper)
+ * Input argument: in - a number written by prefixPutNumber
+ *                 number - where to put it
+ * Output argument: number is read
+ * Return: a pointer just past the number
+ * Dependencies: none
+ */
+static const uint8_t *prefixGetNumber(const uint8_t *in, size_t *number)
+{
+    size_t value = 0;
+    int shift = 0;
+    while (*in & 0x80)
+    {
+        value |= (size_t)(*in++ & 0x7F) << shift;
+        shift += 7;
+    }
+    value |= (size_t)*in++ << shift;
+    *number = value;
+    return in;
+}
+
+/**
+ * Function: prefixFirst (helper)
+ * Input argument: bucket - a bucket with at least one entry
+ *                 length - where to put the length of its first spelling
+ * Output argument: length is filled in
+ * Return: the first spelling, which is stored whole
+ * Dependencies: prefixGetNumber
+ */
+static const char *prefixFirst(const PrefixBucket *bucket, size_t *length)
+{
+    // skip the number of shared bytes, which is zero
+    size_t shared;
+    const uint8_t *in = prefixGetNumber(bucket->bytes, &shared);
+    in = prefixGetNumber(in, length);
+    return (const char*)in;
+}
+
+/**
+ * Function: prefixFindBucket (helper)
+ * Input argument: index - a prefix index with at least one bucket
+ *                 spelling, length - a spelling, or a prefix
+ *                 prefix - true to find where spellings starting with it
+ *                          are, false to find where the spelling goes
+ * Output argument: none
+ * Return: the last bucket whose first entry comes before the prefix, or
+ *         does not come after the spelling; 0 if there is none
+ * Dependencies: prefixFirst, prefixBefore, prefixCompare
+ */
+static size_t prefixFindBucket(const PrefixIndex *index,
+    const char *spelling, size_t length, bool prefix)
+{
+    // bucket low qualifies, unless it is the first; high never does
+    size_t low = 0;
+    size_t high = index->count;
+    while (high - low > 1)
+    {
+        size_t middle = low + (high - low) / 2;
+        size_t firstLength;
+        const char *first = prefixFirst(&index->buckets[middle],
+            &firstLength);
+        bool qualifies = prefix ?
+            prefixBefore(first, firstLength, spelling, length) :
+            prefixCompare(first, firstLength, spelling, length) <= 0;
+        if (qualifies)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    // return it
+    return low;
+}
+
+/**
+ * Function: prefixDecode (helper)
+ * Input argument: bucket - the bucket to decode
+ *                 scratch - where to decode it
+ * Output argument: scratch holds the bucket's entries
+ * Return: true on success, false if memory ran out
+ * Dependencies: prefixGetNumber, stdlib.h, string.h
+ */
+static bool prefixDecode(const PrefixBucket *bucket, PrefixScratch *scratch)
+{
+    // add up the lengths first, so the text is only allocated once and
+    // the spellings never move
+    size_t total = 0;
+    const uint8_t *in = bucket->bytes;
+    for (uint32_t i = 0; i < bucket->count; i++)
+    {
+        size_t shared;
+        size_t suffix;
+        size_t count;
+        in = prefixGetNumber(in, &shared);
+        in = prefixGetNumber(in, &suffix);
+        in = prefixGetNumber(in + suffix, &count);
+        total += shared + suffix;
+    }
+    if (total > scratch->capacity)
+    {
+        char *text = realloc(scratch->text, total);
+        if (text == NULL)
+        {
+            return false;
+        }
+        scratch->text = text;
+        scratch->capacity = total;
+    }
+    // then rebuild each spelling from the start of the one before
+    char *out = scratch->text;
+    in = bucket->bytes;
+    for (uint32_t i = 0; i < bucket->count; i++)
+    {
+        size_t shared;
+        size_t suffix;
+        in = prefixGetNumber(in, &shared);
+        in = prefixGetNumber(in, &suffix);
+        if (shared > 0)
+        {
+            memcpy(out, scratch->spellings[i - 1], shared);
+        }
+        memcpy(out + shared, in, suffix);
+        scratch->spellings[i] = out;
+        scratch->lengths[i] = shared + suffix;
+        in = prefixGetNumber(in + suffix, &scratch->counts[i]);
+        out += shared + suffix;
+    }
+    scratch->count = bucket->count;
+    // return success
+    return true;
+}
+
+/**
+ * Function: prefixEncode (helper)
+ * Input argument: bucket - the bucket to fill in
+ *                 scratch - decoded entries
+ *                 first, last - the entries to encode, first up to but not
+ *                               including last, in order
+ * Output argument: bucket holds the entries; it keeps its bytes if they are
+ *                  big enough
+ * Return: true on success, false if memory ran out; bucket is unchanged
+ *         then
+ * Dependencies: prefixPutNumber, stdlib.h, string.h
+ */
+static bool prefixEncode(PrefixBucket *bucket, const PrefixScratch *scratch,
+    size_t first, size_t last)
+{
+    // room for the whole spellings is enough, whatever they share
+    size_t bound = 0;
+    for (size_t i = first; i < last; i++)
+    {
+        bound += 3 * PREFIX_NUMBER_BYTES + scratch->lengths[i];
+    }
+    uint8_t *bytes = bucket->bytes;
+    if (bound > bucket->capacity)
+    {
+        bytes = malloc(bound);
+        if (bytes == NULL)
+        {
+            return false;
+        }
+    }
+    // write each entry against the one before it
+    uint8_t *out = bytes;
+    const char *previous = NULL;
+    size_t previousLength = 0;
+    for (size_t i = first; i < last; i++)
+    {
+        const char *spelling = scratch->spellings[i];
+        size_t length = scratch->lengths[i];
+        size_t shared = 0;
+        while (shared < length && shared < previousLength &&
+            spelling[shared] == previous[shared])
+        {
+            shared++;
+        }
+        out = prefixPutNumber(out, shared);
+        out = prefixPutNumber(out, length - shared);
+        memcpy(out, spelling + shared, length - shared);
+        out += length - shared;
+        out = prefixPutNumber(out, scratch->counts[i]);
+        previous = spelling;
+        previousLength = length;
+    }
+    // swap in new bytes
+    if (bytes != bucket->bytes)
+    {
+        free(bucket->bytes);
+        bucket->bytes = bytes;
+        bucket->capacity = (uint32_t)bound;
+    }
+    bucket->length = (uint32_t)(out - bytes);
+    bucket->count = (uint32_t)(last - first);
+    // return success
+    return true;
+}
+
+/**
+ * Function: prefixReserve (helper)
+ * Input argument: index - a pointer to a prefix index
+ *                 count - the number of buckets the index should hold
+ * Output argument: the bucket array has room for count buckets
+ * Return: true on success, false if memory ran out
+ * Dependencies: stdlib.h
+ */
+static bool prefixReserve(PrefixIndex *index, size_t count)
+{
+    // grow by doubling
+    if (count <= index->capacity)
+    {
+        return true;
+    }
+    size_t capacity = index->capacity == 0 ? PREFIX_MIN_BUCKETS :
+        index->capacity;
+    while (capacity < count)
+    {
+        capacity *= 2;
+    }
+    PrefixBucket *buckets = realloc(index->buckets,
+        capacity * sizeof(PrefixBucket));
+    if (buckets == NULL)
+    {
+        return false;
+    }
+    index->buckets = buckets;
+    index->capacity = capacity;
+    return true;
+}
+
+/**
+ * Function: prefixInsertBucket (helper)
+ * Input argument: index - a pointer to a prefix index
+ *                 at - where the new bucket goes, at most index->count
+ *                 scratch - decoded entries
+ *                 first, last - the entries to put in the bucket, first up
+ *                               to but not including last, in order
+ * Output argument: a bucket with the entries is inserted before bucket at
+ * Return: true on success, false if memory ran out; index is unchanged then
+ * Dependencies: prefixReserve, prefixEncode, string.h
+ */
+static bool prefixInsertBucket(PrefixIndex *index, size_t at,
+    const PrefixScratch *scratch, size_t first, size_t last)
+{
+    // encode the entries before making room, so failing changes nothing
+    PrefixBucket bucket = { NULL, 0, 0, 0 };
+    if (!prefixEncode(&bucket, scratch, first, last))
+    {
+        return false;
+    }
+    if (!prefixReserve(index, index->count + 1))
+    {
+        free(bucket.bytes);
+        return false;
+    }
+    // move the buckets after it up by one
+    memmove(&index->buckets[at + 1], &index->buckets[at],
+        (index->count - at) * sizeof(PrefixBucket));
+    index->buckets[at] = bucket;
+    index->count++;
+    // return success
+    return true;
+}
+
+/**
+ * Function: prefixInit
+ * Input argument: index - a pointer to a prefix index
+ * Output argument: index is empty; nothing is allocated until the first add
+ * Return: none
+ * Dependencies: none
+ */
+void prefixInit(PrefixIndex *index)
+{
+    index->buckets = NULL;
+    index->count = 0;
+    index->capacity = 0;
+    index->entries = 0;
+    index->longest = 0;
+}
+
+/**
+ * Function: prefixFree
+ * Input argument: index - a pointer to a prefix index
+ * Output argument: every bucket is freed and the index is empty again
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void prefixFree(PrefixIndex *index)
+{
+    for (size_t b = 0; b < index->count; b++)
+    {
+        free(index->buckets[b].bytes);
+    }
+    free(index->buckets);
+    prefixInit(index);
+}
+
+/**
+ * Function: prefixCompareKeys (helper)
+ * Input argument: a, b - pointers to two PrefixKey values
+ * Output argument: none
+ * Return: their order, as a qsort comparator
+ * Dependencies: prefixCompare
+ */
+static int prefixCompareKeys(const void *a, const void *b)
+{
+    const PrefixKey *left = (const PrefixKey*)a;
+    const PrefixKey *right = (const PrefixKey*)b;
+    // the folded first bytes settle most pairs
+    if (left->key != right->key)
+    {
+        return left->key < right->key ? -1 : 1;
+    }
+    return prefixCompare(left->spelling, left->length, right->spelling,
+        right->length);
+}
+
+/**
+ * Function: prefixSortKeys (helper)
+ * Input argument: keys - the keys to sort
+ *                 count - the number of keys
+ * Output argument: keys are in prefixCompareKeys order
+ * Return: true on success, false if memory ran out; keys are unchanged then
+ * Dependencies: prefixCompareKeys, stdlib.h, string.h
+ *
+ * A least significant byte first radix sort on the folded first bytes, one
+ * pass per byte that is not the same in every key, so no comparator is
+ * called for keys that differ there. Only runs of equal keys are then
+ * sorted by comparing the spellings.
+ */
+static bool prefixSortKeys(PrefixKey *keys, size_t count)
+{
+    PrefixKey *other = malloc(count * sizeof(PrefixKey));
+    if (other == NULL)
+    {
+        return false;
+    }
+    // count every byte of every key in one pass
+    size_t (*histogram)[256] = calloc(8, sizeof(*histogram));
+    if (histogram == NULL)
+    {
+        free(other);
+        return false;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        for (int digit = 0; digit < 8; digit++)
+        {
+            histogram[digit][(keys[i].key >> (digit * 8)) & 0xff]++;
+        }
+    }
+    // scatter by each byte in turn, from the last one, back and forth
+    // between the two arrays
+    PrefixKey *from = keys;
+    PrefixKey *to = other;
+    for (int digit = 0; digit < 8; digit++)
+    {
+        // a byte every key shares leaves the order as it is
+        size_t first = (keys[0].key >> (digit * 8)) & 0xff;
+        if (histogram[digit][first] == count)
+        {
+            continue;
+        }
+        size_t offsets[256];
+        size_t total = 0;
+        for (int byte = 0; byte < 256; byte++)
+        {
+            offsets[byte] = total;
+            total += histogram[digit][byte];
+        }
+        for (size_t i = 0; i < count; i++)
+        {
+            to[offsets[(from[i].key >> (digit * 8)) & 0xff]++] = from[i];
+        }
+        PrefixKey *swap = from;
+        from = to;
+        to = swap;
+    }
+    if (from != keys)
+    {
+        memcpy(keys, from, count * sizeof(PrefixKey));
+    }
+    free(histogram);
+    free(other);
+    // keys that tie on their first bytes are ordered by their spellings
+    size_t start = 0;
+    for (size_t i = 1; i <= count; i++)
+    {
+        if (i == count || keys[i].key != keys[start].key)
+        {
+            if (i - start > 1)
+            {
+                qsort(keys + start, i - start, sizeof(PrefixKey),
+                    prefixCompareKeys);
+            }
+            start = i;
+        }
+    }
+    return true;
+}
+
+/**
+ * Function: prefixBuild
+ * Input argument: index - a pointer to an empty prefix index
+ *                 spellings - the strings to add, in any order and with
+ *                             repeats
+ *                 counts - how many times to count each string, or NULL
+ *                          for once
+ *                 count - the number of strings
+ * Output argument: index holds every string, with the counts of its
+ *                  repeats added up
+ * Return: true on success, false if memory ran out; index is empty then
+ * Dependencies: prefixSortKeys, prefixCompare, prefixInsertBucket,
+ *               prefixFree, stdlib.h, string.h
+ *
+ * O(N) for the radix sort, plus O(k log k) for each run of k spellings
+ * whose first eight folded bytes are the same; the buckets are then
+ * filled half full in one pass, leaving room for adds before they split.
+ */
+bool prefixBuild(PrefixIndex *index, const char **spellings,
+    const size_t *counts, size_t count)
+{
+    // nothing to build from nothing
+    if (count == 0)
+    {
+        return true;
+    }
+    // fold the first eight bytes of each spelling into a sort key; the
+    // zero bytes past a short one order it first, as prefixCompare does
+    PrefixKey *keys = malloc(count * sizeof(PrefixKey));
+    if (keys == NULL)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        keys[i].spelling = spellings[i];
+        keys[i].length = strlen(spellings[i]);
+        keys[i].count = counts != NULL ? counts[i] : 1;
+        uint64_t key = 0;
+        for (size_t j = 0; j < 8; j++)
+        {
+            key = key << 8 | (j < keys[i].length ?
+                (uint64_t)prefixFold(spellings[i][j]) : 0);
+        }
+        keys[i].key = key;
+        if (keys[i].length > index->longest)
+        {
+            index->longest = keys[i].length;
+        }
+    }
+    if (!prefixSortKeys(keys, count))
+    {
+        free(keys);
+        return false;
+    }
+    // merge repeats and cut the run into half-full buckets; the scratch
+    // entries point straight into the spellings
+    PrefixScratch scratch;
+    scratch.count = 0;
+    bool built = true;
+    for (size_t i = 0; i < count && built; i++)
+    {
+        // a repeat counts towards the entry before it
+        if (scratch.count > 0 && keys[i].key == keys[i - 1].key &&
+            prefixCompare(keys[i].spelling, keys[i].length,
+                keys[i - 1].spelling, keys[i - 1].length) == 0)
+        {
+            scratch.counts[scratch.count - 1] += keys[i].count;
+            continue;
+        }
+        // otherwise, a full bucket is written out first
+        if (scratch.count == PREFIX_BUCKET_MAX / 2)
+        {
+            built = prefixInsertBucket(index, index->count, &scratch, 0,
+                scratch.count);
+            scratch.count = 0;
+        }
+        // and the spelling starts an entry
+        scratch.spellings[scratch.count] = keys[i].spelling;
+        scratch.lengths[scratch.count] = keys[i].length;
+        scratch.counts[scratch.count] = keys[i].count;
+        scratch.count++;
+        index->entries++;
+    }
+    // write out the last bucket
+    if (built && scratch.count > 0)
+    {
+        built = prefixInsertBucket(index, index->count, &scratch, 0,
+            scratch.count);
+    }
+    free(keys);
+    // leave nothing half built behind
+    if (!built)
+    {
+        prefixFree(index);
+    }
+    return built;
+}
+
+/**
+ * Function: prefixAdd
+ * Input argument: index - a pointer to a prefix index
+ *                 spelling - the string to add
+ *                 length - the number of bytes in it
+ * Output argument: the string's count goes up by one, from zero if it was
+ *                  not in the index
+ * Return: true on success, false if memory ran out; index is unchanged then
+ * Dependencies: prefixFindBucket, prefixDecode, prefixCompare,
+ *               prefixEncode, prefixInsertBucket, stdlib.h, string.h
+ */
+bool prefixAdd(PrefixIndex *index, const char *spelling, size_t length)
+{
+    // decode the bucket the spelling goes in, if there is one
+    PrefixScratch scratch;
+    scratch.text = NULL;
+    scratch.capacity = 0;
+    scratch.count = 0;
+    size_t b = 0;
+    if (index->count > 0)
+    {
+        b = prefixFindBucket(index, spelling, length, false);
+        if (!prefixDecode(&index->buckets[b], &scratch))
+        {
+            return false;
+        }
+    }
+    // find the first entry that does not come before the spelling
+    size_t at = 0;
+    int order = 1;
+    while (at < scratch.count && (order = prefixCompare(scratch.spellings[at],
+        scratch.lengths[at], spelling, length)) < 0)
+    {
+        at++;
+    }
+    bool added = true;
+    // a spelling already there only counts once more
+    if (at < scratch.count && order == 0)
+    {
+        scratch.counts[at]++;
+        added = prefixEncode(&index->buckets[b], &scratch, 0, scratch.count);
+    }
+    // otherwise, it is a new entry
+    else
+    {
+        memmove(&scratch.spellings[at + 1], &scratch.spellings[at],
+            (scratch.count - at) * sizeof(const char*));
+        memmove(&scratch.lengths[at + 1], &scratch.lengths[at],
+            (scratch.count - at) * sizeof(size_t));
+        memmove(&scratch.counts[at + 1], &scratch.counts[at],
+            (scratch.count - at) * sizeof(size_t));
+        scratch.spellings[at] = spelling;
+        scratch.lengths[at] = length;
+        scratch.counts[at] = 1;
+        scratch.count++;
+        // the first entry of the index needs a bucket
+        if (index->count == 0)
+        {
+            added = prefixInsertBucket(index, 0, &scratch, 0, 1);
+        }
+        // a full bucket is split in two, the second half in a new bucket
+        else if (scratch.count > PREFIX_BUCKET_MAX)
+        {
+            // encode the first half aside, so a failure changes nothing
+            size_t half = scratch.count / 2;
+            PrefixBucket front = { NULL, 0, 0, 0 };
+            added = prefixEncode(&front, &scratch, 0, half) &&
+                prefixInsertBucket(index, b + 1, &scratch, half,
+                    scratch.count);
+            if (added)
+            {
+                free(index->buckets[b].bytes);
+                index->buckets[b] = front;
+            }
+            else
+            {
+                free(front.bytes);
+            }
+        }
+        else
+        {
+            added = prefixEncode(&index->buckets[b], &scratch, 0,
+                scratch.count);
+        }
+        if (added)
+        {
+            index->entries++;
+            if (length > index->longest)
+            {
+                index->longest = length;
+            }
+        }
+    }
+    // free the decoded text
+    free(scratch.text);
+    return added;
+}
+
+/**
+ * Function: prefixRemove
+ * Input argument: index - a pointer to a prefix index
+ *                 spelling - a string that was added
+ *                 length - the number of bytes in it
+ * Output argument: the string's count goes down by one, and it leaves the
+ *                  index at zero
+ * Return: true on success, false if the string was not in the index or
+ *         memory ran out; index is unchanged then
+ * Dependencies: prefixFindBucket, prefixDecode, prefixCompare,
+ *               prefixEncode, stdlib.h, string.h
+ */
+bool prefixRemove(PrefixIndex *index, const char *spelling, size_t length)
+{
+    // an empty index has nothing to remove
+    if (index->count == 0)
+    {
+        return false;
+    }
+    // decode the bucket the spelling would be in
+    PrefixScratch scratch;
+    scratch.text = NULL;
+    scratch.capacity = 0;
+    size_t b = prefixFindBucket(index, spelling, length, false);
+    if (!prefixDecode(&index->buckets[b], &scratch))
+    {
+        return false;
+    }
+    // find the spelling
+    size_t at = 0;
+    while (at < scratch.count && prefixCompare(scratch.spellings[at],
+        scratch.lengths[at], spelling, length) != 0)
+    {
+        at++;
+    }
+    bool removed = at < scratch.count;
+    // count it down, and drop it at zero
+    if (removed && --scratch.counts[at] == 0)
+    {
+        memmove(&scratch.spellings[at], &scratch.spellings[at + 1],
+            (scratch.count - at - 1) * sizeof(const char*));
+        memmove(&scratch.lengths[at], &scratch.lengths[at + 1],
+            (scratch.count - at - 1) * sizeof(size_t));
+        memmove(&scratch.counts[at], &scratch.counts[at + 1],
+            (scratch.count - at - 1) * sizeof(size_t));
+        scratch.count--;
+        index->entries--;
+    }
+    // an emptied bucket leaves the array
+    if (removed && scratch.count == 0)
+    {
+        free(index->buckets[b].bytes);
+        memmove(&index->buckets[b], &index->buckets[b + 1],
+            (index->count - b - 1) * sizeof(PrefixBucket));
+        index->count--;
+    }
+    // otherwise, write the bucket back; dropping an entry never makes the
+    // bytes longer, so this reuses them and cannot fail
+    else if (removed)
+    {
+        prefixEncode(&index->buckets[b], &scratch, 0, scratch.count);
+    }
+    // free the decoded text
+    free(scratch.text);
+    return removed;
+}
+
+/**
+ * Function: prefixResultsInit
+ * Input argument: results - a pointer to a result set
+ * Output argument: results is empty
+ * Return: none
+ * Dependencies: none
+ */
+void prefixResultsInit(PrefixResults *results)
+{
+    results->text = NULL;
+    results->textLength = 0;
+    results->textCapacity = 0;
+    results->count = 0;
+}
+
+/**
+ * Function: prefixResultsFree
+ * Input argument: results - a pointer to a result set
+ * Output argument: the text is freed and results is empty again
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void prefixResultsFree(PrefixResults *results)
+{
+    free(results->text);
+    prefixResultsInit(results);
+}
+
+/**
+ * Function: prefixResult
+ * Input argument: results - a pointer to a result set
+ *                 i - a result number, below results->count
+ * Output argument: none
+ * Return: the result's spelling
+ * Dependencies: none
+ */
+const char *prefixResult(const PrefixResults *results, size_t i)
+{
+    return results->text + results->offsets[i];
+}
+
+/**
+ * Function: prefixResultAdd (helper)
+ * Input argument: results - a pointer to a result set with room for one
+ *                           more
+ *                 spelling, length - the spelling to add and its length
+ *                 count - the number of times it was added to the index
+ * Output argument: the spelling is copied to the end of the results
+ * Return: true on success, false if memory ran out
+ * Dependencies: stdlib.h, string.h
+ */
+static bool prefixResultAdd(PrefixResults *results, const char *spelling,
+    size_t length, size_t count)
+{
+    // make room for the spelling and its zero byte
+    if (results->textLength + length + 1 > results->textCapacity)
+    {
+        size_t capacity = results->textCapacity * 2 + length + 64;
+        char *text = realloc(results->text, capacity);
+        if (text == NULL)
+        {
+            return false;
+        }
+        results->text = text;
+        results->textCapacity = capacity;
+    }
+    // copy it
+    memcpy(results->text + results->textLength, spelling, length);
+    results->text[results->textLength + length] = '\0';
+    results->offsets[results->count] = results->textLength;
+    results->counts[results->count] = count;
+    results->textLength += length + 1;
+    results->count++;
+    return true;
+}
+
+/**
+ * Function: prefixCompleteLength (helper)
+ * Input argument: index - a pointer to a prefix index
+ *                 prefix, prefixLength - the start of the strings wanted
+ *                 results - where to put them, or NULL to only count
+ *                 max - the most strings wanted
+ * Output argument: results holds the first strings in order that start with
+ *                  the prefix, ignoring ASCII case
+ * Return: the number of strings found, 0 also if memory ran out
+ * Dependencies: prefixFindBucket, prefixGetNumber, prefixBefore,
+ *               prefixStarts, prefixResultAdd, stdlib.h, string.h
+ */
+static size_t prefixCompleteLength(const PrefixIndex *index,
+    const char *prefix, size_t prefixLength, PrefixResults *results,
+    size_t max)
+{
+    // forget earlier results
+    if (results != NULL)
+    {
+        results->textLength = 0;
+        results->count = 0;
+    }
+    if (index->count == 0 || max == 0)
+    {
+        return 0;
+    }
+    // a buffer for the spelling being decoded
+    char *spelling = malloc(index->longest + 1);
+    if (spelling == NULL)
+    {
+        return 0;
+    }
+    // walk forward from the bucket the run starts in
+    size_t found = 0;
+    bool done = false;
+    for (size_t b = prefixFindBucket(index, prefix, prefixLength, true);
+        b < index->count && !done; b++)
+    {
+        const uint8_t *in = index->buckets[b].bytes;
+        for (uint32_t i = 0; i < index->buckets[b].count && !done; i++)
+        {
+            // rebuild the spelling over the one before it
+            size_t shared;
+            size_t suffix;
+            size_t count;
+            in = prefixGetNumber(in, &shared);
+            in = prefixGetNumber(in, &suffix);
+            memcpy(spelling + shared, in, suffix);
+            in = prefixGetNumber(in + suffix, &count);
+            size_t length = shared + suffix;
+            // skip the spellings before the run, and stop after it
+            if (prefixBefore(spelling, length, prefix, prefixLength))
+            {
+                continue;
+            }
+            if (!prefixStarts(spelling, length, prefix, prefixLength))
+            {
+                done = true;
+            }
+            else if (results != NULL &&
+                !prefixResultAdd(results, spelling, length, count))
+            {
+                found = 0;
+                results->count = 0;
+                done = true;
+            }
+            else
+            {
+                found++;
+                done = found == max;
+            }
+        }
+    }
+    // free the buffer
+    free(spelling);
+    return found;
+}
+
+/**
+ * Function: prefixComplete
+ * Input argument: index - a pointer to a prefix index
+ *                 prefix - the start of the strings wanted, in any case
+ *                 results - where to put them
+ *                 max - the most strings wanted, at most PREFIX_MAX_RESULTS
+ * Output argument: results holds the first strings in order that start with
+ *                  prefix, ignoring ASCII case
+ * Return: the number of results, 0 also if memory ran out
+ * Dependencies: prefixCompleteLength, string.h
+ *
+ * O(log N + prefix + max): one binary search over the buckets, then a
+ * forward walk that stops at the first string past the prefix.
+ */
+size_t prefixComplete(const PrefixIndex *index, const char *prefix,
+    PrefixResults *results, size_t max)
+{
+    // never more than the results hold
+    if (max > PREFIX_MAX_RESULTS)
+    {
+        max = PREFIX_MAX_RESULTS;
+    }
+    return prefixCompleteLength(index, prefix, strlen(prefix), results, max);
+}
+
+/**
+ * Function: prefixDistance (helper)
+ * Input argument: query, queryLength - the string typed and its length
+ *                 spelling, length - a spelling and its length
+ *                 row - room for queryLength + 1 numbers
+ * Output argument: none
+ * Return: the fewest single-byte insertions, deletions and changes, ignoring
+ *         case, that turn query into some start of the spelling
+ * Dependencies: prefixFold
+ *
+ * The usual edit distance table, one row per byte of the spelling; every
+ * row's last number is the distance to that start, and the least is kept.
+ * The spelling is cut off where no start could be closer.
+ */
+static size_t prefixDistance(const char *query, size_t queryLength,
+    const char *spelling, size_t length, size_t *row)
+{
+    // turning query into the empty start deletes every byte
+    for (size_t i = 0; i <= queryLength; i++)
+    {
+        row[i] = i;
+    }
+    size_t best = queryLength;
+    // past twice the query's length, a start is further than deleting all
+    if (length > 2 * queryLength)
+    {
+        length = 2 * queryLength;
+    }
+    for (size_t j = 1; j <= length; j++)
+    {
+        // row[i] is the distance from query[0, i) to spelling[0, j)
+        size_t diagonal = row[0];
+        row[0] = j;
+        for (size_t i = 1; i <= queryLength; i++)
+        {
+            size_t above = row[i];
+            size_t change = diagonal + (prefixFold(query[i - 1]) !=
+                prefixFold(spelling[j - 1]));
+            size_t edit = (above < row[i - 1] ? above : row[i - 1]) + 1;
+            row[i] = change < edit ? change : edit;
+            diagonal = above;
+        }
+        if (row[queryLength] < best)
+        {
+            best = row[queryLength];
+        }
+    }
+    // return the closest start's distance
+    return best;
+}
+
+/**
+ * Function: prefixSuggest
+ * Input argument: index - a pointer to a prefix index
+ *                 query - a string that may be misspelled
+ *                 results - where to put the suggestions
+ *                 max - the most suggestions wanted, at most
+ *                       PREFIX_MAX_RESULTS
+ * Output argument: results holds the strings whose start is closest to
+ *                  query, fewest edits away first, from the completions of
+ *                  the longest start of query that any string has
+ * Return: the number of suggestions, 0 also if memory ran out
+ * Dependencies: prefixCompleteLength, prefixDistance, prefixResultAdd,
+ *               stdlib.h, string.h
+ *
+ * O(log prefix * log N) to find the start, then one edit distance per
+ * completion ranked.
+ */
+size_t prefixSuggest(const PrefixIndex *index, const char *query,
+    PrefixResults *results, size_t max)
+{
+    // forget earlier results
+    results->textLength = 0;
+    results->count = 0;
+    size_t queryLength = strlen(query);
+    if (max > PREFIX_MAX_RESULTS)
+    {
+        max = PREFIX_MAX_RESULTS;
+    }
+    if (queryLength == 0 || max == 0)
+    {
+        return 0;
+    }
+    // every start shorter than one with completions has them too, so the
+    // longest one is found by bisection
+    size_t low = 0;
+    size_t high = queryLength + 1;
+    while (high - low > 1)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (prefixCompleteLength(index, query, middle, NULL, 1) > 0)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    // a first letter no string has leaves nothing to suggest
+    if (low == 0)
+    {
+        return 0;
+    }
+    // gather the candidates and a row for the distances
+    PrefixResults candidates;
+    prefixResultsInit(&candidates);
+    size_t *row = malloc((queryLength + 1) * sizeof(size_t));
+    size_t count = row == NULL ? 0 : prefixCompleteLength(index, query, low,
+        &candidates, PREFIX_MAX_RESULTS);
+    // rank them by distance, keeping their order within a distance
+    size_t distances[PREFIX_MAX_RESULTS];
+    size_t limit = queryLength / PREFIX_SUGGEST_RATIO + 1;
+    for (size_t i = 0; i < count; i++)
+    {
+        const char *spelling = prefixResult(&candidates, i);
+        distances[i] = prefixDistance(query, queryLength, spelling,
+            strlen(spelling), row);
+    }
+    bool failed = false;
+    for (size_t distance = 0; distance <= limit && !failed &&
+        results->count < max; distance++)
+    {
+        for (size_t i = 0; i < count && !failed && results->count < max; i++)
+        {
+            const char *spelling = prefixResult(&candidates, i);
+            failed = distances[i] == distance && !prefixResultAdd(results,
+                spelling, strlen(spelling), candidates.counts[i]);
+        }
+    }
+    if (failed)
+    {
+        results->count = 0;
+    }
+    // free the scratch space
+    free(row);
+    prefixResultsFree(&candidates);
+    return results->count;
+}
@@ -0,0 +1,201 @@
+#ifndef MUSIC_PREFIX_H
+#define MUSIC_PREFIX_H
+
+// header files
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// global definitions
+// a bucket holding this many entries is split in two
+#define PREFIX_BUCKET_MAX 64
+// the most results one completion or suggestion returns, and the most
+// completions a suggestion ranks
+#define PREFIX_MAX_RESULTS 32
+// a suggestion is at most one edit per this many letters of the query away,
+// plus one
+#define PREFIX_SUGGEST_RATIO 3
+
+// a run of entries in order, each stored as the number of bytes it shares
+// with the entry before, the bytes after those, and its count
+//
+// The first entry of a bucket shares nothing, so buckets can be binary
+// searched by it without decoding the rest.
+typedef struct PrefixBucket
+{
+    // the encoded entries
+    uint8_t *bytes;
+    uint32_t length;
+    uint32_t capacity;
+    // number of entries
+    uint32_t count;
+}
+PrefixBucket;
+
+// a sorted set of spellings, each with the number of times it was added
+//
+// Entries are ordered by their spelling folded to lowercase, then by the
+// spelling itself, so every spelling that starts with a prefix in any case
+// is in one run. Adds and removes re-encode a single bucket of at most
+// PREFIX_BUCKET_MAX entries.
+typedef struct PrefixIndex
+{
+    // the buckets, in order
+    PrefixBucket *buckets;
+    size_t count;
+    size_t capacity;
+    // number of distinct spellings
+    size_t entries;
+    // bytes in the longest spelling ever added, for decoding buffers
+    size_t longest;
+}
+PrefixIndex;
+
+// the spellings a completion or suggestion found, best first
+typedef struct PrefixResults
+{
+    // the spellings, each followed by a zero byte
+    char *text;
+    size_t textLength;
+    size_t textCapacity;
+    // where each one starts in text, and how many times it was added
+    size_t offsets[PREFIX_MAX_RESULTS];
+    size_t counts[PREFIX_MAX_RESULTS];
+    size_t count;
+}
+PrefixResults;
+
+// function prototypes
+
+/**
+ * Function: prefixInit
+ * Input argument: index - a pointer to a prefix index
+ * Output argument: index is empty; nothing is allocated until the first add
+ * Return: none
+ * Dependencies: none
+ */
+void prefixInit(PrefixIndex *index);
+
+/**
+ * Function: prefixFree
+ * Input argument: index - a pointer to a prefix index
+ * Output argument: every bucket is freed and the index is empty again
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void prefixFree(PrefixIndex *index);
+
+/**
+ * Function: prefixBuild
+ * Input argument: index - a pointer to an empty prefix index
+ *                 spellings - the strings to add, in any order and with
+ *                             repeats
+ *                 counts - how many times to count each string, or NULL
+ *                          for once
+ *                 count - the number of strings
+ * Output argument: index holds every string, with the counts of its
+ *                  repeats added up
+ * Return: true on success, false if memory ran out; index is empty then
+ * Dependencies: prefixSortKeys, prefixCompare, prefixInsertBucket,
+ *               prefixFree, stdlib.h, string.h
+ *
+ * O(N) for the radix sort, plus O(k log k) for each run of k spellings
+ * whose first eight folded bytes are the same; the buckets are then
+ * filled half full in one pass, leaving room for adds before they split.
+ */
+bool prefixBuild(PrefixIndex *index, const char **spellings,
+    const size_t *counts, size_t count);
+
+/**
+ * Function: prefixAdd
+ * Input argument: index - a pointer to a prefix index
+ *                 spelling - the string to add
+ *                 length - the number of bytes in it
+ * Output argument: the string's count goes up by one, from zero if it was
+ *                  not in the index
+ * Return: true on success, false if memory ran out; index is unchanged then
+ * Dependencies: prefixFindBucket, prefixDecode, prefixCompare,
+ *               prefixEncode, prefixInsertBucket, stdlib.h, string.h
+ */
+bool prefixAdd(PrefixIndex *index, const char *spelling, size_t length);
+
+/**
+ * Function: prefixRemove
+ * Input argument: index - a pointer to a prefix index
+ *                 spelling - a string that was added
+ *                 length - the number of bytes in it
+ * Output argument: the string's count goes down by one, and it leaves the
+ *                  index at zero
+ * Return: true on success, false if the string was not in the index or
+ *         memory ran out; index is unchanged then
+ * Dependencies: prefixFindBucket, prefixDecode, prefixCompare,
+ *               prefixEncode, stdlib.h, string.h
+ */
+bool prefixRemove(PrefixIndex *index, const char *spelling, size_t length);
+
+/**
+ * Function: prefixComplete
+ * Input argument: index - a pointer to a prefix index
+ *                 prefix - the start of the strings wanted, in any case
+ *                 results - where to put them
+ *                 max - the most strings wanted, at most PREFIX_MAX_RESULTS
+ * Output argument: results holds the first strings in order that start with
+ *                  prefix, ignoring ASCII case
+ * Return: the number of results, 0 also if memory ran out
+ * Dependencies: prefixCompleteLength, string.h
+ *
+ * O(log N + prefix + max): one binary search over the buckets, then a
+ * forward walk that stops at the first string past the prefix.
+ */
+size_t prefixComplete(const PrefixIndex *index, const char *prefix,
+    PrefixResults *results, size_t max);
+
+/**
+ * Function: prefixSuggest
+ * Input argument: index - a pointer to a prefix index
+ *                 query - a string that may be misspelled
+ *                 results - where to put the suggestions
+ *                 max - the most suggestions wanted, at most
+ *                       PREFIX_MAX_RESULTS
+ * Output argument: results holds the strings whose start is closest to
+ *                  query, fewest edits away first, from the completions of
+ *                  the longest start of query that any string has
+ * Return: the number of suggestions, 0 also if memory ran out
+ * Dependencies: prefixCompleteLength, prefixDistance, prefixResultAdd,
+ *               stdlib.h, string.h
+ *
+ * O(log prefix * log N) to find the start, then one edit distance per
+ * completion ranked.
+ */
+size_t prefixSuggest(const PrefixIndex *index, const char *query,
+    PrefixResults *results, size_t max);
+
+/**
+ * Function: prefixResultsInit
+ * Input argument: results - a pointer to a result set
+ * Output argument: results is empty
+ * Return: none
+ * Dependencies: none
+ */
+void prefixResultsInit(PrefixResults *results);
+
+/**
+ * Function: prefixResultsFree
+ * Input argument: results - a pointer to a result set
+ * Output argument: the text is freed and results is empty again
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void prefixResultsFree(PrefixResults *results);
+
+/**
+ * Function: prefixResult
+ * Input argument: results - a pointer to a result set
+ *                 i - a result number, below results->count
+ * Output argument: none
+ * Return: the result's spelling
+ * Dependencies: none
+ */
+const char *prefixResult(const PrefixResults *results, size_t i);
+
+#endif // MUSIC_PREFIX_H
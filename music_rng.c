@@ -0,0 +1,188 @@
+// header files
+#include "music_rng.h"
+
+/**
+ * Function: rngRotate (helper)
+ * Input argument: x - the value to rotate
+ *                 k - the number of bits to rotate left by, 1 to 63
+ * Output argument: none
+ * Return: x rotated left by k bits
+ * Dependencies: none
+ */
+static inline uint64_t rngRotate(uint64_t x, int k)
+{
+    // compilers turn this into a single rotate instruction
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * Function: rngSeed
+ * Input argument: rng - a pointer to a generator
+ *                 seed - any 64-bit value; equal seeds give equal sequences
+ * Output argument: rng is ready to produce numbers
+ * Return: none
+ * Dependencies: none
+ */
+void rngSeed(Rng *rng, uint64_t seed)
+{
+    // expand the seed with splitmix64, which never yields an all-zero state
+    for (int i = 0; i < 4; i++)
+    {
+        // advance the splitmix counter
+        seed += 0x9E3779B97F4A7C15ULL;
+        // scramble it into one word of state
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        rng->state[i] = z ^ (z >> 31);
+    }
+}
+
+/**
+ * Function: rngNext
+ * Input argument: rng - a pointer to a seeded generator
+ * Output argument: rng advances by one step
+ * Return: 64 uniformly distributed random bits
+ * Dependencies: rngRotate
+ */
+uint64_t rngNext(Rng *rng)
+{
+    // create a shorthand for the state
+    uint64_t *s = rng->state;
+    // the output scrambles the second word
+    uint64_t result = rngRotate(s[1] * 5, 7) * 9;
+    // advance the state
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rngRotate(s[3], 45);
+    // return the output
+    return result;
+}
+
+/**
+ * Function: rngBelow
+ * Input argument: rng - a pointer to a seeded generator
+ *                 bound - the exclusive upper limit, greater than zero
+ * Output argument: rng advances by one or more steps
+ * Return: a uniformly distributed number in [0, bound), without modulo bias
+ * Dependencies: rngNext
+ *
+ * Lemire's method: the high half of a 64x64-bit product maps the random word
+ * onto [0, bound), and the rare low halves that would bias the result are
+ * rejected. Most calls need no division at all.
+ */
+uint64_t rngBelow(Rng *rng, uint64_t bound)
+{
+    // scale a random word onto the range
+    unsigned __int128 product = (unsigned __int128)rngNext(rng) * bound;
+    // the low half tells whether this word lands in the biased zone
+    uint64_t low = (uint64_t)product;
+    // only words below bound can be biased, so check further only then
+    if (low < bound)
+    {
+        // the number of words that have to be rejected, 2^64 mod bound
+        uint64_t threshold = -bound % bound;
+        // draw again until the word is outside the biased zone
+        while (low < threshold)
+        {
+            product = (unsigned __int128)rngNext(rng) * bound;
+            low = (uint64_t)product;
+        }
+    }
+    // the high half is the result
+    return (uint64_t)(product >> 64);
+}
+
+/**
+ * Function: permutationInit
+ * Input argument: permutation - a pointer to a permutation
+ *                 size - the number of indices to permute
+ *                 seed - the key; equal seeds give equal permutations
+ * Output argument: permutation is ready for permutationAt
+ * Return: none
+ * Dependencies: rngSeed, rngNext
+ */
+void permutationInit(Permutation *permutation, uint64_t size, uint64_t seed)
+{
+    // remember the domain
+    permutation->size = size;
+    // find the bits needed for the largest index, at least two
+    int bits = 2;
+    while (bits < 64 && (size - 1) >> bits != 0)
+    {
+        bits++;
+    }
+    // split them into two equal halves, so the block is under 4 * size
+    permutation->halfBits = (bits + 1) / 2;
+    permutation->halfMask = (1ULL << permutation->halfBits) - 1;
+    // derive the round keys from the seed
+    Rng rng;
+    rngSeed(&rng, seed);
+    for (int i = 0; i < PERMUTATION_ROUNDS; i++)
+    {
+        permutation->keys[i] = rngNext(&rng);
+    }
+}
+
+/**
+ * Function: permutationRound (helper)
+ * Input argument: half - the right half of the block
+ *                 key - the round key
+ * Output argument: none
+ * Return: 64 well mixed bits of half and key
+ * Dependencies: none
+ */
+static inline uint64_t permutationRound(uint64_t half, uint64_t key)
+{
+    // the splitmix64 finalizer mixes every input bit into every output bit
+    uint64_t z = half ^ key;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Function: permutationAt
+ * Input argument: permutation - a pointer to an initialized permutation
+ *                 index - a position in [0, size)
+ * Output argument: none
+ * Return: the index placed at that position, also in [0, size); every
+ *         position maps to a different index
+ * Dependencies: permutationRound
+ *
+ * A balanced Feistel network is a bijection on blocks of 2 * halfBits bits
+ * whatever its round function. Blocks outside [0, size) are encrypted again
+ * (cycle walking) until they land inside, which keeps the bijection on
+ * [0, size). The block is less than four times size, so this takes under
+ * four walks on average.
+ */
+uint64_t permutationAt(const Permutation *permutation, uint64_t index)
+{
+    // create variable for the block being encrypted
+    uint64_t block = index;
+    // walk until the block is back in range
+    do
+    {
+        // split the block into halves
+        uint64_t left = block >> permutation->halfBits;
+        uint64_t right = block & permutation->halfMask;
+        // run the Feistel rounds
+        for (int i = 0; i < PERMUTATION_ROUNDS; i++)
+        {
+            uint64_t mixed = left ^
+                (permutationRound(right, permutation->keys[i]) &
+                permutation->halfMask);
+            left = right;
+            right = mixed;
+        }
+        // join the halves again
+        block = (left << permutation->halfBits) | right;
+    }
+    while (block >= permutation->size);
+    // return the permuted index
+    return block;
+}
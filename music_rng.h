@@ -0,0 +1,84 @@
+#ifndef MUSIC_RNG_H
+#define MUSIC_RNG_H
+
+// header files
+#include <stdint.h>
+
+// xoshiro256** generator state
+typedef struct Rng
+{
+    uint64_t state[4];
+}
+Rng;
+
+// global definitions
+#define PERMUTATION_ROUNDS 4
+
+// keyed bijection over [0, size), evaluated one index at a time
+typedef struct Permutation
+{
+    // the number of indices being permuted
+    uint64_t size;
+    // bits in each half of the Feistel block
+    int halfBits;
+    // mask selecting one half
+    uint64_t halfMask;
+    // one key per Feistel round, derived from the seed
+    uint64_t keys[PERMUTATION_ROUNDS];
+}
+Permutation;
+
+// function prototypes
+
+/**
+ * Function: rngSeed
+ * Input argument: rng - a pointer to a generator
+ *                 seed - any 64-bit value; equal seeds give equal sequences
+ * Output argument: rng is ready to produce numbers
+ * Return: none
+ * Dependencies: none
+ */
+void rngSeed(Rng *rng, uint64_t seed);
+
+/**
+ * Function: rngNext
+ * Input argument: rng - a pointer to a seeded generator
+ * Output argument: rng advances by one step
+ * Return: 64 uniformly distributed random bits
+ * Dependencies: none
+ */
+uint64_t rngNext(Rng *rng);
+
+/**
+ * Function: rngBelow
+ * Input argument: rng - a pointer to a seeded generator
+ *                 bound - the exclusive upper limit, greater than zero
+ * Output argument: rng advances by one or more steps
+ * Return: a uniformly distributed number in [0, bound), without modulo bias
+ * Dependencies: rngNext
+ */
+uint64_t rngBelow(Rng *rng, uint64_t bound);
+
+/**
+ * Function: permutationInit
+ * Input argument: permutation - a pointer to a permutation
+ *                 size - the number of indices to permute
+ *                 seed - the key; equal seeds give equal permutations
+ * Output argument: permutation is ready for permutationAt
+ * Return: none
+ * Dependencies: rngSeed, rngNext
+ */
+void permutationInit(Permutation *permutation, uint64_t size, uint64_t seed);
+
+/**
+ * Function: permutationAt
+ * Input argument: permutation - a pointer to an initialized permutation
+ *                 index - a position in [0, size)
+ * Output argument: none
+ * Return: the index placed at that position, also in [0, size); every
+ *         position maps to a different index
+ * Dependencies: none
+ */
+uint64_t permutationAt(const Permutation *permutation, uint64_t index);
+
+#endif // MUSIC_RNG_H
@@ -0,0 +1,688 @@
+// header files
+#include "music_search.h"
+#include "music_artist.h"
+#include <unistd.h>
+#include <pthread.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+// the AVX2 kernel is compiled for any x86 build and only run where the
+// processor has it
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SEARCH_HAVE_AVX2 1
+#include <immintrin.h>
+#else
+#define SEARCH_HAVE_AVX2 0
+#endif
+
+// a substring kernel: the first place in [start, end) where the length
+// bytes of needle are, or NULL
+typedef const char *(*SearchFinder)(const char *start, const char *end,
+    const char *needle, size_t length);
+
+// one slice of the copy and the songs matched in it
+typedef struct SearchChunk
+{
+    // the copy being searched
+    const SearchIndex *index;
+    // the lowercased query, at least one byte long, and the kernel
+    const char *needle;
+    size_t length;
+    SearchFinder find;
+    // the songs of the slice, first up to but not including last
+    size_t first;
+    size_t last;
+    // the numbers of the songs matched, in order
+    size_t *matches;
+    size_t count;
+    size_t capacity;
+    // set if memory for the matches ran out
+    bool failed;
+}
+SearchChunk;
+
+/**
+ * Function: searchFindScalar (helper)
+ * Input argument: start, end - the bytes to search
+ *                 needle - the bytes to look for
+ *                 length - the number of bytes in needle, at least 1
+ * Output argument: none
+ * Return: the first place needle starts at, or NULL
+ * Dependencies: string.h
+ */
+static const char *searchFindScalar(const char *start, const char *end,
+    const char *needle, size_t length)
+{
+    // look for the first byte, then check the rest
+    while ((size_t)(end - start) >= length)
+    {
+        const char *candidate = memchr(start, needle[0],
+            (size_t)(end - start) - length + 1);
+        if (candidate == NULL)
+        {
+            return NULL;
+        }
+        if (memcmp(candidate + 1, needle + 1, length - 1) == 0)
+        {
+            return candidate;
+        }
+        start = candidate + 1;
+    }
+    // no room left for a match
+    return NULL;
+}
+
+#ifdef __SSE2__
+/**
+ * Function: searchFindSse2 (helper)
+ * Input argument: start, end - the bytes to search
+ *                 needle - the bytes to look for
+ *                 length - the number of bytes in needle, at least 1
+ * Output argument: none
+ * Return: the first place needle starts at, or NULL
+ * Dependencies: searchFindScalar, emmintrin.h, string.h
+ *
+ * Compares 16 places at a time against the needle's first and last bytes,
+ * and only checks the middle of places where both match.
+ */
+static const char *searchFindSse2(const char *start, const char *end,
+    const char *needle, size_t length)
+{
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[length - 1]);
+    // go on while the block of last bytes fits before the end
+    while ((size_t)(end - start) >= length - 1 + 16)
+    {
+        __m128i heads = _mm_loadu_si128((const __m128i*)start);
+        __m128i tails = _mm_loadu_si128(
+            (const __m128i*)(start + length - 1));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_and_si128(
+            _mm_cmpeq_epi8(heads, first), _mm_cmpeq_epi8(tails, last)));
+        // check the candidates in order
+        while (mask != 0)
+        {
+            const char *candidate = start + __builtin_ctz(mask);
+            if (length <= 2 ||
+                memcmp(candidate + 1, needle + 1, length - 2) == 0)
+            {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+        start += 16;
+    }
+    // finish one place at a time
+    return searchFindScalar(start, end, needle, length);
+}
+#endif
+
+#if SEARCH_HAVE_AVX2
+/**
+ * Function: searchFindAvx2 (helper)
+ * Input argument: start, end - the bytes to search
+ *                 needle - the bytes to look for
+ *                 length - the number of bytes in needle, at least 1
+ * Output argument: none
+ * Return: the first place needle starts at, or NULL
+ * Dependencies: searchFindScalar, immintrin.h, string.h
+ *
+ * The same filter as searchFindSse2, 32 places at a time. Only called once
+ * the processor is known to have AVX2.
+ */
+__attribute__((target("avx2")))
+static const char *searchFindAvx2(const char *start, const char *end,
+    const char *needle, size_t length)
+{
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[length - 1]);
+    // go on while the block of last bytes fits before the end
+    while ((size_t)(end - start) >= length - 1 + 32)
+    {
+        __m256i heads = _mm256_loadu_si256((const __m256i*)start);
+        __m256i tails = _mm256_loadu_si256(
+            (const __m256i*)(start + length - 1));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_and_si256(
+            _mm256_cmpeq_epi8(heads, first), _mm256_cmpeq_epi8(tails, last)));
+        // check the candidates in order
+        while (mask != 0)
+        {
+            const char *candidate = start + __builtin_ctz(mask);
+            if (length <= 2 ||
+                memcmp(candidate + 1, needle + 1, length - 2) == 0)
+            {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+        start += 32;
+    }
+    // finish one place at a time
+    return searchFindScalar(start, end, needle, length);
+}
+#endif
+
+/**
+ * Function: searchKernelAvailable
+ * Input argument: kernel - a substring kernel
+ * Output argument: none
+ * Return: true if this build and processor can run the kernel
+ * Dependencies: none
+ */
+bool searchKernelAvailable(SearchKernel kernel)
+{
+    switch (kernel)
+    {
+        // automatic and scalar always run
+        case SEARCH_AUTO:
+        case SEARCH_SCALAR:
+            return true;
+        // SSE2 is decided at compile time, as in the columnar filters
+        case SEARCH_SSE2:
+#ifdef __SSE2__
+            return true;
+#else
+            return false;
+#endif
+        // AVX2 also needs the processor to have it
+        case SEARCH_AVX2:
+#if SEARCH_HAVE_AVX2
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+    }
+    // not a kernel
+    return false;
+}
+
+/**
+ * Function: searchChoose (helper)
+ * Input argument: kernel - the substring kernel asked for
+ * Output argument: none
+ * Return: the kernel's function, or that of the next slower one if the
+ *         processor cannot run it
+ * Dependencies: searchKernelAvailable
+ */
+static SearchFinder searchChoose(SearchKernel kernel)
+{
+#if SEARCH_HAVE_AVX2
+    if ((kernel == SEARCH_AUTO || kernel == SEARCH_AVX2) &&
+        searchKernelAvailable(SEARCH_AVX2))
+    {
+        return searchFindAvx2;
+    }
+#endif
+#ifdef __SSE2__
+    if (kernel != SEARCH_SCALAR)
+    {
+        return searchFindSse2;
+    }
+#endif
+    // otherwise, one byte at a time
+    (void)kernel;
+    return searchFindScalar;
+}
+
+/**
+ * Function: searchInit
+ * Input argument: index - a pointer to a search index
+ * Output argument: index is empty; nothing is allocated until the first
+ *                  refresh
+ * Return: none
+ * Dependencies: none
+ */
+void searchInit(SearchIndex *index)
+{
+    // nothing copied, nothing matched
+    index->text = NULL;
+    index->textLength = 0;
+    index->textCapacity = 0;
+    index->offsets = NULL;
+    index->songs = NULL;
+    index->count = 0;
+    index->capacity = 0;
+    index->playlist = NULL;
+    index->generation = 0;
+    index->matches = NULL;
+    index->matchCount = 0;
+    index->matchCapacity = 0;
+}
+
+/**
+ * Function: searchFree
+ * Input argument: index - a pointer to a search index
+ * Output argument: the copy and the matches are freed and index is empty
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void searchFree(SearchIndex *index)
+{
+    // free every array
+    free(index->text);
+    free(index->offsets);
+    free(index->songs);
+    free(index->matches);
+    // leave an empty, reusable index behind
+    searchInit(index);
+}
+
+/**
+ * Function: searchAppend (helper)
+ * Input argument: index - a pointer to a search index
+ *                 song - the song that plays after the ones copied so far
+ * Output argument: the song's title and artist are copied in lowercase
+ * Return: true on success, false if memory ran out
+ * Dependencies: songTitle, artistPoolName, artistPoolLength, stdlib.h,
+ *               ctype.h
+ */
+static bool searchAppend(SearchIndex *index, Song *song)
+{
+    // make room for the song, and for the end offset after it
+    if (index->count + 1 >= index->capacity)
+    {
+        size_t capacity = index->capacity == 0 ? SEARCH_MIN_CAPACITY :
+            index->capacity * 2;
+        Song **songs = realloc(index->songs, capacity * sizeof(Song*));
+        if (songs == NULL)
+        {
+            return false;
+        }
+        index->songs = songs;
+        size_t *offsets = realloc(index->offsets, capacity * sizeof(size_t));
+        if (offsets == NULL)
+        {
+            return false;
+        }
+        index->offsets = offsets;
+        index->capacity = capacity;
+    }
+    // and for its text, with a zero byte after each field
+    size_t artistLength = artistPoolLength(song->artist);
+    size_t length = song->titleLength + artistLength + 2;
+    if (index->textLength + length > index->textCapacity)
+    {
+        size_t capacity = index->textCapacity == 0 ?
+            SEARCH_MIN_CAPACITY : index->textCapacity;
+        while (capacity < index->textLength + length)
+        {
+            capacity *= 2;
+        }
+        char *text = realloc(index->text, capacity);
+        if (text == NULL)
+        {
+            return false;
+        }
+        index->text = text;
+        index->textCapacity = capacity;
+    }
+    // copy both fields in lowercase
+    char *out = index->text + index->textLength;
+    const char *title = songTitle(song);
+    for (size_t i = 0; i < song->titleLength; i++)
+    {
+        *out++ = (char)tolower((unsigned char)title[i]);
+    }
+    *out++ = '\0';
+    const char *artist = artistPoolName(song->artist);
+    for (size_t i = 0; i < artistLength; i++)
+    {
+        *out++ = (char)tolower((unsigned char)artist[i]);
+    }
+    *out++ = '\0';
+    // number the song
+    index->songs[index->count] = song;
+    index->offsets[index->count] = index->textLength;
+    index->count++;
+    index->textLength += length;
+    index->offsets[index->count] = index->textLength;
+    // return success
+    return true;
+}
+
+/**
+ * Function: searchRefresh
+ * Input argument: index - a pointer to a search index
+ *                 playlist - a pointer to the playlist handle to search
+ * Output argument: index holds the playlist's titles and artists in play
+ *                  order
+ * Return: true on success, false if memory ran out; the copy starts over on
+ *         the next refresh then
+ * Dependencies: playlistSongAt, playlistNext, searchAppend
+ *
+ * O(1) when nothing changed, O(k) after k appends, otherwise O(N).
+ */
+bool searchRefresh(SearchIndex *index, const Playlist *playlist)
+{
+    // appends leave the generation alone and only add songs at the end of
+    // play order; every other edit moves the generation on
+    if (index->playlist != playlist ||
+        index->generation != playlist->generation ||
+        index->count > playlist->length)
+    {
+        index->playlist = playlist;
+        index->generation = playlist->generation;
+        index->count = 0;
+        index->textLength = 0;
+    }
+    // the matches were numbered in the old copy
+    index->matchCount = 0;
+    // copy the songs not copied yet, from the first of them on
+    Song *current = playlistSongAt(playlist, index->count);
+    while (index->count < playlist->length)
+    {
+        if (!searchAppend(index, current))
+        {
+            // start over next time
+            index->playlist = NULL;
+            printf("Memory allocation failed.\n");
+            return false;
+        }
+        current = playlistNext(playlist, current);
+    }
+    // return success
+    return true;
+}
+
+/**
+ * Function: searchSongAt (helper)
+ * Input argument: index - a pointer to a search index
+ *                 low, high - songs to look between, low < high
+ *                 offset - a place in the text that is in one of them
+ * Output argument: none
+ * Return: the number of the song whose text the offset is in
+ * Dependencies: none
+ */
+static size_t searchSongAt(const SearchIndex *index, size_t low, size_t high,
+    size_t offset)
+{
+    // find the last song that starts at or before the offset
+    while (high - low > 1)
+    {
+        size_t middle = low + (high - low) / 2;
+        if (index->offsets[middle] <= offset)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    // return it
+    return low;
+}
+
+/**
+ * Function: searchScanChunk (helper)
+ * Input argument: argument - a pointer to the SearchChunk to scan
+ * Output argument: the chunk's matches are filled in
+ * Return: NULL, as a pthread start routine
+ * Dependencies: searchSongAt, stdlib.h
+ */
+static void *searchScanChunk(void *argument)
+{
+    // create pointers to the chunk, its copy and its text
+    SearchChunk *chunk = (SearchChunk*)argument;
+    const SearchIndex *index = chunk->index;
+    const char *text = index->text;
+    const char *end = text + index->offsets[chunk->last];
+    // run the kernel over the whole slice in one go, song by song only
+    // where it finds something
+    size_t song = chunk->first;
+    while (song < chunk->last)
+    {
+        const char *found = chunk->find(text + index->offsets[song], end,
+            chunk->needle, chunk->length);
+        if (found == NULL)
+        {
+            break;
+        }
+        song = searchSongAt(index, song, chunk->last, (size_t)(found - text));
+        // keep the song
+        if (chunk->count == chunk->capacity)
+        {
+            size_t capacity = chunk->capacity == 0 ? SEARCH_MIN_CAPACITY :
+                chunk->capacity * 2;
+            size_t *matches = realloc(chunk->matches,
+                capacity * sizeof(size_t));
+            if (matches == NULL)
+            {
+                chunk->failed = true;
+                break;
+            }
+            chunk->matches = matches;
+            chunk->capacity = capacity;
+        }
+        chunk->matches[chunk->count++] = song;
+        // a song matches once, however often the query is in it
+        song++;
+    }
+    // nothing to hand back
+    return NULL;
+}
+
+/**
+ * Function: searchThreadCount (helper)
+ * Input argument: threads - the requested number of threads, 0 for automatic
+ *                 bytes - the number of bytes to scan
+ * Output argument: none
+ * Return: the number of chunks to split the copy into, at least 1
+ * Dependencies: unistd.h
+ */
+static int searchThreadCount(int threads, size_t bytes)
+{
+    // default to one thread per online processor
+    if (threads <= 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    // cap the count
+    if (threads > SEARCH_MAX_THREADS)
+    {
+        threads = SEARCH_MAX_THREADS;
+    }
+    // keep every chunk big enough to be worth its thread
+    size_t useful = bytes / SEARCH_MIN_CHUNK;
+    if ((size_t)threads > useful)
+    {
+        threads = useful > 0 ? (int)useful : 1;
+    }
+    // return the count
+    return threads;
+}
+
+/**
+ * Function: searchSplit (helper)
+ * Input argument: chunks - the chunks to fill in
+ *                 count - the number of chunks
+ *                 index - the copy to split
+ * Output argument: the songs are divided into count chunks of about the
+ *                  same number of bytes
+ * Return: none
+ * Dependencies: searchSongAt
+ */
+static void searchSplit(SearchChunk *chunks, int count,
+    const SearchIndex *index)
+{
+    // create variable to hold the next chunk's first song
+    size_t boundary = 0;
+    for (int k = 0; k < count; k++)
+    {
+        chunks[k].first = boundary;
+        // aim for an even share of the text, ending at a song's start
+        if (k == count - 1)
+        {
+            boundary = index->count;
+        }
+        else
+        {
+            size_t target = index->textLength * (size_t)(k + 1) /
+                (size_t)count;
+            size_t song = searchSongAt(index, 0, index->count, target);
+            boundary = song > boundary ? song : boundary;
+        }
+        chunks[k].last = boundary;
+    }
+}
+
+/**
+ * Function: searchFind
+ * Input argument: index - a pointer to a refreshed search index
+ *                 query - the text to look for, in any case
+ *                 kernel - the substring kernel to run; one the processor
+ *                          cannot run falls back to the next slower one
+ *                 threads - the number of threads to scan with, 0 for one
+ *                           per online processor
+ * Output argument: index's matches are the songs whose title or artist
+ *                  contains the query, ignoring ASCII case, in play order
+ * Return: true on success, false if memory ran out
+ * Dependencies: searchChoose, searchThreadCount, searchSplit,
+ *               searchScanChunk, pthread.h, stdlib.h, string.h, ctype.h
+ */
+bool searchFind(SearchIndex *index, const char *query, SearchKernel kernel,
+    int threads)
+{
+    // forget the last search
+    index->matchCount = 0;
+    size_t length = strlen(query);
+    // make sure every song fits in the matches
+    if (index->matchCapacity < index->count)
+    {
+        size_t *matches = realloc(index->matches,
+            index->count * sizeof(size_t));
+        if (matches == NULL)
+        {
+            printf("Memory allocation failed.\n");
+            return false;
+        }
+        index->matches = matches;
+        index->matchCapacity = index->count;
+    }
+    // an empty query is in every song
+    if (length == 0)
+    {
+        for (size_t i = 0; i < index->count; i++)
+        {
+            index->matches[i] = i;
+        }
+        index->matchCount = index->count;
+        return true;
+    }
+    // nothing to scan in an empty copy
+    if (index->count == 0)
+    {
+        return true;
+    }
+    // lowercase the query the way the copy was
+    char *needle = malloc(length);
+    int count = searchThreadCount(threads, index->textLength);
+    SearchChunk *chunks = calloc((size_t)count, sizeof(SearchChunk));
+    pthread_t *workers = calloc((size_t)count, sizeof(pthread_t));
+    bool *started = calloc((size_t)count, sizeof(bool));
+    if (needle == NULL || chunks == NULL || workers == NULL ||
+        started == NULL)
+    {
+        free(needle);
+        free(chunks);
+        free(workers);
+        free(started);
+        printf("Memory allocation failed.\n");
+        return false;
+    }
+    for (size_t i = 0; i < length; i++)
+    {
+        needle[i] = (char)tolower((unsigned char)query[i]);
+    }
+    // split the songs into chunks that all run the same kernel
+    SearchFinder find = searchChoose(kernel);
+    searchSplit(chunks, count, index);
+    for (int k = 0; k < count; k++)
+    {
+        chunks[k].index = index;
+        chunks[k].needle = needle;
+        chunks[k].length = length;
+        chunks[k].find = find;
+    }
+    // hand every chunk but the first to a thread of its own
+    for (int k = 1; k < count; k++)
+    {
+        started[k] = pthread_create(&workers[k], NULL, searchScanChunk,
+            &chunks[k]) == 0;
+    }
+    // scan the first chunk here, and any chunk whose thread did not start
+    for (int k = 0; k < count; k++)
+    {
+        if (!started[k])
+        {
+            searchScanChunk(&chunks[k]);
+        }
+    }
+    // wait for the threads
+    for (int k = 1; k < count; k++)
+    {
+        if (started[k])
+        {
+            pthread_join(workers[k], NULL);
+        }
+    }
+    // the chunks are in play order, so their matches go one after another
+    bool failed = false;
+    for (int k = 0; k < count; k++)
+    {
+        if (chunks[k].count > 0)
+        {
+            memcpy(index->matches + index->matchCount, chunks[k].matches,
+                chunks[k].count * sizeof(size_t));
+        }
+        index->matchCount += chunks[k].count;
+        failed = failed || chunks[k].failed;
+        free(chunks[k].matches);
+    }
+    // free the scratch space
+    free(needle);
+    free(chunks);
+    free(workers);
+    free(started);
+    // a chunk that ran out of memory missed songs
+    if (failed)
+    {
+        index->matchCount = 0;
+        printf("Memory allocation failed.\n");
+        return false;
+    }
+    // return success
+    return true;
+}
+
+/**
+ * Function: searchPlay
+ * Input argument: index - a pointer to a search index after searchFind
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres. Genres are
+ *                          listed in the array according to its enum value.
+ *                          For example, "Pop" is at index genres[POP]
+ * Output argument: up to MAX_SONGS of the matching songs are played in
+ *                  play order
+ * Return: the number of songs played
+ * Dependencies: outputPlaying, outputFlush, songTitle, artistPoolName,
+ *               artistPoolLength
+ */
+size_t searchPlay(const SearchIndex *index, OutputSink *sink,
+    char* genres[])
+{
+    // play the first matches, as playback stops at MAX_SONGS
+    size_t count = index->matchCount < MAX_SONGS ? index->matchCount :
+        MAX_SONGS;
+    for (size_t i = 0; i < count; i++)
+    {
+        const Song *song = index->songs[index->matches[i]];
+        outputPlaying(sink, songTitle(song), song->titleLength,
+            artistPoolName(song->artist), artistPoolLength(song->artist),
+            genres[song->genre]);
+    }
+    // the songs must show before whatever the caller prints next
+    outputFlush(sink);
+    // return the count
+    return count;
+}
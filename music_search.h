@@ -0,0 +1,137 @@
+#ifndef MUSIC_SEARCH_H
+#define MUSIC_SEARCH_H
+
+// header files
+#include "music_lib.h"
+
+// global definitions
+// songs and bytes of text a search copy has room for at first
+#define SEARCH_MIN_CAPACITY 64
+// the most threads a search will start
+#define SEARCH_MAX_THREADS 64
+// slices smaller than this are not worth a thread of their own
+#define SEARCH_MIN_CHUNK (1024 * 1024)
+
+// the substring kernels a search can run
+typedef enum
+{
+    // the fastest one the processor supports
+    SEARCH_AUTO,
+    // memchr for the first byte, then memcmp
+    SEARCH_SCALAR,
+    // 16 candidate positions per compare
+    SEARCH_SSE2,
+    // 32 candidate positions per compare
+    SEARCH_AVX2
+}
+SearchKernel;
+
+// a lowercased copy of every title and artist of a playlist, back to back,
+// for substring search
+//
+// Song number i is songs[i], the i-th song in play order, and its text is
+// its title and its artist, each followed by a zero byte, from offsets[i] on.
+// A query has no zero byte, so no match runs from one field into the next.
+// The copy is brought up to date by searchRefresh: appends are copied on to
+// the end, any other edit starts it over.
+typedef struct SearchIndex
+{
+    // the text, and where each song's text starts; offsets[count] is the
+    // end of the text
+    char *text;
+    size_t textLength;
+    size_t textCapacity;
+    size_t *offsets;
+    // the songs, in play order
+    Song **songs;
+    size_t count;
+    size_t capacity;
+    // the playlist copied, and its generation at the time; NULL when the
+    // copy must start over
+    const Playlist *playlist;
+    uint64_t generation;
+    // the numbers of the songs the last search matched, in play order
+    size_t *matches;
+    size_t matchCount;
+    size_t matchCapacity;
+}
+SearchIndex;
+
+// function prototypes
+
+/**
+ * Function: searchInit
+ * Input argument: index - a pointer to a search index
+ * Output argument: index is empty; nothing is allocated until the first
+ *                  refresh
+ * Return: none
+ * Dependencies: none
+ */
+void searchInit(SearchIndex *index);
+
+/**
+ * Function: searchFree
+ * Input argument: index - a pointer to a search index
+ * Output argument: the copy and the matches are freed and index is empty
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+void searchFree(SearchIndex *index);
+
+/**
+ * Function: searchRefresh
+ * Input argument: index - a pointer to a search index
+ *                 playlist - a pointer to the playlist handle to search
+ * Output argument: index holds the playlist's titles and artists in play
+ *                  order
+ * Return: true on success, false if memory ran out; the copy starts over on
+ *         the next refresh then
+ * Dependencies: playlistSongAt, playlistNext, searchAppend
+ *
+ * O(1) when nothing changed, O(k) after k appends, otherwise O(N).
+ */
+bool searchRefresh(SearchIndex *index, const Playlist *playlist);
+
+/**
+ * Function: searchKernelAvailable
+ * Input argument: kernel - a substring kernel
+ * Output argument: none
+ * Return: true if this build and processor can run the kernel
+ * Dependencies: none
+ */
+bool searchKernelAvailable(SearchKernel kernel);
+
+/**
+ * Function: searchFind
+ * Input argument: index - a pointer to a refreshed search index
+ *                 query - the text to look for, in any case
+ *                 kernel - the substring kernel to run; one the processor
+ *                          cannot run falls back to the next slower one
+ *                 threads - the number of threads to scan with, 0 for one
+ *                           per online processor
+ * Output argument: index's matches are the songs whose title or artist
+ *                  contains the query, ignoring ASCII case, in play order
+ * Return: true on success, false if memory ran out
+ * Dependencies: searchChoose, searchThreadCount, searchSplit,
+ *               searchScanChunk, pthread.h, stdlib.h, string.h, ctype.h
+ */
+bool searchFind(SearchIndex *index, const char *query, SearchKernel kernel,
+    int threads);
+
+/**
+ * Function: searchPlay
+ * Input argument: index - a pointer to a search index after searchFind
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres. Genres are
+ *                          listed in the array according to its enum value.
+ *                          For example, "Pop" is at index genres[POP]
+ * Output argument: up to MAX_SONGS of the matching songs are played in
+ *                  play order
+ * Return: the number of songs played
+ * Dependencies: outputPlaying, outputFlush, songTitle, artistPoolName,
+ *               artistPoolLength
+ */
+size_t searchPlay(const SearchIndex *index, OutputSink *sink,
+    char* genres[]);
+
+#endif // MUSIC_SEARCH_H
@@ -0,0 +1,499 @@
+// header files
+#include "music_shared.h"
+#include "music_artist.h"
+
+/**
+ * Function: sharedReleaseOrder (helper)
+ * Input argument: context - unused
+ *                 item - a retired play order whose array lives on in a
+ *                        newer one
+ * Output argument: the play order is freed, its array is not
+ * Return: none
+ * Dependencies: stdlib.h
+ */
+static void sharedReleaseOrder(void *context, void *item)
+{
+    (void)context;
+    free(item);
+}
+
+/**
+ * Function: sharedReleaseArray (helper)
+ * Input argument: context - unused
+ *                 item - a retired play order, the newest to use its array
+ * Output argument: the play order and its array are freed
+ * Return: none
+ * Dependencies: stdlib.h
+ *
+ * Older orders on the same array were retired earlier, so they are
+ * released before this one.
+ */
+static void sharedReleaseArray(void *context, void *item)
+{
+    (void)context;
+    PlayOrder *order = (PlayOrder*)item;
+    free(order->songs);
+    free(order);
+}
+
+/**
+ * Function: sharedReleaseSong (helper)
+ * Input argument: context - the shared playlist the song was detached from
+ *                 item - a detached song
+ * Output argument: the song is freed
+ * Return: none
+ * Dependencies: playlistReleaseSong
+ *
+ * Runs inside epochCollect or epochSynchronize, so under the writer's
+ * lock like every other change to the playlist's pool.
+ */
+static void sharedReleaseSong(void *context, void *item)
+{
+    SharedPlaylist *shared = (SharedPlaylist*)context;
+    playlistReleaseSong(&shared->playlist, (Song*)item);
+}
+
+/**
+ * Function: sharedAllocOrder (helper)
+ * Input argument: capacity - the number of songs the array must hold
+ * Output argument: none
+ * Return: an empty play order with an array of its own, or NULL if memory
+ *         ran out
+ * Dependencies: stdlib.h
+ */
+static PlayOrder *sharedAllocOrder(size_t capacity)
+{
+    PlayOrder *order = (PlayOrder*)malloc(sizeof(PlayOrder));
+    if (order == NULL)
+    {
+        return NULL;
+    }
+    order->songs = (Song**)malloc(capacity * sizeof(Song*));
+    if (order->songs == NULL)
+    {
+        free(order);
+        return NULL;
+    }
+    order->length = 0;
+    order->capacity = capacity;
+    order->reversed = false;
+    // return the order
+    return order;
+}
+
+/**
+ * Function: sharedFillOrder (helper)
+ * Input argument: order - a play order from sharedAllocOrder with room for
+ *                         every song
+ *                 playlist - a pointer to a playlist handle
+ * Output argument: order holds the playlist's songs in play order
+ * Return: none
+ * Dependencies: playlistFirst, playlistNext
+ */
+static void sharedFillOrder(PlayOrder *order, const Playlist *playlist)
+{
+    Song *song = playlistFirst(playlist);
+    for (size_t i = 0; i < playlist->length; i++)
+    {
+        order->songs[i] = song;
+        song = playlistNext(playlist, song);
+    }
+    order->length = playlist->length;
+    order->reversed = false;
+}
+
+/**
+ * Function: sharedPublish (helper)
+ * Input argument: shared - a pointer to a shared playlist, lock held
+ *                 next - the play order to publish
+ *                 newArray - true if next does not use the current order's
+ *                            array
+ * Output argument: readers that start from now on see next; the current
+ *                  order is retired, with its array if nothing newer uses
+ *                  it, and whatever readers let go of is released
+ * Return: none
+ * Dependencies: epochRetire, epochCollect
+ */
+static void sharedPublish(SharedPlaylist *shared, PlayOrder *next,
+    bool newArray)
+{
+    // everything next points at was written before this store
+    PlayOrder *current = shared->order;
+    __atomic_store_n(&shared->order, next, __ATOMIC_RELEASE);
+    epochRetire(&shared->epoch, current,
+        newArray ? sharedReleaseArray : sharedReleaseOrder, NULL);
+    epochCollect(&shared->epoch);
+}
+
+/**
+ * Function: sharedPublishCopy (helper)
+ * Input argument: shared - a pointer to a shared playlist, lock held
+ * Output argument: the playlist's play order is published in a new array
+ *                  with room to append as many songs again
+ * Return: true on success, false if memory ran out, in which case readers
+ *         keep the current order
+ * Dependencies: sharedAllocOrder, sharedFillOrder, sharedPublish, stdio.h
+ */
+static bool sharedPublishCopy(SharedPlaylist *shared)
+{
+    size_t length = shared->playlist.length;
+    PlayOrder *next = sharedAllocOrder(length < SHARED_MIN_CAPACITY / 2 ?
+        SHARED_MIN_CAPACITY : length * 2);
+    if (next == NULL)
+    {
+        printf("Out of memory. Playback keeps the previous order.\n");
+        shared->published = false;
+        return false;
+    }
+    sharedFillOrder(next, &shared->playlist);
+    sharedPublish(shared, next, true);
+    shared->published = true;
+    // return success
+    return true;
+}
+
+/**
+ * Function: sharedInit
+ * Input argument: shared - a pointer to a shared playlist
+ * Output argument: shared is empty, with an empty play order published
+ * Return: true on success, false if memory ran out
+ * Dependencies: playlistInit, epochInit, sharedAllocOrder, pthread.h
+ */
+bool sharedInit(SharedPlaylist *shared)
+{
+    // readers need an order to read from the start
+    shared->order = sharedAllocOrder(SHARED_MIN_CAPACITY);
+    if (shared->order == NULL)
+    {
+        return false;
+    }
+    shared->published = true;
+    playlistInit(&shared->playlist);
+    pthread_mutex_init(&shared->lock, NULL);
+    epochInit(&shared->epoch);
+    // return success
+    return true;
+}
+
+/**
+ * Function: sharedLoad
+ * Input argument: shared - a pointer to a shared playlist
+ *                 filename - the path of the CSV file to read
+ * Output argument: songs from the file are appended and published
+ * Return: true if the playlist is successfully loaded, false if errors occur
+ * Dependencies: playlistLoad, sharedPublishCopy, pthread.h
+ */
+bool sharedLoad(SharedPlaylist *shared, const char *filename)
+{
+    pthread_mutex_lock(&shared->lock);
+    // load under the lock, then let readers see the songs
+    bool loaded = playlistLoad(&shared->playlist, filename);
+    bool published = sharedPublishCopy(shared);
+    pthread_mutex_unlock(&shared->lock);
+    // return the result
+    return loaded && published;
+}
+
+/**
+ * Function: sharedFree
+ * Input argument: shared - a pointer to a shared playlist whose readers are
+ *                          all closed
+ * Output argument: every song and play order is freed
+ * Return: none
+ * Dependencies: epochFree, playlistFree, pthread.h, stdlib.h
+ */
+void sharedFree(SharedPlaylist *shared)
+{
+    // removed songs go back to the pool before the pool goes
+    pthread_mutex_lock(&shared->lock);
+    epochFree(&shared->epoch);
+    pthread_mutex_unlock(&shared->lock);
+    // the current order is the last one on its array
+    sharedReleaseArray(NULL, shared->order);
+    shared->order = NULL;
+    playlistFree(&shared->playlist);
+    pthread_mutex_destroy(&shared->lock);
+}
+
+/**
+ * Function: sharedAddSong
+ * Input argument: shared - a pointer to a shared playlist
+ *                 title - a string with the title of the song
+ *                 artist - a string with the artist of the song
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song is added at the end of play order and published
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: playlistAddSong, playlistLast, sharedPublish,
+ *               sharedPublishCopy, playlistDetachSong, playlistReleaseSong,
+ *               pthread.h, stdlib.h
+ *
+ * O(1) amortized: the song is written past the end of the shared array.
+ */
+bool sharedAddSong(SharedPlaylist *shared, const char *title,
+    const char *artist, Genre genre)
+{
+    pthread_mutex_lock(&shared->lock);
+    // add the song where readers cannot see it yet
+    if (!playlistAddSong(&shared->playlist, title, artist, genre))
+    {
+        pthread_mutex_unlock(&shared->lock);
+        return false;
+    }
+    Song *song = playlistLast(&shared->playlist);
+    PlayOrder *current = shared->order;
+    PlayOrder *next = NULL;
+    // an order that is up to date and has room takes the song past its end,
+    // where no version that can see the array reads
+    if (shared->published && !current->reversed &&
+        current->length < current->capacity)
+    {
+        next = (PlayOrder*)malloc(sizeof(PlayOrder));
+    }
+    if (next != NULL)
+    {
+        current->songs[current->length] = song;
+        *next = *current;
+        next->length++;
+        sharedPublish(shared, next, false);
+    }
+    // otherwise the order is copied with room to grow; a song readers never
+    // saw is simply taken back if that fails
+    else if (!sharedPublishCopy(shared))
+    {
+        playlistDetachSong(&shared->playlist, song);
+        playlistReleaseSong(&shared->playlist, song);
+        pthread_mutex_unlock(&shared->lock);
+        return false;
+    }
+    pthread_mutex_unlock(&shared->lock);
+    // return success
+    return true;
+}
+
+/**
+ * Function: sharedRemoveSong
+ * Input argument: shared - a pointer to a shared playlist
+ *                 title - a string with the title of the song
+ * Output argument: the first song in play order with that title is
+ *                  unpublished, and freed once no reader holds it
+ * Return: true if the song is successfully removed, false otherwise
+ * Dependencies: playlistFindSong, sharedAllocOrder, playlistPosition,
+ *               playlistDetachSong, sharedFillOrder, sharedPublish,
+ *               epochRetire, epochCollect, pthread.h, stdio.h, string.h
+ *
+ * O(N): the new play order is a copy without the song, made with two
+ * block copies of the current one.
+ */
+bool sharedRemoveSong(SharedPlaylist *shared, const char *title)
+{
+    pthread_mutex_lock(&shared->lock);
+    Song *song = playlistFindSong(&shared->playlist, title);
+    // check if the title was not found
+    if (song == NULL)
+    {
+        printf("Song '%s' is not in the list.\n", title);
+        pthread_mutex_unlock(&shared->lock);
+        return false;
+    }
+    // the new order is allocated first, so a failure changes nothing
+    size_t length = shared->playlist.length;
+    PlayOrder *next = sharedAllocOrder(length < SHARED_MIN_CAPACITY ?
+        SHARED_MIN_CAPACITY : length);
+    if (next == NULL)
+    {
+        printf("Out of memory. Song not removed.\n");
+        pthread_mutex_unlock(&shared->lock);
+        return false;
+    }
+    // an up-to-date order is copied around the song, two block copies
+    // instead of a walk over every song
+    PlayOrder *current = shared->order;
+    if (shared->published)
+    {
+        size_t position = playlistPosition(&shared->playlist, song);
+        size_t index = current->reversed ? length - 1 - position : position;
+        memcpy(next->songs, current->songs, index * sizeof(Song*));
+        memcpy(next->songs + index, current->songs + index + 1,
+            (length - index - 1) * sizeof(Song*));
+        next->length = length - 1;
+        next->reversed = current->reversed;
+        playlistDetachSong(&shared->playlist, song);
+    }
+    // otherwise it is filled from the links
+    else
+    {
+        playlistDetachSong(&shared->playlist, song);
+        sharedFillOrder(next, &shared->playlist);
+        shared->published = true;
+    }
+    // readers can reach the song until the order without it is published,
+    // so only then does it go to the epoch domain
+    sharedPublish(shared, next, true);
+    epochRetire(&shared->epoch, song, sharedReleaseSong, shared);
+    epochCollect(&shared->epoch);
+    pthread_mutex_unlock(&shared->lock);
+    // return success
+    return true;
+}
+
+/**
+ * Function: sharedSortByGenre
+ * Input argument: shared - a pointer to a shared playlist
+ * Output argument: the playlist is sorted by genre and the new order
+ *                  published
+ * Return: none
+ * Dependencies: playlistSortByGenre, sharedPublishCopy, pthread.h
+ */
+void sharedSortByGenre(SharedPlaylist *shared)
+{
+    pthread_mutex_lock(&shared->lock);
+    // readers keep playing the old order while the links are rearranged
+    playlistSortByGenre(&shared->playlist);
+    sharedPublishCopy(shared);
+    pthread_mutex_unlock(&shared->lock);
+}
+
+/**
+ * Function: sharedReverse
+ * Input argument: shared - a pointer to a shared playlist
+ * Output argument: the play order is reversed and published in O(1)
+ * Return: none
+ * Dependencies: playlistReverse, sharedPublish, sharedPublishCopy,
+ *               pthread.h, stdlib.h
+ */
+void sharedReverse(SharedPlaylist *shared)
+{
+    pthread_mutex_lock(&shared->lock);
+    playlistReverse(&shared->playlist);
+    PlayOrder *current = shared->order;
+    PlayOrder *next = NULL;
+    // an up-to-date order is read the other way round, on the same array
+    if (shared->published)
+    {
+        next = (PlayOrder*)malloc(sizeof(PlayOrder));
+    }
+    if (next != NULL)
+    {
+        *next = *current;
+        next->reversed = !next->reversed;
+        sharedPublish(shared, next, false);
+    }
+    // otherwise it is copied; if even that fails, the playlist is turned
+    // back so it still plays as readers see it
+    else if (!sharedPublishCopy(shared))
+    {
+        playlistReverse(&shared->playlist);
+    }
+    pthread_mutex_unlock(&shared->lock);
+}
+
+/**
+ * Function: sharedReaderOpen
+ * Input argument: reader - a pointer to a reader
+ *                 shared - a pointer to a shared playlist
+ * Output argument: reader is registered with shared
+ * Return: true on success, false if EPOCH_MAX_READERS readers are open
+ * Dependencies: epochRegister
+ */
+bool sharedReaderOpen(SharedReader *reader, SharedPlaylist *shared)
+{
+    reader->shared = shared;
+    reader->slot = epochRegister(&shared->epoch);
+    return reader->slot < EPOCH_MAX_READERS;
+}
+
+/**
+ * Function: sharedReaderClose
+ * Input argument: reader - a pointer to an open reader outside a read
+ *                          section
+ * Output argument: reader is no longer registered
+ * Return: none
+ * Dependencies: epochUnregister
+ */
+void sharedReaderClose(SharedReader *reader)
+{
+    epochUnregister(&reader->shared->epoch, reader->slot);
+    reader->slot = EPOCH_MAX_READERS;
+}
+
+/**
+ * Function: sharedReadBegin
+ * Input argument: reader - a pointer to an open reader
+ * Output argument: a read section starts, without taking a lock
+ * Return: the current play order; it and its songs stay valid until
+ *         sharedReadEnd, whatever writers do meanwhile
+ * Dependencies: epochEnter
+ */
+const PlayOrder *sharedReadBegin(SharedReader *reader)
+{
+    // announce the section before loading the order
+    epochEnter(&reader->shared->epoch, reader->slot);
+    return __atomic_load_n(&reader->shared->order, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Function: sharedReadEnd
+ * Input argument: reader - a pointer to a reader inside a read section
+ * Output argument: the section ends; nothing read in it may be used after
+ * Return: none
+ * Dependencies: epochExit
+ */
+void sharedReadEnd(SharedReader *reader)
+{
+    epochExit(&reader->shared->epoch, reader->slot);
+}
+
+/**
+ * Function: playOrderAt
+ * Input argument: order - a play order from sharedReadBegin
+ *                 position - a place in play order, below its length
+ * Output argument: none
+ * Return: the song at that position
+ * Dependencies: none
+ */
+Song *playOrderAt(const PlayOrder *order, size_t position)
+{
+    // a reversed order plays from the end of the array
+    return order->songs[order->reversed ?
+        order->length - 1 - position : position];
+}
+
+/**
+ * Function: sharedPlay
+ * Input argument: reader - a pointer to an open reader
+ *                 position - the place in play order to play from
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres. Genres are
+ *                          listed in the array according to its enum value.
+ *                          For example, "Pop" is at index genres[POP]
+ *                 max - the most songs to play
+ * Output argument: up to max songs of the current play order are played in
+ *                  one read section, and position moves past them
+ * Return: the number of songs played, 0 at the end of the play order
+ * Dependencies: sharedReadBegin, sharedReadEnd, playOrderAt, outputPlaying,
+ *               outputFlush
+ *
+ * The position is a number, not a song, so edits before it shift what
+ * plays next by the number of songs added or removed.
+ */
+size_t sharedPlay(SharedReader *reader, size_t *position, OutputSink *sink,
+    char* genres[], size_t max)
+{
+    // format the batch inside the section; the sink copies every byte
+    const PlayOrder *order = sharedReadBegin(reader);
+    size_t count = 0;
+    while (count < max && *position < order->length)
+    {
+        Song *song = playOrderAt(order, *position);
+        outputPlaying(sink, songTitle(song), song->titleLength,
+            artistPoolName(song->artist), artistPoolLength(song->artist),
+            genres[song->genre]);
+        (*position)++;
+        count++;
+    }
+    sharedReadEnd(reader);
+    // and write it out after, so a slow destination holds nothing back
+    outputFlush(sink);
+    // return the number of songs played
+    return count;
+}
@@ -0,0 +1,216 @@
+#ifndef MUSIC_SHARED_H
+#define MUSIC_SHARED_H
+
+// header files
+#include <pthread.h>
+#include "music_lib.h"
+#include "music_epoch.h"
+
+// global definitions
+// songs a play order has room for at first
+#define SHARED_MIN_CAPACITY 64
+
+// one published version of the play order, never changed once readers can
+// see it
+//
+// Versions share their array until an edit other than an append needs a
+// new one: an append writes past the end of every version that can see the
+// array and publishes a version one song longer.
+typedef struct PlayOrder
+{
+    // the songs, in link order
+    Song **songs;
+    // the number of songs in this version, and the room in the array
+    size_t length;
+    size_t capacity;
+    // whether the songs play from the end of the array to the start
+    bool reversed;
+}
+PlayOrder;
+
+// a playlist that playback threads read without locks while one control
+// thread at a time edits it
+//
+// Writers edit the playlist under the lock and then publish a new play
+// order; songs they remove and orders they replace are released through
+// the epoch domain once no reader can hold them. The handle must not be
+// moved or copied after sharedInit.
+typedef struct SharedPlaylist
+{
+    // the playlist the writers edit, only touched under the lock
+    Playlist playlist;
+    pthread_mutex_t lock;
+    // the current play order, swapped atomically
+    PlayOrder *order;
+    // whether order matches the playlist; false after a change readers
+    // could not be shown for lack of memory, until a copy succeeds
+    bool published;
+    // tracks what readers may still hold
+    EpochDomain epoch;
+}
+SharedPlaylist;
+
+// one playback thread's registration with a shared playlist
+typedef struct SharedReader
+{
+    SharedPlaylist *shared;
+    // the reader's slot in the epoch domain
+    size_t slot;
+}
+SharedReader;
+
+// function prototypes
+
+/**
+ * Function: sharedInit
+ * Input argument: shared - a pointer to a shared playlist
+ * Output argument: shared is empty, with an empty play order published
+ * Return: true on success, false if memory ran out
+ * Dependencies: playlistInit, epochInit, sharedAllocOrder, pthread.h
+ */
+bool sharedInit(SharedPlaylist *shared);
+
+/**
+ * Function: sharedLoad
+ * Input argument: shared - a pointer to a shared playlist
+ *                 filename - the path of the CSV file to read
+ * Output argument: songs from the file are appended and published
+ * Return: true if the playlist is successfully loaded, false if errors occur
+ * Dependencies: playlistLoad, sharedPublishCopy, pthread.h
+ */
+bool sharedLoad(SharedPlaylist *shared, const char *filename);
+
+/**
+ * Function: sharedFree
+ * Input argument: shared - a pointer to a shared playlist whose readers are
+ *                          all closed
+ * Output argument: every song and play order is freed
+ * Return: none
+ * Dependencies: epochFree, playlistFree, pthread.h, stdlib.h
+ */
+void sharedFree(SharedPlaylist *shared);
+
+/**
+ * Function: sharedAddSong
+ * Input argument: shared - a pointer to a shared playlist
+ *                 title - a string with the title of the song
+ *                 artist - a string with the artist of the song
+ *                 genre - a Genre enum for the genre of the song
+ * Output argument: the song is added at the end of play order and published
+ * Return: true if the song is successfully added, false otherwise
+ * Dependencies: playlistAddSong, playlistLast, sharedPublish,
+ *               sharedPublishCopy, playlistDetachSong, playlistReleaseSong,
+ *               pthread.h, stdlib.h
+ *
+ * O(1) amortized: the song is written past the end of the shared array.
+ */
+bool sharedAddSong(SharedPlaylist *shared, const char *title,
+    const char *artist, Genre genre);
+
+/**
+ * Function: sharedRemoveSong
+ * Input argument: shared - a pointer to a shared playlist
+ *                 title - a string with the title of the song
+ * Output argument: the first song in play order with that title is
+ *                  unpublished, and freed once no reader holds it
+ * Return: true if the song is successfully removed, false otherwise
+ * Dependencies: playlistFindSong, sharedAllocOrder, playlistPosition,
+ *               playlistDetachSong, sharedFillOrder, sharedPublish,
+ *               epochRetire, epochCollect, pthread.h, stdio.h, string.h
+ *
+ * O(N): the new play order is a copy without the song, made with two
+ * block copies of the current one.
+ */
+bool sharedRemoveSong(SharedPlaylist *shared, const char *title);
+
+/**
+ * Function: sharedSortByGenre
+ * Input argument: shared - a pointer to a shared playlist
+ * Output argument: the playlist is sorted by genre and the new order
+ *                  published
+ * Return: none
+ * Dependencies: playlistSortByGenre, sharedPublishCopy, pthread.h
+ */
+void sharedSortByGenre(SharedPlaylist *shared);
+
+/**
+ * Function: sharedReverse
+ * Input argument: shared - a pointer to a shared playlist
+ * Output argument: the play order is reversed and published in O(1)
+ * Return: none
+ * Dependencies: playlistReverse, sharedPublish, sharedPublishCopy,
+ *               pthread.h, stdlib.h
+ */
+void sharedReverse(SharedPlaylist *shared);
+
+/**
+ * Function: sharedReaderOpen
+ * Input argument: reader - a pointer to a reader
+ *                 shared - a pointer to a shared playlist
+ * Output argument: reader is registered with shared
+ * Return: true on success, false if EPOCH_MAX_READERS readers are open
+ * Dependencies: epochRegister
+ */
+bool sharedReaderOpen(SharedReader *reader, SharedPlaylist *shared);
+
+/**
+ * Function: sharedReaderClose
+ * Input argument: reader - a pointer to an open reader outside a read
+ *                          section
+ * Output argument: reader is no longer registered
+ * Return: none
+ * Dependencies: epochUnregister
+ */
+void sharedReaderClose(SharedReader *reader);
+
+/**
+ * Function: sharedReadBegin
+ * Input argument: reader - a pointer to an open reader
+ * Output argument: a read section starts, without taking a lock
+ * Return: the current play order; it and its songs stay valid until
+ *         sharedReadEnd, whatever writers do meanwhile
+ * Dependencies: epochEnter
+ */
+const PlayOrder *sharedReadBegin(SharedReader *reader);
+
+/**
+ * Function: sharedReadEnd
+ * Input argument: reader - a pointer to a reader inside a read section
+ * Output argument: the section ends; nothing read in it may be used after
+ * Return: none
+ * Dependencies: epochExit
+ */
+void sharedReadEnd(SharedReader *reader);
+
+/**
+ * Function: playOrderAt
+ * Input argument: order - a play order from sharedReadBegin
+ *                 position - a place in play order, below its length
+ * Output argument: none
+ * Return: the song at that position
+ * Dependencies: none
+ */
+Song *playOrderAt(const PlayOrder *order, size_t position);
+
+/**
+ * Function: sharedPlay
+ * Input argument: reader - a pointer to an open reader
+ *                 position - the place in play order to play from
+ *                 sink - where the songs are played to
+ *                 genres - an array with the names of the genres. Genres are
+ *                          listed in the array according to its enum value.
+ *                          For example, "Pop" is at index genres[POP]
+ *                 max - the most songs to play
+ * Output argument: up to max songs of the current play order are played in
+ *                  one read section, and position moves past them
+ * Return: the number of songs played, 0 at the end of the play order
+ * Dependencies: sharedReadBegin, sharedReadEnd, playOrderAt, outputPlaying,
+ *               outputFlush
+ *
+ * The position is a number, not a song, so edits before it shift what
+ * plays next by the number of songs added or removed.
+ */
+size_t sharedPlay(SharedReader *reader, size_t *position, OutputSink *sink,
+    char* genres[], size_t max);
+
+#endif // MUSIC_SHARED_H
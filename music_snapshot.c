@@ -0,0 +1,462 @@
+// header files
+#include "music_snapshot.h"
+#include "music_artist.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// global definitions
+#define SNAPSHOT_MAGIC "TUNESNAP"
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+// the strings written so far, each stored once
+typedef struct SnapshotStrings
+{
+    // the string table being built
+    char *bytes;
+    // bytes used and allocated
+    size_t length;
+    size_t capacity;
+    // open-addressing table of offsets + 1 into bytes, 0 for an empty slot
+    uint32_t *slots;
+    // capacity - 1 of the slot table
+    size_t mask;
+    // number of distinct strings
+    size_t count;
+}
+SnapshotStrings;
+
+/**
+ * Function: snapshotChecksum (helper)
+ * Input argument: data - the bytes to checksum
+ *                 bytes - how many there are
+ *                 hash - the checksum so far, or 0 to start
+ * Output argument: none
+ * Return: the checksum continued over data
+ * Dependencies: string.h
+ *
+ * Mixes a word at a time, so checking a large snapshot costs far less than
+ * reading it from disk.
+ */
+static uint64_t snapshotChecksum(const void *data, size_t bytes, uint64_t hash)
+{
+    // create pointer to the next unread byte
+    const unsigned char *current = (const unsigned char*)data;
+    // mix every whole 8-byte word
+    while (bytes >= 8)
+    {
+        uint64_t word;
+        memcpy(&word, current, sizeof(word));
+        hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+        hash ^= hash >> 29;
+        current += 8;
+        bytes -= 8;
+    }
+    // then the leftover bytes
+    while (bytes > 0)
+    {
+        hash = (hash ^ *current) * 0x100000001B3ull;
+        current++;
+        bytes--;
+    }
+    // return the checksum
+    return hash;
+}
+
+/**
+ * Function: snapshotHash (helper)
+ * Input argument: text - the string to hash
+ *                 length - its length
+ * Output argument: none
+ * Return: a 32-bit FNV-1a hash of the string
+ * Dependencies: none
+ */
+static uint32_t snapshotHash(const char *text, size_t length)
+{
+    // FNV-1a over the bytes
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++)
+    {
+        hash = (hash ^ (unsigned char)text[i]) * 16777619u;
+    }
+    // return the hash
+    return hash;
+}
+
+/**
+ * Function: snapshotIntern (helper)
+ * Input argument: strings - the string table being built
+ *                 text - the null terminated string to store
+ *                 length - its length
+ *                 offset - where to store the string's offset
+ * Output argument: the string is added unless an equal one already was
+ * Return: true on success, false if memory ran out or the table is over
+ *         the 4 GB the offsets can address
+ * Dependencies: snapshotHash, stdlib.h, string.h
+ */
+static bool snapshotIntern(SnapshotStrings *strings, const char *text,
+    size_t length, uint32_t *offset)
+{
+    // keep the slot table at most half full
+    if ((strings->count + 1) * 2 > strings->mask + 1)
+    {
+        // double it and place every string again
+        size_t capacity = (strings->mask + 1) * 2;
+        uint32_t *slots = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+        if (slots == NULL)
+        {
+            return false;
+        }
+        for (size_t i = 0; i <= strings->mask; i++)
+        {
+            if (strings->slots[i] != 0)
+            {
+                const char *old = strings->bytes + strings->slots[i] - 1;
+                size_t position = snapshotHash(old, strlen(old)) &
+                    (capacity - 1);
+                while (slots[position] != 0)
+                {
+                    position = (position + 1) & (capacity - 1);
+                }
+                slots[position] = strings->slots[i];
+            }
+        }
+        free(strings->slots);
+        strings->slots = slots;
+        strings->mask = capacity - 1;
+    }
+    // probe for the string or a free slot
+    size_t position = snapshotHash(text, length) & strings->mask;
+    while (strings->slots[position] != 0)
+    {
+        // reuse an equal string
+        const char *old = strings->bytes + strings->slots[position] - 1;
+        if (strcmp(old, text) == 0)
+        {
+            *offset = strings->slots[position] - 1;
+            return true;
+        }
+        position = (position + 1) & strings->mask;
+    }
+    // make room for the string and its terminator
+    if (strings->length + length + 1 > strings->capacity)
+    {
+        size_t capacity = strings->capacity * 2 + length + 1;
+        char *bytes = (char*)realloc(strings->bytes, capacity);
+        if (bytes == NULL)
+        {
+            return false;
+        }
+        strings->bytes = bytes;
+        strings->capacity = capacity;
+    }
+    // offsets must fit in a record, with one to spare for the slot encoding
+    if (strings->length + length + 1 >= UINT32_MAX)
+    {
+        return false;
+    }
+    // append it
+    *offset = (uint32_t)strings->length;
+    memcpy(strings->bytes + strings->length, text, length + 1);
+    strings->length += length + 1;
+    // and remember it
+    strings->slots[position] = *offset + 1;
+    strings->count++;
+    // return success
+    return true;
+}
+
+/**
+ * Function: playlistSaveSnapshot
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 filename - the path of the snapshot to write
+ *                 source - the CSV the playlist was loaded from, whose size
+ *                          and modification time are recorded
+ *                 sequence - the last journal record the playlist includes,
+ *                            0 for none
+ * Output argument: the snapshot replaces filename atomically: it is written
+ *                  to a temporary file that is renamed over filename
+ * Return: true if the snapshot was written, false otherwise
+ * Dependencies: snapshotIntern, snapshotChecksum, playlistFirst,
+ *               playlistNext, stdio.h, stdlib.h, string.h, sys/stat.h,
+ *               unistd.h
+ */
+bool playlistSaveSnapshot(const Playlist *playlist, const char *filename,
+    const char *source, uint64_t sequence)
+{
+    // the snapshot is only useful alongside the CSV it came from
+    struct stat info;
+    if (stat(source, &info) != 0)
+    {
+        return false;
+    }
+    // allocate the records and a first string table
+    SnapshotRecord *records = (SnapshotRecord*)calloc(
+        playlist->length > 0 ? playlist->length : 1, sizeof(SnapshotRecord));
+    SnapshotStrings strings = { NULL, 0, 0, NULL, 63, 0 };
+    strings.slots = (uint32_t*)calloc(strings.mask + 1, sizeof(uint32_t));
+    bool ok = records != NULL && strings.slots != NULL;
+    // describe every song in play order
+    Song *current = playlistFirst(playlist);
+    for (size_t i = 0; ok && i < playlist->length; i++)
+    {
+        size_t titleLength = current->titleLength;
+        const char *artist = songArtist(current);
+        size_t artistLength = strlen(artist);
+        ok = snapshotIntern(&strings, songTitle(current), titleLength,
+            &records[i].title) &&
+            snapshotIntern(&strings, artist, artistLength,
+            &records[i].artist);
+        records[i].titleLength = (uint32_t)titleLength;
+        records[i].artistLength = (uint8_t)artistLength;
+        records[i].genre = (uint8_t)current->genre;
+        current = playlistNext(playlist, current);
+    }
+
+    // fill in the header
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.sourceSize = (uint64_t)info.st_size;
+    header.sourceSeconds = (int64_t)info.st_mtim.tv_sec;
+    header.sourceNanoseconds = (int64_t)info.st_mtim.tv_nsec;
+    header.songCount = playlist->length;
+    header.stringBytes = strings.length;
+    header.circular = playlist->circular;
+    header.sequence = sequence;
+    size_t recordBytes = playlist->length * sizeof(SnapshotRecord);
+    if (ok)
+    {
+        header.checksum = snapshotChecksum(strings.bytes, strings.length,
+            snapshotChecksum(records, recordBytes, 0));
+    }
+
+    // write everything to a temporary file next to the snapshot
+    size_t nameLength = strlen(filename) + sizeof(".XXXXXX");
+    char *temporary = (char*)malloc(nameLength);
+    int fd = -1;
+    if (ok && temporary != NULL)
+    {
+        snprintf(temporary, nameLength, "%s.XXXXXX", filename);
+        fd = mkstemp(temporary);
+    }
+    // mkstemp creates the file private, but a snapshot is as readable as
+    // its CSV
+    if (fd >= 0)
+    {
+        fchmod(fd, info.st_mode & 0666);
+    }
+    FILE *file = fd >= 0 ? fdopen(fd, "wb") : NULL;
+    ok = file != NULL;
+    ok = ok && fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && fwrite(records, 1, recordBytes, file) == recordBytes;
+    ok = ok && fwrite(strings.bytes, 1, strings.length, file) ==
+        strings.length;
+    // make the data durable before it can replace the old snapshot
+    ok = ok && fflush(file) == 0 && fsync(fd) == 0;
+    if (file != NULL)
+    {
+        ok = fclose(file) == 0 && ok;
+    }
+    else if (fd >= 0)
+    {
+        close(fd);
+    }
+    // swap it in, or throw it away
+    if (fd >= 0)
+    {
+        if (ok)
+        {
+            ok = rename(temporary, filename) == 0;
+        }
+        if (!ok)
+        {
+            unlink(temporary);
+        }
+    }
+
+    // free the buffers
+    free(temporary);
+    free(records);
+    free(strings.bytes);
+    free(strings.slots);
+    // return the result
+    return ok;
+}
+
+/**
+ * Function: playlistLoadSnapshot
+ * Input argument: playlist - a pointer to an empty playlist handle
+ *                 filename - the path of the snapshot to read
+ *                 source - the CSV the snapshot must be up to date with
+ * Output argument: the snapshot's songs are appended to the playlist
+ *                  sequence - the last journal record it includes, unless
+ *                             NULL
+ * Return: true if the snapshot was loaded, false if it is missing, stale,
+ *         corrupt or memory ran out; the playlist is left empty then
+ * Dependencies: snapshotChecksum, artistCacheIntern, playlistAppendInterned,
+ *               playlistRebuildIndexes, playlistFree, sys/mman.h, sys/stat.h
+ *
+ * Only the base file the journal replays over; it loads no faster than
+ * the CSV, as building the songs and their indexes costs the same.
+ */
+bool playlistLoadSnapshot(Playlist *playlist, const char *filename,
+    const char *source, uint64_t *sequence)
+{
+    // read the CSV's size and modification time
+    struct stat sourceInfo;
+    if (stat(source, &sourceInfo) != 0)
+    {
+        return false;
+    }
+    // open the snapshot, which may not exist yet
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    // it must at least hold a header
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SnapshotHeader))
+    {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)info.st_size;
+    // map it; the descriptor is no longer needed afterwards
+    const char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    // check that the header belongs to this CSV and this version
+    const SnapshotHeader *header = (const SnapshotHeader*)data;
+    size_t available = size - sizeof(SnapshotHeader);
+    bool ok = memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic))
+        == 0 && header->version == SNAPSHOT_VERSION &&
+        header->byteOrder == SNAPSHOT_BYTE_ORDER &&
+        header->sourceSize == (uint64_t)sourceInfo.st_size &&
+        header->sourceSeconds == (int64_t)sourceInfo.st_mtim.tv_sec &&
+        header->sourceNanoseconds == (int64_t)sourceInfo.st_mtim.tv_nsec &&
+        header->songCount <= available / sizeof(SnapshotRecord) &&
+        header->songCount * sizeof(SnapshotRecord) + header->stringBytes ==
+        available;
+    // then that its contents are intact
+    const SnapshotRecord *records =
+        (const SnapshotRecord*)(data + sizeof(SnapshotHeader));
+    const char *strings = (const char*)(records + (ok ? header->songCount : 0));
+    if (ok && snapshotChecksum(strings, header->stringBytes,
+        snapshotChecksum(records, header->songCount *
+        sizeof(SnapshotRecord), 0)) != header->checksum)
+    {
+        printf("Snapshot %s is corrupt, reading %s instead.\n", filename,
+            source);
+        ok = false;
+    }
+
+    // the songs are indexed in one pass once they are all linked
+    bool indexed = playlist->indexed;
+    playlist->indexed = false;
+    // repeated artists are numbered without taking the pool lock
+    ArtistCache artists;
+    artistCacheInit(&artists);
+    // copy each record into a song
+    for (uint64_t i = 0; ok && i < header->songCount; i++)
+    {
+        const SnapshotRecord *record = &records[i];
+        // the checksum catches damage, this catches files that lie
+        ok = record->title < header->stringBytes &&
+            record->artist < header->stringBytes &&
+            header->stringBytes - record->title > record->titleLength &&
+            header->stringBytes - record->artist > record->artistLength &&
+            strings[(uint64_t)record->title + record->titleLength] == '\0' &&
+            strings[record->artist + record->artistLength] == '\0' &&
+            record->artistLength < STR_LEN &&
+            record->genre < GENRE_COUNT;
+        if (!ok)
+        {
+            break;
+        }
+        // number the artist, then copy the title into a new song
+        uint32_t artist = artistCacheIntern(&artists,
+            strings + record->artist, record->artistLength);
+        ok = artist != ARTIST_NONE && playlistAppendInterned(playlist,
+            strings + record->title, record->titleLength, artist,
+            (Genre)record->genre);
+        // give the artist reference back if the song was not added
+        if (!ok && artist != ARTIST_NONE)
+        {
+            artistCacheDrop(&artists, artist);
+        }
+    }
+    // hand the references counted by the cache to the shared pool
+    artistCacheFlush(&artists);
+    // index them
+    playlist->indexed = indexed;
+    if (ok)
+    {
+        playlistRebuildIndexes(playlist);
+    }
+    // restore continuous play
+    if (ok && header->circular && playlist->tail != NULL)
+    {
+        playlist->tail->next = playlist->head;
+        playlist->head->prev = playlist->tail;
+        playlist->circular = true;
+    }
+    // tell the caller which journal records the songs already include
+    if (ok && sequence != NULL)
+    {
+        *sequence = header->sequence;
+    }
+    // every byte has been copied out of the mapping
+    munmap((void *)data, size);
+    // leave nothing half loaded behind
+    if (!ok)
+    {
+        playlistFree(playlist);
+    }
+    // return the result
+    return ok;
+}
+
+/**
+ * Function: playlistSnapshotSequence
+ * Input argument: filename - the path of a snapshot
+ * Output argument: none
+ * Return: the last journal record folded into the snapshot, 0 if it holds
+ *         none or is missing or not a snapshot of this version
+ * Dependencies: fcntl.h, unistd.h
+ *
+ * Reads only the header, whatever CSV the snapshot was taken from, so a
+ * caller can tell a stale snapshot that holds edits from a plain copy of
+ * the CSV.
+ */
+uint64_t playlistSnapshotSequence(const char *filename)
+{
+    // a missing snapshot holds no edits
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        return 0;
+    }
+    // read the header alone
+    SnapshotHeader header;
+    bool read = pread(fd, &header, sizeof(header), 0) ==
+        (ssize_t)sizeof(header);
+    close(fd);
+    // and trust its sequence only if it is a header this version wrote
+    if (!read ||
+        memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SNAPSHOT_VERSION ||
+        header.byteOrder != SNAPSHOT_BYTE_ORDER)
+    {
+        return 0;
+    }
+    return header.sequence;
+}
@@ -0,0 +1,328 @@
+// header files
+#include "music_sort.h"
+
+// how a sort run compares two songs
+typedef struct SortOrder
+{
+    // the caller's comparator, used for ties and when there is no key
+    SongComparator compare;
+    // true when the sortKey fields were filled in for this run
+    bool keyed;
+    // true when equal keys already mean equal songs
+    bool exact;
+}
+SortOrder;
+
+/**
+ * Function: songCompareByGenre
+ * Input argument: a, b - pointers to the songs to compare
+ * Output argument: none
+ * Return: negative, zero or positive as a's genre is before, equal to or
+ *         after b's
+ * Dependencies: none
+ */
+int songCompareByGenre(const Song *a, const Song *b)
+{
+    // genres order by their enum value
+    return (int)a->genre - (int)b->genre;
+}
+
+/**
+ * Function: songCompareByArtist
+ * Input argument: a, b - pointers to the songs to compare
+ * Output argument: none
+ * Return: the strcmp order of the artists
+ * Dependencies: songArtist, string.h
+ */
+int songCompareByArtist(const Song *a, const Song *b)
+{
+    // one number per artist, so equal numbers settle ties without the names
+    if (a->artist == b->artist)
+    {
+        return 0;
+    }
+    // otherwise, artists order like strcmp
+    return strcmp(songArtist(a), songArtist(b));
+}
+
+/**
+ * Function: songCompareByTitle
+ * Input argument: a, b - pointers to the songs to compare
+ * Output argument: none
+ * Return: the strcmp order of the titles
+ * Dependencies: songTitle, string.h
+ */
+int songCompareByTitle(const Song *a, const Song *b)
+{
+    // titles order like strcmp
+    return strcmp(songTitle(a), songTitle(b));
+}
+
+/**
+ * Function: songCompareByGenreArtistTitle
+ * Input argument: a, b - pointers to the songs to compare
+ * Output argument: none
+ * Return: the order by genre, then artist, then title
+ * Dependencies: songCompareByGenre, songCompareByArtist, songCompareByTitle
+ */
+int songCompareByGenreArtistTitle(const Song *a, const Song *b)
+{
+    // genre decides first
+    int order = songCompareByGenre(a, b);
+    // then artist
+    if (order == 0)
+    {
+        order = songCompareByArtist(a, b);
+    }
+    // then title
+    if (order == 0)
+    {
+        order = songCompareByTitle(a, b);
+    }
+    // return the first difference
+    return order;
+}
+
+/**
+ * Function: sortPrefixKey (helper)
+ * Input argument: text - the string to abbreviate
+ *                 bytes - how many leading bytes to pack, at most 8
+ * Output argument: none
+ * Return: the leading bytes packed big-endian, so comparing keys as integers
+ *         agrees with strcmp on those bytes
+ * Dependencies: none
+ */
+static uint64_t sortPrefixKey(const char *text, int bytes)
+{
+    // create variable to accumulate the key
+    uint64_t key = 0;
+    // create variable to stop at the end of short strings
+    bool ended = false;
+    // pack each byte, padding with zeros after the terminator
+    for (int i = 0; i < bytes; i++)
+    {
+        // read the next byte unless the string already ended
+        unsigned char c = ended ? 0 : (unsigned char)text[i];
+        // remember when the terminator is reached
+        ended = c == 0;
+        // shift it in as the next lower byte
+        key = (key << 8) | c;
+    }
+    // left-align short keys so they compare over the full 64 bits
+    return key << (8 * (8 - bytes));
+}
+
+/**
+ * Function: sortPrepare (helper)
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 compare - the comparator the sort was called with
+ * Output argument: the sortKey of every song is set when compare is built in
+ * Return: how the merge loop should compare songs
+ * Dependencies: sortPrefixKey
+ *
+ * The built-in comparators are replaced by integer keys: the genre itself,
+ * or the first bytes of the artist or title. Songs whose keys tie are handed
+ * to the comparator, so the order is exactly the comparator's.
+ */
+static SortOrder sortPrepare(Playlist *playlist, SongComparator compare)
+{
+    // default to calling the comparator for every pair
+    SortOrder order = { compare, false, false };
+    // create variable to store current song
+    Song* current = playlist->head;
+    // genre keys are exact
+    if (compare == songCompareByGenre)
+    {
+        for (size_t i = 0; i < playlist->length; i++)
+        {
+            current->sortKey = (uint64_t)current->genre;
+            current = current->next;
+        }
+        order.keyed = true;
+        order.exact = true;
+    }
+    // artist keys hold the first 8 bytes
+    else if (compare == songCompareByArtist)
+    {
+        for (size_t i = 0; i < playlist->length; i++)
+        {
+            current->sortKey = sortPrefixKey(songArtist(current), 8);
+            current = current->next;
+        }
+        order.keyed = true;
+    }
+    // title keys hold the first 8 bytes
+    else if (compare == songCompareByTitle)
+    {
+        for (size_t i = 0; i < playlist->length; i++)
+        {
+            current->sortKey = sortPrefixKey(songTitle(current), 8);
+            current = current->next;
+        }
+        order.keyed = true;
+    }
+    // compound keys hold the genre in the top byte over 7 artist bytes
+    else if (compare == songCompareByGenreArtistTitle)
+    {
+        for (size_t i = 0; i < playlist->length; i++)
+        {
+            current->sortKey = ((uint64_t)current->genre << 56) |
+                (sortPrefixKey(songArtist(current), 7) >> 8);
+            current = current->next;
+        }
+        order.keyed = true;
+    }
+    // return the chosen strategy
+    return order;
+}
+
+/**
+ * Function: sortInOrder (helper)
+ * Input argument: order - how to compare songs
+ *                 a - the song from the left run
+ *                 b - the song from the right run
+ * Output argument: none
+ * Return: true if a should be taken first, which keeps equal songs stable
+ * Dependencies: none
+ */
+static inline bool sortInOrder(const SortOrder *order, const Song *a,
+    const Song *b)
+{
+    // compare keys first when they were prepared
+    if (order->keyed)
+    {
+        // different keys settle it without touching the strings
+        if (a->sortKey != b->sortKey)
+        {
+            return a->sortKey < b->sortKey;
+        }
+        // equal exact keys mean equal songs
+        if (order->exact)
+        {
+            return true;
+        }
+    }
+    // fall back to the comparator
+    return order->compare(a, b) <= 0;
+}
+
+/**
+ * Function: sortMerge (helper)
+ * Input argument: order - how to compare songs
+ *                 left - a sorted, NULL terminated run of earlier songs
+ *                 right - a sorted, NULL terminated run of later songs
+ * Output argument: the two runs are relinked into one
+ * Return: the head of the merged run
+ * Dependencies: sortInOrder
+ */
+static Song *sortMerge(const SortOrder *order, Song *left, Song *right)
+{
+    // a placeholder in front of the merged run saves a special case
+    Song head;
+    Song *tail = &head;
+    // take the smaller song while both runs have songs
+    while (left != NULL && right != NULL)
+    {
+        // ties go to the left run, which keeps the sort stable
+        if (sortInOrder(order, left, right))
+        {
+            tail->next = left;
+            left = left->next;
+        }
+        else
+        {
+            tail->next = right;
+            right = right->next;
+        }
+        // move the tail to the song just taken
+        tail = tail->next;
+    }
+    // the rest of whichever run is left over follows as is
+    tail->next = left != NULL ? left : right;
+    // return the merged run
+    return head.next;
+}
+
+/**
+ * Function: sortPlaylist
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 compare - the comparator that defines the order; the
+ *                           songCompareBy* functions take a fast path
+ * Output argument: playlist sorted in place, tail and circularity kept
+ * Return: void
+ * Dependencies: playlistStraighten, sortPrepare, sortMerge,
+ *               playlistRebuildIndexes
+ *
+ * Bottom-up merge sort over the links. Songs are fed one at a time into a
+ * binary counter of sorted runs, where runs[i] holds 2^i songs, and equal
+ * sized runs are merged as they meet. Every merge works on runs that were
+ * just touched, so the sort stays in cache far longer than a pass per
+ * width would. This is O(N log N), stable, and needs only the fixed array
+ * of run heads.
+ */
+void sortPlaylist(Playlist *playlist, SongComparator compare)
+{
+    // nothing to sort in playlists of fewer than two songs
+    if (playlist->length < 2)
+    {
+        return;
+    }
+    // the merges follow the next links, so they must run in play order
+    playlistStraighten(playlist);
+    // every song may have a new position
+    playlist->generation++;
+    // precompute keys for the built-in comparators
+    SortOrder order = sortPrepare(playlist, compare);
+    // the loop below needs a NULL terminated list
+    playlist->tail->next = NULL;
+    // sorted runs of 2^i songs, enough for any playlist that fits in memory
+    Song *runs[64] = { NULL };
+    // create pointer to the next unsorted song
+    Song *current = playlist->head;
+    // feed every song into the counter
+    while (current != NULL)
+    {
+        // detach the song as a run of one
+        Song *carry = current;
+        current = current->next;
+        carry->next = NULL;
+        // merge it with every full run it meets, older runs on the left
+        int i = 0;
+        while (i < 63 && runs[i] != NULL)
+        {
+            carry = sortMerge(&order, runs[i], carry);
+            runs[i] = NULL;
+            i++;
+        }
+        // park the result in the first empty slot
+        runs[i] = carry;
+    }
+    // merge the leftover runs, the larger older ones on the left
+    Song *sorted = NULL;
+    for (int i = 0; i < 64; i++)
+    {
+        if (runs[i] != NULL)
+        {
+            sorted = sortMerge(&order, runs[i], sorted);
+        }
+    }
+    // the merged run is the new playlist
+    playlist->head = sorted;
+    // find the new tail, linking each song back to the one before
+    Song *tail = sorted;
+    sorted->prev = NULL;
+    while (tail->next != NULL)
+    {
+        tail->next->prev = tail;
+        tail = tail->next;
+    }
+    playlist->tail = tail;
+    // close the playlist again if it was circular
+    if (playlist->circular)
+    {
+        playlist->tail->next = playlist->head;
+        playlist->head->prev = playlist->tail;
+    }
+    // songs have new predecessors
+    playlistRebuildIndexes(playlist);
+}
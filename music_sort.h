@@ -0,0 +1,63 @@
+#ifndef MUSIC_SORT_H
+#define MUSIC_SORT_H
+
+// header files
+#include "music_lib.h"
+
+// compares two songs like strcmp: negative, zero or positive
+typedef int (*SongComparator)(const Song *a, const Song *b);
+
+// function prototypes
+
+/**
+ * Function: songCompareByGenre
+ * Input argument: a, b - pointers to the songs to compare
+ * Output argument: none
+ * Return: negative, zero or positive as a's genre is before, equal to or
+ *         after b's
+ * Dependencies: none
+ */
+int songCompareByGenre(const Song *a, const Song *b);
+
+/**
+ * Function: songCompareByArtist
+ * Input argument: a, b - pointers to the songs to compare
+ * Output argument: none
+ * Return: the strcmp order of the artists
+ * Dependencies: songArtist, string.h
+ */
+int songCompareByArtist(const Song *a, const Song *b);
+
+/**
+ * Function: songCompareByTitle
+ * Input argument: a, b - pointers to the songs to compare
+ * Output argument: none
+ * Return: the strcmp order of the titles
+ * Dependencies: songTitle, string.h
+ */
+int songCompareByTitle(const Song *a, const Song *b);
+
+/**
+ * Function: songCompareByGenreArtistTitle
+ * Input argument: a, b - pointers to the songs to compare
+ * Output argument: none
+ * Return: the order by genre, then artist, then title
+ * Dependencies: songCompareByGenre, songCompareByArtist, songCompareByTitle
+ */
+int songCompareByGenreArtistTitle(const Song *a, const Song *b);
+
+/**
+ * Function: sortPlaylist
+ * Input argument: playlist - a pointer to a playlist handle
+ *                 compare - the comparator that defines the order; the
+ *                           songCompareBy* functions above take a fast path
+ * Output argument: playlist sorted in place, tail and circularity kept
+ * Return: void
+ * Dependencies: none
+ *
+ * Bottom-up merge sort over the links: O(N log N), stable and O(1) extra
+ * memory (a fixed array of 64 run heads).
+ */
+void sortPlaylist(Playlist *playlist, SongComparator compare);
+
+#endif // MUSIC_SORT_H